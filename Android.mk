@@ -36,6 +36,9 @@ LOCAL_SRC_FILES := \
     android/service/platform_api_stub.cpp \
     src/anbox/common/fd.cpp \
     src/anbox/common/wait_handle.cpp \
+    src/anbox/network/receive_buffer.cpp \
+    src/anbox/rpc/frame_decoder.cpp \
+    src/anbox/rpc/frame_encoder.cpp \
     src/anbox/rpc/message_processor.cpp \
     src/anbox/rpc/pending_call_cache.cpp \
     src/anbox/rpc/channel.cpp \
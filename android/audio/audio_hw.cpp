@@ -22,6 +22,7 @@
 #include <pthread.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <sys/mman.h>
 #include <sys/socket.h>
 #include <sys/time.h>
 #include <sys/un.h>
@@ -36,14 +37,17 @@
 #include <hardware/hardware.h>
 #include <system/audio.h>
 
+#include "anbox/audio/capture_ring.h"
 #include "anbox/audio/client_info.h"
 
 #define AUDIO_DEVICE_NAME "/dev/anbox_audio"
 #define OUT_SAMPLING_RATE 44100
-#define OUT_BUFFER_SIZE 4096
+#define OUT_BUFFER_SIZE 2048
 #define OUT_LATENCY_MS 20
 #define IN_SAMPLING_RATE 8000
 #define IN_BUFFER_SIZE 320
+#define IN_FRAME_SIZE 2
+#define IN_PERIOD_COUNT 4
 
 struct generic_audio_device {
   struct audio_hw_device device;
@@ -58,6 +62,7 @@ struct generic_stream_out {
   struct generic_audio_device *dev;
   audio_devices_t device;
   int fd;
+  uint32_t latency_ms;
 };
 
 struct generic_stream_in {
@@ -65,6 +70,9 @@ struct generic_stream_in {
   struct generic_audio_device *dev;
   audio_devices_t device;
   int fd;
+  anbox::audio::CaptureRingHeader *ring;
+  size_t ring_size;
+  uint64_t frames_lost;
 };
 
 static uint32_t out_get_sample_rate(const struct audio_stream *stream) {
@@ -164,7 +172,8 @@ static char *out_get_parameters(const struct audio_stream *stream, const char *k
 }
 
 static uint32_t out_get_latency(const struct audio_stream_out *stream) {
-  return OUT_LATENCY_MS;
+  const struct generic_stream_out *out = (const struct generic_stream_out *)stream;
+  return out->latency_ms;
 }
 
 static int out_set_volume(struct audio_stream_out *stream, float left,
@@ -303,13 +312,62 @@ static int in_set_gain(struct audio_stream_in *stream, float gain) {
   return 0;
 }
 
+// Copies frames out of the shared capture ring. When it runs dry we tell
+// the server we are waiting and block on the socket until it wrote more.
+static ssize_t read_from_ring(struct generic_stream_in *in, void *buffer,
+                              size_t bytes) {
+  anbox::audio::CaptureRingHeader *ring = in->ring;
+  const uint8_t *frames = (const uint8_t *)ring + anbox::audio::CaptureRingHeader::data_offset;
+  const size_t frame_size = ring->frame_size;
+  const size_t capacity = ring->capacity;
+  const size_t wanted = bytes / frame_size;
+  uint64_t read_position = ring->read_position.load(std::memory_order_relaxed);
+  size_t done = 0;
+
+  while (done < wanted) {
+    const uint64_t write_position = ring->write_position.load(std::memory_order_acquire);
+    size_t available = (size_t)(write_position - read_position);
+    if (available > capacity)
+      available = capacity;
+
+    if (available == 0) {
+      ring->reader_waiting.store(1, std::memory_order_seq_cst);
+      if (ring->write_position.load(std::memory_order_seq_cst) != read_position)
+        continue;
+
+      char wakeup;
+      if (read(in->fd, &wakeup, sizeof(wakeup)) != sizeof(wakeup))
+        return -EIO;
+      continue;
+    }
+
+    size_t n = wanted - done;
+    if (n > available)
+      n = available;
+    const size_t offset = (size_t)(read_position % capacity);
+    size_t first = capacity - offset;
+    if (first > n)
+      first = n;
+    memcpy((uint8_t *)buffer + done * frame_size, frames + offset * frame_size, first * frame_size);
+    memcpy((uint8_t *)buffer + (done + first) * frame_size, frames, (n - first) * frame_size);
+
+    read_position += n;
+    ring->read_position.store(read_position, std::memory_order_release);
+    done += n;
+  }
+
+  return (ssize_t)(done * frame_size);
+}
+
 static ssize_t in_read(struct audio_stream_in *stream, void *buffer,
                        size_t bytes) {
   struct generic_stream_in *in = (struct generic_stream_in *)stream;
   struct generic_audio_device *adev = in->dev;
 
   pthread_mutex_lock(&adev->lock);
-  if (in->fd >= 0)
+  if (in->ring)
+    bytes = read_from_ring(in, buffer, bytes);
+  else if (in->fd >= 0)
     bytes = read(in->fd, buffer, bytes);
   if (adev->mic_mute && (bytes > 0)) {
     memset(buffer, 0, bytes);
@@ -320,7 +378,14 @@ static ssize_t in_read(struct audio_stream_in *stream, void *buffer,
 }
 
 static uint32_t in_get_input_frames_lost(struct audio_stream_in *stream) {
-  return 0;
+  struct generic_stream_in *in = (struct generic_stream_in *)stream;
+  if (!in->ring)
+    return 0;
+
+  const uint64_t dropped = in->ring->dropped_frames.load(std::memory_order_relaxed);
+  const uint64_t lost = dropped - in->frames_lost;
+  in->frames_lost = dropped;
+  return (uint32_t)lost;
 }
 
 static int in_add_audio_effect(const struct audio_stream *stream, effect_handle_t effect) {
@@ -331,7 +396,37 @@ static int in_remove_audio_effect(const struct audio_stream *stream, effect_hand
   return 0;
 }
 
-static int connect_audio_server(const anbox::audio::ClientInfo::Type &type) {
+static int receive_fd(int socket) {
+  char dummy;
+  struct iovec iov;
+  iov.iov_base = &dummy;
+  iov.iov_len = sizeof(dummy);
+
+  char control[CMSG_SPACE(sizeof(int))];
+  struct msghdr header;
+  memset(&header, 0, sizeof(header));
+  header.msg_iov = &iov;
+  header.msg_iovlen = 1;
+  header.msg_control = control;
+  header.msg_controllen = sizeof(control);
+
+  if (recvmsg(socket, &header, MSG_WAITALL) != sizeof(dummy))
+    return -EIO;
+
+  struct cmsghdr *message = CMSG_FIRSTHDR(&header);
+  if (!message || message->cmsg_level != SOL_SOCKET || message->cmsg_type != SCM_RIGHTS ||
+      message->cmsg_len != CMSG_LEN(sizeof(int)))
+    return -EIO;
+
+  int fd;
+  memcpy(&fd, CMSG_DATA(message), sizeof(fd));
+  return fd;
+}
+
+static int connect_audio_server(const anbox::audio::ClientInfo::Type &type,
+                                anbox::audio::StreamFormat *format,
+                                anbox::audio::CaptureConfig *capture,
+                                int *ring_fd) {
   int fd = socket(AF_LOCAL, SOCK_STREAM, 0);
   if (fd < 0)
     return -errno;
@@ -348,21 +443,47 @@ static int connect_audio_server(const anbox::audio::ClientInfo::Type &type) {
 
   // We will send out client type information to the server and the
   // server will either deny the request by closing the connection
-  // or by sending us the approved client details back.
+  // or by sending us the approved client details back. If we pass a
+  // format along the server answers with the one it settled on.
   anbox::audio::ClientInfo client_info{type};
-  if (::write(fd, &client_info, sizeof(client_info)) < 0) {
+  if (format)
+    client_info.type = static_cast<anbox::audio::ClientInfo::Type>(
+        static_cast<uint8_t>(type) | anbox::audio::ClientInfo::format_follows);
+
+  if (::write(fd, &client_info, sizeof(client_info)) < 0 ||
+      (format && ::write(fd, format, sizeof(*format)) < 0) ||
+      (format && capture && ::write(fd, capture, sizeof(*capture)) < 0)) {
     close(fd);
     return -EIO;
   }
 
-  auto bytes_read = ::read(fd, &client_info, sizeof(client_info));
-  if (bytes_read < 0) {
+  auto bytes_read = ::recv(fd, &client_info, sizeof(client_info), MSG_WAITALL);
+  if (bytes_read != sizeof(client_info)) {
     close(fd);
     return -EIO;
   }
 
-  // FIXME once we have real client details we need to check if we
-  // got everything we need or if anything is missing.
+  if (format) {
+    bytes_read = ::recv(fd, format, sizeof(*format), MSG_WAITALL);
+    if (bytes_read != sizeof(*format)) {
+      close(fd);
+      return -EIO;
+    }
+
+    if (capture) {
+      bytes_read = ::recv(fd, capture, sizeof(*capture), MSG_WAITALL);
+      if (bytes_read != sizeof(*capture)) {
+        close(fd);
+        return -EIO;
+      }
+
+      *ring_fd = receive_fd(fd);
+      if (*ring_fd < 0) {
+        close(fd);
+        return -EIO;
+      }
+    }
+  }
 
   ALOGE("Successfully connected Anbox audio server");
 
@@ -378,7 +499,9 @@ static int adev_open_output_stream(struct audio_hw_device *dev,
                                    const char *address __unused) {
   struct generic_audio_device *adev = (struct generic_audio_device *)dev;
   struct generic_stream_out *out;
-  int ret = 0, fd = 0;
+  int ret = 0, fd = 0, sndbuf = 0;
+  anbox::audio::StreamFormat format{OUT_SAMPLING_RATE, 2,
+                                    anbox::audio::StreamFormat::Sample::S16, 0};
 
   pthread_mutex_lock(&adev->lock);
   if (adev->output != NULL) {
@@ -386,13 +509,27 @@ static int adev_open_output_stream(struct audio_hw_device *dev,
     goto error;
   }
 
-  fd = connect_audio_server(anbox::audio::ClientInfo::Type::Playback);
+  fd = connect_audio_server(anbox::audio::ClientInfo::Type::Playback, &format, NULL, NULL);
   if (fd < 0) {
     ret = fd;
     ALOGE("Failed to connect with Anbox audio servers (err %d)", ret);
     goto error;
   }
 
+  if (format.rate != OUT_SAMPLING_RATE || format.channels != 2 ||
+      format.sample != anbox::audio::StreamFormat::Sample::S16) {
+    ALOGE("Anbox audio server didn't accept our output format");
+    close(fd);
+    ret = -EINVAL;
+    goto error;
+  }
+
+  // Keep the socket from buffering much more than the one buffer we are
+  // writing, otherwise everything it holds adds to the latency while the
+  // host already paces us by how fast it plays.
+  sndbuf = OUT_BUFFER_SIZE;
+  setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+
   if ((config->format != AUDIO_FORMAT_PCM_16_BIT) ||
       (config->channel_mask != AUDIO_CHANNEL_OUT_STEREO) ||
       (config->sample_rate != OUT_SAMPLING_RATE)) {
@@ -407,6 +544,9 @@ static int adev_open_output_stream(struct audio_hw_device *dev,
 
   out = (struct generic_stream_out *)calloc(1, sizeof(struct generic_stream_out));
   out->fd = fd;
+  // What the host queues plus the buffer sitting in the socket.
+  out->latency_ms = format.latency_ms > 0 ?
+      format.latency_ms + OUT_BUFFER_SIZE * 1000 / (OUT_SAMPLING_RATE * 4) : OUT_LATENCY_MS;
 
   out->stream.common.get_sample_rate = out_get_sample_rate;
   out->stream.common.set_sample_rate = out_set_sample_rate;
@@ -443,6 +583,9 @@ static void adev_close_output_stream(struct audio_hw_device *dev,
 
   pthread_mutex_lock(&adev->lock);
   if (stream == adev->output) {
+    struct generic_stream_out *out = (struct generic_stream_out *)stream;
+    if (out->fd >= 0)
+      close(out->fd);
     free(stream);
     adev->output = NULL;
   }
@@ -520,7 +663,12 @@ static int adev_open_input_stream(struct audio_hw_device *dev,
                                   audio_source_t source __unused) {
   struct generic_audio_device *adev = (struct generic_audio_device *)dev;
   struct generic_stream_in *in;
-  int ret = 0, fd = 0;
+  int ret = 0, fd = 0, ring_fd = -1;
+  size_t ring_size = 0;
+  void *ring = MAP_FAILED;
+  anbox::audio::StreamFormat format{IN_SAMPLING_RATE, 1,
+                                    anbox::audio::StreamFormat::Sample::S16, 0};
+  anbox::audio::CaptureConfig capture{IN_BUFFER_SIZE / IN_FRAME_SIZE, IN_PERIOD_COUNT};
 
   pthread_mutex_lock(&adev->lock);
   if (adev->input != NULL) {
@@ -540,15 +688,35 @@ static int adev_open_input_stream(struct audio_hw_device *dev,
     goto error;
   }
 
-  fd = connect_audio_server(anbox::audio::ClientInfo::Type::Recording);
+  fd = connect_audio_server(anbox::audio::ClientInfo::Type::Recording, &format, &capture, &ring_fd);
   if (fd < 0) {
     ret = fd;
     ALOGE("Failed to connect with Anbox audio servers (err %d)", ret);
     goto error;
   }
 
+  // The captured frames arrive through shared memory instead of the socket.
+  ring_size = anbox::audio::capture_ring_size(IN_FRAME_SIZE, capture.period_frames * capture.period_count);
+  ring = mmap(NULL, ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, ring_fd, 0);
+  close(ring_fd);
+  if (ring == MAP_FAILED ||
+      ((anbox::audio::CaptureRingHeader *)ring)->magic != anbox::audio::CaptureRingHeader::magic_value ||
+      ((anbox::audio::CaptureRingHeader *)ring)->frame_size != IN_FRAME_SIZE ||
+      ((anbox::audio::CaptureRingHeader *)ring)->capacity != capture.period_frames * capture.period_count ||
+      format.rate != IN_SAMPLING_RATE || format.channels != 1 ||
+      format.sample != anbox::audio::StreamFormat::Sample::S16) {
+    ALOGE("Anbox audio server didn't accept our input format");
+    if (ring != MAP_FAILED)
+      munmap(ring, ring_size);
+    close(fd);
+    ret = -EINVAL;
+    goto error;
+  }
+
   in = (struct generic_stream_in *)calloc(1, sizeof(struct generic_stream_in));
   in->fd = fd;
+  in->ring = (anbox::audio::CaptureRingHeader *)ring;
+  in->ring_size = ring_size;
 
   in->stream.common.get_sample_rate = in_get_sample_rate;
   in->stream.common.set_sample_rate = in_set_sample_rate;
@@ -583,6 +751,12 @@ static void adev_close_input_stream(struct audio_hw_device *dev,
 
   pthread_mutex_lock(&adev->lock);
   if (stream == adev->input) {
+    struct generic_stream_in *in = (struct generic_stream_in *)stream;
+    // Closing the connection stops the capture on the host.
+    if (in->ring)
+      munmap(in->ring, in->ring_size);
+    if (in->fd >= 0)
+      close(in->fd);
     free(stream);
     adev->input = NULL;
   }
@@ -0,0 +1,274 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+// Plays a stream through SDL's dummy audio driver, which consumes audio in
+// real time without a sound card, once with a copy of the AudioSink used
+// before and once with the current one. Reports the end-to-end latency of
+// each buffer (from being handed to the sink until the device took its
+// first frame, plus the one period the device needs to play it out) and
+// the glitches the sink ran into. Two clients are simulated: one writing
+// back to back like AudioFlinger does, throttled only by the sink, and one
+// writing in real time with up to 5 ms of jitter.
+
+#include "anbox/graphics/buffer_queue.h"
+#include "anbox/platform/sdl/audio_sink.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+// What the Android HAL writes at a time: OUT_BUFFER_SIZE bytes of 16 bit
+// stereo at 44.1 kHz. Both sinks get the same client.
+constexpr std::uint32_t rate{44100};
+constexpr std::size_t frame_size{4};
+constexpr std::size_t frames_per_write{512};
+constexpr std::chrono::milliseconds max_jitter{5};
+
+class Probe {
+ public:
+  virtual ~Probe() {}
+  virtual void write_data(const std::uint8_t *data, std::size_t size) = 0;
+  virtual std::uint64_t played_frames() const = 0;
+  virtual std::uint64_t glitches() const = 0;
+  virtual std::size_t period_frames() const = 0;
+};
+
+// The AudioSink from before: a queue of up to 16 client writes, a fixed
+// 1024 frame device buffer and a callback which blocks on an empty queue.
+// Counts what it hands to the device and how often the device was starved,
+// either by blocking the callback or by handing over less than asked for.
+class LegacySink : public Probe {
+ public:
+  LegacySink() : queue_(16) {}
+
+  ~LegacySink() {
+    {
+      std::unique_lock<std::mutex> l(lock_);
+      queue_.close_locked();
+    }
+    if (device_id_ > 0)
+      SDL_CloseAudioDevice(device_id_);
+  }
+
+  void write_data(const std::uint8_t *data, std::size_t size) override {
+    std::unique_lock<std::mutex> l(lock_);
+    if (!connect_audio())
+      return;
+    anbox::graphics::Buffer buffer{data, data + size};
+    queue_.push_locked(std::move(buffer), l);
+  }
+
+  std::uint64_t played_frames() const override { return played_bytes_ / frame_size; }
+  std::uint64_t glitches() const override { return short_reads_; }
+  std::size_t period_frames() const override { return spec_.samples; }
+
+ private:
+  bool connect_audio() {
+    if (device_id_ > 0)
+      return true;
+
+    SDL_memset(&spec_, 0, sizeof(spec_));
+    spec_.freq = rate;
+    spec_.format = AUDIO_S16;
+    spec_.channels = 2;
+    spec_.samples = 1024;
+    spec_.callback = &LegacySink::on_data_requested;
+    spec_.userdata = this;
+
+    device_id_ = SDL_OpenAudioDevice(nullptr, 0, &spec_, nullptr, 0);
+    if (!device_id_)
+      return false;
+
+    SDL_PauseAudioDevice(device_id_, 0);
+    return true;
+  }
+
+  static void on_data_requested(void *user_data, std::uint8_t *buffer, int size) {
+    static_cast<LegacySink*>(user_data)->read_data(buffer, size);
+  }
+
+  void read_data(std::uint8_t *buffer, int size) {
+    std::unique_lock<std::mutex> l(lock_);
+    const auto wanted = size;
+    int count = 0;
+
+    if (played_bytes_ > 0 && read_buffer_left_ == 0 && !queue_.can_pop_locked())
+      short_reads_++;
+
+    while (count < wanted) {
+      if (read_buffer_left_ > 0) {
+        size_t avail = std::min<size_t>(wanted - count, read_buffer_left_);
+        memcpy(buffer + count,
+               read_buffer_.data() + (read_buffer_.size() - read_buffer_left_),
+               avail);
+        count += avail;
+        read_buffer_left_ -= avail;
+        continue;
+      }
+
+      auto result = count == 0 ? queue_.pop_locked(&read_buffer_, l) : queue_.try_pop_locked(&read_buffer_);
+      if (result == 0) {
+        read_buffer_left_ = read_buffer_.size();
+        continue;
+      }
+      break;
+    }
+
+    played_bytes_ += count;
+    if (count > 0 && count < wanted)
+      short_reads_++;
+  }
+
+  std::mutex lock_;
+  SDL_AudioSpec spec_;
+  SDL_AudioDeviceID device_id_ = 0;
+  anbox::graphics::BufferQueue queue_;
+  anbox::graphics::Buffer read_buffer_;
+  size_t read_buffer_left_ = 0;
+  std::atomic<std::uint64_t> played_bytes_{0};
+  std::atomic<std::uint64_t> short_reads_{0};
+};
+
+class CurrentSink : public Probe {
+ public:
+  CurrentSink() { sink_.set_format(anbox::audio::default_stream_format); }
+
+  void write_data(const std::uint8_t *data, std::size_t size) override { sink_.write_data(data, size); }
+  // In client frames, in case the device runs at a different rate.
+  std::uint64_t played_frames() const override {
+    const auto stats = sink_.stats();
+    return stats.rate > 0 ? stats.played_frames * rate / stats.rate : 0;
+  }
+  std::uint64_t glitches() const override {
+    const auto stats = sink_.stats();
+    return stats.ring.underruns + stats.ring.overruns;
+  }
+  std::size_t period_frames() const override {
+    const auto stats = sink_.stats();
+    return stats.rate > 0 ? stats.period_frames * rate / stats.rate : 0;
+  }
+
+ private:
+  anbox::platform::sdl::AudioSink sink_;
+};
+
+struct Result {
+  double mean_ms;
+  double max_ms;
+  std::uint64_t glitches;
+};
+
+Result run(Probe &sink, bool paced, std::chrono::seconds duration) {
+  using clock = std::chrono::steady_clock;
+
+  const std::size_t writes = duration.count() * rate / frames_per_write;
+  std::vector<std::int16_t> chunk(frames_per_write * 2);
+  for (std::size_t n = 0; n < frames_per_write; n++)
+    chunk[2 * n] = chunk[2 * n + 1] = static_cast<std::int16_t>(8000 * std::sin(2 * M_PI * 440 * n / rate));
+
+  std::vector<clock::time_point> handed(writes);
+  std::atomic<std::size_t> started{0};
+
+  std::thread producer([&]() {
+    std::mt19937 random(42);
+    std::uniform_int_distribution<int> jitter(0, max_jitter.count() * 1000);
+    const auto start = clock::now();
+    for (std::size_t k = 0; k < writes; k++) {
+      if (paced)
+        std::this_thread::sleep_until(start + std::chrono::microseconds(
+            k * frames_per_write * 1000000 / rate + jitter(random)));
+      handed[k] = clock::now();
+      started.store(k + 1, std::memory_order_release);
+      sink.write_data(reinterpret_cast<const std::uint8_t*>(chunk.data()), chunk.size() * sizeof(std::int16_t));
+    }
+  });
+
+  Result result{0, 0, 0};
+  std::size_t next = 0;
+  auto last_progress = clock::now();
+  while (next < writes && clock::now() - last_progress < std::chrono::seconds{2}) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    const auto played = sink.played_frames();
+    const auto now = clock::now();
+    const auto available = started.load(std::memory_order_acquire);
+    while (next < available && played > next * frames_per_write) {
+      const auto device = std::chrono::duration<double, std::milli>(1000.0 * sink.period_frames() / rate);
+      const auto latency = std::chrono::duration<double, std::milli>(now - handed[next]) + device;
+      result.mean_ms += latency.count();
+      result.max_ms = std::max(result.max_ms, latency.count());
+      last_progress = now;
+      next++;
+    }
+  }
+  // Taken before the device drains the ring for good, which would count
+  // as a last underrun.
+  result.glitches = sink.glitches();
+  result.mean_ms /= std::max<std::size_t>(next, 1);
+
+  producer.join();
+  if (next < writes)
+    std::cerr << "Device stopped taking data after " << next << " of " << writes << " writes" << std::endl;
+  return result;
+}
+
+void report(const char *name, const Result &before, const Result &after) {
+  std::cout << std::fixed << std::setprecision(1) << std::setw(20) << std::left << name << std::right << " | "
+            << std::setw(7) << before.mean_ms << " | " << std::setw(7) << before.max_ms << " | "
+            << std::setw(8) << before.glitches << " | " << std::setw(7) << after.mean_ms << " | "
+            << std::setw(7) << after.max_ms << " | " << std::setw(8) << after.glitches << std::endl;
+}
+
+template <typename Sink>
+Result run_with(bool paced, std::chrono::seconds duration) {
+  Sink sink;
+  return run(sink, paced, duration);
+}
+}
+
+int main(int argc, char **argv) {
+  std::chrono::seconds duration{5};
+  if (argc > 1)
+    duration = std::chrono::seconds(std::max(1l, std::strtol(argv[1], nullptr, 10)));
+
+  ::setenv("SDL_AUDIODRIVER", "dummy", 1);
+  if (SDL_Init(SDL_INIT_AUDIO) != 0) {
+    std::cerr << "Failed to initialize SDL audio: " << SDL_GetError() << std::endl;
+    return 1;
+  }
+
+  std::cout << duration.count() << " s of 44.1 kHz stereo per run, latency in ms" << std::endl
+            << "client               |  before |     max | glitches |   after |     max | glitches" << std::endl;
+  report("back to back",
+         run_with<LegacySink>(false, duration),
+         run_with<CurrentSink>(false, duration));
+  report("real time + jitter",
+         run_with<LegacySink>(true, duration),
+         run_with<CurrentSink>(true, duration));
+
+  SDL_Quit();
+  return 0;
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Measures how many EGL context switches composing a frame of several
+// windows takes, with every window bound and released on its own and with
+// all of them drawn within begin_frame() / end_frame().
+
+#include "anbox/graphics/emugl/DispatchTables.h"
+#include "anbox/graphics/emugl/EglBinding.h"
+#include "anbox/graphics/emugl/Renderer.h"
+#include "anbox/graphics/frame_exporter.h"
+
+#include "gl_context.h"
+
+#include <GLES2/gl2.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace {
+constexpr size_t default_frames{200};
+constexpr size_t num_windows{4};
+constexpr int window_size{64};
+
+struct Window {
+  EGLNativeWindowType key;
+  HandleType buffer;
+  RenderableList renderables;
+};
+
+struct Result {
+  double us_per_frame;
+  double switches_per_frame;
+  double avoided_per_frame;
+};
+
+Result run(Renderer &renderer, std::vector<Window> &windows,
+           std::vector<std::uint8_t> &pixels, size_t frames, bool batched) {
+  const anbox::graphics::Rect frame{0, 0, window_size, window_size};
+  const auto switches = EglBinding::switches();
+  const auto avoided = EglBinding::avoided();
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t n = 0; n < frames; n++) {
+    // The guest updates every buffer through the helper context before
+    // the frame is composed, as with software rendered applications.
+    for (const auto &w : windows) {
+      pixels[0] = static_cast<std::uint8_t>(n);
+      renderer.updateColorBuffer(w.buffer, 0, 0, window_size, window_size,
+                                 GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    }
+
+    if (batched)
+      renderer.begin_frame();
+    for (const auto &w : windows)
+      renderer.draw(w.key, frame, w.renderables);
+    if (batched)
+      renderer.end_frame();
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  return {std::chrono::duration<double, std::micro>(elapsed).count() / frames,
+          static_cast<double>(EglBinding::switches() - switches) / frames,
+          static_cast<double>(EglBinding::avoided() - avoided) / frames};
+}
+}
+
+int main(int argc, char **argv) {
+  size_t frames = default_frames;
+  if (argc > 1)
+    frames = std::max<size_t>(1, std::strtoul(argv[1], nullptr, 10));
+
+  if (!anbox::benchmarks::load_host_gl()) {
+    std::cerr << "Failed to load host GL libraries" << std::endl;
+    return 1;
+  }
+
+  Renderer renderer;
+  if (!renderer.initialize(EGL_DEFAULT_DISPLAY)) {
+    std::cerr << "Failed to initialize the renderer" << std::endl;
+    return 1;
+  }
+
+  std::vector<Window> windows;
+  for (size_t n = 0; n < num_windows; n++) {
+    const auto key = reinterpret_cast<EGLNativeWindowType>(n + 1);
+    auto exporter = std::make_shared<anbox::graphics::FrameExporter>(
+        static_cast<std::int32_t>(n + 1), window_size, window_size);
+    if (!renderer.createOffscreenWindow(key, exporter)) {
+      std::cerr << "Failed to create an offscreen window" << std::endl;
+      return 1;
+    }
+
+    const auto buffer = renderer.createColorBuffer(window_size, window_size, GL_RGBA);
+    windows.push_back({key, buffer,
+                       {{"org.anbox.surface.1", buffer, 1.0f,
+                         {0, 0, window_size, window_size},
+                         {0, 0, window_size, window_size}}}});
+  }
+
+  std::vector<std::uint8_t> pixels(window_size * window_size * 4, 0x80);
+
+  std::cout << num_windows << " windows of " << window_size << "x" << window_size << std::endl
+            << "composition | us/frame | switches/frame | avoided/frame" << std::endl;
+  for (const auto batched : {false, true}) {
+    // Warm up so shader setup in the driver isn't measured.
+    run(renderer, windows, pixels, 2, batched);
+    const auto r = run(renderer, windows, pixels, frames, batched);
+    std::cout << std::setw(11) << std::left << (batched ? "batched" : "per window")
+              << std::right << " | " << std::setw(8) << std::fixed
+              << std::setprecision(1) << r.us_per_frame << " | "
+              << std::setw(14) << r.switches_per_frame << " | "
+              << std::setw(13) << r.avoided_per_frame << std::endl;
+  }
+
+  for (const auto &w : windows) {
+    renderer.closeColorBuffer(w.buffer);
+    renderer.destroyNativeWindow(w.key);
+  }
+  renderer.finalize();
+  return 0;
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef ANBOX_BENCHMARKS_GRAPHICS_GL_CONTEXT_H_
+#define ANBOX_BENCHMARKS_GRAPHICS_GL_CONTEXT_H_
+
+#include "anbox/graphics/emugl/DispatchTables.h"
+#include "anbox/graphics/emugl/RenderApi.h"
+
+#include "OpenGLESDispatch/EGLDispatch.h"
+
+#include <EGL/egl.h>
+
+#include <cstdlib>
+
+namespace anbox {
+namespace benchmarks {
+// Load the host GL libraries into the dispatch tables. Doesn't require a
+// running display server when the EGL implementation supports rendering
+// without one (honored by Mesa).
+inline bool load_host_gl() {
+  setenv("EGL_PLATFORM", "surfaceless", 0);
+  return anbox::graphics::emugl::initialize(
+      anbox::graphics::emugl::default_gl_libraries(), nullptr, nullptr);
+}
+
+// Make a GLES2 context current on a 1x1 pbuffer. The context is created
+// like the renderer creates its own so benchmarks see the same GL
+// version. Render into a framebuffer object to draw anything bigger.
+inline bool make_offscreen_context_current() {
+  const auto display = s_egl.eglGetDisplay(EGL_DEFAULT_DISPLAY);
+  if (display == EGL_NO_DISPLAY || !s_egl.eglInitialize(display, nullptr, nullptr))
+    return false;
+
+  const EGLint config_attribs[] = {EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+                                   EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
+                                   EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8,
+                                   EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+                                   EGL_NONE};
+  EGLConfig config;
+  EGLint num_configs = 0;
+  if (!s_egl.eglChooseConfig(display, config_attribs, &config, 1, &num_configs) ||
+      num_configs == 0)
+    return false;
+
+  const EGLint surface_attribs[] = {EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE};
+  const auto surface = s_egl.eglCreatePbufferSurface(display, config, surface_attribs);
+  const EGLint context_attribs[] = {EGL_CONTEXT_CLIENT_VERSION, 2, EGL_NONE};
+  const auto context = s_egl.eglCreateContext(display, config, EGL_NO_CONTEXT, context_attribs);
+  if (surface == EGL_NO_SURFACE || context == EGL_NO_CONTEXT)
+    return false;
+
+  return s_egl.eglMakeCurrent(display, surface, surface, context);
+}
+}  // namespace benchmarks
+}  // namespace anbox
+
+#endif
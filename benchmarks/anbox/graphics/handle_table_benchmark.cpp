@@ -0,0 +1,253 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+// Replays a stream of renderControl calls against the handle lookups the
+// Renderer does for them while it holds its lock, once with ordered maps
+// and handles from a counter as the Renderer used before and once with
+// HandleTable. The stream follows what a guest with a few applications on
+// screen issues: every frame binds a context, updates and flushes window
+// buffers and composes all layers, while gralloc keeps allocating and
+// freeing buffers in the background. Only the lookups are replayed so the
+// numbers show the time each call holds the lock for on its own, without
+// any GL work.
+
+#include "anbox/graphics/emugl/HandleTable.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <vector>
+
+namespace {
+constexpr size_t default_frames{20000};
+constexpr size_t contexts{32};
+constexpr size_t surfaces{32};
+constexpr size_t color_buffers{400};
+constexpr size_t layers_per_frame{8};
+constexpr size_t apps_on_screen{4};
+
+enum class Call {
+  CreateColorBuffer,
+  OpenColorBuffer,
+  CloseColorBuffer,
+  UpdateColorBuffer,
+  SetWindowColorBuffer,
+  FlushWindowColorBuffer,
+  BindContext,
+  ComposeLayer,
+};
+
+// Objects are referred to by their position in creation order so each
+// implementation can map them to the handles it handed out.
+struct RecordedCall {
+  Call call;
+  size_t object;
+  size_t other;
+};
+
+struct Object {
+  std::shared_ptr<int> payload = std::make_shared<int>(0);
+  std::uint32_t refcount = 1;
+};
+
+std::vector<RecordedCall> record_session(size_t frames) {
+  std::vector<RecordedCall> calls;
+  std::mt19937 rng(42);
+  std::vector<size_t> live;
+  size_t next_buffer = 0;
+  for (; next_buffer < color_buffers; next_buffer++) {
+    calls.push_back({Call::CreateColorBuffer, next_buffer, 0});
+    live.push_back(next_buffer);
+  }
+
+  for (size_t frame = 0; frame < frames; frame++) {
+    for (size_t app = 0; app < apps_on_screen; app++) {
+      const auto buffer = live[rng() % live.size()];
+      calls.push_back({Call::BindContext, rng() % contexts, app});
+      calls.push_back({Call::UpdateColorBuffer, buffer, 0});
+      calls.push_back({Call::FlushWindowColorBuffer, app, 0});
+      calls.push_back({Call::SetWindowColorBuffer, app, buffer});
+    }
+    for (size_t layer = 0; layer < layers_per_frame; layer++)
+      calls.push_back({Call::ComposeLayer, live[rng() % live.size()], 0});
+
+    // Gralloc churn, e.g. for surfaces being resized or recreated.
+    if (frame % 8 == 0) {
+      const auto n = rng() % live.size();
+      calls.push_back({Call::OpenColorBuffer, live[n], 0});
+      calls.push_back({Call::CloseColorBuffer, live[n], 0});
+      calls.push_back({Call::CloseColorBuffer, live[n], 0});
+      live[n] = next_buffer;
+      calls.push_back({Call::CreateColorBuffer, next_buffer++, 0});
+    }
+  }
+  return calls;
+}
+
+// The Renderer before handle tables: ordered maps keyed by a counter.
+class MapHandles {
+ public:
+  std::uint32_t create() {
+    const auto handle = ++next_handle_;
+    buffers_[handle] = Object();
+    return handle;
+  }
+  void add_context(std::uint32_t handle) { contexts_[handle] = std::make_shared<int>(0); }
+  void add_surface(std::uint32_t handle) { surfaces_[handle] = std::make_shared<int>(0); }
+  std::uint32_t next_handle() { return ++next_handle_; }
+
+  Object *buffer(std::uint32_t handle) {
+    const auto it = buffers_.find(handle);
+    return it == buffers_.end() ? nullptr : &it->second;
+  }
+  bool has_context(std::uint32_t handle) { return contexts_.find(handle) != contexts_.end(); }
+  bool has_surface(std::uint32_t handle) { return surfaces_.find(handle) != surfaces_.end(); }
+  void erase(std::uint32_t handle) { buffers_.erase(handle); }
+
+ private:
+  std::uint32_t next_handle_ = 0;
+  std::map<std::uint32_t, Object> buffers_;
+  std::map<std::uint32_t, std::shared_ptr<int>> contexts_;
+  std::map<std::uint32_t, std::shared_ptr<int>> surfaces_;
+};
+
+class TableHandles {
+ public:
+  std::uint32_t create() { return buffers_.insert(Object()); }
+  std::uint32_t add_context() { return contexts_.insert(std::make_shared<int>(0)); }
+  std::uint32_t add_surface() { return surfaces_.insert(std::make_shared<int>(0)); }
+
+  Object *buffer(std::uint32_t handle) { return buffers_.find(handle); }
+  bool has_context(std::uint32_t handle) { return contexts_.find(handle) != nullptr; }
+  bool has_surface(std::uint32_t handle) { return surfaces_.find(handle) != nullptr; }
+  void erase(std::uint32_t handle) { buffers_.erase(handle); }
+
+ private:
+  HandleTable<std::shared_ptr<int>> contexts_{1};
+  HandleTable<std::shared_ptr<int>> surfaces_{2};
+  HandleTable<Object> buffers_{3};
+};
+
+struct Result {
+  double mean_ns;
+  double p99_ns;
+};
+
+template <typename Handles>
+Result replay(Handles &handles, const std::vector<std::uint32_t> &context_handles,
+              const std::vector<std::uint32_t> &surface_handles,
+              const std::vector<RecordedCall> &calls) {
+  std::mutex lock;
+  std::vector<std::uint32_t> buffer_handles(calls.size());
+  std::vector<double> held;
+  held.reserve(calls.size());
+  std::uint64_t checksum = 0;
+
+  for (const auto &c : calls) {
+    std::unique_lock<std::mutex> l(lock);
+    const auto start = std::chrono::steady_clock::now();
+    switch (c.call) {
+      case Call::CreateColorBuffer:
+        buffer_handles[c.object] = handles.create();
+        break;
+      case Call::OpenColorBuffer:
+        if (auto b = handles.buffer(buffer_handles[c.object])) b->refcount++;
+        break;
+      case Call::CloseColorBuffer:
+        if (auto b = handles.buffer(buffer_handles[c.object])) {
+          if (--b->refcount == 0) handles.erase(buffer_handles[c.object]);
+        }
+        break;
+      case Call::UpdateColorBuffer:
+      case Call::ComposeLayer:
+        if (auto b = handles.buffer(buffer_handles[c.object])) checksum += *b->payload;
+        break;
+      case Call::SetWindowColorBuffer:
+        if (handles.has_surface(surface_handles[c.object]) &&
+            handles.buffer(buffer_handles[c.other]))
+          checksum++;
+        break;
+      case Call::FlushWindowColorBuffer:
+        checksum += handles.has_surface(surface_handles[c.object]);
+        break;
+      case Call::BindContext:
+        checksum += handles.has_context(context_handles[c.object]) &&
+                    handles.has_surface(surface_handles[c.other]);
+        break;
+    }
+    held.push_back(std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - start).count());
+  }
+
+  if (checksum == 0) std::cerr << "Replay didn't resolve any handle" << std::endl;
+
+  double total = 0;
+  for (const auto ns : held) total += ns;
+  std::nth_element(held.begin(), held.begin() + held.size() * 99 / 100, held.end());
+  return {total / held.size(), held[held.size() * 99 / 100]};
+}
+}
+
+int main(int argc, char **argv) {
+  size_t frames = default_frames;
+  if (argc > 1)
+    frames = std::max<size_t>(1, std::strtoul(argv[1], nullptr, 10));
+
+  const auto calls = record_session(frames);
+
+  // Contexts and surfaces are created interleaved with the first buffers
+  // in a real session, spreading their handles.
+  MapHandles maps;
+  std::vector<std::uint32_t> map_contexts, map_surfaces;
+  for (size_t n = 0; n < std::max(contexts, surfaces); n++) {
+    map_contexts.push_back(maps.next_handle());
+    maps.add_context(map_contexts.back());
+    map_surfaces.push_back(maps.next_handle());
+    maps.add_surface(map_surfaces.back());
+  }
+
+  TableHandles tables;
+  std::vector<std::uint32_t> table_contexts, table_surfaces;
+  for (size_t n = 0; n < std::max(contexts, surfaces); n++) {
+    table_contexts.push_back(tables.add_context());
+    table_surfaces.push_back(tables.add_surface());
+  }
+
+  // Warm up caches and the allocator.
+  replay(maps, map_contexts, map_surfaces, record_session(100));
+  replay(tables, table_contexts, table_surfaces, record_session(100));
+
+  const auto map_result = replay(maps, map_contexts, map_surfaces, calls);
+  const auto table_result = replay(tables, table_contexts, table_surfaces, calls);
+
+  std::cout << calls.size() << " calls replayed" << std::endl
+            << "handles     | mean ns held | p99 ns held" << std::endl
+            << std::fixed << std::setprecision(1)
+            << "std::map    | " << std::setw(12) << map_result.mean_ns << " | "
+            << std::setw(11) << map_result.p99_ns << std::endl
+            << "HandleTable | " << std::setw(12) << table_result.mean_ns << " | "
+            << std::setw(11) << table_result.p99_ns << std::endl;
+  return 0;
+}
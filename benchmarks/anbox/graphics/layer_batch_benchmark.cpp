@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+// Measures what composing a frame costs on the CPU side for a growing
+// number of layers. Every GL call is routed through a counting shim so
+// the numbers show both the time spent per frame and how many calls the
+// driver has to process for it. Rendering goes into an offscreen
+// framebuffer so no window system is needed.
+
+#include "anbox/graphics/emugl/DispatchTables.h"
+#include "anbox/graphics/emugl/LayerBatch.h"
+
+#include "gl_context.h"
+
+#include <GLES2/gl2.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace {
+constexpr size_t default_frames{2000};
+constexpr int width{1280};
+constexpr int height{720};
+constexpr int layer_size{256};
+
+size_t gl_calls = 0;
+GLESv2Dispatch real_gles2;
+
+#define COUNTING_SHIM(return_type, func_name, signature, callargs) \
+  return_type KHRONOS_APIENTRY counting_##func_name signature {    \
+    gl_calls++;                                                    \
+    return real_gles2.func_name callargs;                          \
+  }
+LIST_GLES2_FUNCTIONS(COUNTING_SHIM, COUNTING_SHIM)
+#undef COUNTING_SHIM
+
+void install_counting_shims() {
+  real_gles2 = s_gles2;
+#define INSTALL_SHIM(return_type, func_name, signature, callargs) \
+  if (s_gles2.func_name) s_gles2.func_name = counting_##func_name;
+  LIST_GLES2_FUNCTIONS(INSTALL_SHIM, INSTALL_SHIM)
+#undef INSTALL_SHIM
+}
+
+GLuint create_texture(int w, int h) {
+  std::vector<std::uint8_t> pixels(w * h * 4, 0x80);
+  GLuint tex = 0;
+  s_gles2.glGenTextures(1, &tex);
+  s_gles2.glBindTexture(GL_TEXTURE_2D, tex);
+  s_gles2.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  s_gles2.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  s_gles2.glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA,
+                       GL_UNSIGNED_BYTE, pixels.data());
+  return tex;
+}
+
+RenderableList make_layers(size_t count) {
+  RenderableList layers;
+  const auto columns = (width - layer_size) / 32;
+  for (size_t n = 0; n < count; n++) {
+    const auto x = static_cast<int32_t>((n % columns) * 32);
+    const auto y = static_cast<int32_t>((n / columns) * 32 % (height - layer_size));
+    // Mix in some translucent layers like dialogs or fading windows.
+    const auto alpha = n % 4 == 3 ? 0.5f : 1.0f;
+    layers.push_back({"layer", static_cast<std::uint32_t>(n), alpha,
+                      {x, y, x + layer_size, y + layer_size},
+                      {0, 0, layer_size, layer_size}});
+  }
+  return layers;
+}
+
+struct Result {
+  double gl_calls_per_frame;
+  double us_per_frame;
+};
+
+// With |per_layer| set every layer gets its own batch which sets up all
+// draw state again, like layers were drawn before they were batched.
+Result run(LayerBatch &batch, const RenderableList &layers,
+           const std::vector<GLuint> &textures, size_t frames, bool per_layer) {
+  // Maps screen coordinates to GL coordinates like an orthographic
+  // projection of the framebuffer.
+  glm::mat4 screen_to_gl_coords(1.0f);
+  screen_to_gl_coords[0][0] = 2.0f / width;
+  screen_to_gl_coords[1][1] = -2.0f / height;
+  screen_to_gl_coords[3][0] = -1.0f;
+  screen_to_gl_coords[3][1] = 1.0f;
+  const glm::mat4 identity(1.0f);
+  const anbox::graphics::Rect buffer_size{0, 0, layer_size, layer_size};
+
+  std::chrono::steady_clock::duration elapsed{0};
+  size_t calls = 0;
+  for (size_t frame = 0; frame < frames; frame++) {
+    gl_calls = 0;
+    const auto start = std::chrono::steady_clock::now();
+
+    s_gles2.glClear(GL_COLOR_BUFFER_BIT);
+    for (size_t n = 0; n < layers.size(); n++) {
+      batch.add(textures[n], buffer_size, layers[n]);
+      if (per_layer)
+        batch.draw(screen_to_gl_coords, identity);
+    }
+    batch.draw(screen_to_gl_coords, identity);
+
+    elapsed += std::chrono::steady_clock::now() - start;
+    calls += gl_calls;
+
+    // Keep the GPU from falling behind so queued work doesn't pile up
+    // and get accounted to later frames.
+    real_gles2.glFinish();
+  }
+
+  const auto us = std::chrono::duration<double, std::micro>(elapsed).count();
+  return {static_cast<double>(calls) / frames, us / frames};
+}
+}
+
+int main(int argc, char **argv) {
+  size_t frames = default_frames;
+  if (argc > 1)
+    frames = std::max<size_t>(1, std::strtoul(argv[1], nullptr, 10));
+
+  if (!anbox::benchmarks::load_host_gl()) {
+    std::cerr << "Failed to load host GL libraries" << std::endl;
+    return 1;
+  }
+
+  if (!anbox::benchmarks::make_offscreen_context_current()) {
+    std::cerr << "Failed to create an offscreen GLES2 context" << std::endl;
+    return 1;
+  }
+
+  const auto target = create_texture(width, height);
+  GLuint fbo = 0;
+  s_gles2.glGenFramebuffers(1, &fbo);
+  s_gles2.glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+  s_gles2.glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                                 GL_TEXTURE_2D, target, 0);
+  s_gles2.glViewport(0, 0, width, height);
+
+  const size_t max_layers = 32;
+  std::vector<GLuint> textures;
+  for (size_t n = 0; n < max_layers; n++)
+    textures.push_back(create_texture(layer_size, layer_size));
+
+  LayerBatch batch;
+  install_counting_shims();
+
+  std::cout << "layers | mode      | GL calls/frame | us/frame" << std::endl;
+  for (const auto count : {1, 8, 32}) {
+    const auto layers = make_layers(count);
+    for (const auto per_layer : {true, false}) {
+      // Warm up so shader and buffer setup in the driver isn't measured.
+      run(batch, layers, textures, 10, per_layer);
+      const auto result = run(batch, layers, textures, frames, per_layer);
+      std::cout << std::setw(6) << count << " | "
+                << std::setw(9) << std::left << (per_layer ? "per layer" : "batched")
+                << std::right << " | " << std::setw(14) << std::fixed
+                << std::setprecision(1) << result.gl_calls_per_frame << " | "
+                << std::setw(8) << std::setprecision(2) << result.us_per_frame
+                << std::endl;
+    }
+  }
+
+  return 0;
+}
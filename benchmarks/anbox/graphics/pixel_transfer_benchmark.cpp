@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+// Measures the throughput of ColorBuffer sized uploads and readbacks, once
+// with plain glTexSubImage2D/glReadPixels like before and once through
+// PixelTransfer. The renderer only uses PixelTransfer with hardware
+// renderers, runs on software rasterizers show what it would cost there.
+
+#include "anbox/graphics/emugl/DispatchTables.h"
+#include "anbox/graphics/emugl/PixelTransfer.h"
+
+#include "gl_context.h"
+
+#include <GLES2/gl2.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace {
+constexpr size_t default_iterations{200};
+constexpr int width{1280};
+constexpr int height{720};
+constexpr size_t frame_size{width * height * 4};
+
+double megabytes_per_second(size_t iterations, const std::function<void()> &transfer) {
+  // Warm up so buffer allocations in the driver aren't measured.
+  for (size_t n = 0; n < 5; n++) transfer();
+  s_gles2.glFinish();
+
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t n = 0; n < iterations; n++) transfer();
+  // Uploads return before the GPU has the pixels; only count them once
+  // they arrived.
+  s_gles2.glFinish();
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+
+  const auto seconds = std::chrono::duration<double>(elapsed).count();
+  return iterations * frame_size / seconds / (1024.0 * 1024.0);
+}
+}
+
+int main(int argc, char **argv) {
+  size_t iterations = default_iterations;
+  if (argc > 1)
+    iterations = std::max<size_t>(1, std::strtoul(argv[1], nullptr, 10));
+
+  if (!anbox::benchmarks::load_host_gl()) {
+    std::cerr << "Failed to load host GL libraries" << std::endl;
+    return 1;
+  }
+
+  if (!anbox::benchmarks::make_offscreen_context_current()) {
+    std::cerr << "Failed to create an offscreen GLES2 context" << std::endl;
+    return 1;
+  }
+
+  std::cout << "GL renderer: " << s_gles2.glGetString(GL_RENDERER) << std::endl;
+  if (!PixelTransfer::isSupported()) {
+    std::cerr << "Host GL doesn't support pixel buffer objects" << std::endl;
+    return 1;
+  }
+  const auto renderer = reinterpret_cast<const char *>(s_gles2.glGetString(GL_RENDERER));
+  if (!PixelTransfer::isWorthwhile(renderer))
+    std::cout << "The renderer doesn't use PixelTransfer on this host" << std::endl;
+
+  GLuint tex = 0;
+  s_gles2.glGenTextures(1, &tex);
+  s_gles2.glBindTexture(GL_TEXTURE_2D, tex);
+  s_gles2.glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA,
+                       GL_UNSIGNED_BYTE, nullptr);
+
+  GLuint fbo = 0;
+  s_gles2.glGenFramebuffers(1, &fbo);
+  s_gles2.glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+  s_gles2.glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                                 GL_TEXTURE_2D, tex, 0);
+
+  // Same as ColorBuffer::subUpdate() and readPixels() set up.
+  s_gles2.glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  s_gles2.glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+  std::vector<std::uint8_t> pixels(frame_size);
+  for (size_t n = 0; n < pixels.size(); n++)
+    pixels[n] = static_cast<std::uint8_t>(n * 7);
+  std::vector<std::uint8_t> readback(frame_size);
+
+  PixelTransfer transfer;
+
+  const auto sync_upload = megabytes_per_second(iterations, [&]() {
+    s_gles2.glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA,
+                            GL_UNSIGNED_BYTE, pixels.data());
+  });
+  const auto pbo_upload = megabytes_per_second(iterations, [&]() {
+    transfer.upload(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+  });
+  const auto sync_readback = megabytes_per_second(iterations, [&]() {
+    s_gles2.glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE,
+                         readback.data());
+  });
+  const auto pbo_readback = megabytes_per_second(iterations, [&]() {
+    transfer.readback(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE,
+                      readback.data());
+  });
+
+  if (readback != pixels) {
+    std::cerr << "Read back pixels differ from the uploaded ones" << std::endl;
+    return 1;
+  }
+
+  std::cout << std::fixed << std::setprecision(1)
+            << "direction | synchronous MB/s | PixelTransfer MB/s" << std::endl
+            << "upload    | " << std::setw(16) << sync_upload << " | "
+            << std::setw(18) << pbo_upload << std::endl
+            << "readback  | " << std::setw(16) << sync_readback << " | "
+            << std::setw(18) << pbo_readback << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,205 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+// Measures how long building the GL programs of an app launch takes, once
+// straight through the driver like before, once with an empty program
+// binary cache (first launch) and once with the cache filled by the first
+// launch as it is found after restarting the session. The programs are
+// variants of the kind of shaders the Android UI toolkit generates.
+//
+// Mesa only provides program binaries with its own shader cache enabled,
+// which also skips compiling shaders it saw before. The last column
+// relaunches without the program cache to tell both apart.
+
+#include "anbox/graphics/emugl/DispatchTables.h"
+#include "anbox/graphics/emugl/ProgramCache.h"
+#include "anbox/graphics/emugl/RenderThreadInfo.h"
+#include "anbox/graphics/program_binary_cache.h"
+
+#include "gl_context.h"
+
+#include <GLES2/gl2.h>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace fs = boost::filesystem;
+
+namespace {
+constexpr size_t default_programs{40};
+
+const char *vertex_shader = R"(
+attribute vec4 position;
+attribute vec2 texCoords;
+uniform mat4 projection;
+uniform mat4 transform;
+varying vec2 outTexCoords;
+void main() {
+  outTexCoords = texCoords;
+  gl_Position = projection * transform * position;
+}
+)";
+
+const char *fragment_shader = R"(
+precision mediump float;
+varying vec2 outTexCoords;
+uniform sampler2D baseSampler;
+uniform vec4 color;
+uniform float alpha;
+void main() {
+  vec4 base = texture2D(baseSampler, outTexCoords);
+#if VARIANT & 1
+  base *= color;
+#endif
+#if VARIANT & 2
+  base = vec4(base.rgb * base.a, base.a);
+#endif
+#if VARIANT & 4
+  for (int i = 1; i < 8; i++)
+    base += texture2D(baseSampler, outTexCoords + vec2(float(i) * 0.002)) * 0.1;
+#endif
+#if VARIANT & 8
+  base.rgb = pow(base.rgb, vec3(1.0 / 2.2));
+#endif
+  gl_FragColor = base * alpha + vec4(float(VARIANT) * 0.0001);
+}
+)";
+
+GLuint compile(GLenum type, const std::string &source) {
+  const auto shader = s_gles2.glCreateShader(type);
+  const char *text = source.c_str();
+  s_gles2.glShaderSource(shader, 1, &text, nullptr);
+  s_gles2.glCompileShader(shader);
+  return shader;
+}
+
+void link_through_driver(GLESv2Decoder &dec) {
+  dec.glCreateProgram = s_gles2.glCreateProgram;
+  dec.glDeleteProgram = s_gles2.glDeleteProgram;
+  dec.glBindAttribLocation = s_gles2.glBindAttribLocation;
+  dec.glLinkProgram = s_gles2.glLinkProgram;
+}
+
+// Builds and links |count| programs, starting with variant |first|, like
+// an app does on its first frames and returns the time it took in
+// milliseconds, or a negative value if a program failed to link.
+double launch(size_t first, size_t count, GLESv2Decoder &dec) {
+  s_gles2.glFinish();
+  const auto start = std::chrono::steady_clock::now();
+  bool linked = true;
+  for (size_t n = first; n < first + count; n++) {
+    const auto defines = "#define VARIANT " + std::to_string(n) + "\n";
+    const auto vs = compile(GL_VERTEX_SHADER, vertex_shader);
+    const auto fs = compile(GL_FRAGMENT_SHADER, defines + fragment_shader);
+
+    const auto program = dec.glCreateProgram();
+    s_gles2.glAttachShader(program, vs);
+    s_gles2.glAttachShader(program, fs);
+    dec.glBindAttribLocation(program, 0, "position");
+    dec.glBindAttribLocation(program, 1, "texCoords");
+    dec.glLinkProgram(program);
+
+    GLint status = GL_FALSE;
+    s_gles2.glGetProgramiv(program, GL_LINK_STATUS, &status);
+    linked = linked && status == GL_TRUE;
+
+    // Drivers may defer work until the program is used first.
+    s_gles2.glUseProgram(program);
+    s_gles2.glDrawArrays(GL_TRIANGLES, 0, 3);
+
+    s_gles2.glUseProgram(0);
+    dec.glDeleteProgram(program);
+    s_gles2.glDeleteShader(vs);
+    s_gles2.glDeleteShader(fs);
+  }
+  s_gles2.glFinish();
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  return linked ? std::chrono::duration<double, std::milli>(elapsed).count() : -1.0;
+}
+}
+
+int main(int argc, char **argv) {
+  size_t programs = default_programs;
+  if (argc > 1)
+    programs = std::max<size_t>(1, std::strtoul(argv[1], nullptr, 10));
+
+  // Start out with an empty driver cache.
+  const auto driver_cache_dir = fs::temp_directory_path() / fs::unique_path("%%%%-%%%%.mesa");
+  setenv("MESA_SHADER_CACHE_DIR", driver_cache_dir.c_str(), 1);
+
+  if (!anbox::benchmarks::load_host_gl()) {
+    std::cerr << "Failed to load host GL libraries" << std::endl;
+    return 1;
+  }
+
+  if (!anbox::benchmarks::make_offscreen_context_current()) {
+    std::cerr << "Failed to create an offscreen GLES2 context" << std::endl;
+    return 1;
+  }
+
+  std::cout << "GL renderer: " << s_gles2.glGetString(GL_RENDERER) << std::endl;
+
+  const auto cache_dir = fs::temp_directory_path() / fs::unique_path("%%%%-%%%%.programs");
+
+  RenderThreadInfo thread_info;
+  auto &dec = thread_info.m_gl2Dec;
+  link_through_driver(dec);
+  // Warm up the driver so the first run isn't penalized. All runs but the
+  // last two build programs the driver hasn't seen before.
+  launch(3 * programs, 1, dec);
+  const auto uncached = launch(programs, programs, dec);
+
+  initProgramCache(&dec);
+  thread_info.m_programCache = std::make_shared<anbox::graphics::ProgramBinaryCache>(cache_dir);
+  const auto cold = launch(0, programs, dec);
+
+  // Reopen the cache like a new session does.
+  thread_info.m_programCache = std::make_shared<anbox::graphics::ProgramBinaryCache>(cache_dir);
+  const auto warm = launch(0, programs, dec);
+  const auto stats = thread_info.m_programCache->statistics();
+  thread_info.m_programCache.reset();
+
+  link_through_driver(dec);
+  const auto driver_warm = launch(0, programs, dec);
+
+  fs::remove_all(cache_dir);
+  fs::remove_all(driver_cache_dir);
+
+  if (uncached < 0 || cold < 0 || warm < 0 || driver_warm < 0) {
+    std::cerr << "Failed to link the programs" << std::endl;
+    return 1;
+  }
+  if (stats.hits != programs)
+    std::cerr << "Warning: only " << stats.hits << " of " << programs
+              << " programs came from the cache" << std::endl;
+
+  std::cout << std::fixed << std::setprecision(1)
+            << "programs | uncached ms | cold cache ms | warm cache ms | relaunch uncached ms" << std::endl
+            << std::setw(8) << programs << " | " << std::setw(11) << uncached << " | "
+            << std::setw(13) << cold << " | " << std::setw(13) << warm << " | "
+            << std::setw(20) << driver_warm << std::endl;
+
+  return 0;
+}
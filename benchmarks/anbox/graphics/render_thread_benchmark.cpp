@@ -0,0 +1,251 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Stress benchmark for render threads working on independent guest
+// contexts of a pbuffer Renderer. Every render thread gets its own guest
+// stream which creates a context and a window surface and then keeps
+// cycling color buffers through it: create and open one, attach it to the
+// surface, clear the surface, flush it into the buffer and close the
+// buffer again. The render threads only share the Renderer's handle tables
+// and helper context, so the numbers show how well that scales when more
+// guest streams are active at the same time.
+
+#include "anbox/graphics/emugl/RenderControl.h"
+#include "anbox/graphics/emugl/RenderThread.h"
+#include "anbox/graphics/emugl/Renderer.h"
+
+#include "external/android-emugl/host/include/libOpenglRender/IOStream.h"
+
+// Generated with emugl at build time
+#include "gles2_opcodes.h"
+#include "renderControl_opcodes.h"
+
+#include "gl_context.h"
+
+#include <GLES2/gl2.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+constexpr size_t default_rounds_per_stream{256};
+constexpr std::uint32_t surface_size{64};
+
+void append_u32(std::vector<std::uint8_t> &buffer, std::uint32_t value) {
+  const auto offset = buffer.size();
+  buffer.resize(offset + sizeof(value));
+  std::memcpy(buffer.data() + offset, &value, sizeof(value));
+}
+
+void append_float(std::vector<std::uint8_t> &buffer, float value) {
+  std::uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  append_u32(buffer, bits);
+}
+
+// Plays the guest side of one connection. The packets of each step depend
+// on the handles the host returned for the previous one, so every read()
+// generates the next step from the replies the decoders committed.
+class GuestStream : public IOStream {
+ public:
+  explicit GuestStream(size_t rounds) : IOStream(256), rounds_left_(rounds) {}
+
+  void *allocBuffer(size_t min_size) override {
+    if (reply_.size() < min_size) reply_.resize(min_size);
+    return reply_.data();
+  }
+
+  size_t commitBuffer(size_t size) override {
+    // Every call issued here returns a single 32 bit value.
+    for (size_t offset = 0; offset + sizeof(std::uint32_t) <= size; offset += sizeof(std::uint32_t)) {
+      std::uint32_t value;
+      std::memcpy(&value, reply_.data() + offset, sizeof(value));
+      replies_.push_back(value);
+    }
+    return size;
+  }
+
+  const unsigned char *read(void *buf, size_t *inout_len) override {
+    if (stopped_)
+      return nullptr;
+
+    if (offset_ == pending_.size()) {
+      pending_.clear();
+      offset_ = 0;
+      if (!next_step())
+        return nullptr;
+    }
+
+    const auto len = std::min(*inout_len, pending_.size() - offset_);
+    std::memcpy(buf, pending_.data() + offset_, len);
+    offset_ += len;
+    *inout_len = len;
+    return static_cast<const unsigned char *>(buf);
+  }
+
+  void forceStop() override { stopped_ = true; }
+
+  size_t packets() const { return packets_; }
+
+ private:
+  enum class Step { setup, bind, round, done };
+
+  void append_packet(std::uint32_t opcode, const std::vector<std::uint32_t> &args) {
+    append_u32(pending_, opcode);
+    append_u32(pending_, static_cast<std::uint32_t>(8 + args.size() * sizeof(std::uint32_t)));
+    for (const auto &arg : args)
+      append_u32(pending_, arg);
+    packets_++;
+  }
+
+  bool next_step() {
+    switch (step_) {
+      case Step::setup:
+        append_packet(OP_rcCreateContext, {0, 0, 2});
+        append_packet(OP_rcCreateWindowSurface, {0, surface_size, surface_size});
+        step_ = Step::bind;
+        return true;
+      case Step::bind:
+        if (replies_.size() < 2 || !replies_[0] || !replies_[1]) {
+          std::cerr << "Failed to create a context and a window surface" << std::endl;
+          return false;
+        }
+        context_ = replies_[0];
+        surface_ = replies_[1];
+        append_packet(OP_rcMakeCurrent, {context_, surface_, surface_});
+        append_packet(OP_rcCreateColorBuffer, {surface_size, surface_size, GL_RGBA});
+        step_ = Step::round;
+        return true;
+      case Step::round: {
+        // The color buffer created at the end of the previous step.
+        const auto buffer = replies_.back();
+        append_packet(OP_rcOpenColorBuffer, {buffer});
+        append_packet(OP_rcSetWindowColorBuffer, {surface_, buffer});
+        append_u32(pending_, OP_glClearColor);
+        append_u32(pending_, 8 + 4 * sizeof(float));
+        for (const auto c : {0.0f, 0.5f, static_cast<float>(rounds_left_ % 2), 1.0f})
+          append_float(pending_, c);
+        packets_++;
+        append_packet(OP_glClear, {GL_COLOR_BUFFER_BIT});
+        append_packet(OP_rcFlushWindowColorBuffer, {surface_});
+        append_packet(OP_rcCloseColorBuffer, {buffer});
+        append_packet(OP_rcCloseColorBuffer, {buffer});
+        if (--rounds_left_ > 0) {
+          append_packet(OP_rcCreateColorBuffer, {surface_size, surface_size, GL_RGBA});
+        } else {
+          append_packet(OP_rcMakeCurrent, {0, 0, 0});
+          append_packet(OP_rcDestroyWindowSurface, {surface_});
+          append_packet(OP_rcDestroyContext, {context_});
+          step_ = Step::done;
+        }
+        return true;
+      }
+      case Step::done:
+      default:
+        return false;
+    }
+  }
+
+  size_t rounds_left_;
+  Step step_ = Step::setup;
+  std::uint32_t context_ = 0;
+  std::uint32_t surface_ = 0;
+  std::vector<std::uint8_t> pending_;
+  size_t offset_ = 0;
+  size_t packets_ = 0;
+  std::vector<std::uint32_t> replies_;
+  std::atomic<bool> stopped_{false};
+  std::vector<std::uint8_t> reply_;
+};
+
+struct Result {
+  double seconds;
+  double ops_per_second;
+};
+
+Result run(const std::shared_ptr<Renderer> &renderer, size_t num_threads, size_t rounds) {
+  std::vector<std::unique_ptr<GuestStream>> streams;
+  std::vector<std::unique_ptr<RenderThread>> threads;
+  for (size_t n = 0; n < num_threads; n++) {
+    streams.push_back(std::make_unique<GuestStream>(rounds));
+    threads.emplace_back(RenderThread::create(renderer, streams.back().get()));
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  for (auto &t : threads)
+    t->start();
+  for (auto &t : threads)
+    t->wait(nullptr);
+  const auto stop = std::chrono::steady_clock::now();
+
+  threads.clear();
+
+  size_t packets = 0;
+  for (const auto &stream : streams)
+    packets += stream->packets();
+
+  const auto seconds = std::chrono::duration<double>(stop - start).count();
+  return {seconds, static_cast<double>(packets) / seconds};
+}
+}
+
+int main(int argc, char **argv) {
+  size_t rounds = default_rounds_per_stream;
+  if (argc > 1)
+    rounds = std::max<size_t>(1, std::strtoul(argv[1], nullptr, 10));
+
+  if (!anbox::benchmarks::load_host_gl()) {
+    std::cerr << "Failed to load host GL libraries" << std::endl;
+    return 1;
+  }
+
+  auto renderer = std::make_shared<Renderer>();
+  if (!renderer->initialize(EGL_DEFAULT_DISPLAY)) {
+    std::cerr << "Failed to initialize the renderer" << std::endl;
+    return 1;
+  }
+  registerRenderer(renderer);
+
+  const size_t max_threads = std::max(2U, std::thread::hardware_concurrency()) * 2;
+
+  std::cout << "render threads | seconds | Kops/s | scaling" << std::endl;
+
+  double baseline = 0.0;
+  for (size_t num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+    const auto result = run(renderer, num_threads, rounds);
+    if (num_threads == 1)
+      baseline = result.ops_per_second;
+
+    std::cout << std::setw(14) << num_threads << " | "
+              << std::fixed << std::setprecision(3) << std::setw(7) << result.seconds << " | "
+              << std::setw(6) << result.ops_per_second / 1e3 << " | "
+              << std::setprecision(2) << result.ops_per_second / baseline << "x"
+              << std::endl;
+  }
+
+  registerRenderer(nullptr);
+  renderer->finalize();
+  return 0;
+}
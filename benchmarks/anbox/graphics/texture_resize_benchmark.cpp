@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Measures what downscaling a high resolution buffer for a small window
+// costs per composed frame, both when the buffer content changes every
+// frame and when it stays the same and the previous result can be reused.
+
+#include "anbox/graphics/emugl/DispatchTables.h"
+#include "anbox/graphics/emugl/TextureResize.h"
+
+#include "gl_context.h"
+
+#include <GLES2/gl2.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace {
+constexpr size_t default_frames{20};
+constexpr int buffer_width{2560};
+constexpr int buffer_height{1600};
+constexpr int viewport_width{640};
+constexpr int viewport_height{400};
+
+GLuint create_texture(int w, int h) {
+  std::vector<std::uint8_t> pixels(w * h * 4, 0x80);
+  GLuint tex = 0;
+  s_gles2.glGenTextures(1, &tex);
+  s_gles2.glBindTexture(GL_TEXTURE_2D, tex);
+  s_gles2.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  s_gles2.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  s_gles2.glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA,
+                       GL_UNSIGNED_BYTE, pixels.data());
+  return tex;
+}
+
+// Returns the time per frame in microseconds, including the time the GPU
+// needs to finish the work.
+double run(TextureResize &resize, GLuint texture, size_t frames, bool changing) {
+  unsigned int generation = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t frame = 0; frame < frames; frame++) {
+    if (changing) generation++;
+    resize.update(texture, generation, viewport_width, viewport_height);
+    s_gles2.glFinish();
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  return std::chrono::duration<double, std::micro>(elapsed).count() / frames;
+}
+}
+
+int main(int argc, char **argv) {
+  size_t frames = default_frames;
+  if (argc > 1)
+    frames = std::max<size_t>(1, std::strtoul(argv[1], nullptr, 10));
+
+  if (!anbox::benchmarks::load_host_gl()) {
+    std::cerr << "Failed to load host GL libraries" << std::endl;
+    return 1;
+  }
+
+  if (!anbox::benchmarks::make_offscreen_context_current()) {
+    std::cerr << "Failed to create an offscreen GLES2 context" << std::endl;
+    return 1;
+  }
+
+  const auto texture = create_texture(buffer_width, buffer_height);
+  TextureResize resize(buffer_width, buffer_height);
+  s_gles2.glViewport(0, 0, viewport_width, viewport_height);
+
+  std::cout << buffer_width << "x" << buffer_height << " buffer in a "
+            << viewport_width << "x" << viewport_height << " window" << std::endl
+            << "content   | us/frame" << std::endl;
+  for (const auto changing : {true, false}) {
+    // Warm up so shader setup in the driver isn't measured.
+    run(resize, texture, 2, changing);
+    const auto us = run(resize, texture, frames, changing);
+    std::cout << std::setw(9) << std::left << (changing ? "changing" : "unchanged")
+              << std::right << " | " << std::setw(8) << std::fixed
+              << std::setprecision(1) << us << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,261 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+// Feeds high rate pointer motion, 4 reports per millisecond like a gaming
+// mouse, into an input device for a few seconds, once with a copy of the
+// send path used before and once with the current one. The client stands
+// in for Android's EventHub, reading up to 256 events at a time, either as
+// fast as it can or only once per 60Hz frame like a busy input reader.
+// Reports how long the event thread spent per wakeup on average and at
+// most, and the latency of each report from being queued until the client
+// read it.
+
+#include "anbox/input/device.h"
+#include "anbox/runtime.h"
+
+#include <boost/asio.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace ba = boost::asio;
+
+namespace {
+constexpr std::chrono::seconds run_time{3};
+constexpr std::size_t reports_per_wakeup{4};
+constexpr std::chrono::microseconds wakeup_interval{1000};
+
+typedef ba::local::stream_protocol::socket Socket;
+
+struct WireEvent {
+  std::uint64_t sec;
+  std::uint64_t usec;
+  std::uint16_t type;
+  std::uint16_t code;
+  std::uint32_t value;
+};
+
+std::uint64_t monotonic_us() {
+  struct timespec spec;
+  clock_gettime(CLOCK_MONOTONIC, &spec);
+  return static_cast<std::uint64_t>(spec.tv_sec) * 1000000 + static_cast<std::uint64_t>(spec.tv_nsec) / 1000;
+}
+
+// What input::Device::send_events and sdl::Platform did before: fresh
+// vectors per SDL event, a new[]ed array per send which was never freed
+// and a blocking write per report.
+void legacy_send_events(Socket &socket, const std::vector<anbox::input::Event> &events) {
+  struct timespec spec;
+  clock_gettime(CLOCK_MONOTONIC, &spec);
+
+  auto data = new WireEvent[events.size()];
+  int n = 0;
+  for (const auto &event : events) {
+    data[n].sec = spec.tv_sec;
+    data[n].usec = spec.tv_nsec / 1000;
+    data[n].type = event.type;
+    data[n].code = event.code;
+    data[n].value = event.value;
+    n++;
+  }
+
+  for (;;) {
+    try {
+      ba::write(socket, ba::buffer(data, events.size() * sizeof(WireEvent)), ba::transfer_all());
+    } catch (const boost::system::system_error &err) {
+      if (err.code() == ba::error::try_again) continue;
+      throw;
+    }
+    break;
+  }
+}
+
+void legacy_process_input_event(Socket &socket, std::int32_t x, std::int32_t y) {
+  std::vector<anbox::input::Event> mouse_events;
+  std::vector<anbox::input::Event> keyboard_events;
+  std::vector<anbox::input::Event> touch_events;
+  mouse_events.push_back({EV_ABS, ABS_X, x});
+  mouse_events.push_back({EV_ABS, ABS_Y, y});
+  mouse_events.push_back({EV_REL, REL_X, 1});
+  mouse_events.push_back({EV_REL, REL_Y, 1});
+  mouse_events.push_back({EV_SYN, SYN_REPORT, 0});
+  legacy_send_events(socket, mouse_events);
+}
+
+struct Result {
+  std::uint64_t reports_sent = 0;
+  std::uint64_t reports_received = 0;
+  std::uint64_t total_stall_us = 0;
+  std::uint64_t max_stall_us = 0;
+  std::uint64_t wakeups = 0;
+  std::vector<std::uint32_t> latency_us;
+
+  std::uint32_t percentile(double p) {
+    if (latency_us.empty()) return 0;
+    const auto n = std::min(latency_us.size() - 1, static_cast<std::size_t>(latency_us.size() * p));
+    std::nth_element(latency_us.begin(), latency_us.begin() + n, latency_us.end());
+    return latency_us[n];
+  }
+};
+
+// Reads until the producer is done and the socket ran dry.
+void receive(Socket &client, bool slow, const std::atomic<bool> &done, Result &result) {
+  client.non_blocking(true);
+  std::vector<WireEvent> events(256);
+  std::size_t partial = 0;
+  for (;;) {
+    boost::system::error_code err;
+    auto bytes = client.read_some(ba::buffer(reinterpret_cast<std::uint8_t*>(events.data()) + partial,
+                                             events.size() * sizeof(WireEvent) - partial), err);
+    if (err == ba::error::would_block) {
+      if (done) break;
+      std::this_thread::sleep_for(std::chrono::microseconds{200});
+      continue;
+    }
+    if (err) break;
+
+    const auto now = monotonic_us();
+    bytes += partial;
+    const auto count = bytes / sizeof(WireEvent);
+    for (std::size_t n = 0; n < count; n++) {
+      if (events[n].type != EV_SYN) continue;
+      result.reports_received++;
+      result.latency_us.push_back(static_cast<std::uint32_t>(now - (events[n].sec * 1000000 + events[n].usec)));
+    }
+    partial = bytes % sizeof(WireEvent);
+    std::memmove(events.data(), reinterpret_cast<std::uint8_t*>(events.data()) + count * sizeof(WireEvent), partial);
+
+    if (slow)
+      std::this_thread::sleep_for(std::chrono::milliseconds{16});
+  }
+}
+
+template <typename Wakeup>
+Result run(Socket &client, bool slow, Wakeup wakeup) {
+  Result result;
+  std::atomic<bool> done{false};
+  std::thread reader([&]() { receive(client, slow, done, result); });
+
+  const auto start = std::chrono::steady_clock::now();
+  auto next = start;
+  std::int32_t position = 0;
+  while (std::chrono::steady_clock::now() - start < run_time) {
+    const auto before = monotonic_us();
+    wakeup(position);
+    const auto stall = monotonic_us() - before;
+    result.total_stall_us += stall;
+    result.max_stall_us = std::max(result.max_stall_us, stall);
+    result.wakeups++;
+    position += reports_per_wakeup;
+    result.reports_sent += reports_per_wakeup;
+
+    next += wakeup_interval;
+    std::this_thread::sleep_until(next);
+  }
+
+  // Give the client the chance to catch up with what is still in flight.
+  std::this_thread::sleep_for(std::chrono::milliseconds{200});
+  done = true;
+  reader.join();
+  return result;
+}
+
+void report(const std::string &name, Result before, Result after) {
+  const auto row = [](Result &r) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1) << std::setw(8) << r.reports_received << " | "
+        << std::setw(4) << r.total_stall_us / r.wakeups << " | " << std::setw(5) << r.max_stall_us << " | "
+        << std::setw(4) << r.percentile(0.5) / 1000.0 << " | " << std::setw(5) << r.percentile(0.99) / 1000.0;
+    return out.str();
+  };
+  std::cout << std::left << std::setw(11) << name << std::right
+            << " | " << row(before) << " | " << row(after) << std::endl;
+}
+}
+
+int main() {
+  const auto rt = anbox::Runtime::create(1);
+  rt->start();
+
+  char dir_template[] = "/tmp/anbox-input-benchmark-XXXXXX";
+  const std::string dir = ::mkdtemp(dir_template);
+  const auto device = anbox::input::Device::create(dir + "/event0", rt);
+
+  const auto legacy = [&](bool slow) {
+    Socket server{rt->service()}, client{rt->service()};
+    ba::local::connect_pair(server, client);
+    server.non_blocking(true);
+    ba::socket_base::send_buffer_size option(64 * 1024);
+    server.set_option(option);
+    return run(client, slow, [&](std::int32_t position) {
+      for (std::size_t n = 0; n < reports_per_wakeup; n++)
+        legacy_process_input_event(server, position + n, position + n);
+    });
+  };
+
+  const auto current = [&](bool slow) {
+    Socket client{rt->service()};
+    client.connect(ba::local::stream_protocol::endpoint(device->socket_path()));
+    std::vector<std::uint8_t> info(4096);
+    // The device info goes out first; its size doesn't matter here.
+    std::this_thread::sleep_for(std::chrono::milliseconds{50});
+    boost::system::error_code err;
+    client.non_blocking(true);
+    client.read_some(ba::buffer(info), err);
+    client.non_blocking(false);
+
+    std::vector<anbox::input::Event> events;
+    return run(client, slow, [&](std::int32_t position) {
+      for (std::size_t n = 0; n < reports_per_wakeup; n++) {
+        events.clear();
+        events.push_back({EV_ABS, ABS_X, static_cast<std::int32_t>(position + n)});
+        events.push_back({EV_ABS, ABS_Y, static_cast<std::int32_t>(position + n)});
+        events.push_back({EV_REL, REL_X, 1});
+        events.push_back({EV_REL, REL_Y, 1});
+        events.push_back({EV_SYN, SYN_REPORT, 0});
+        device->queue_events(events);
+      }
+      device->flush();
+    });
+  };
+
+  std::cout << run_time.count() << " s of " << reports_per_wakeup << " reports per "
+            << wakeup_interval.count() << " us, before | after" << std::endl
+            << "            |          |    stall     |   latency    |          |    stall     |   latency" << std::endl
+            << "client      | received | mean |   max |  p50 |   p99 | received | mean |   max |  p50 |   p99" << std::endl
+            << "            |  reports |   us |    us |   ms |    ms |  reports |   us |    us |   ms |    ms" << std::endl;
+  report("fast", legacy(false), current(false));
+  report("60Hz", legacy(true), current(true));
+
+  rt->stop();
+  ::unlink((dir + "/event0").c_str());
+  ::rmdir(dir.c_str());
+  return 0;
+}
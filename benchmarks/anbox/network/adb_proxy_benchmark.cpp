@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+// Streams data through the adb proxy between a unix socket pair, standing
+// in for the qemud pipe, and a loopback TCP connection, standing in for the
+// adb host server. Reports throughput and the CPU time the proxy thread
+// spends per GiB for each direction, once with a copy of the read/write
+// forwarding AdbMessageProcessor used before and once with SpliceProxy.
+
+#include "anbox/network/splice_proxy.h"
+#include "anbox/runtime.h"
+
+#include <boost/asio.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <time.h>
+
+namespace ba = boost::asio;
+
+namespace {
+constexpr size_t default_megabytes{1024};
+constexpr size_t chunk_size{256 * 1024};
+
+typedef ba::local::stream_protocol::socket LocalSocket;
+typedef ba::ip::tcp::socket TcpSocket;
+
+// The forwarding AdbMessageProcessor and its SocketConnection did before:
+// read into a fixed buffer and write it out synchronously, copying it once
+// more into a vector in the guest to host direction.
+class LegacyProxy : public std::enable_shared_from_this<LegacyProxy> {
+ public:
+  LegacyProxy(const std::shared_ptr<LocalSocket> &guest, const std::shared_ptr<TcpSocket> &host)
+      : guest_{guest}, host_{host} {}
+
+  void start() {
+    read_guest();
+    read_host();
+  }
+
+ private:
+  void read_guest() {
+    auto self = shared_from_this();
+    guest_->async_read_some(ba::buffer(guest_buffer_), [self](const boost::system::error_code &err,
+                                                              size_t size) {
+      if (err) return;
+      std::vector<std::uint8_t> data(self->guest_buffer_.begin(), self->guest_buffer_.begin() + size);
+      ba::write(*self->host_, ba::buffer(data));
+      self->read_guest();
+    });
+  }
+
+  void read_host() {
+    auto self = shared_from_this();
+    host_->async_read_some(ba::buffer(host_buffer_), [self](const boost::system::error_code &err,
+                                                            size_t size) {
+      if (err) return;
+      ba::write(*self->guest_, ba::buffer(self->host_buffer_.data(), size));
+      self->read_host();
+    });
+  }
+
+  std::shared_ptr<LocalSocket> guest_;
+  std::shared_ptr<TcpSocket> host_;
+  std::array<std::uint8_t, 8192> guest_buffer_;
+  std::array<std::uint8_t, 8192> host_buffer_;
+};
+
+struct Result {
+  double megabytes_per_s;
+  double cpu_s_per_gigabyte;
+};
+
+// CPU time consumed so far by the thread the runtime runs its handlers on.
+double runtime_cpu_time(const std::shared_ptr<anbox::Runtime> &rt) {
+  std::promise<double> result;
+  rt->service().post([&]() {
+    struct timespec ts;
+    ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    result.set_value(ts.tv_sec + ts.tv_nsec / 1e9);
+  });
+  return result.get_future().get();
+}
+
+template <typename Source, typename Sink>
+Result transfer(const std::shared_ptr<anbox::Runtime> &rt, Source &source, Sink &sink, size_t bytes) {
+  const std::vector<char> chunk(chunk_size, 'a');
+
+  const auto cpu_before = runtime_cpu_time(rt);
+  const auto start = std::chrono::steady_clock::now();
+
+  auto writer = std::async(std::launch::async, [&]() {
+    for (size_t written = 0; written < bytes; written += chunk.size())
+      ba::write(source, ba::buffer(chunk));
+  });
+
+  std::vector<char> buffer(chunk_size);
+  for (size_t received = 0; received < bytes;)
+    received += sink.read_some(ba::buffer(buffer));
+  writer.get();
+
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  const auto cpu = runtime_cpu_time(rt) - cpu_before;
+  const auto megabytes = static_cast<double>(bytes) / (1024 * 1024);
+  return {megabytes / elapsed.count(), cpu / (megabytes / 1024)};
+}
+
+struct Setup {
+  Setup() : rt{anbox::Runtime::create(1)} {
+    ba::local::connect_pair(guest_peer, *guest);
+
+    ba::ip::tcp::acceptor acceptor{rt->service(), {ba::ip::address_v4::loopback(), 0}};
+    host_peer.connect(acceptor.local_endpoint());
+    acceptor.accept(*host);
+
+    rt->start();
+  }
+
+  ~Setup() { rt->stop(); }
+
+  std::shared_ptr<anbox::Runtime> rt;
+  LocalSocket guest_peer{rt->service()};
+  TcpSocket host_peer{rt->service()};
+  std::shared_ptr<LocalSocket> guest = std::make_shared<LocalSocket>(rt->service());
+  std::shared_ptr<TcpSocket> host = std::make_shared<TcpSocket>(rt->service());
+};
+
+void report(const std::string &name, const Result &before, const Result &after) {
+  std::cout << std::fixed << std::setprecision(2) << std::left << std::setw(13) << name << std::right
+            << " | " << std::setw(11) << before.megabytes_per_s << " | " << std::setw(11)
+            << before.cpu_s_per_gigabyte << " | " << std::setw(11) << after.megabytes_per_s << " | "
+            << std::setw(11) << after.cpu_s_per_gigabyte << std::endl;
+}
+}
+
+int main(int argc, char **argv) {
+  size_t megabytes = default_megabytes;
+  if (argc > 1)
+    megabytes = std::max<size_t>(1, std::strtoul(argv[1], nullptr, 10));
+  const auto bytes = megabytes * 1024 * 1024;
+
+  Setup legacy;
+  std::make_shared<LegacyProxy>(legacy.guest, legacy.host)->start();
+
+  Setup splice;
+  auto proxy = std::make_shared<anbox::network::SpliceProxy<ba::local::stream_protocol, ba::ip::tcp>>(
+      splice.rt, splice.guest, splice.host);
+  proxy->start([](const boost::system::error_code &) {});
+
+  std::cout << megabytes << " MiB per run" << std::endl
+            << "direction     | before MB/s |   CPU s/GiB |  after MB/s |   CPU s/GiB" << std::endl;
+  report("guest to host",
+         transfer(legacy.rt, legacy.guest_peer, legacy.host_peer, bytes),
+         transfer(splice.rt, splice.guest_peer, splice.host_peer, bytes));
+  report("host to guest",
+         transfer(legacy.rt, legacy.host_peer, legacy.guest_peer, bytes),
+         transfer(splice.rt, splice.host_peer, splice.guest_peer, bytes));
+
+  proxy->stop();
+  return 0;
+}
@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+// Frames bridge messages the way rpc::Channel and rpc::MessageProcessor
+// send them and reports messages per second and heap allocations per
+// message, once with a copy of the framing they used before FrameEncoder
+// and once with the current code. The messages are sent to a sender which
+// drops them so only the framing is measured.
+
+#include "anbox/common/variable_length_array.h"
+#include "anbox/network/message_sender.h"
+#include "anbox/rpc/channel.h"
+#include "anbox/rpc/constants.h"
+#include "anbox/rpc/frame_encoder.h"
+#include "anbox/rpc/message_processor.h"
+#include "anbox/rpc/pending_call_cache.h"
+
+#include "anbox_bridge.pb.h"
+#include "anbox_rpc.pb.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+std::atomic<size_t> allocations{0};
+}
+
+void *operator new(size_t size) {
+  allocations++;
+  if (auto p = std::malloc(size ? size : 1)) return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+
+namespace {
+constexpr size_t default_messages{500000};
+
+class NullSender : public anbox::network::MessageSender {
+ public:
+  void send(char const*, size_t) override {}
+  ssize_t send_raw(char const*, size_t length) override { return length; }
+};
+
+class Responder : public anbox::rpc::MessageProcessor {
+ public:
+  Responder()
+      : anbox::rpc::MessageProcessor(std::make_shared<NullSender>(),
+                                     std::make_shared<anbox::rpc::PendingCallCache>()) {}
+
+  using anbox::rpc::MessageProcessor::send_response;
+};
+
+// The framing rpc::Channel and rpc::MessageProcessor used before.
+namespace legacy {
+void send_message(anbox::network::MessageSender &sender, const std::uint8_t &type,
+                  google::protobuf::MessageLite const &message) {
+  const size_t size = message.ByteSize();
+  const unsigned char header_bytes[anbox::rpc::header_size] = {
+      static_cast<unsigned char>((size >> 16) & 0xff),
+      static_cast<unsigned char>((size >> 8) & 0xff),
+      static_cast<unsigned char>((size >> 0) & 0xff), type,
+  };
+
+  std::vector<std::uint8_t> send_buffer(sizeof(header_bytes) + size);
+  std::copy(header_bytes, header_bytes + sizeof(header_bytes), send_buffer.begin());
+  message.SerializeToArray(send_buffer.data() + sizeof(header_bytes), size);
+  sender.send(reinterpret_cast<const char *>(send_buffer.data()), send_buffer.size());
+}
+
+void call_method(anbox::network::MessageSender &sender, std::uint32_t id,
+                 std::string const &method_name,
+                 google::protobuf::MessageLite const *request) {
+  anbox::VariableLengthArray<2048> buffer{static_cast<size_t>(request->ByteSize())};
+  request->SerializeWithCachedSizesToArray(buffer.data());
+
+  anbox::protobuf::rpc::Invocation invoke;
+  invoke.set_id(id);
+  invoke.set_method_name(method_name);
+  invoke.set_parameters(buffer.data(), buffer.size());
+  invoke.set_protocol_version(1);
+
+  send_message(sender, anbox::rpc::MessageType::invocation, invoke);
+}
+
+void send_event(anbox::network::MessageSender &sender, google::protobuf::MessageLite const &event) {
+  anbox::VariableLengthArray<2048> buffer{static_cast<size_t>(event.ByteSize())};
+  event.SerializeWithCachedSizesToArray(buffer.data());
+
+  anbox::protobuf::rpc::Result response;
+  response.add_events(buffer.data(), buffer.size());
+
+  send_message(sender, anbox::rpc::MessageType::response, response);
+}
+
+void send_response(anbox::network::MessageSender &sender, std::uint32_t id,
+                   google::protobuf::MessageLite *response) {
+  anbox::VariableLengthArray<anbox::rpc::serialization_buffer_size> send_response_buffer(
+      static_cast<size_t>(response->ByteSize()));
+  response->SerializeWithCachedSizesToArray(send_response_buffer.data());
+
+  anbox::protobuf::rpc::Result send_response_result;
+  send_response_result.set_id(id);
+  send_response_result.set_response(send_response_buffer.data(), send_response_buffer.size());
+
+  send_response_buffer.resize(send_response_result.ByteSize());
+  send_response_result.SerializeWithCachedSizesToArray(send_response_buffer.data());
+
+  const size_t size = send_response_buffer.size();
+  const unsigned char header_bytes[anbox::rpc::header_size] = {
+      static_cast<unsigned char>((size >> 16) & 0xff),
+      static_cast<unsigned char>((size >> 8) & 0xff),
+      static_cast<unsigned char>((size >> 0) & 0xff), anbox::rpc::MessageType::response,
+  };
+
+  std::vector<std::uint8_t> send_buffer(sizeof(header_bytes) + size);
+  std::copy(header_bytes, header_bytes + sizeof(header_bytes), send_buffer.begin());
+  std::copy(send_response_buffer.data(), send_response_buffer.data() + send_response_buffer.size(),
+            send_buffer.begin() + sizeof(header_bytes));
+  sender.send(reinterpret_cast<const char *>(send_buffer.data()), send_buffer.size());
+}
+}  // namespace legacy
+
+struct Result {
+  double messages_per_s;
+  double allocations_per_message;
+};
+
+Result run(size_t messages, const std::function<void(std::uint32_t)> &send) {
+  // Warm up caches and any buffers kept around.
+  for (std::uint32_t n = 0; n < 1000; n++) send(n);
+
+  const auto allocations_before = allocations.load();
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t n = 0; n < messages; n++) send(static_cast<std::uint32_t>(n));
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  return {messages / elapsed.count(),
+          static_cast<double>(allocations.load() - allocations_before) / messages};
+}
+
+void report(const std::string &name, const Result &before, const Result &after) {
+  std::cout << std::fixed << std::setprecision(2) << std::left << std::setw(10) << name << std::right
+            << " | " << std::setw(12) << before.messages_per_s << " | " << std::setw(10)
+            << before.allocations_per_message << " | " << std::setw(12) << after.messages_per_s
+            << " | " << std::setw(10) << after.allocations_per_message << std::endl;
+}
+}
+
+int main(int argc, char **argv) {
+  size_t messages = default_messages;
+  if (argc > 1)
+    messages = std::max<size_t>(1, std::strtoul(argv[1], nullptr, 10));
+
+  NullSender sender;
+  auto channel = std::make_shared<anbox::rpc::Channel>(
+      std::make_shared<anbox::rpc::PendingCallCache>(), std::make_shared<NullSender>());
+  anbox::rpc::FrameEncoder encoder;
+  Responder responder;
+
+  anbox::protobuf::bridge::ResizeTask invocation;
+  invocation.set_id(42);
+  invocation.set_resize_mode(3);
+  auto rect = invocation.mutable_rect();
+  rect->set_left(100);
+  rect->set_top(100);
+  rect->set_right(1380);
+  rect->set_bottom(820);
+
+  anbox::protobuf::bridge::ClipboardData payload;
+  payload.set_text(std::string(256, 'x'));
+
+  std::cout << messages << " messages per run" << std::endl
+            << "message    |     before/s | allocs/msg |      after/s | allocs/msg" << std::endl;
+
+  // Invocations go through the encoder directly as rpc::Channel also
+  // records a pending call for each which isn't part of the framing.
+  report("invocation",
+         run(messages, [&](std::uint32_t id) { legacy::call_method(sender, id, "resize_task", &invocation); }),
+         run(messages, [&](std::uint32_t id) {
+           const auto &frame = encoder.encode_invocation(id, "resize_task", invocation);
+           sender.send(reinterpret_cast<const char *>(frame.data()), frame.size());
+         }));
+  report("response",
+         run(messages, [&](std::uint32_t id) { legacy::send_response(sender, id, &payload); }),
+         run(messages, [&](std::uint32_t id) { responder.send_response(id, &payload); }));
+  report("event",
+         run(messages, [&](std::uint32_t) { legacy::send_event(sender, payload); }),
+         run(messages, [&](std::uint32_t) { channel->send_event(payload); }));
+  return 0;
+}
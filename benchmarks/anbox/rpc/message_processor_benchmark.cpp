@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+// Feeds a stream of RPC invocations in 8 KiB reads, the size the socket
+// connections read with, into rpc::MessageProcessor and into a copy of the
+// byte-wise parser it used before which erased every message from the
+// front of its buffer. One workload has many small messages like the
+// bridge exchanges for input and window updates, the other a few large
+// ones like application icons or clipboard content. Both parsers decode
+// every message into a protobuf so the numbers include that work too.
+
+#include "anbox/network/message_sender.h"
+#include "anbox/rpc/constants.h"
+#include "anbox/rpc/message_processor.h"
+#include "anbox/rpc/pending_call_cache.h"
+
+#include "anbox_rpc.pb.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+constexpr size_t read_size{8192};
+
+class NullSender : public anbox::network::MessageSender {
+ public:
+  void send(char const*, size_t) override {}
+  ssize_t send_raw(char const*, size_t length) override { return length; }
+};
+
+class CountingProcessor : public anbox::rpc::MessageProcessor {
+ public:
+  CountingProcessor()
+      : anbox::rpc::MessageProcessor(std::make_shared<NullSender>(),
+                                     std::make_shared<anbox::rpc::PendingCallCache>()) {}
+
+  size_t messages = 0;
+
+ protected:
+  void dispatch(anbox::rpc::Invocation const&) override { messages++; }
+};
+
+// The parser rpc::MessageProcessor used before FrameDecoder.
+class LegacyProcessor {
+ public:
+  void process_data(const std::vector<std::uint8_t> &data) {
+    for (const auto &byte : data) buffer_.push_back(byte);
+
+    while (buffer_.size() > 0) {
+      const auto high = buffer_[0];
+      const auto medium = buffer_[1];
+      const auto low = buffer_[2];
+      size_t const message_size = (high << 16) + (medium << 8) + low;
+      const auto message_type = buffer_[3];
+
+      if (buffer_.size() < (message_size + anbox::rpc::header_size)) break;
+
+      if (message_type == anbox::rpc::MessageType::invocation) {
+        anbox::protobuf::rpc::Invocation raw_invocation;
+        raw_invocation.ParseFromArray(buffer_.data() + anbox::rpc::header_size, message_size);
+        messages++;
+      }
+
+      buffer_.erase(buffer_.begin(),
+                    buffer_.begin() + anbox::rpc::header_size + message_size);
+    }
+  }
+
+  size_t messages = 0;
+
+ private:
+  std::vector<std::uint8_t> buffer_;
+};
+
+std::vector<std::uint8_t> make_stream(size_t count, size_t parameters_size) {
+  std::vector<std::uint8_t> stream;
+  for (size_t n = 0; n < count; n++) {
+    anbox::protobuf::rpc::Invocation invocation;
+    invocation.set_id(n);
+    invocation.set_method_name("benchmark_method");
+    invocation.set_parameters(std::string(parameters_size, static_cast<char>(n)));
+    invocation.set_protocol_version(1);
+
+    const auto payload = invocation.SerializeAsString();
+    const auto size = payload.size();
+    stream.push_back((size >> 16) & 0xff);
+    stream.push_back((size >> 8) & 0xff);
+    stream.push_back((size >> 0) & 0xff);
+    stream.push_back(anbox::rpc::MessageType::invocation);
+    stream.insert(stream.end(), payload.begin(), payload.end());
+  }
+  return stream;
+}
+
+struct Result {
+  double mb_per_s;
+  double messages_per_s;
+  size_t messages;
+};
+
+template <typename Processor>
+Result run(const std::vector<std::uint8_t> &stream) {
+  Processor processor;
+  std::vector<std::uint8_t> chunk;
+
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t offset = 0; offset < stream.size(); offset += read_size) {
+    const auto size = std::min(read_size, stream.size() - offset);
+    chunk.assign(stream.begin() + offset, stream.begin() + offset + size);
+    processor.process_data(chunk);
+  }
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  return {stream.size() / elapsed.count() / (1024.0 * 1024.0),
+          processor.messages / elapsed.count(), processor.messages};
+}
+
+void report(const std::string &name, const std::vector<std::uint8_t> &stream) {
+  // Warm up the allocator.
+  run<CountingProcessor>(stream);
+
+  const auto legacy = run<LegacyProcessor>(stream);
+  const auto decoder = run<CountingProcessor>(stream);
+
+  std::cout << name << ": " << decoder.messages << " messages, "
+            << stream.size() / 1024 << " KiB" << std::endl
+            << std::fixed << std::setprecision(1)
+            << "  parser       |       MB/s |   messages/s" << std::endl
+            << "  legacy       | " << std::setw(10) << legacy.mb_per_s << " | "
+            << std::setw(12) << legacy.messages_per_s << std::endl
+            << "  FrameDecoder | " << std::setw(10) << decoder.mb_per_s << " | "
+            << std::setw(12) << decoder.messages_per_s << std::endl;
+}
+}
+
+int main(int argc, char **argv) {
+  size_t scale = 1;
+  if (argc > 1)
+    scale = std::max<size_t>(1, std::strtoul(argv[1], nullptr, 10));
+
+  report("small messages", make_stream(200000 * scale, 48));
+  report("large messages", make_stream(8 * scale, 4 * 1024 * 1024));
+  return 0;
+}
@@ -24,9 +24,8 @@
 
 // As a special case, LIST_GLES3_ONLY_FUNCTIONS below uses the Y parameter
 // instead of the X one, meaning that the corresponding functions are
-// optional extensions. This is only because currently, the only GLESv3
-// API we support is glGetStringi(), which is not always provided by
-// host desktop GL drivers (though most do).
+// optional extensions. They are not provided by every host GL driver, so
+// callers have to check for them before use.
 #define LIST_GLES_FUNCTIONS(X,Y) \
     LIST_GLES_COMMON_FUNCTIONS(X) \
     LIST_GLES_EXTENSIONS_FUNCTIONS(Y) \
@@ -47,4 +46,5 @@
     LIST_GLES_EXTENSIONS_FUNCTIONS(Y) \
     LIST_GLES2_ONLY_FUNCTIONS(X) \
     LIST_GLES2_EXTENSIONS_FUNCTIONS(Y) \
+    LIST_GLES3_ONLY_FUNCTIONS(Y) \
 
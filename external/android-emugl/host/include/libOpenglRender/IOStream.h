@@ -32,6 +32,15 @@ public:
     virtual const unsigned char *read(void *buf, size_t *inout_len) = 0;
     virtual void forceStop() = 0;
 
+    // Optional zero-copy read path. Streams which keep received data in
+    // one contiguous buffer return a pointer to all readable bytes once
+    // more than |pending| bytes are available, or NULL when stopped. The
+    // bytes stay valid, and may be modified by the decoders, until they
+    // are released with consume().
+    virtual bool canReadInPlace() const { return false; }
+    virtual unsigned char *readInPlace(size_t, size_t *) { return NULL; }
+    virtual void consume(size_t) {}
+
     virtual ~IOStream() {
         // NOTE: m_buf is 'owned' by the child class thus we expect it to be released by it
     }
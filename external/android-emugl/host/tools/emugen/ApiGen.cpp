@@ -757,6 +757,10 @@ int ApiGen::genDecoderHeader(const std::string &filename)
         fprintf(fp, "\n#include <map>\n");
         fprintf(fp, "\n#include <mutex>\n");
     }
+    if (m_tableDecoder) {
+        fprintf(fp, "\n#include \"DecoderStats.h\"\n");
+        fprintf(fp, "#include \"ScratchBuffer.h\"\n");
+    }
     fprintf(fp, "\n#include \"emugl/common/logging.h\"\n");
 
     for (size_t i = 0; i < m_decoderHeaders.size(); i++) {
@@ -767,6 +771,11 @@ int ApiGen::genDecoderHeader(const std::string &filename)
     fprintf(fp, "struct %s : public %s_%s_context_t {\n\n",
             classname.c_str(), m_basename.c_str(), sideString(SERVER_SIDE));
     fprintf(fp, "\tsize_t decode(void *buf, size_t bufsize, IOStream *stream);\n");
+    if (m_tableDecoder) {
+        fprintf(fp, "\t// Returns the per-opcode counters, or 0 unless built with EMUGL_DECODER_PROFILING.\n");
+        fprintf(fp, "\tstatic size_t opcodeStats(const emugl::DecoderOpcodeStats **stats);\n");
+        fprintf(fp, "\temugl::ScratchBuffer m_scratch;\n");
+    }
     if (strcmp(classname.c_str(), "gles2_decoder_context_t") == 0){ 
 	fprintf(fp, 
 			"\tvoid freeShader(); \n\
@@ -815,8 +824,42 @@ int ApiGen::genContextImpl(const std::string &filename, SideType side)
     return 0;
 }
 
+// glsl shader/program free, used by both decoder backends;
+static void printFreeShaderAndProgram(FILE *fp, const std::string &classname)
+{
+    fprintf(fp, "void %s::freeShader(){\n", classname.c_str());
+    fprintf(fp,
+            "                       \n\
+\tauto it = m_shaders.begin();\n\
+\tm_lock.lock();\n\
+\twhile(it != m_shaders.end()) \n\
+\t{\n\
+\t\tthis->glDeleteShader(it->first);\n\
+\t\tit++;\n\
+\t}\n\
+\tm_lock.unlock();\n\
+}\n\n");
+
+    fprintf(fp, "void %s::freeProgram(){\n", classname.c_str());
+    fprintf(fp,
+            "		\n\
+\tauto it = m_programs.begin(); \n\
+\tm_lock.lock();\n\
+\twhile(it != m_programs.end()) \n\
+\t{\n\
+\t\tthis->glDeleteProgram(it->first);\n\
+\t\tit++;\n\
+\t}\n\
+\tm_lock.unlock();\n\
+}\n\n");
+}
+
 int ApiGen::genDecoderImpl(const std::string &filename)
 {
+    if (m_tableDecoder) {
+        return genTableDecoderImpl(filename);
+    }
+
     FILE *fp = fopen(filename.c_str(), "wt");
     if (fp == NULL) {
         perror(filename.c_str());
@@ -852,31 +895,7 @@ int ApiGen::genDecoderImpl(const std::string &filename)
 
     // glsl shader/program free;
     if (strcmp(classname.c_str(), "gles2_decoder_context_t") == 0) {
-        fprintf(fp, "void %s::freeShader(){\n", classname.c_str());
-	fprintf(fp, 
-		"                       \n\
-\tauto it = m_shaders.begin();\n\
-\tm_lock.lock();\n\
-\twhile(it != m_shaders.end()) \n\
-\t{\n\
-\t\tthis->glDeleteShader(it->first);\n\
-\t\tit++;\n\
-\t}\n\
-\tm_lock.unlock();\n\
-}\n\n");
-
-        fprintf(fp, "void %s::freeProgram(){\n", classname.c_str());
-	fprintf(fp, 
-		"		\n\
-\tauto it = m_programs.begin(); \n\
-\tm_lock.lock();\n\
-\twhile(it != m_programs.end()) \n\
-\t{\n\
-\t\tthis->glDeleteProgram(it->first);\n\
-\t\tit++;\n\
-\t}\n\
-\tm_lock.unlock();\n\
-}\n\n");
+        printFreeShaderAndProgram(fp, classname);
     }
 
     // decoder switch;
@@ -1262,6 +1281,360 @@ int ApiGen::genDecoderImpl(const std::string &filename)
     return 0;
 }
 
+int ApiGen::genTableDecoderImpl(const std::string &filename)
+{
+    FILE *fp = fopen(filename.c_str(), "wt");
+    if (fp == NULL) {
+        perror(filename.c_str());
+        return -1;
+    }
+
+    printHeader(fp);
+
+    std::string classname = m_basename + "_decoder_context_t";
+    bool isGles2 = m_basename == "gles2";
+
+    size_t n = size();
+
+    fprintf(fp, "\n\n#include <string.h>\n");
+    fprintf(fp, "#include \"%s_opcodes.h\"\n\n", m_basename.c_str());
+    fprintf(fp, "#include \"%s_dec.h\"\n\n\n", m_basename.c_str());
+    fprintf(fp, "#include \"ProtocolUtils.h\"\n\n");
+    fprintf(fp, "#include \"ChecksumCalculatorThreadInfo.h\"\n\n");
+    fprintf(fp, "#include <stdio.h>\n\n");
+
+    // helper macros
+    fprintf(fp, "#  define DEBUG(...) do { if (emugl_cxt_logger) { emugl_cxt_logger(LogLevel::TRACE, __VA_ARGS__); } } while(0)\n");
+    fprintf(fp, "#  define ERR(...) do { if (emugl_logger) { emugl_logger(LogLevel::ERROR, __VA_ARGS__); } } while(0)\n\n");
+
+    fprintf(fp, "using namespace emugl;\n\n");
+
+    if (isGles2) {
+        printFreeShaderAndProgram(fp, classname);
+    }
+
+    // The checksum version only changes through entries flagged with
+    // changes_checksum, so the decoder reads it once per decode() call
+    // instead of once per packet.
+    fprintf(fp,
+            "namespace {\n\n"
+            "struct DecoderState {\n"
+            "\tIOStream *stream;\n"
+            "\tScratchBuffer *scratch;\n"
+            "\tbool useChecksum;\n"
+            "\tsize_t checksumSize;\n"
+            "};\n\n"
+            "// Out pointers are allocated by the host, cap what a guest can ask for.\n"
+            "const uint32_t kMaxOutPointerSize = 256 * 1024 * 1024;\n\n"
+            "void loadChecksumState(DecoderState &state)\n"
+            "{\n"
+            "\tstate.useChecksum = ChecksumCalculatorThreadInfo::getVersion() > 0;\n"
+            "\tstate.checksumSize = state.useChecksum ? ChecksumCalculatorThreadInfo::checksumByteSize() : 0;\n"
+            "}\n\n"
+            "typedef bool (*DecodeFunc)(%s *ctx, unsigned char *ptr, size_t packetLen, DecoderState &state);\n\n",
+            classname.c_str());
+
+    // one decode function per opcode; each returns false if the packet is
+    // too short for what it declares.
+    for (size_t f = 0; f < n; f++) {
+        EntryPoint *e = &at(f);
+        VarsArray & evars = e->vars();
+        const char *entry_name = e->name().c_str();
+
+        std::string printString = "";
+        unsigned fixedBytes = 0;
+        size_t pointerCount = 0;
+        for (size_t i = 0; i < evars.size(); i++) {
+            Var *v = &evars[i];
+            if (v->isVoid()) {
+                continue;
+            }
+            printString += (v->isPointer() ? "%p(%u)" : v->type()->printFormat()) + " ";
+            if (v->isPointer()) {
+                fixedBytes += 4;
+                pointerCount++;
+            } else {
+                fixedBytes += v->type()->bytes();
+            }
+        }
+
+        std::string retvalType;
+        bool hasRetval = !e->retval().isVoid() && !e->retval().isPointer();
+        if (hasRetval) {
+            retvalType = e->retval().type()->name();
+        }
+
+        fprintf(fp,
+                "bool decode_%s(%s *ctx, unsigned char *ptr, size_t packetLen, DecoderState &state)\n{\n",
+                entry_name, classname.c_str());
+        fprintf(fp,
+                "\tsize_t minLen = 8 + %u + state.checksumSize;\n"
+                "\tif (packetLen < minLen) return false;\n",
+                fixedBytes);
+
+        // unpack; in pointer data extends the packet so re-check its bounds
+        // before reading what follows.
+        std::string varoffset = "8";
+        std::string tmpSize = "";
+        std::string *tmpBufOffset = new std::string[evars.size()];
+        std::string scratchSize = "";
+        for (size_t j = 0; j < evars.size(); j++) {
+            Var *v = &evars[j];
+            if (v->isVoid()) {
+                continue;
+            }
+            const char *var_name = v->name().c_str();
+            const char *var_type_name = v->type()->name().c_str();
+            const unsigned var_type_bytes = v->type()->bytes();
+
+            if (!v->isPointer()) {
+                fprintf(fp,
+                        "\t%s var_%s = Unpack<%s,uint%u_t>(ptr + %s);\n",
+                        var_type_name, var_name, var_type_name,
+                        var_type_bytes * 8U, varoffset.c_str());
+                varoffset += " + " + toString(var_type_bytes);
+                continue;
+            }
+
+            fprintf(fp,
+                    "\tuint32_t size_%s = Unpack<uint32_t,uint32_t>(ptr + %s);\n",
+                    var_name, varoffset.c_str());
+            scratchSize += "(size_t)size_" + v->name() + " + ";
+            if (v->pointerDir() == Var::POINTER_IN ||
+                v->pointerDir() == Var::POINTER_INOUT) {
+                fprintf(fp,
+                        "\tif (size_%s > packetLen - minLen) return false;\n"
+                        "\tminLen += size_%s;\n",
+                        var_name, var_name);
+                varoffset += " + 4 + size_";
+                varoffset += v->name();
+            } else {
+                // Sizes are added in size_t so that they can't wrap.
+                fprintf(fp,
+                        "\tif (size_%s > kMaxOutPointerSize) return false;\n",
+                        var_name);
+                tmpBufOffset[j] = tmpSize.empty() ? "0" : tmpSize;
+                tmpSize += (tmpSize.empty() ? "(size_t)size_" : " + (size_t)size_") + v->name();
+                varoffset += " + 4";
+            }
+        }
+
+        fprintf(fp,
+                "\tif (state.useChecksum) {\n"
+                "\t\tChecksumCalculatorThreadInfo::validOrDie(ptr, %s, ptr + %s, state.checksumSize,\n"
+                "\t\t\t\"%s::decode, OP_%s: GL checksumCalculator failure\\n\");\n"
+                "\t}\n",
+                varoffset.c_str(), varoffset.c_str(), classname.c_str(), entry_name);
+
+        std::string retvalOffset = tmpSize.empty() ? "0" : tmpSize;
+        if (hasRetval) {
+            tmpSize += (tmpSize.empty() ? "" : " + ") + std::string("sizeof(") + retvalType + ")";
+        }
+        bool hasTmpBuf = !tmpSize.empty();
+        if (hasTmpBuf) {
+            fprintf(fp,
+                    "\tsize_t totalTmpSize = %s + state.checksumSize;\n"
+                    "\tunsigned char *tmpBuf = state.stream->alloc(totalTmpSize);\n",
+                    tmpSize.c_str());
+        }
+
+        if (pointerCount > 0) {
+            fprintf(fp, "\tstate.scratch->reserve(%s%u * ScratchBuffer::kAlign);\n",
+                    scratchSize.c_str(), (unsigned)pointerCount);
+        }
+
+        // aligned views of the pointer arguments
+        varoffset = "8";
+        for (size_t j = 0; j < evars.size(); j++) {
+            Var *v = &evars[j];
+            if (v->isVoid()) {
+                continue;
+            }
+            const char *var_name = v->name().c_str();
+            if (!v->isPointer()) {
+                varoffset += " + " + toString(v->type()->bytes());
+                continue;
+            }
+            if (v->pointerDir() == Var::POINTER_IN ||
+                v->pointerDir() == Var::POINTER_INOUT) {
+                fprintf(fp,
+                        "\tunsigned char *inptr_%s = state.scratch->input(ptr + %s + 4, size_%s);\n",
+                        var_name, varoffset.c_str(), var_name);
+                varoffset += " + 4 + size_";
+                varoffset += v->name();
+            } else {
+                fprintf(fp,
+                        "\tunsigned char *outptr_%s = state.scratch->output(&tmpBuf[%s], size_%s);\n",
+                        var_name, tmpBufOffset[j].c_str(), var_name);
+                varoffset += " + 4";
+            }
+        }
+
+        // trace and call
+        std::string debugArgs = "";
+        std::string callArgs = e->customDecoder() ? "ctx" : "";
+        for (size_t j = 0; j < evars.size(); j++) {
+            Var *v = &evars[j];
+            if (v->isVoid()) {
+                continue;
+            }
+            const std::string &var_name = v->name();
+            const std::string &var_type_name = v->type()->name();
+            std::string arg;
+            std::string value;
+            if (!v->isPointer()) {
+                arg = "var_" + var_name;
+                value = arg;
+            } else {
+                std::string buf = (v->pointerDir() == Var::POINTER_OUT ? "outptr_" : "inptr_") + var_name;
+                value = "(" + var_type_name + ")(" + buf + ")";
+                arg = v->nullAllowed() ? "size_" + var_name + " == 0 ? NULL : " + value : value;
+                value += ", size_" + var_name;
+            }
+            debugArgs += ", " + value;
+            callArgs += (callArgs.empty() ? "" : ", ") + arg;
+        }
+        fprintf(fp, "\tDEBUG(\"%s(%%p): %s(%s)\", state.stream%s);\n",
+                m_basename.c_str(), entry_name, printString.c_str(), debugArgs.c_str());
+        if (hasRetval) {
+            fprintf(fp, "\t*(%s *)(&tmpBuf[%s]) = ", retvalType.c_str(), retvalOffset.c_str());
+        } else {
+            fprintf(fp, "\t");
+        }
+        fprintf(fp, "ctx->%s(%s);\n", entry_name, callArgs.c_str());
+
+        // send back out pointers data as well as retval
+        for (size_t j = 0; j < evars.size(); j++) {
+            Var *v = &evars[j];
+            if (v->isPointer() && v->pointerDir() == Var::POINTER_OUT) {
+                fprintf(fp,
+                        "\tstate.scratch->flush(&tmpBuf[%s], outptr_%s, size_%s);\n",
+                        tmpBufOffset[j].c_str(), v->name().c_str(), v->name().c_str());
+            }
+        }
+        if (hasTmpBuf) {
+            fprintf(fp,
+                    "\tif (state.useChecksum) {\n"
+                    "\t\tChecksumCalculatorThreadInfo::writeChecksum(&tmpBuf[0], totalTmpSize - state.checksumSize,\n"
+                    "\t\t\t&tmpBuf[totalTmpSize - state.checksumSize], state.checksumSize);\n"
+                    "\t}\n"
+                    "\tstate.stream->flush();\n");
+        }
+
+        if (e->changesChecksum()) {
+            fprintf(fp, "\tloadChecksumState(state);\n");
+        }
+
+        if (isGles2) {
+            if (e->name() == "glAttachShader") {
+                fprintf(fp,
+                        "\tctx->m_lock.lock();\n"
+                        "\tctx->m_shaders.insert({var_shader, 1});\n"
+                        "\tctx->m_lock.unlock();\n");
+            } else if (e->name() == "glDeleteProgram") {
+                fprintf(fp,
+                        "\tctx->m_lock.lock();\n"
+                        "\tctx->m_programs.erase(var_program);\n"
+                        "\tctx->m_lock.unlock();\n");
+            } else if (e->name() == "glDeleteShader") {
+                fprintf(fp,
+                        "\tctx->m_lock.lock();\n"
+                        "\tctx->m_shaders.erase(var_shader);\n"
+                        "\tctx->m_lock.unlock();\n");
+            } else if (e->name() == "glLinkProgram") {
+                fprintf(fp,
+                        "\tctx->m_lock.lock();\n"
+                        "\tctx->m_programs.insert({var_program, 1});\n"
+                        "\tctx->m_lock.unlock();\n");
+            }
+        }
+
+        fprintf(fp, "\treturn true;\n}\n\n");
+        delete [] tmpBufOffset;
+    }
+
+    // dense tables indexed by (opcode - base opcode)
+    fprintf(fp, "const DecodeFunc s_decoders[] = {\n");
+    for (size_t f = 0; f < n; f++) {
+        fprintf(fp, "\tdecode_%s,\n", at(f).name().c_str());
+    }
+    fprintf(fp, "};\n\n");
+
+    fprintf(fp, "const char *const s_names[] = {\n");
+    for (size_t f = 0; f < n; f++) {
+        fprintf(fp, "\t\"%s\",\n", at(f).name().c_str());
+    }
+    fprintf(fp, "};\n\n");
+
+    fprintf(fp, "const size_t s_numOpcodes = sizeof(s_decoders) / sizeof(s_decoders[0]);\n\n");
+
+    fprintf(fp, "#ifdef EMUGL_DECODER_PROFILING\n");
+    fprintf(fp, "DecoderOpcodeStats s_stats[] = {\n");
+    for (size_t f = 0; f < n; f++) {
+        fprintf(fp, "\t{ \"%s\", OP_%s, {0}, {0} },\n",
+                at(f).name().c_str(), at(f).name().c_str());
+    }
+    fprintf(fp, "};\n");
+    fprintf(fp, "#endif\n\n");
+    fprintf(fp, "} // namespace\n\n");
+
+    fprintf(fp,
+            "size_t %s::opcodeStats(const DecoderOpcodeStats **stats)\n"
+            "{\n"
+            "#ifdef EMUGL_DECODER_PROFILING\n"
+            "\t*stats = s_stats;\n"
+            "\treturn s_numOpcodes;\n"
+            "#else\n"
+            "\t*stats = NULL;\n"
+            "\treturn 0;\n"
+            "#endif\n"
+            "}\n\n",
+            classname.c_str());
+
+    // decoder loop; stops at an incomplete packet or an unknown opcode just
+    // like the switch decoder, and skips packets that fail their bounds check.
+    fprintf(fp, "size_t %s::decode(void *buf, size_t len, IOStream *stream)\n{\n", classname.c_str());
+    fprintf(fp,
+            "\tsize_t pos = 0;\n"
+            "\tunsigned char *ptr = (unsigned char *)buf;\n"
+            "\tDecoderState state;\n"
+            "\tstate.stream = stream;\n"
+            "\tstate.scratch = &m_scratch;\n"
+            "\tloadChecksumState(state);\n"
+            "\twhile (len - pos >= 8) {\n"
+            "\t\tuint32_t opcode = *(uint32_t *)ptr;\n"
+            "\t\tsize_t packetLen = *(uint32_t *)(ptr + 4);\n"
+            "\t\tif (len - pos < packetLen) return pos;\n"
+            "\t\tuint32_t index = opcode - %uU;\n"
+            "\t\tif (index >= s_numOpcodes || packetLen < 8) break;\n"
+            "#ifdef EMUGL_DECODER_PROFILING\n"
+            "\t\tuint64_t start = decoderClockNs();\n"
+            "#endif\n"
+            "\t\tif (!s_decoders[index](this, ptr, packetLen, state)) {\n"
+            "\t\t\tERR(\"%s: dropping malformed %%s packet of %%zu bytes\\n\", s_names[index], packetLen);\n"
+            "\t\t}\n"
+            "#ifdef EMUGL_DECODER_PROFILING\n"
+            "\t\ts_stats[index].calls.fetch_add(1, std::memory_order_relaxed);\n"
+            "\t\ts_stats[index].ns.fetch_add(decoderClockNs() - start, std::memory_order_relaxed);\n"
+            "#endif\n",
+            (unsigned)m_baseOpcode, classname.c_str());
+    if (strstr(m_basename.c_str(), "gl")) {
+        fprintf(fp, "#ifdef CHECK_GL_ERROR\n");
+        fprintf(fp, "\t\tint err = this->glGetError();\n");
+        fprintf(fp, "\t\tif (err) fprintf(stderr, \"%s Error: 0x%%X in %%s\\n\", err, s_names[index]);\n", m_basename.c_str());
+        fprintf(fp, "#endif\n");
+    }
+    fprintf(fp,
+            "\t\tpos += packetLen;\n"
+            "\t\tptr += packetLen;\n"
+            "\t}\n"
+            "\treturn pos;\n"
+            "}\n");
+
+    fclose(fp);
+    return 0;
+}
+
 int ApiGen::readSpec(const std::string & filename)
 {
     FILE *specfp = fopen(filename.c_str(), "rt");
@@ -30,7 +30,8 @@ public:
     ApiGen(const std::string & basename) :
         m_basename(basename),
         m_maxEntryPointsParams(0),
-        m_baseOpcode(0)
+        m_baseOpcode(0),
+        m_tableDecoder(false)
     { }
     virtual ~ApiGen() {}
     int readSpec(const std::string & filename);
@@ -41,6 +42,8 @@ public:
     }
     int baseOpcode() { return m_baseOpcode; }
     void setBaseOpcode(int base) { m_baseOpcode = base; }
+    bool tableDecoder() { return m_tableDecoder; }
+    void setTableDecoder(bool state) { m_tableDecoder = state; }
 
     const char *sideString(SideType side) {
         const char *retval;
@@ -91,6 +94,8 @@ protected:
     StringVec m_decoderHeaders;
     size_t m_maxEntryPointsParams; // record the maximum number of parameters in the entry points;
     int m_baseOpcode;
+    bool m_tableDecoder; // generate a table driven decoder instead of a switch;
+    int genTableDecoderImpl(const std::string &filename);
     int setGlobalAttribute(const std::string & line, size_t lc);
 };
 
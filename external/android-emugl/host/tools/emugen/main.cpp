@@ -33,6 +33,7 @@ void usage(const char *filename)
     fprintf(stderr, "\t-h: This message\n");
     fprintf(stderr, "\t-E <dir>: generate encoder into dir\n");
     fprintf(stderr, "\t-D <dir>: generate decoder into dir\n");
+    fprintf(stderr, "\t-B <switch|table>: decoder backend, switch by default\n");
     fprintf(stderr, "\t-i: input dir, local directory by default\n");
     fprintf(stderr, "\t-T : generate attribute template into the input directory\n\t\tno other files are generated\n");
     fprintf(stderr, "\t-W : generate wrapper into dir\n");
@@ -44,10 +45,11 @@ int main(int argc, char *argv[])
     std::string decoderDir = "";
     std::string wrapperDir = "";
     std::string inDir = ".";
+    std::string decoderBackend = "switch";
     bool generateAttributesTemplate = false;
 
     int c;
-    while((c = getopt(argc, argv, "TE:D:i:hW:")) != -1) {
+    while((c = getopt(argc, argv, "TE:D:B:i:hW:")) != -1) {
         switch(c) {
         case 'W':
             wrapperDir = std::string(optarg);
@@ -65,6 +67,9 @@ int main(int argc, char *argv[])
         case 'D':
             decoderDir = std::string(optarg);
             break;
+        case 'B':
+            decoderBackend = std::string(optarg);
+            break;
         case 'i':
             inDir = std::string(optarg);
             break;
@@ -90,8 +95,14 @@ int main(int argc, char *argv[])
         return BAD_USAGE;
     }
 
+    if (decoderBackend != "switch" && decoderBackend != "table") {
+        fprintf(stderr, "Unknown decoder backend %s\n", decoderBackend.c_str());
+        return BAD_USAGE;
+    }
+
     std::string baseName = std::string(argv[optind]);
     ApiGen apiEntries(baseName);
+    apiEntries.setTableDecoder(decoderBackend == "table");
 
     // init types;
     std::string typesFilename = inDir + "/" + baseName + TYPES_EXTENTION;
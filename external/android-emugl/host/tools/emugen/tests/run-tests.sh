@@ -63,7 +63,8 @@ Usage: $PROGNAME [options]
 
 Run the emugen test suite. This scripts looks for sub-directories
 named t.<number>/input, and uses them as input to 'emugen'. It then
-compares the output to t.<number>/expected/ content.
+compares the output to t.<number>/expected/ content. Options to pass to
+'emugen' can be listed in t.<number>/options.
 
 Valid options:
     --help|-h|-?         Print this help.
@@ -107,12 +108,17 @@ for TEST_DIR in $TEST_DIRS; do
     IN=$PROGDIR/$TEST_DIR/input
     PREFIXES=$(cd $IN && find . -name "*.in" | sed -e 's|^\./||g' -e 's|\.in$||g')
     OUT=$OUT_DIR/$TEST_DIR
+    # Extra emugen options for the test, e.g. to select a decoder backend.
+    OPTIONS=
+    if [ -f "$PROGDIR/$TEST_DIR/options" ]; then
+        OPTIONS=$(cat "$PROGDIR/$TEST_DIR/options")
+    fi
     mkdir -p "$OUT/encoder"
     mkdir -p "$OUT/decoder"
     mkdir -p "$OUT/wrapper"
     for PREFIX in $PREFIXES; do
         echo "Processing $IN/foo.*"
-        $EMUGEN -i "$PROGDIR/$TEST_DIR/input" -D "$OUT/decoder" -E "$OUT/encoder" -W "$OUT/wrapper" $PREFIX
+        $EMUGEN $OPTIONS -i "$PROGDIR/$TEST_DIR/input" -D "$OUT/decoder" -E "$OUT/encoder" -W "$OUT/wrapper" $PREFIX
     done
     if ! diff -qr "$PROGDIR/$TEST_DIR/expected" "$OUT"; then
         if [ "$OPT_TOOL" ]; then
@@ -16,11 +16,7 @@
 
 typedef unsigned int tsize_t; // Target "size_t", which is 32-bit for now. It may or may not be the same as host's size_t when emugen is compiled.
 
-#ifdef OPENGL_DEBUG_PRINTOUT
-#  define DEBUG(...) do { if (emugl_cxt_logger) { emugl_cxt_logger(__VA_ARGS__); } } while(0)
-#else
-#  define DEBUG(...)  ((void)0)
-#endif
+#  define DEBUG(...) do { if (emugl_cxt_logger) { emugl_cxt_logger(LogLevel::TRACE, __VA_ARGS__); } } while(0)
 
 #ifdef CHECK_GLERROR
 #  define SET_LASTCALL(name)  sprintf(lastCall, #name)
@@ -57,7 +53,7 @@ size_t foo_decoder_context_t::decode(void *buf, size_t len, IOStream *stream)
 				ChecksumCalculatorThreadInfo::validOrDie(ptr, 8 + 4 + 4, ptr + 8 + 4 + 4, checksumSize, 
 					"8 + 4 + 4::decode, OP_foo_decoder_context_t: GL checksumCalculator failure\n");
 			}
-			DEBUG("foo(%p): fooAlphaFunc(%d %f )\n", stream,var_func, var_ref);
+			DEBUG("foo(%p): fooAlphaFunc(%d %f )", stream,var_func, var_ref);
 			this->fooAlphaFunc(var_func, var_ref);
 			SET_LASTCALL("fooAlphaFunc");
 			break;
@@ -72,7 +68,7 @@ size_t foo_decoder_context_t::decode(void *buf, size_t len, IOStream *stream)
 			size_t totalTmpSize = sizeof(FooBoolean);
 			totalTmpSize += checksumSize;
 			unsigned char *tmpBuf = stream->alloc(totalTmpSize);
-			DEBUG("foo(%p): fooIsBuffer(%p(%u) )\n", stream,(void*)(inptr_stuff.get()), size_stuff);
+			DEBUG("foo(%p): fooIsBuffer(%p(%u) )", stream,(void*)(inptr_stuff.get()), size_stuff);
 			*(FooBoolean *)(&tmpBuf[0]) = 			this->fooIsBuffer((void*)(inptr_stuff.get()));
 			if (useChecksum) {
 				ChecksumCalculatorThreadInfo::writeChecksum(&tmpBuf[0], totalTmpSize - checksumSize, &tmpBuf[totalTmpSize - checksumSize], checksumSize);
@@ -88,7 +84,7 @@ size_t foo_decoder_context_t::decode(void *buf, size_t len, IOStream *stream)
 				ChecksumCalculatorThreadInfo::validOrDie(ptr, 8 + 4 + size_params, ptr + 8 + 4 + size_params, checksumSize, 
 					"8 + 4 + size_params::decode, OP_foo_decoder_context_t: GL checksumCalculator failure\n");
 			}
-			DEBUG("foo(%p): fooUnsupported(%p(%u) )\n", stream,(void*)(inptr_params.get()), size_params);
+			DEBUG("foo(%p): fooUnsupported(%p(%u) )", stream,(void*)(inptr_params.get()), size_params);
 			this->fooUnsupported((void*)(inptr_params.get()));
 			SET_LASTCALL("fooUnsupported");
 			break;
@@ -99,7 +95,7 @@ size_t foo_decoder_context_t::decode(void *buf, size_t len, IOStream *stream)
 				ChecksumCalculatorThreadInfo::validOrDie(ptr, 8 + 4, ptr + 8 + 4, checksumSize, 
 					"8 + 4::decode, OP_foo_decoder_context_t: GL checksumCalculator failure\n");
 			}
-			DEBUG("foo(%p): fooDoEncoderFlush(%d )\n", stream,var_param);
+			DEBUG("foo(%p): fooDoEncoderFlush(%d )", stream,var_param);
 			this->fooDoEncoderFlush(var_param);
 			SET_LASTCALL("fooDoEncoderFlush");
 			break;
@@ -111,7 +107,7 @@ size_t foo_decoder_context_t::decode(void *buf, size_t len, IOStream *stream)
 				ChecksumCalculatorThreadInfo::validOrDie(ptr, 8 + 4 + size_param, ptr + 8 + 4 + size_param, checksumSize, 
 					"8 + 4 + size_param::decode, OP_foo_decoder_context_t: GL checksumCalculator failure\n");
 			}
-			DEBUG("foo(%p): fooTakeConstVoidPtrConstPtr(%p(%u) )\n", stream,(const void* const*)(inptr_param.get()), size_param);
+			DEBUG("foo(%p): fooTakeConstVoidPtrConstPtr(%p(%u) )", stream,(const void* const*)(inptr_param.get()), size_param);
 			this->fooTakeConstVoidPtrConstPtr((const void* const*)(inptr_param.get()));
 			SET_LASTCALL("fooTakeConstVoidPtrConstPtr");
 			break;
@@ -9,6 +9,8 @@
 
 
 
+#include "emugl/common/logging.h"
+
 struct foo_decoder_context_t : public foo_server_context_t {
 
 	size_t decode(void *buf, size_t bufsize, IOStream *stream);
@@ -0,0 +1,201 @@
+// Generated Code - DO NOT EDIT !!
+// generated by 'emugen'
+
+
+#include <string.h>
+#include "foo_opcodes.h"
+
+#include "foo_dec.h"
+
+
+#include "ProtocolUtils.h"
+
+#include "ChecksumCalculatorThreadInfo.h"
+
+#include <stdio.h>
+
+#  define DEBUG(...) do { if (emugl_cxt_logger) { emugl_cxt_logger(LogLevel::TRACE, __VA_ARGS__); } } while(0)
+#  define ERR(...) do { if (emugl_logger) { emugl_logger(LogLevel::ERROR, __VA_ARGS__); } } while(0)
+
+using namespace emugl;
+
+namespace {
+
+struct DecoderState {
+	IOStream *stream;
+	ScratchBuffer *scratch;
+	bool useChecksum;
+	size_t checksumSize;
+};
+
+// Out pointers are allocated by the host, cap what a guest can ask for.
+const uint32_t kMaxOutPointerSize = 256 * 1024 * 1024;
+
+void loadChecksumState(DecoderState &state)
+{
+	state.useChecksum = ChecksumCalculatorThreadInfo::getVersion() > 0;
+	state.checksumSize = state.useChecksum ? ChecksumCalculatorThreadInfo::checksumByteSize() : 0;
+}
+
+typedef bool (*DecodeFunc)(foo_decoder_context_t *ctx, unsigned char *ptr, size_t packetLen, DecoderState &state);
+
+bool decode_fooAlphaFunc(foo_decoder_context_t *ctx, unsigned char *ptr, size_t packetLen, DecoderState &state)
+{
+	size_t minLen = 8 + 8 + state.checksumSize;
+	if (packetLen < minLen) return false;
+	FooInt var_func = Unpack<FooInt,uint32_t>(ptr + 8);
+	FooFloat var_ref = Unpack<FooFloat,uint32_t>(ptr + 8 + 4);
+	if (state.useChecksum) {
+		ChecksumCalculatorThreadInfo::validOrDie(ptr, 8 + 4 + 4, ptr + 8 + 4 + 4, state.checksumSize,
+			"foo_decoder_context_t::decode, OP_fooAlphaFunc: GL checksumCalculator failure\n");
+	}
+	DEBUG("foo(%p): fooAlphaFunc(%d %f )", state.stream, var_func, var_ref);
+	ctx->fooAlphaFunc(var_func, var_ref);
+	return true;
+}
+
+bool decode_fooIsBuffer(foo_decoder_context_t *ctx, unsigned char *ptr, size_t packetLen, DecoderState &state)
+{
+	size_t minLen = 8 + 4 + state.checksumSize;
+	if (packetLen < minLen) return false;
+	uint32_t size_stuff = Unpack<uint32_t,uint32_t>(ptr + 8);
+	if (size_stuff > packetLen - minLen) return false;
+	minLen += size_stuff;
+	if (state.useChecksum) {
+		ChecksumCalculatorThreadInfo::validOrDie(ptr, 8 + 4 + size_stuff, ptr + 8 + 4 + size_stuff, state.checksumSize,
+			"foo_decoder_context_t::decode, OP_fooIsBuffer: GL checksumCalculator failure\n");
+	}
+	size_t totalTmpSize = sizeof(FooBoolean) + state.checksumSize;
+	unsigned char *tmpBuf = state.stream->alloc(totalTmpSize);
+	state.scratch->reserve((size_t)size_stuff + 1 * ScratchBuffer::kAlign);
+	unsigned char *inptr_stuff = state.scratch->input(ptr + 8 + 4, size_stuff);
+	DEBUG("foo(%p): fooIsBuffer(%p(%u) )", state.stream, (void*)(inptr_stuff), size_stuff);
+	*(FooBoolean *)(&tmpBuf[0]) = ctx->fooIsBuffer((void*)(inptr_stuff));
+	if (state.useChecksum) {
+		ChecksumCalculatorThreadInfo::writeChecksum(&tmpBuf[0], totalTmpSize - state.checksumSize,
+			&tmpBuf[totalTmpSize - state.checksumSize], state.checksumSize);
+	}
+	state.stream->flush();
+	return true;
+}
+
+bool decode_fooUnsupported(foo_decoder_context_t *ctx, unsigned char *ptr, size_t packetLen, DecoderState &state)
+{
+	size_t minLen = 8 + 4 + state.checksumSize;
+	if (packetLen < minLen) return false;
+	uint32_t size_params = Unpack<uint32_t,uint32_t>(ptr + 8);
+	if (size_params > packetLen - minLen) return false;
+	minLen += size_params;
+	if (state.useChecksum) {
+		ChecksumCalculatorThreadInfo::validOrDie(ptr, 8 + 4 + size_params, ptr + 8 + 4 + size_params, state.checksumSize,
+			"foo_decoder_context_t::decode, OP_fooUnsupported: GL checksumCalculator failure\n");
+	}
+	state.scratch->reserve((size_t)size_params + 1 * ScratchBuffer::kAlign);
+	unsigned char *inptr_params = state.scratch->input(ptr + 8 + 4, size_params);
+	DEBUG("foo(%p): fooUnsupported(%p(%u) )", state.stream, (void*)(inptr_params), size_params);
+	ctx->fooUnsupported((void*)(inptr_params));
+	return true;
+}
+
+bool decode_fooDoEncoderFlush(foo_decoder_context_t *ctx, unsigned char *ptr, size_t packetLen, DecoderState &state)
+{
+	size_t minLen = 8 + 4 + state.checksumSize;
+	if (packetLen < minLen) return false;
+	FooInt var_param = Unpack<FooInt,uint32_t>(ptr + 8);
+	if (state.useChecksum) {
+		ChecksumCalculatorThreadInfo::validOrDie(ptr, 8 + 4, ptr + 8 + 4, state.checksumSize,
+			"foo_decoder_context_t::decode, OP_fooDoEncoderFlush: GL checksumCalculator failure\n");
+	}
+	DEBUG("foo(%p): fooDoEncoderFlush(%d )", state.stream, var_param);
+	ctx->fooDoEncoderFlush(var_param);
+	return true;
+}
+
+bool decode_fooTakeConstVoidPtrConstPtr(foo_decoder_context_t *ctx, unsigned char *ptr, size_t packetLen, DecoderState &state)
+{
+	size_t minLen = 8 + 4 + state.checksumSize;
+	if (packetLen < minLen) return false;
+	uint32_t size_param = Unpack<uint32_t,uint32_t>(ptr + 8);
+	if (size_param > packetLen - minLen) return false;
+	minLen += size_param;
+	if (state.useChecksum) {
+		ChecksumCalculatorThreadInfo::validOrDie(ptr, 8 + 4 + size_param, ptr + 8 + 4 + size_param, state.checksumSize,
+			"foo_decoder_context_t::decode, OP_fooTakeConstVoidPtrConstPtr: GL checksumCalculator failure\n");
+	}
+	state.scratch->reserve((size_t)size_param + 1 * ScratchBuffer::kAlign);
+	unsigned char *inptr_param = state.scratch->input(ptr + 8 + 4, size_param);
+	DEBUG("foo(%p): fooTakeConstVoidPtrConstPtr(%p(%u) )", state.stream, (const void* const*)(inptr_param), size_param);
+	ctx->fooTakeConstVoidPtrConstPtr((const void* const*)(inptr_param));
+	return true;
+}
+
+const DecodeFunc s_decoders[] = {
+	decode_fooAlphaFunc,
+	decode_fooIsBuffer,
+	decode_fooUnsupported,
+	decode_fooDoEncoderFlush,
+	decode_fooTakeConstVoidPtrConstPtr,
+};
+
+const char *const s_names[] = {
+	"fooAlphaFunc",
+	"fooIsBuffer",
+	"fooUnsupported",
+	"fooDoEncoderFlush",
+	"fooTakeConstVoidPtrConstPtr",
+};
+
+const size_t s_numOpcodes = sizeof(s_decoders) / sizeof(s_decoders[0]);
+
+#ifdef EMUGL_DECODER_PROFILING
+DecoderOpcodeStats s_stats[] = {
+	{ "fooAlphaFunc", OP_fooAlphaFunc, {0}, {0} },
+	{ "fooIsBuffer", OP_fooIsBuffer, {0}, {0} },
+	{ "fooUnsupported", OP_fooUnsupported, {0}, {0} },
+	{ "fooDoEncoderFlush", OP_fooDoEncoderFlush, {0}, {0} },
+	{ "fooTakeConstVoidPtrConstPtr", OP_fooTakeConstVoidPtrConstPtr, {0}, {0} },
+};
+#endif
+
+} // namespace
+
+size_t foo_decoder_context_t::opcodeStats(const DecoderOpcodeStats **stats)
+{
+#ifdef EMUGL_DECODER_PROFILING
+	*stats = s_stats;
+	return s_numOpcodes;
+#else
+	*stats = NULL;
+	return 0;
+#endif
+}
+
+size_t foo_decoder_context_t::decode(void *buf, size_t len, IOStream *stream)
+{
+	size_t pos = 0;
+	unsigned char *ptr = (unsigned char *)buf;
+	DecoderState state;
+	state.stream = stream;
+	state.scratch = &m_scratch;
+	loadChecksumState(state);
+	while (len - pos >= 8) {
+		uint32_t opcode = *(uint32_t *)ptr;
+		size_t packetLen = *(uint32_t *)(ptr + 4);
+		if (len - pos < packetLen) return pos;
+		uint32_t index = opcode - 200U;
+		if (index >= s_numOpcodes || packetLen < 8) break;
+#ifdef EMUGL_DECODER_PROFILING
+		uint64_t start = decoderClockNs();
+#endif
+		if (!s_decoders[index](this, ptr, packetLen, state)) {
+			ERR("foo_decoder_context_t: dropping malformed %s packet of %zu bytes\n", s_names[index], packetLen);
+		}
+#ifdef EMUGL_DECODER_PROFILING
+		s_stats[index].calls.fetch_add(1, std::memory_order_relaxed);
+		s_stats[index].ns.fetch_add(decoderClockNs() - start, std::memory_order_relaxed);
+#endif
+		pos += packetLen;
+		ptr += packetLen;
+	}
+	return pos;
+}
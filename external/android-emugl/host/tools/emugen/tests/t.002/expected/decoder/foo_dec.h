@@ -0,0 +1,26 @@
+// Generated Code - DO NOT EDIT !!
+// generated by 'emugen'
+
+#ifndef GUARD_foo_decoder_context_t
+#define GUARD_foo_decoder_context_t
+
+#include "IOStream.h" 
+#include "foo_server_context.h"
+
+
+
+#include "DecoderStats.h"
+#include "ScratchBuffer.h"
+
+#include "emugl/common/logging.h"
+
+struct foo_decoder_context_t : public foo_server_context_t {
+
+	size_t decode(void *buf, size_t bufsize, IOStream *stream);
+	// Returns the per-opcode counters, or 0 unless built with EMUGL_DECODER_PROFILING.
+	static size_t opcodeStats(const emugl::DecoderOpcodeStats **stats);
+	emugl::ScratchBuffer m_scratch;
+
+};
+
+#endif  // GUARD_foo_decoder_context_t
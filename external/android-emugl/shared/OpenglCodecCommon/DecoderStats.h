@@ -0,0 +1,40 @@
+/*
+* Copyright (C) 2016 The Android Open Source Project
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+#include <stdint.h>
+
+namespace emugl {
+
+// Per-opcode counters kept by the table-driven decoders generated by emugen
+// when built with EMUGL_DECODER_PROFILING. |ns| is the cumulative time spent
+// decoding and executing packets with that opcode, summed over all threads.
+struct DecoderOpcodeStats {
+    const char* name;
+    uint32_t opcode;
+    std::atomic<uint64_t> calls;
+    std::atomic<uint64_t> ns;
+};
+
+inline uint64_t decoderClockNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}  // namespace emugl
@@ -0,0 +1,117 @@
+/*
+* Copyright (C) 2016 The Android Open Source Project
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace emugl {
+
+// Reusable arena providing the same guarantees as InputBuffer and
+// OutputBuffer from ProtocolUtils.h without a heap allocation per
+// misaligned pointer. Each decoder, and so each render thread, owns one;
+// the table driven decoders reserve room for all the pointers of a packet
+// before taking any of them.
+// Usage example:
+//
+//    scratch.reserve(inSize + outSize + 2 * ScratchBuffer::kAlign);
+//    unsigned char* in = scratch.input(inPtr, inSize);
+//    unsigned char* out = scratch.output(outPtr, outSize);
+//    glGetStuff(in, out);
+//    scratch.flush(outPtr, out, outSize);
+//
+// Pointers returned by input() and output() are valid until the next call
+// to reserve().
+class ScratchBuffer {
+public:
+    static const size_t kAlign = 8;
+
+    ScratchBuffer() : mBuff(NULL), mCapacity(0), mUsed(0) {}
+
+    ~ScratchBuffer() {
+        free(mBuff);
+    }
+
+    // Discards previous copies and makes sure |size| bytes, including
+    // alignment padding, are available.
+    void reserve(size_t size) {
+        mUsed = 0;
+        if (size <= mCapacity) {
+            return;
+        }
+        void* newBuff = realloc(mBuff, size);
+        if (!newBuff) {
+            abort();
+        }
+        mBuff = static_cast<unsigned char*>(newBuff);
+        mCapacity = size;
+    }
+
+    // Returns |ptr| if it is aligned, an aligned copy of its |size| bytes
+    // otherwise.
+    unsigned char* input(unsigned char* ptr, size_t size) {
+        if (isAligned(ptr)) {
+            return ptr;
+        }
+        unsigned char* copy = take(size);
+        memcpy(copy, ptr, size);
+        return copy;
+    }
+
+    // Returns |ptr| if it is aligned, a zeroed aligned buffer of |size|
+    // bytes otherwise.
+    unsigned char* output(unsigned char* ptr, size_t size) {
+        if (isAligned(ptr)) {
+            return ptr;
+        }
+        unsigned char* buff = take(size);
+        memset(buff, 0, size);
+        return buff;
+    }
+
+    // Copies what was written to a buffer returned by output() back to
+    // |ptr|, if needed.
+    void flush(unsigned char* ptr, const unsigned char* buff, size_t size) {
+        if (buff != ptr) {
+            memcpy(ptr, buff, size);
+        }
+    }
+
+private:
+    ScratchBuffer(const ScratchBuffer&);
+    ScratchBuffer& operator=(const ScratchBuffer&);
+
+    static bool isAligned(const void* ptr) {
+        return (reinterpret_cast<uintptr_t>(ptr) & (kAlign - 1U)) == 0;
+    }
+
+    unsigned char* take(size_t size) {
+        unsigned char* buff = mBuff + mUsed;
+        mUsed += (size + kAlign - 1U) & ~(kAlign - 1U);
+        if (mUsed > mCapacity) {
+            abort();
+        }
+        return buff;
+    }
+
+    unsigned char* mBuff;
+    size_t mCapacity;
+    size_t mUsed;
+};
+
+}  // namespace emugl
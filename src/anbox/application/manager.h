@@ -23,6 +23,9 @@
 #include "anbox/graphics/rect.h"
 #include "anbox/wm/stack.h"
 
+#include <functional>
+#include <memory>
+#include <stdexcept>
 #include <string>
 
 #include <core/property.h>
@@ -30,10 +33,29 @@
 namespace anbox::application {
 class Manager : public DoNotCopyOrMove {
  public:
+  // Called once a launch finished. |error| is empty if it succeeded.
+  typedef std::function<void(const std::string &error)> LaunchCallback;
+
   virtual void launch(const android::Intent &intent,
                       const graphics::Rect &launch_bounds = graphics::Rect::Invalid,
                       const wm::Stack::Id &stack = wm::Stack::Id::Default) = 0;
 
+  // Starts a launch without waiting for it to finish. Managers which can't
+  // launch asynchronously launch right away and call |done| before
+  // returning.
+  virtual void launch_async(const android::Intent &intent,
+                            const graphics::Rect &launch_bounds,
+                            const wm::Stack::Id &stack,
+                            const LaunchCallback &done) {
+    try {
+      launch(intent, launch_bounds, stack);
+    } catch (const std::exception &err) {
+      done(err.what());
+      return;
+    }
+    done("");
+  }
+
   virtual core::Property<bool>& ready() = 0;
 };
 
@@ -50,17 +72,27 @@ class RestrictedManager : public Manager {
   void launch(const android::Intent &intent,
               const graphics::Rect &launch_bounds = graphics::Rect::Invalid,
               const wm::Stack::Id &stack = wm::Stack::Id::Default) override {
-    auto selected_stack = stack;
-    // If we have a static launch stack set use that one instead of
-    // the one the caller gave us.
-    if (launch_stack_ != wm::Stack::Id::Invalid)
-      selected_stack = launch_stack_;
-    other_->launch(intent, launch_bounds, selected_stack);
+    other_->launch(intent, launch_bounds, select_stack(stack));
+  }
+
+  void launch_async(const android::Intent &intent,
+                    const graphics::Rect &launch_bounds,
+                    const wm::Stack::Id &stack,
+                    const LaunchCallback &done) override {
+    other_->launch_async(intent, launch_bounds, select_stack(stack), done);
   }
 
   core::Property<bool>& ready() override { return other_->ready(); }
 
  private:
+  wm::Stack::Id select_stack(const wm::Stack::Id &stack) const {
+    // If we have a static launch stack set use that one instead of
+    // the one the caller gave us.
+    if (launch_stack_ != wm::Stack::Id::Invalid)
+      return launch_stack_;
+    return stack;
+  }
+
   std::shared_ptr<Manager> other_;
   wm::Stack::Id launch_stack_;
 };
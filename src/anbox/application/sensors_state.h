@@ -1,34 +1,34 @@
 #ifndef ANBOX_APPLICATION_SENSORS_STATE_H_
 #define ANBOX_APPLICATION_SENSORS_STATE_H_
 
+#include <array>
 #include <cstdint>
-#include <tuple>
 
+#include "anbox/common/seqlock.h"
 #include "anbox/do_not_copy_or_move.h"
 #include "anbox/logger.h"
 
 namespace anbox::application {
+// The values the sensors report to Android.
+struct SensorsValues {
+  std::array<double, 3> acceleration{{0, 0, 9.80665}};
+  std::array<double, 3> magneticField{{25, 25, 5}};
+  std::array<double, 3> orientation{{0, 0, 0}};
+  double temperature = 25;
+  double proximity = 5;
+  double light = 1240;
+  double pressure = 1013.25;
+  double humidity = 45.1;
+};
+
+// Shared by the D-Bus SensorsServer which changes the values and the
+// sensors pipe which streams them to Android. Every change bumps the
+// version of the values and readers get consistent snapshots without
+// taking a lock.
 struct SensorsState : public DoNotCopyOrMove {
-  SensorsState() {
-    disabled_sensors = 0;
-    acceleration = {0, 0, 9.80665};
-    magneticField = {25, 25, 5};
-    orientation = {0, 0, 0};
-    temperature = 25;
-    proximity = 5;
-    light = 1240;
-    pressure = 1013.25;
-    humidity = 45.1;
-  }
-  int disabled_sensors;
-  std::tuple<double, double, double> acceleration;
-  std::tuple<double, double, double> magneticField;
-  std::tuple<double, double, double> orientation;
-  double temperature;
-  double proximity;
-  double light;
-  double pressure;
-  double humidity;
+  // Set up once on startup before any connection reads it.
+  int disabled_sensors = 0;
+  common::SeqLock<SensorsValues> values;
 };
 }
 #endif
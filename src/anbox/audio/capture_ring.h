@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef ANBOX_AUDIO_CAPTURE_RING_H_
+#define ANBOX_AUDIO_CAPTURE_RING_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace anbox::audio {
+// Sent by recording clients right after their StreamFormat and answered by
+// the server with the values it settled on. Clients read period_frames at
+// a time; the ring holds period_count periods.
+struct CaptureConfig {
+  std::uint32_t period_frames;
+  std::uint32_t period_count;
+};
+static_assert(sizeof(CaptureConfig) == 8, "CaptureConfig is sent as is over the wire");
+
+// Start of the shared memory the server passes to recording clients after
+// the handshake. The captured frames follow at data_offset. The server
+// only moves write_position and the client only moves read_position, so
+// neither side ever waits for the other. A client which finds the ring
+// empty sets reader_waiting and blocks reading the socket; the server
+// sends a single byte there after its next write if the flag was set.
+struct CaptureRingHeader {
+  static constexpr std::uint32_t magic_value = 0x41434150;  // "PACA"
+  static constexpr std::uint32_t data_offset = 256;
+
+  std::uint32_t magic;
+  std::uint32_t frame_size;
+  // In frames.
+  std::uint32_t capacity;
+  std::uint32_t reserved;
+
+  alignas(64) std::atomic<std::uint64_t> write_position;
+  // Frames the server had to throw away because the client didn't keep up.
+  std::atomic<std::uint64_t> dropped_frames;
+
+  alignas(64) std::atomic<std::uint64_t> read_position;
+  std::atomic<std::uint32_t> reader_waiting;
+};
+static_assert(sizeof(CaptureRingHeader) <= CaptureRingHeader::data_offset,
+              "Frames would overlap the capture ring header");
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2,
+              "Capture ring positions are shared between processes and have to be lock free");
+
+inline std::size_t capture_ring_size(std::uint32_t frame_size, std::uint32_t capacity) {
+  return CaptureRingHeader::data_offset + static_cast<std::size_t>(frame_size) * capacity;
+}
+}
+#endif
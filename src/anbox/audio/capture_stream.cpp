@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "anbox/audio/capture_stream.h"
+#include "anbox/logger.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+#include <boost/throw_exception.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace anbox::audio {
+constexpr std::chrono::milliseconds CaptureStream::default_period;
+constexpr std::uint32_t CaptureStream::default_period_count;
+constexpr std::chrono::milliseconds CaptureStream::min_period;
+constexpr std::chrono::milliseconds CaptureStream::max_period;
+constexpr std::uint32_t CaptureStream::max_period_count;
+
+CaptureConfig CaptureStream::negotiate(const StreamFormat &format, const CaptureConfig &requested) {
+  const auto frames_for = [&](std::chrono::milliseconds duration) {
+    return static_cast<std::uint32_t>(std::max<std::uint64_t>(format.rate * duration.count() / 1000, 1));
+  };
+
+  CaptureConfig config = requested;
+  if (config.period_frames == 0)
+    config.period_frames = frames_for(default_period);
+  config.period_frames = std::min(std::max(config.period_frames, frames_for(min_period)), frames_for(max_period));
+
+  if (config.period_count == 0)
+    config.period_count = default_period_count;
+  config.period_count = std::min(std::max(config.period_count, 2u), max_period_count);
+  return config;
+}
+
+CaptureStream::CaptureStream(const std::shared_ptr<Runtime> &rt,
+                             const std::shared_ptr<Source> &source,
+                             const std::shared_ptr<network::MessageSender> &sender,
+                             const StreamFormat &format,
+                             const CaptureConfig &config,
+                             bool shared_memory) :
+  source_(source),
+  sender_(sender),
+  format_(format),
+  config_(config),
+  frame_size_(frame_size(format)),
+  period_(std::chrono::microseconds(std::uint64_t{config.period_frames} * 1000000 / format.rate)),
+  timer_(rt->service()) {
+  source_->set_format(format_);
+
+  if (!shared_memory)
+    return;
+
+  const auto capacity = config_.period_frames * config_.period_count;
+  mapping_size_ = capture_ring_size(static_cast<std::uint32_t>(frame_size_), capacity);
+
+  ring_fd_ = Fd(::memfd_create("anbox-audio-capture", MFD_CLOEXEC | MFD_ALLOW_SEALING));
+  if (ring_fd_ < 0)
+    BOOST_THROW_EXCEPTION(std::runtime_error(std::string("Failed to create capture ring: ") + std::strerror(errno)));
+
+  // The client must not be able to shrink the memory under our feet.
+  if (::ftruncate(ring_fd_, static_cast<off_t>(mapping_size_)) < 0 ||
+      ::fcntl(ring_fd_, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) < 0)
+    BOOST_THROW_EXCEPTION(std::runtime_error(std::string("Failed to size capture ring: ") + std::strerror(errno)));
+
+  mapping_ = ::mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_SHARED, ring_fd_, 0);
+  if (mapping_ == MAP_FAILED) {
+    mapping_ = nullptr;
+    BOOST_THROW_EXCEPTION(std::runtime_error(std::string("Failed to map capture ring: ") + std::strerror(errno)));
+  }
+
+  header_ = new (mapping_) CaptureRingHeader;
+  header_->magic = CaptureRingHeader::magic_value;
+  header_->frame_size = static_cast<std::uint32_t>(frame_size_);
+  header_->capacity = capacity;
+  header_->reserved = 0;
+  header_->write_position.store(0);
+  header_->dropped_frames.store(0);
+  header_->read_position.store(0);
+  header_->reader_waiting.store(0);
+  ring_frames_ = static_cast<std::uint8_t*>(mapping_) + CaptureRingHeader::data_offset;
+}
+
+CaptureStream::~CaptureStream() {
+  stop();
+  if (mapping_)
+    ::munmap(mapping_, mapping_size_);
+}
+
+void CaptureStream::start() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (running_)
+    return;
+
+  running_ = true;
+  started_ = Clock::now();
+  ticks_ = 0;
+  produced_ = 0;
+  arm_timer();
+}
+
+void CaptureStream::stop() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!running_)
+    return;
+
+  running_ = false;
+  timer_.cancel();
+}
+
+std::uint64_t CaptureStream::dropped_frames() const {
+  if (header_)
+    return header_->dropped_frames.load(std::memory_order_relaxed);
+  return dropped_frames_.load(std::memory_order_relaxed);
+}
+
+void CaptureStream::arm_timer() {
+  ticks_++;
+  timer_.expires_at(started_ + period_ * ticks_);
+
+  std::weak_ptr<CaptureStream> weak_self{shared_from_this()};
+  timer_.async_wait([weak_self](const boost::system::error_code &err) {
+    if (auto self = weak_self.lock())
+      self->on_timer(err);
+  });
+}
+
+void CaptureStream::on_timer(const boost::system::error_code &err) {
+  if (err == boost::asio::error::operation_aborted)
+    return;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!running_)
+    return;
+
+  // Everything that became due since the start goes out, so a timer
+  // which fired late is made up for in the same batch.
+  const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - started_);
+  const auto due_total = static_cast<std::uint64_t>(elapsed.count()) * format_.rate / 1000000;
+  auto due = due_total > produced_ ? due_total - produced_ : 0;
+
+  // After a stall longer than the ring there is no point in catching up
+  // with stale audio; skip ahead instead of building up latency.
+  const std::uint64_t limit = std::uint64_t{config_.period_frames} * config_.period_count;
+  if (due > limit) {
+    produced_ += due - limit;
+    due = limit;
+  }
+
+  if (due > 0) {
+    buffer_.resize(due * frame_size_);
+    source_->read_data(buffer_);
+    deliver(buffer_.data(), due);
+    produced_ += due;
+  }
+
+  arm_timer();
+}
+
+void CaptureStream::deliver(const std::uint8_t *frames, std::size_t count) {
+  if (header_)
+    write_to_ring(frames, count);
+  else
+    write_to_socket(frames, count);
+}
+
+void CaptureStream::write_to_ring(const std::uint8_t *frames, std::size_t count) {
+  const std::size_t capacity = header_->capacity;
+  const auto write_position = header_->write_position.load(std::memory_order_relaxed);
+  const auto read_position = header_->read_position.load(std::memory_order_acquire);
+  // The client owns the read position, so don't trust it to stay sane.
+  const auto used = std::min<std::uint64_t>(write_position - read_position, capacity);
+  const auto n = std::min<std::size_t>(count, capacity - used);
+
+  const auto offset = static_cast<std::size_t>(write_position % capacity);
+  const auto first = std::min(n, capacity - offset);
+  std::memcpy(ring_frames_ + offset * frame_size_, frames, first * frame_size_);
+  std::memcpy(ring_frames_, frames + first * frame_size_, (n - first) * frame_size_);
+
+  // Pairs with the client setting reader_waiting before it checks the
+  // write position a last time, so one of the two always sees the other.
+  header_->write_position.store(write_position + n, std::memory_order_seq_cst);
+  if (n < count)
+    header_->dropped_frames.fetch_add(count - n, std::memory_order_relaxed);
+
+  if (header_->reader_waiting.exchange(0, std::memory_order_seq_cst)) {
+    const char wakeup = 0;
+    sender_->send_raw(&wakeup, sizeof(wakeup));
+  }
+}
+
+void CaptureStream::write_to_socket(const std::uint8_t *frames, std::size_t count) {
+  // The socket is non-blocking; whatever it doesn't take right away is
+  // dropped rather than stalling the runtime for a client not reading.
+  if (pending_size_ > 0) {
+    const auto sent = sender_->send_raw(reinterpret_cast<const char*>(pending_.data()), pending_size_);
+    if (sent > 0) {
+      pending_size_ -= static_cast<std::size_t>(sent);
+      std::memmove(pending_.data(), pending_.data() + sent, pending_size_);
+    }
+    if (pending_size_ > 0) {
+      dropped_frames_.fetch_add(count, std::memory_order_relaxed);
+      return;
+    }
+  }
+
+  const auto size = count * frame_size_;
+  auto sent = sender_->send_raw(reinterpret_cast<const char*>(frames), size);
+  if (sent < 0)
+    sent = 0;
+
+  const auto whole_frames = static_cast<std::size_t>(sent) / frame_size_;
+  const auto partial = static_cast<std::size_t>(sent) % frame_size_;
+  if (partial > 0) {
+    pending_size_ = frame_size_ - partial;
+    std::memcpy(pending_.data(), frames + sent, pending_size_);
+  }
+  const auto started_frames = whole_frames + (partial > 0 ? 1 : 0);
+  if (started_frames < count)
+    dropped_frames_.fetch_add(count - started_frames, std::memory_order_relaxed);
+}
+}
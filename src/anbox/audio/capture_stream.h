@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef ANBOX_AUDIO_CAPTURE_STREAM_H_
+#define ANBOX_AUDIO_CAPTURE_STREAM_H_
+
+#include "anbox/audio/capture_ring.h"
+#include "anbox/audio/client_info.h"
+#include "anbox/audio/source.h"
+#include "anbox/common/fd.h"
+#include "anbox/network/message_sender.h"
+#include "anbox/runtime.h"
+
+#include <boost/asio.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace anbox::audio {
+// Streams what a Source records to a recording client. Once per period
+// everything that became due since the last one is read from the source
+// in one batch. With shared memory the batch goes into a CaptureRing the
+// client maps and the socket only carries a wakeup if the client is
+// blocked waiting for data; otherwise the frames are written to the
+// socket as old clients expect.
+class CaptureStream : public std::enable_shared_from_this<CaptureStream> {
+ public:
+  typedef std::chrono::steady_clock Clock;
+
+  // Used for whatever a client doesn't ask for.
+  static constexpr std::chrono::milliseconds default_period{20};
+  static constexpr std::uint32_t default_period_count{4};
+  // Limits for what a client can ask for.
+  static constexpr std::chrono::milliseconds min_period{2};
+  static constexpr std::chrono::milliseconds max_period{500};
+  static constexpr std::uint32_t max_period_count{32};
+
+  // Returns the configuration closest to requested we support.
+  static CaptureConfig negotiate(const StreamFormat &format, const CaptureConfig &requested);
+
+  // Throws std::runtime_error if the shared memory can't be set up.
+  CaptureStream(const std::shared_ptr<Runtime> &rt,
+                const std::shared_ptr<Source> &source,
+                const std::shared_ptr<network::MessageSender> &sender,
+                const StreamFormat &format,
+                const CaptureConfig &config,
+                bool shared_memory);
+  ~CaptureStream();
+
+  // The memfd holding the ring which has to be passed to the client;
+  // invalid without shared memory.
+  Fd ring_fd() const { return ring_fd_; }
+
+  void start();
+  void stop();
+
+  // Frames thrown away because the client didn't keep up.
+  std::uint64_t dropped_frames() const;
+
+ private:
+  void arm_timer();
+  void on_timer(const boost::system::error_code &err);
+  void deliver(const std::uint8_t *frames, std::size_t count);
+  void write_to_ring(const std::uint8_t *frames, std::size_t count);
+  void write_to_socket(const std::uint8_t *frames, std::size_t count);
+
+  std::shared_ptr<Source> const source_;
+  std::shared_ptr<network::MessageSender> const sender_;
+  const StreamFormat format_;
+  const CaptureConfig config_;
+  const std::size_t frame_size_;
+  const std::chrono::microseconds period_;
+
+  std::mutex mutex_;
+  boost::asio::steady_timer timer_;
+  bool running_ = false;
+  Clock::time_point started_;
+  std::uint64_t ticks_ = 0;
+  std::uint64_t produced_ = 0;
+  std::vector<std::uint8_t> buffer_;
+
+  Fd ring_fd_;
+  void *mapping_ = nullptr;
+  std::size_t mapping_size_ = 0;
+  CaptureRingHeader *header_ = nullptr;
+  std::uint8_t *ring_frames_ = nullptr;
+
+  // Socket transport only: the rest of a frame the socket took only part
+  // of, which has to go out first to keep the stream aligned.
+  std::array<std::uint8_t, 32> pending_;
+  std::size_t pending_size_ = 0;
+  std::atomic<std::uint64_t> dropped_frames_{0};
+};
+}
+#endif
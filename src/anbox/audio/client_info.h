@@ -18,6 +18,7 @@
 #ifndef ANBOX_AUDIO_CLIENT_INFO_H_
 #define ANBOX_AUDIO_CLIENT_INFO_H_
 
+#include <cstddef>
 #include <cstdint>
 
 namespace anbox::audio {
@@ -27,7 +28,33 @@ struct ClientInfo {
     Recording = 1,
     Max = 2,
   };
+  // Set on top of the type by clients which send a StreamFormat right
+  // after the client info. The server then replies with the client info
+  // followed by the format it settled on. Clients without the flag get
+  // the fixed legacy format and only the client info as reply.
+  static constexpr std::uint8_t format_follows = 0x80;
   Type type;
 };
+
+struct StreamFormat {
+  enum class Sample : std::uint8_t {
+    S16 = 0,
+    F32 = 1,
+  };
+  std::uint32_t rate;
+  std::uint8_t channels;
+  Sample sample;
+  // Filled in by the server: how far behind the client the stream will be
+  // heard (or was recorded) in the worst case.
+  std::uint16_t latency_ms;
+};
+static_assert(sizeof(StreamFormat) == 8, "StreamFormat is sent as is over the wire");
+
+// What clients get when they don't ask for something else.
+constexpr StreamFormat default_stream_format{44100, 2, StreamFormat::Sample::S16, 0};
+
+inline std::size_t frame_size(const StreamFormat &format) {
+  return format.channels * (format.sample == StreamFormat::Sample::F32 ? 4 : 2);
+}
 }
 #endif
@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "anbox/audio/converter.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include <boost/throw_exception.hpp>
+
+namespace {
+constexpr std::uint32_t min_rate{8000};
+constexpr std::uint32_t max_rate{192000};
+constexpr std::uint8_t max_channels{8};
+
+void s16_to_float(const std::int16_t *in, std::size_t count, float *out) {
+  for (std::size_t n = 0; n < count; n++)
+    out[n] = in[n] * (1.0f / 32768.0f);
+}
+
+void float_to_s16(const float *in, std::size_t count, std::int16_t *out) {
+  for (std::size_t n = 0; n < count; n++)
+    out[n] = static_cast<std::int16_t>(std::min(std::max(in[n] * 32768.0f, -32768.0f), 32767.0f));
+}
+}
+
+namespace anbox::audio {
+Converter::Converter(const StreamFormat &input, const StreamFormat &output) :
+  input_(input),
+  output_(output),
+  step_((static_cast<std::uint64_t>(input.rate) << 32) / std::max<std::uint32_t>(output.rate, 1)),
+  samples_(output.channels),
+  position_(std::uint64_t{1} << 32) {
+  if (!supports(input_) || !supports(output_))
+    BOOST_THROW_EXCEPTION(std::invalid_argument("Unsupported audio format"));
+}
+
+bool Converter::supports(const StreamFormat &format) {
+  if (format.rate < min_rate || format.rate > max_rate)
+    return false;
+  if (format.channels == 0 || format.channels > max_channels)
+    return false;
+  switch (format.sample) {
+  case StreamFormat::Sample::S16:
+  case StreamFormat::Sample::F32:
+    return true;
+  default:
+    return false;
+  }
+}
+
+bool Converter::passthrough() const {
+  return input_.rate == output_.rate &&
+         input_.channels == output_.channels &&
+         input_.sample == output_.sample;
+}
+
+std::size_t Converter::max_output_frames(std::size_t count) const {
+  if (input_.rate == output_.rate)
+    return count;
+  return static_cast<std::size_t>((static_cast<std::uint64_t>(count) << 32) / step_ + 1);
+}
+
+std::size_t Converter::convert(const std::uint8_t *input, std::size_t count, std::uint8_t *output) {
+  if (passthrough()) {
+    std::memcpy(output, input, count * frame_size(input_));
+    return count;
+  }
+
+  const std::size_t channels = output_.channels;
+
+  if (input_.rate == output_.rate) {
+    samples_.resize(count * channels);
+    load(input, count, samples_.data());
+    store(samples_.data(), count, output);
+    return count;
+  }
+
+  // The first frame is the last one of the previous call, the new ones go
+  // behind it.
+  samples_.resize((count + 1) * channels);
+  load(input, count, samples_.data() + channels);
+  const auto frames = resample(count);
+  store(resampled_.data(), frames, output);
+  return frames;
+}
+
+void Converter::load(const std::uint8_t *input, std::size_t count, float *samples) {
+  const std::size_t in_channels = input_.channels;
+  const std::size_t out_channels = output_.channels;
+
+  float *unmapped = samples;
+  if (in_channels != out_channels) {
+    unmapped_.resize(count * in_channels);
+    unmapped = unmapped_.data();
+  }
+
+  if (input_.sample == StreamFormat::Sample::S16) {
+    s16_to_float(reinterpret_cast<const std::int16_t*>(input), count * in_channels, unmapped);
+  } else {
+    std::memcpy(unmapped, input, count * in_channels * sizeof(float));
+  }
+
+  if (in_channels == out_channels)
+    return;
+
+  if (in_channels == 1) {
+    for (std::size_t n = 0; n < count; n++)
+      for (std::size_t c = 0; c < out_channels; c++)
+        samples[n * out_channels + c] = unmapped[n];
+  } else if (out_channels == 1) {
+    const float scale = 1.0f / in_channels;
+    for (std::size_t n = 0; n < count; n++) {
+      float sum = 0.0f;
+      for (std::size_t c = 0; c < in_channels; c++)
+        sum += unmapped[n * in_channels + c];
+      samples[n] = sum * scale;
+    }
+  } else {
+    // Keep the channels both sides have in common and repeat them if the
+    // output has more.
+    for (std::size_t n = 0; n < count; n++)
+      for (std::size_t c = 0; c < out_channels; c++)
+        samples[n * out_channels + c] = unmapped[n * in_channels + c % in_channels];
+  }
+}
+
+void Converter::store(const float *samples, std::size_t count, std::uint8_t *output) const {
+  const auto total = count * output_.channels;
+  if (output_.sample == StreamFormat::Sample::S16)
+    float_to_s16(samples, total, reinterpret_cast<std::int16_t*>(output));
+  else
+    std::memcpy(output, samples, total * sizeof(float));
+}
+
+std::size_t Converter::resample(std::size_t count) {
+  const std::size_t channels = output_.channels;
+  const auto end = static_cast<std::uint64_t>(count) << 32;
+
+  std::size_t frames = 0;
+  if (position_ < end)
+    frames = static_cast<std::size_t>((end - position_ + step_ - 1) / step_);
+
+  resampled_.resize(frames * channels);
+  const float *in = samples_.data();
+  float *out = resampled_.data();
+
+  for (std::size_t n = 0; n < frames; n++) {
+    const auto position = position_ + n * step_;
+    const auto index = static_cast<std::size_t>(position >> 32) * channels;
+    const float t = static_cast<float>(position & 0xffffffff) * (1.0f / 4294967296.0f);
+    for (std::size_t c = 0; c < channels; c++) {
+      const float a = in[index + c];
+      const float b = in[index + channels + c];
+      out[n * channels + c] = a + (b - a) * t;
+    }
+  }
+
+  position_ = position_ + frames * step_ - end;
+  std::copy(samples_.begin() + count * channels,
+            samples_.begin() + (count + 1) * channels,
+            samples_.begin());
+  return frames;
+}
+}
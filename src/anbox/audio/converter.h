@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef ANBOX_AUDIO_CONVERTER_H_
+#define ANBOX_AUDIO_CONVERTER_H_
+
+#include "anbox/audio/client_info.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace anbox::audio {
+// Turns a stream of frames in one format into another: sample type,
+// channel count and rate. Rates are converted by linear interpolation with
+// a 32.32 fixed point phase which is carried across calls, so feeding the
+// stream in arbitrary chunks gives the same output as feeding it at once.
+// Sample type conversion and channel mapping run as straight loops over
+// contiguous buffers which the compiler turns into SIMD code.
+class Converter {
+ public:
+  // Throws std::invalid_argument if either format isn't supported.
+  Converter(const StreamFormat &input, const StreamFormat &output);
+
+  static bool supports(const StreamFormat &format);
+
+  const StreamFormat& input() const { return input_; }
+  const StreamFormat& output() const { return output_; }
+
+  // Whether convert() does anything but copy.
+  bool passthrough() const;
+
+  // Upper bound of the frames convert() produces from count input frames.
+  std::size_t max_output_frames(std::size_t count) const;
+
+  // Converts count frames from input into output, which has to have room
+  // for max_output_frames(count) frames. Returns the number of frames
+  // written.
+  std::size_t convert(const std::uint8_t *input, std::size_t count, std::uint8_t *output);
+
+ private:
+  void load(const std::uint8_t *input, std::size_t count, float *samples);
+  void store(const float *samples, std::size_t count, std::uint8_t *output) const;
+  std::size_t resample(std::size_t count);
+
+  const StreamFormat input_;
+  const StreamFormat output_;
+  const std::uint64_t step_;
+
+  // Input frames, already mapped to the output channel layout, with the
+  // last frame of the previous call in front.
+  std::vector<float> samples_;
+  std::vector<float> resampled_;
+  std::vector<float> unmapped_;
+  // Position of the next output frame in samples_.
+  std::uint64_t position_;
+};
+}
+#endif
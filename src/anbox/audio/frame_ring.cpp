@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "anbox/audio/frame_ring.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include <boost/throw_exception.hpp>
+
+namespace anbox::audio {
+FrameRing::FrameRing(std::size_t frame_size, std::size_t capacity) :
+  frame_size_(frame_size),
+  capacity_(capacity),
+  data_(frame_size * capacity) {
+  if (frame_size_ == 0 || capacity_ == 0)
+    BOOST_THROW_EXCEPTION(std::invalid_argument("Frame ring needs a non-zero frame size and capacity"));
+}
+
+std::size_t FrameRing::size() const {
+  const auto read_position = read_position_.load(std::memory_order_acquire);
+  const auto write_position = write_position_.load(std::memory_order_acquire);
+  return static_cast<std::size_t>(write_position - read_position);
+}
+
+std::size_t FrameRing::write(const std::uint8_t *frames, std::size_t count) {
+  const auto write_position = write_position_.load(std::memory_order_relaxed);
+  const auto read_position = read_position_.load(std::memory_order_acquire);
+  const auto free = capacity_ - static_cast<std::size_t>(write_position - read_position);
+  count = std::min(count, free);
+  if (count == 0)
+    return 0;
+
+  const auto offset = static_cast<std::size_t>(write_position % capacity_);
+  const auto first = std::min(count, capacity_ - offset);
+  std::memcpy(data_.data() + offset * frame_size_, frames, first * frame_size_);
+  std::memcpy(data_.data(), frames + first * frame_size_, (count - first) * frame_size_);
+
+  write_position_.store(write_position + count, std::memory_order_release);
+  return count;
+}
+
+void FrameRing::drop(std::size_t count) {
+  if (count == 0)
+    return;
+  overruns_.fetch_add(1, std::memory_order_relaxed);
+  dropped_frames_.fetch_add(count, std::memory_order_relaxed);
+}
+
+std::size_t FrameRing::read(std::uint8_t *frames, std::size_t count) {
+  const auto read_position = read_position_.load(std::memory_order_relaxed);
+  const auto write_position = write_position_.load(std::memory_order_acquire);
+  const auto available = static_cast<std::size_t>(write_position - read_position);
+  const auto n = std::min(count, available);
+
+  const auto offset = static_cast<std::size_t>(read_position % capacity_);
+  const auto first = std::min(n, capacity_ - offset);
+  std::memcpy(frames, data_.data() + offset * frame_size_, first * frame_size_);
+  std::memcpy(frames + first * frame_size_, data_.data(), (n - first) * frame_size_);
+
+  if (n > 0)
+    read_position_.store(read_position + n, std::memory_order_release);
+
+  if (n < count) {
+    std::memset(frames + n * frame_size_, 0, (count - n) * frame_size_);
+    underruns_.fetch_add(1, std::memory_order_relaxed);
+    silent_frames_.fetch_add(count - n, std::memory_order_relaxed);
+  }
+
+  return n;
+}
+
+FrameRing::Stats FrameRing::stats() const {
+  return Stats{
+    overruns_.load(std::memory_order_relaxed),
+    dropped_frames_.load(std::memory_order_relaxed),
+    underruns_.load(std::memory_order_relaxed),
+    silent_frames_.load(std::memory_order_relaxed),
+  };
+}
+}
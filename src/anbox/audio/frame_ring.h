@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef ANBOX_AUDIO_FRAME_RING_H_
+#define ANBOX_AUDIO_FRAME_RING_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace anbox::audio {
+// Fixed size ring of audio frames between exactly one producer and one
+// consumer. Each side only ever moves its own position and reads the other
+// one, so the audio callback never has to wait for the thread feeding it.
+// Frames which don't fit (overruns) and frames the consumer asked for but
+// didn't get (underruns) are counted so glitches can be told apart from
+// latency.
+class FrameRing {
+ public:
+  struct Stats {
+    // Number of times the producer gave up on frames because the ring was
+    // full and how many frames it dropped doing so.
+    std::uint64_t overruns;
+    std::uint64_t dropped_frames;
+    // Number of reads which came up short and how many frames of silence
+    // were played instead.
+    std::uint64_t underruns;
+    std::uint64_t silent_frames;
+  };
+
+  FrameRing(std::size_t frame_size, std::size_t capacity);
+  FrameRing(const FrameRing&) = delete;
+  FrameRing& operator=(const FrameRing&) = delete;
+
+  std::size_t frame_size() const { return frame_size_; }
+  std::size_t capacity() const { return capacity_; }
+
+  // Number of frames queued right now. Exact when called from either side,
+  // a snapshot otherwise.
+  std::size_t size() const;
+
+  // Producer side. Copies as many of count frames as fit and returns how
+  // many that were.
+  std::size_t write(const std::uint8_t *frames, std::size_t count);
+  // Records that count frames were thrown away because they didn't fit.
+  void drop(std::size_t count);
+
+  // Consumer side. Copies up to count frames and fills whatever is missing
+  // with silence (all bits zero, which is silence for every format we
+  // use). A short read is counted as an underrun. Returns the number of
+  // frames which came from the ring.
+  std::size_t read(std::uint8_t *frames, std::size_t count);
+
+  Stats stats() const;
+
+ private:
+  const std::size_t frame_size_;
+  const std::size_t capacity_;
+  std::vector<std::uint8_t> data_;
+
+  // Both positions count frames since the ring was created and only ever
+  // grow; they sit on their own cache lines so the two sides don't keep
+  // stealing the line from each other.
+  alignas(64) std::atomic<std::uint64_t> write_position_{0};
+  std::atomic<std::uint64_t> overruns_{0};
+  std::atomic<std::uint64_t> dropped_frames_{0};
+
+  alignas(64) std::atomic<std::uint64_t> read_position_{0};
+  std::atomic<std::uint64_t> underruns_{0};
+  std::atomic<std::uint64_t> silent_frames_{0};
+};
+}
+#endif
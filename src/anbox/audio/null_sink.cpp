@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "anbox/audio/null_sink.h"
+
+#include <thread>
+
+namespace anbox::audio {
+constexpr std::chrono::milliseconds NullSink::max_latency;
+
+NullSink::NullSink() : format_(default_stream_format) {}
+
+std::uint16_t NullSink::set_format(const StreamFormat &format) {
+  format_ = format;
+  return static_cast<std::uint16_t>(max_latency.count());
+}
+
+void NullSink::write_data(const std::uint8_t *data, std::size_t size) {
+  (void) data;
+
+  const auto now = std::chrono::steady_clock::now();
+  // After a pause the client starts over instead of getting the time it
+  // was silent for as credit.
+  const auto played = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::microseconds(frames_ * 1000000 / format_.rate));
+  if (frames_ == 0 || start_ + played < now) {
+    start_ = now;
+    frames_ = 0;
+  }
+
+  frames_ += size / frame_size(format_);
+
+  const auto written = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::microseconds(frames_ * 1000000 / format_.rate));
+  const auto ahead = start_ + written - now;
+  if (ahead > max_latency)
+    std::this_thread::sleep_for(ahead - max_latency);
+}
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef ANBOX_AUDIO_NULL_SINK_H_
+#define ANBOX_AUDIO_NULL_SINK_H_
+
+#include "anbox/audio/sink.h"
+
+#include <chrono>
+
+namespace anbox::audio {
+// Discards everything it gets but consumes it at the rate a real device
+// would. Clients which time their playback by the socket (and the guest's
+// audio clock) then see the same behaviour as with speakers attached.
+class NullSink : public Sink {
+ public:
+  // How far a client may run ahead of the wall clock before writes block.
+  static constexpr std::chrono::milliseconds max_latency{40};
+
+  NullSink();
+
+  std::uint16_t set_format(const StreamFormat &format) override;
+  void write_data(const std::uint8_t *data, std::size_t size) override;
+
+ private:
+  StreamFormat format_;
+  std::chrono::steady_clock::time_point start_;
+  // Frames consumed since start_.
+  std::uint64_t frames_ = 0;
+};
+}
+#endif
@@ -16,11 +16,16 @@
  */
 
 #include "anbox/audio/server.h"
+#include "anbox/audio/capture_stream.h"
+#include "anbox/audio/converter.h"
 #include "anbox/audio/sink.h"
+#include "anbox/audio/tone_source.h"
+#include "anbox/audio/wav_file_source.h"
 #include "anbox/network/published_socket_connector.h"
 #include "anbox/network/delegate_connection_creator.h"
 #include "anbox/network/local_socket_messenger.h"
 #include "anbox/network/message_processor.h"
+#include "anbox/network/fd_socket_transmission.h"
 #include "anbox/common/type_traits.h"
 #include "anbox/system_configuration.h"
 #include "anbox/utils.h"
@@ -29,25 +34,53 @@
 using namespace std::placeholders;
 
 namespace {
+// What recording clients which don't negotiate have always been sent.
+constexpr anbox::audio::StreamFormat legacy_recording_format{8000, 1, anbox::audio::StreamFormat::Sample::S16, 0};
+const std::string tone_source_prefix{"tone"};
+
 class AudioForwarder : public anbox::network::MessageProcessor {
  public:
   AudioForwarder(const std::shared_ptr<anbox::audio::Sink> &sink) :
     sink_(sink) {
   }
 
-  bool process_data(const std::vector<std::uint8_t> &data) override {
-    sink_->write_data(data);
+  bool process_data(anbox::network::ReceiveBuffer &&buffer) override {
+    sink_->write_data(buffer.data(), buffer.size());
     return true;
   }
 
  private:
   std::shared_ptr<anbox::audio::Sink> sink_;
 };
+
+// Recording clients don't send anything after the handshake; the
+// connection is only kept to notice when they go away.
+class CaptureProcessor : public anbox::network::MessageProcessor {
+ public:
+  CaptureProcessor(const std::shared_ptr<anbox::audio::CaptureStream> &stream) :
+    stream_(stream) {
+  }
+
+  ~CaptureProcessor() {
+    stream_->stop();
+  }
+
+  bool process_data(anbox::network::ReceiveBuffer &&buffer) override {
+    (void) buffer;
+    return true;
+  }
+
+ private:
+  std::shared_ptr<anbox::audio::CaptureStream> stream_;
+};
 }
 
 namespace anbox::audio {
-Server::Server(const std::shared_ptr<Runtime>& rt, const std::shared_ptr<platform::BasePlatform> &platform) :
+Server::Server(const std::shared_ptr<Runtime>& rt, const std::shared_ptr<platform::BasePlatform> &platform,
+               const std::string &capture_source) :
+  rt_(rt),
   platform_(platform),
+  capture_source_(capture_source),
   socket_file_(utils::string_format("%s/anbox_audio", SystemConfiguration::instance().socket_dir())),
   connector_(std::make_shared<network::PublishedSocketConnector>(
              socket_file_, rt,
@@ -76,29 +109,124 @@ void Server::create_connection_for(std::shared_ptr<boost::asio::basic_stream_soc
     return;
   }
 
-  std::shared_ptr<network::MessageProcessor> processor;
+  const auto raw_type = static_cast<std::uint8_t>(client_info.type);
+  const bool negotiate = (raw_type & ClientInfo::format_follows) != 0;
+  const auto type = static_cast<ClientInfo::Type>(raw_type & ~ClientInfo::format_follows);
+
+  StreamFormat format = default_stream_format;
+  if (negotiate) {
+    err = messenger->receive_msg(boost::asio::buffer(&format, sizeof(StreamFormat)));
+    if (err) {
+      ERROR("Failed to read stream format: %s", err.message());
+      return;
+    }
+    // Anything we can't convert is answered with the default format,
+    // which the client then has to use instead.
+    if (!Converter::supports(format))
+      format = default_stream_format;
+    format.latency_ms = 0;
+  }
 
-  switch (client_info.type) {
-  case ClientInfo::Type::Playback:
-    processor = std::make_shared<AudioForwarder>(platform_->create_audio_sink());
+  std::shared_ptr<network::MessageProcessor> processor;
+  std::shared_ptr<CaptureStream> capture;
+  CaptureConfig capture_config{0, 0};
+
+  switch (type) {
+  case ClientInfo::Type::Playback: {
+    auto sink = platform_->create_audio_sink();
+    if (!sink) {
+      ERROR("Platform has no audio output, rejecting playback client");
+      return;
+    }
+    // Sinks convert from whatever the client wants to play, so what the
+    // client asked for is what it gets.
+    format.latency_ms = sink->set_format(format);
+    processor = std::make_shared<AudioForwarder>(sink);
     break;
-  case ClientInfo::Type::Recording:
+  }
+  case ClientInfo::Type::Recording: {
+    auto source = create_source();
+    if (!source) {
+      ERROR("No audio source available, rejecting recording client");
+      return;
+    }
+
+    CaptureConfig config{0, 0};
+    if (negotiate) {
+      err = messenger->receive_msg(boost::asio::buffer(&config, sizeof(CaptureConfig)));
+      if (err) {
+        ERROR("Failed to read capture config: %s", err.message());
+        return;
+      }
+    } else {
+      format = legacy_recording_format;
+    }
+    config = CaptureStream::negotiate(format, config);
+    format.latency_ms = static_cast<std::uint16_t>(
+        std::uint64_t{config.period_frames} * config.period_count * 1000 / format.rate);
+
+    try {
+      capture = std::make_shared<CaptureStream>(rt_, source, messenger, format, config, negotiate);
+    } catch (const std::exception &err) {
+      ERROR("Failed to set up audio capture: %s", err.what());
+      return;
+    }
+    processor = std::make_shared<CaptureProcessor>(capture);
+
+    // Sent along with the rest of the reply below.
+    capture_config = config;
     break;
+  }
   default:
-    ERROR("Invalid client type %d", static_cast<int>(client_info.type));
+    ERROR("Invalid client type %d", static_cast<int>(type));
     return;
   }
 
   // Everything ok, so approve the client by sending the requesting client
-  // info back. Once we have more things to negotiate we will send a modified
-  // client info struct back.
+  // info back, followed by the format we settled on if the client asked
+  // for one. Recording clients then get the capture config and the shared
+  // memory holding the capture ring.
   messenger->send(reinterpret_cast<char*>(&client_info), sizeof(client_info));
+  if (negotiate) {
+    messenger->send(reinterpret_cast<char*>(&format), sizeof(format));
+    if (capture) {
+      messenger->send(reinterpret_cast<char*>(&capture_config), sizeof(capture_config));
+      try {
+        send_fds(Fd{IntOwnedFd{socket->native_handle()}}, {capture->ring_fd()});
+      } catch (const std::exception &err) {
+        ERROR("Failed to pass capture ring to client: %s", err.what());
+        return;
+      }
+    }
+  }
 
   auto connection = std::make_shared<network::SocketConnection>(
         messenger, messenger, next_id(), connections_, processor);
   connections_->add(connection);
 
   connection->read_next_message();
+
+  if (capture)
+    capture->start();
+}
+
+std::shared_ptr<Source> Server::create_source() {
+  if (capture_source_.empty())
+    return platform_->create_audio_source();
+
+  try {
+    if (capture_source_.compare(0, tone_source_prefix.size(), tone_source_prefix) == 0) {
+      auto frequency = ToneSource::default_frequency;
+      if (capture_source_.size() > tone_source_prefix.size() + 1 &&
+          capture_source_[tone_source_prefix.size()] == ':')
+        frequency = std::stod(capture_source_.substr(tone_source_prefix.size() + 1));
+      return std::make_shared<ToneSource>(frequency);
+    }
+    return std::make_shared<WavFileSource>(capture_source_);
+  } catch (const std::exception &err) {
+    ERROR("Failed to create audio source '%s': %s", capture_source_, err.what());
+  }
+  return nullptr;
 }
 
 int Server::next_id() {
@@ -20,6 +20,7 @@
 
 #include "anbox/runtime.h"
 #include "anbox/audio/client_info.h"
+#include "anbox/audio/source.h"
 #include "anbox/network/socket_messenger.h"
 #include "anbox/network/socket_connection.h"
 #include "anbox/platform/base_platform.h"
@@ -33,7 +34,11 @@ namespace anbox::network {
 namespace anbox::audio {
 class Server {
  public:
-  Server(const std::shared_ptr<Runtime>& rt, const std::shared_ptr<platform::BasePlatform> &platform);
+  // capture_source selects what recording clients get: empty for the
+  // platform's source, "tone" or "tone:<frequency>" for a sine tone or the
+  // path of a WAV file.
+  Server(const std::shared_ptr<Runtime>& rt, const std::shared_ptr<platform::BasePlatform> &platform,
+         const std::string &capture_source = "");
   ~Server();
 
   std::string socket_file() const { return socket_file_; }
@@ -42,9 +47,12 @@ class Server {
   void create_connection_for(std::shared_ptr<boost::asio::basic_stream_socket<
                              boost::asio::local::stream_protocol>> const& socket);
 
+  std::shared_ptr<Source> create_source();
   int next_id();
 
+  std::shared_ptr<Runtime> rt_;
   std::shared_ptr<platform::BasePlatform> platform_;
+  std::string capture_source_;
   std::string socket_file_;
   std::shared_ptr<network::PublishedSocketConnector> connector_;
   std::shared_ptr<network::Connections<network::SocketConnection>> const connections_;
@@ -18,15 +18,19 @@
 #ifndef ANBOX_AUDIO_SINK_H_
 #define ANBOX_AUDIO_SINK_H_
 
-#include <cstdint>
+#include "anbox/audio/client_info.h"
 
-#include <vector>
+#include <cstddef>
+#include <cstdint>
 
 namespace anbox::audio {
 class Sink {
  public:
   virtual ~Sink() {}
-  virtual void write_data(const std::vector<std::uint8_t> &data) = 0;
+  // Called before the first write_data() with the format the data will
+  // come in. Returns the latency the sink adds in milliseconds.
+  virtual std::uint16_t set_format(const StreamFormat &format) { (void) format; return 0; }
+  virtual void write_data(const std::uint8_t *data, std::size_t size) = 0;
 };
 }
 #endif
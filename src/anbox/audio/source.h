@@ -18,6 +18,8 @@
 #ifndef ANBOX_AUDIO_SOURCE_H_
 #define ANBOX_AUDIO_SOURCE_H_
 
+#include "anbox/audio/client_info.h"
+
 #include <cstdint>
 
 #include <vector>
@@ -27,6 +29,12 @@ class Source {
  public:
   virtual ~Source() {}
 
+  // Called before the first read_data() with the format the client wants
+  // the data in.
+  virtual void set_format(const StreamFormat &format) = 0;
+  // Fills data, which holds a whole number of frames, with the next frames
+  // of audio. Called from the runtime, so it must not block; a source
+  // which has nothing yet fills in silence.
   virtual void read_data(std::vector<std::uint8_t> &data) = 0;
 };
 }
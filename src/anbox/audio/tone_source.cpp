@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "anbox/audio/tone_source.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace anbox::audio {
+constexpr double ToneSource::default_frequency;
+constexpr double ToneSource::default_amplitude;
+
+ToneSource::ToneSource(double frequency, double amplitude) :
+  frequency_(frequency),
+  amplitude_(amplitude),
+  format_(default_stream_format) {
+}
+
+void ToneSource::set_format(const StreamFormat &format) {
+  format_ = format;
+}
+
+void ToneSource::read_data(std::vector<std::uint8_t> &data) {
+  const auto channels = format_.channels;
+  const auto frames = data.size() / frame_size(format_);
+  const auto step = 2.0 * M_PI * frequency_ / format_.rate;
+
+  for (std::size_t n = 0; n < frames; n++) {
+    const auto value = amplitude_ * std::sin(phase_);
+    phase_ = std::fmod(phase_ + step, 2.0 * M_PI);
+
+    for (std::size_t c = 0; c < channels; c++) {
+      const auto index = n * channels + c;
+      if (format_.sample == StreamFormat::Sample::F32) {
+        const auto sample = static_cast<float>(value);
+        std::memcpy(data.data() + index * sizeof(float), &sample, sizeof(float));
+      } else {
+        const auto sample = static_cast<std::int16_t>(std::lrint(value * 32767.0));
+        std::memcpy(data.data() + index * sizeof(std::int16_t), &sample, sizeof(std::int16_t));
+      }
+    }
+  }
+}
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef ANBOX_AUDIO_TONE_SOURCE_H_
+#define ANBOX_AUDIO_TONE_SOURCE_H_
+
+#include "anbox/audio/source.h"
+
+namespace anbox::audio {
+// Produces a sine tone on all channels. Stands in for a microphone where
+// there is none, e.g. to test recording apps on headless hosts.
+class ToneSource : public Source {
+ public:
+  static constexpr double default_frequency{440.0};
+  static constexpr double default_amplitude{0.25};
+
+  explicit ToneSource(double frequency = default_frequency, double amplitude = default_amplitude);
+
+  void set_format(const StreamFormat &format) override;
+  void read_data(std::vector<std::uint8_t> &data) override;
+
+ private:
+  const double frequency_;
+  const double amplitude_;
+  StreamFormat format_;
+  // Current position in the wave in radians; kept between reads so the
+  // tone has no seams.
+  double phase_ = 0.0;
+};
+}
+#endif
@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "anbox/audio/wav_file_source.h"
+#include "anbox/utils.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#include <boost/throw_exception.hpp>
+
+namespace {
+// File frames converted at a time.
+constexpr std::size_t chunk_frames{1024};
+
+constexpr std::uint16_t format_pcm{1};
+constexpr std::uint16_t format_float{3};
+constexpr std::uint16_t format_extensible{0xfffe};
+
+std::uint16_t read_u16(const std::uint8_t *data) {
+  return static_cast<std::uint16_t>(data[0] | (data[1] << 8));
+}
+
+std::uint32_t read_u32(const std::uint8_t *data) {
+  return static_cast<std::uint32_t>(data[0]) | (static_cast<std::uint32_t>(data[1]) << 8) |
+         (static_cast<std::uint32_t>(data[2]) << 16) | (static_cast<std::uint32_t>(data[3]) << 24);
+}
+
+[[noreturn]] void invalid_file(const std::string &path, const std::string &reason) {
+  BOOST_THROW_EXCEPTION(std::runtime_error(
+      anbox::utils::string_format("Can't use %s as audio source: %s", path, reason)));
+}
+}
+
+namespace anbox::audio {
+WavFileSource::WavFileSource(const std::string &path) {
+  std::ifstream file(path, std::ifstream::binary);
+  if (!file)
+    invalid_file(path, "failed to open file");
+  const std::vector<std::uint8_t> content{std::istreambuf_iterator<char>(file),
+                                          std::istreambuf_iterator<char>()};
+
+  if (content.size() < 12 || std::memcmp(content.data(), "RIFF", 4) != 0 ||
+      std::memcmp(content.data() + 8, "WAVE", 4) != 0)
+    invalid_file(path, "not a WAV file");
+
+  bool have_format = false;
+  std::uint16_t bits = 0;
+  const std::uint8_t *data = nullptr;
+  std::size_t data_size = 0;
+
+  std::size_t offset = 12;
+  while (offset + 8 <= content.size()) {
+    const auto chunk = content.data() + offset;
+    const auto size = std::min<std::size_t>(read_u32(chunk + 4), content.size() - offset - 8);
+    const auto body = chunk + 8;
+
+    if (std::memcmp(chunk, "fmt ", 4) == 0) {
+      if (size < 16)
+        invalid_file(path, "truncated format chunk");
+      auto tag = read_u16(body);
+      if (tag == format_extensible && size >= 26)
+        tag = read_u16(body + 24);
+      bits = read_u16(body + 14);
+
+      if (tag == format_pcm && bits == 16)
+        file_format_.sample = StreamFormat::Sample::S16;
+      else if (tag == format_float && bits == 32)
+        file_format_.sample = StreamFormat::Sample::F32;
+      else
+        invalid_file(path, "only 16 bit integer and 32 bit float samples are supported");
+
+      file_format_.channels = static_cast<std::uint8_t>(std::min<std::uint16_t>(read_u16(body + 2), 0xff));
+      file_format_.rate = read_u32(body + 4);
+      file_format_.latency_ms = 0;
+      have_format = true;
+    } else if (std::memcmp(chunk, "data", 4) == 0) {
+      data = body;
+      data_size = size;
+    }
+
+    // Chunks are padded to an even size.
+    offset += 8 + size + (size & 1);
+  }
+
+  if (!have_format || !data)
+    invalid_file(path, "format or data chunk missing");
+  if (!Converter::supports(file_format_))
+    invalid_file(path, "unsupported sample rate or channel count");
+
+  frame_count_ = data_size / frame_size(file_format_);
+  if (frame_count_ == 0)
+    invalid_file(path, "no audio data");
+
+  samples_.assign(data, data + frame_count_ * frame_size(file_format_));
+  format_ = file_format_;
+  converter_ = std::make_unique<Converter>(file_format_, format_);
+}
+
+void WavFileSource::set_format(const StreamFormat &format) {
+  format_ = format;
+  converter_ = std::make_unique<Converter>(file_format_, format_);
+  converted_.clear();
+  converted_offset_ = 0;
+}
+
+void WavFileSource::read_data(std::vector<std::uint8_t> &data) {
+  const auto in_frame_size = frame_size(file_format_);
+  const auto out_frame_size = frame_size(format_);
+  const auto wanted = data.size() / out_frame_size * out_frame_size;
+
+  std::size_t filled = 0;
+  while (filled < wanted) {
+    if (converted_offset_ == converted_.size()) {
+      const auto count = std::min(chunk_frames, frame_count_ - position_);
+      converted_.resize(converter_->max_output_frames(count) * out_frame_size);
+      const auto frames = converter_->convert(samples_.data() + position_ * in_frame_size, count, converted_.data());
+      converted_.resize(frames * out_frame_size);
+      converted_offset_ = 0;
+      position_ = (position_ + count) % frame_count_;
+      continue;
+    }
+
+    const auto n = std::min(wanted - filled, converted_.size() - converted_offset_);
+    std::memcpy(data.data() + filled, converted_.data() + converted_offset_, n);
+    filled += n;
+    converted_offset_ += n;
+  }
+}
+}
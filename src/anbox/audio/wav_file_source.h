@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef ANBOX_AUDIO_WAV_FILE_SOURCE_H_
+#define ANBOX_AUDIO_WAV_FILE_SOURCE_H_
+
+#include "anbox/audio/converter.h"
+#include "anbox/audio/source.h"
+
+#include <memory>
+#include <string>
+
+namespace anbox::audio {
+// Plays a WAV file in a loop as if it was recorded, converted to whatever
+// the client asks for. Makes it possible to test recording apps, e.g.
+// voice recognition, with known input.
+class WavFileSource : public Source {
+ public:
+  // Loads the whole file; throws std::runtime_error unless it holds 16 bit
+  // integer or 32 bit float PCM.
+  explicit WavFileSource(const std::string &path);
+
+  const StreamFormat& file_format() const { return file_format_; }
+
+  void set_format(const StreamFormat &format) override;
+  void read_data(std::vector<std::uint8_t> &data) override;
+
+ private:
+  StreamFormat file_format_;
+  std::vector<std::uint8_t> samples_;
+  std::size_t frame_count_ = 0;
+  // Next file frame to convert.
+  std::size_t position_ = 0;
+
+  StreamFormat format_;
+  std::unique_ptr<Converter> converter_;
+  // Converted frames not handed out yet.
+  std::vector<std::uint8_t> converted_;
+  std::size_t converted_offset_ = 0;
+};
+}
+#endif
@@ -26,46 +26,116 @@
 #include "anbox_rpc.pb.h"
 
 #include <boost/filesystem.hpp>
-#ifdef USE_PROTOBUF_CALLBACK_HEADER
-#include <google/protobuf/stubs/callback.h>
-#endif
 
 
+#include <atomic>
+#include <future>
+
 namespace fs = boost::filesystem;
 
 namespace {
 constexpr const std::chrono::milliseconds default_rpc_call_timeout{30000};
+
+// Shared between a call and its deadline which may expire before the
+// call has been sent and its id is known.
+struct PendingCall {
+  std::uint32_t id = 0;
+  std::atomic<bool> sent{false};
+  std::atomic<bool> expired{false};
+};
 } // namespace
 
 namespace anbox::bridge {
-AndroidApiStub::AndroidApiStub() {}
+AndroidApiStub::AndroidApiStub(const std::shared_ptr<Runtime> &rt) : rt_(rt) {}
 
 AndroidApiStub::~AndroidApiStub() {}
 
 void AndroidApiStub::set_rpc_channel(
     const std::shared_ptr<rpc::Channel> &channel) {
+  std::lock_guard<decltype(mutex_)> lock(mutex_);
   channel_ = channel;
 }
 
-void AndroidApiStub::reset_rpc_channel() { channel_.reset(); }
-
-void AndroidApiStub::ensure_rpc_channel() {
-  if (!channel_) throw std::runtime_error("No remote client connected");
+void AndroidApiStub::reset_rpc_channel() {
+  std::lock_guard<decltype(mutex_)> lock(mutex_);
+  channel_.reset();
 }
 
-void AndroidApiStub::launch(const android::Intent &intent,
-                            const graphics::Rect &launch_bounds,
-                            const wm::Stack::Id &stack) {
-  ensure_rpc_channel();
-
-  auto c = std::make_shared<Request<protobuf::rpc::Void>>();
-  protobuf::bridge::LaunchApplication message;
-
+void AndroidApiStub::call_async(const std::string &method_name,
+                                const google::protobuf::MessageLite &message,
+                                const Completion &done) {
+  std::shared_ptr<rpc::Channel> channel;
   {
     std::lock_guard<decltype(mutex_)> lock(mutex_);
-    launch_wait_handle_.expect_result();
+    channel = channel_;
   }
 
+  if (!channel) {
+    done("No remote client connected");
+    return;
+  }
+
+  // Every call gets its own deadline so a slow call doesn't hold up any
+  // of the others in flight. The deadline is armed before the call is sent
+  // as its reply can arrive on another runtime thread right away and the
+  // timer must not be cancelled while it is still being set up.
+  auto response = std::make_shared<protobuf::rpc::Void>();
+  auto deadline = std::make_shared<boost::asio::steady_timer>(rt_->service());
+  auto call = std::make_shared<PendingCall>();
+
+  std::weak_ptr<rpc::Channel> weak_channel = channel;
+  deadline->expires_from_now(default_rpc_call_timeout);
+  deadline->async_wait([weak_channel, call](const boost::system::error_code &err) {
+    if (err) return;
+    call->expired = true;
+    if (!call->sent) return;
+    if (auto channel = weak_channel.lock())
+      channel->cancel_call(call->id, rpc::CallStatus::timed_out);
+  });
+
+  call->id = channel->call_method_async(
+      method_name, &message, response.get(),
+      [response, deadline, done](rpc::CallStatus status) {
+        deadline->cancel();
+        switch (status) {
+        case rpc::CallStatus::timed_out:
+          done("RPC call timed out");
+          break;
+        case rpc::CallStatus::disconnected:
+          done("Remote client disconnected");
+          break;
+        default:
+          done(response->has_error() ? response->error() : "");
+          break;
+        }
+      });
+  call->sent = true;
+
+  // Sending took longer than the deadline so the timer couldn't end it.
+  if (call->expired)
+    channel->cancel_call(call->id, rpc::CallStatus::timed_out);
+}
+
+void AndroidApiStub::wait_for(const std::function<void(const Completion &)> &call) {
+  auto result = std::make_shared<std::promise<std::string>>();
+  auto finished = result->get_future();
+  call([result](const std::string &error) { result->set_value(error); });
+
+  // The call's deadline completes it but that relies on the runtime to
+  // run, so don't wait forever if it doesn't.
+  if (finished.wait_for(default_rpc_call_timeout + std::chrono::seconds(1)) != std::future_status::ready)
+    throw std::runtime_error("RPC call timed out");
+
+  const auto message = finished.get();
+  if (!message.empty()) throw std::runtime_error(message);
+}
+
+void AndroidApiStub::launch_async(const android::Intent &intent,
+                                  const graphics::Rect &launch_bounds,
+                                  const wm::Stack::Id &stack,
+                                  const LaunchCallback &done) {
+  protobuf::bridge::LaunchApplication message;
+
   switch (stack) {
   case wm::Stack::Id::Default:
     message.set_stack(::anbox::protobuf::bridge::LaunchApplication_Stack_DEFAULT);
@@ -82,10 +152,10 @@ void AndroidApiStub::launch(const android::Intent &intent,
 
   if (launch_bounds != graphics::Rect::Invalid) {
     auto rect = message.mutable_launch_bounds();
-    rect->set_left(launch_bounds_.left());
-    rect->set_top(launch_bounds_.top());
-    rect->set_right(launch_bounds_.right());
-    rect->set_bottom(launch_bounds_.bottom());
+    rect->set_left(launch_bounds.left());
+    rect->set_top(launch_bounds.top());
+    rect->set_right(launch_bounds.right());
+    rect->set_bottom(launch_bounds.bottom());
   }
 
   auto launch_intent = message.mutable_intent();
@@ -105,93 +175,47 @@ void AndroidApiStub::launch(const android::Intent &intent,
     *c = category;
   }
 
-  channel_->call_method(
-      "launch_application", &message, c->response.get(),
-      google::protobuf::NewCallback(this, &AndroidApiStub::application_launched,
-                                    c.get()));
-
-  launch_wait_handle_.wait_for_pending(default_rpc_call_timeout);
-  if (!launch_wait_handle_.has_result())
-    throw std::runtime_error("RPC call timed out");
+  call_async("launch_application", message, done);
+}
 
-  if (c->response->has_error()) throw std::runtime_error(c->response->error());
+void AndroidApiStub::launch(const android::Intent &intent,
+                            const graphics::Rect &launch_bounds,
+                            const wm::Stack::Id &stack) {
+  wait_for([&](const Completion &done) {
+    launch_async(intent, launch_bounds, stack, done);
+  });
 }
 
 core::Property<bool>& AndroidApiStub::ready() {
   return ready_;
 }
 
-void AndroidApiStub::application_launched(
-    Request<protobuf::rpc::Void> *request) {
-  (void)request;
-  launch_wait_handle_.result_received();
-}
-
-void AndroidApiStub::set_focused_task(const std::int32_t &id) {
-  ensure_rpc_channel();
-
-  auto c = std::make_shared<Request<protobuf::rpc::Void>>();
-
+void AndroidApiStub::set_focused_task_async(const std::int32_t &id,
+                                            const Completion &done) {
   protobuf::bridge::SetFocusedTask message;
   message.set_id(id);
-
-  {
-    std::lock_guard<decltype(mutex_)> lock(mutex_);
-    set_focused_task_handle_.expect_result();
-  }
-
-  channel_->call_method("set_focused_task", &message, c->response.get(),
-                        google::protobuf::NewCallback(
-                            this, &AndroidApiStub::focused_task_set, c.get()));
-
-  set_focused_task_handle_.wait_for_pending(default_rpc_call_timeout);
-  if (!set_focused_task_handle_.has_result())
-    throw std::runtime_error("RPC call timed out");
-
-  if (c->response->has_error()) throw std::runtime_error(c->response->error());
+  call_async("set_focused_task", message, done);
 }
 
-void AndroidApiStub::focused_task_set(Request<protobuf::rpc::Void> *request) {
-  (void)request;
-  set_focused_task_handle_.result_received();
+void AndroidApiStub::set_focused_task(const std::int32_t &id) {
+  wait_for([&](const Completion &done) { set_focused_task_async(id, done); });
 }
 
-void AndroidApiStub::remove_task(const std::int32_t &id) {
-  ensure_rpc_channel();
-
-  auto c = std::make_shared<Request<protobuf::rpc::Void>>();
-
+void AndroidApiStub::remove_task_async(const std::int32_t &id,
+                                       const Completion &done) {
   protobuf::bridge::RemoveTask message;
   message.set_id(id);
-
-  {
-    std::lock_guard<decltype(mutex_)> lock(mutex_);
-    remove_task_handle_.expect_result();
-  }
-
-  channel_->call_method("remove_task", &message, c->response.get(),
-                        google::protobuf::NewCallback(
-                            this, &AndroidApiStub::task_removed, c.get()));
-
-  remove_task_handle_.wait_for_pending(default_rpc_call_timeout);
-  if (!remove_task_handle_.has_result())
-    throw std::runtime_error("RPC call timed out");
-
-  if (c->response->has_error()) throw std::runtime_error(c->response->error());
+  call_async("remove_task", message, done);
 }
 
-void AndroidApiStub::task_removed(Request<protobuf::rpc::Void> *request) {
-  (void)request;
-  remove_task_handle_.result_received();
+void AndroidApiStub::remove_task(const std::int32_t &id) {
+  wait_for([&](const Completion &done) { remove_task_async(id, done); });
 }
 
-void AndroidApiStub::resize_task(const std::int32_t &id,
-                                 const anbox::graphics::Rect &rect,
-                                 const std::int32_t &resize_mode) {
-  ensure_rpc_channel();
-
-  auto c = std::make_shared<Request<protobuf::rpc::Void>>();
-
+void AndroidApiStub::resize_task_async(const std::int32_t &id,
+                                       const anbox::graphics::Rect &rect,
+                                       const std::int32_t &resize_mode,
+                                       const Completion &done) {
   protobuf::bridge::ResizeTask message;
   message.set_id(id);
   message.set_resize_mode(resize_mode);
@@ -202,24 +226,14 @@ void AndroidApiStub::resize_task(const std::int32_t &id,
   r->set_right(rect.right());
   r->set_bottom(rect.bottom());
 
-  {
-    std::lock_guard<decltype(mutex_)> lock(mutex_);
-    resize_task_handle_.expect_result();
-  }
-
-  channel_->call_method("resize_task", &message, c->response.get(),
-                        google::protobuf::NewCallback(
-                            this, &AndroidApiStub::task_resized, c.get()));
-
-  resize_task_handle_.wait_for_pending(default_rpc_call_timeout);
-  if (!resize_task_handle_.has_result())
-    throw std::runtime_error("RPC call timed out");
-
-  if (c->response->has_error()) throw std::runtime_error(c->response->error());
+  call_async("resize_task", message, done);
 }
 
-void AndroidApiStub::task_resized(Request<protobuf::rpc::Void> *request) {
-  (void)request;
-  resize_task_handle_.result_received();
+void AndroidApiStub::resize_task(const std::int32_t &id,
+                                 const anbox::graphics::Rect &rect,
+                                 const std::int32_t &resize_mode) {
+  wait_for([&](const Completion &done) {
+    resize_task_async(id, rect, resize_mode, done);
+  });
+}
 }
-}
\ No newline at end of file
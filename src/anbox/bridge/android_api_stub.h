@@ -19,14 +19,17 @@
 #define ANBOX_BRIDGE_ANDROID_API_STUB_H_
 
 #include "anbox/application/manager.h"
-#include "anbox/common/wait_handle.h"
 #include "anbox/graphics/rect.h"
+#include "anbox/runtime.h"
 
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <vector>
 
-namespace anbox::protobuf::rpc {
-  class Void;
+namespace google::protobuf {
+  class MessageLite;
 }
 
 namespace anbox::rpc {
@@ -36,12 +39,29 @@ namespace anbox::rpc {
 namespace anbox::bridge {
 class AndroidApiStub : public anbox::application::Manager {
  public:
-  AndroidApiStub();
+  // Called once a call finished. |error| is empty if it succeeded.
+  typedef std::function<void(const std::string &error)> Completion;
+
+  AndroidApiStub(const std::shared_ptr<Runtime> &rt);
   ~AndroidApiStub();
 
   void set_rpc_channel(const std::shared_ptr<rpc::Channel> &channel);
   void reset_rpc_channel();
 
+  // The asynchronous variants return right away and can have any number
+  // of calls in flight. Each call fails if Android doesn't answer it
+  // before its deadline or the connection goes away.
+  void set_focused_task_async(const std::int32_t &id, const Completion &done);
+  void remove_task_async(const std::int32_t &id, const Completion &done);
+  void resize_task_async(const std::int32_t &id, const anbox::graphics::Rect &rect,
+                         const std::int32_t &resize_mode, const Completion &done);
+  void launch_async(const android::Intent &intent,
+                    const graphics::Rect &launch_bounds,
+                    const wm::Stack::Id &stack,
+                    const LaunchCallback &done) override;
+
+  // The synchronous variants block until the call finished and throw if
+  // it failed.
   void set_focused_task(const std::int32_t &id);
   void remove_task(const std::int32_t &id);
   void resize_task(const std::int32_t &id, const anbox::graphics::Rect &rect,
@@ -54,27 +74,14 @@ class AndroidApiStub : public anbox::application::Manager {
   core::Property<bool>& ready() override;
 
  private:
-  void ensure_rpc_channel();
-
-  template <typename Response>
-  struct Request {
-    Request() : response(std::make_shared<Response>()), success(true) {}
-    std::shared_ptr<Response> response;
-    bool success;
-  };
-
-  void application_launched(Request<protobuf::rpc::Void> *request);
-  void focused_task_set(Request<protobuf::rpc::Void> *request);
-  void task_removed(Request<protobuf::rpc::Void> *request);
-  void task_resized(Request<protobuf::rpc::Void> *request);
+  void call_async(const std::string &method_name,
+                  const google::protobuf::MessageLite &message,
+                  const Completion &done);
+  void wait_for(const std::function<void(const Completion &)> &call);
 
+  std::shared_ptr<Runtime> rt_;
   mutable std::mutex mutex_;
   std::shared_ptr<rpc::Channel> channel_;
-  common::WaitHandle launch_wait_handle_;
-  common::WaitHandle set_focused_task_handle_;
-  common::WaitHandle remove_task_handle_;
-  common::WaitHandle resize_task_handle_;
-  graphics::Rect launch_bounds_ = graphics::Rect::Invalid;
   core::Property<bool> ready_;
 };
 }
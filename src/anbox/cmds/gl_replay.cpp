@@ -0,0 +1,240 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "anbox/cmds/gl_replay.h"
+#include "anbox/graphics/emugl/RenderApi.h"
+#include "anbox/graphics/emugl/RenderControl.h"
+#include "anbox/graphics/emugl/Renderer.h"
+#include "anbox/graphics/stream_replay.h"
+#include "anbox/logger.h"
+
+#include "gles1_dec.h"
+#include "gles2_dec.h"
+#include "renderControl_dec.h"
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <iomanip>
+#include <numeric>
+
+namespace fs = boost::filesystem;
+
+namespace {
+const char *api_of(std::uint32_t opcode) {
+  if (opcode >= 10000) return "rc";
+  if (opcode >= 2048) return "gles2";
+  if (opcode >= 1024) return "gles1";
+  return "?";
+}
+
+double percentile(std::vector<std::uint32_t> &values, double p) {
+  if (values.empty()) return 0.0;
+  const auto n = std::min(values.size() - 1, static_cast<std::size_t>(values.size() * p));
+  std::nth_element(values.begin(), values.begin() + n, values.end());
+  return values[n];
+}
+
+std::vector<std::string> find_captures(const std::vector<std::string> &args) {
+  std::vector<std::string> paths;
+  for (const auto &arg : args) {
+    if (!fs::is_directory(arg)) {
+      paths.push_back(arg);
+      continue;
+    }
+    for (const auto &entry : fs::directory_iterator(arg)) {
+      if (entry.path().extension() == ".glcap")
+        paths.push_back(entry.path().string());
+    }
+  }
+  std::sort(paths.begin(), paths.end());
+  return paths;
+}
+
+void print_summary(std::ostream &out, anbox::graphics::StreamReplay::Result &result) {
+  using seconds = std::chrono::duration<double>;
+
+  out << std::fixed << std::setprecision(3)
+      << "replayed " << result.bytes << " bytes, " << result.packets << " packets in "
+      << seconds(result.wall_time).count() << " s (captured over "
+      << seconds(result.captured_time).count() << " s)" << std::endl
+      << "decode: " << std::setprecision(1)
+      << (result.packets ? static_cast<double>(result.decode_time.count()) / result.packets : 0.0)
+      << " ns/op, " << std::setprecision(3) << seconds(result.decode_time).count()
+      << " s total" << std::endl;
+
+  if (result.frame_times.empty()) {
+    out << "frames: none posted" << std::endl;
+    return;
+  }
+
+  std::vector<std::uint32_t> frame_us;
+  for (const auto &t : result.frame_times)
+    frame_us.push_back(static_cast<std::uint32_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(t).count()));
+  const auto total = std::accumulate(frame_us.begin(), frame_us.end(), 0.0);
+  const auto max = *std::max_element(frame_us.begin(), frame_us.end());
+  out << "frames: " << frame_us.size() << ", mean "
+      << total / frame_us.size() / 1000.0
+      << " ms, p50 " << percentile(frame_us, 0.5) / 1000.0 << " ms, p99 "
+      << percentile(frame_us, 0.99) / 1000.0 << " ms, max " << max / 1000.0 << " ms"
+      << std::endl;
+}
+
+void print_opcodes(std::ostream &out, anbox::graphics::StreamReplay::Result &result,
+                   std::size_t top, bool histogram) {
+  struct Row {
+    std::uint32_t opcode;
+    std::uint64_t total_ns;
+  };
+  std::vector<Row> rows;
+  for (const auto &op : result.opcode_ns)
+    rows.push_back({op.first, std::accumulate(op.second.begin(), op.second.end(), std::uint64_t{0})});
+  std::sort(rows.begin(), rows.end(), [](const Row &a, const Row &b) {
+    return a.total_ns > b.total_ns;
+  });
+  if (rows.size() > top) rows.resize(top);
+
+  out << std::endl
+      << "  api | opcode |    count | total ms | mean ns |  p50 ns |  p99 ns" << std::endl;
+  for (const auto &row : rows) {
+    auto &ns = result.opcode_ns[row.opcode];
+    out << std::setw(5) << api_of(row.opcode) << " | " << std::setw(6) << row.opcode
+        << " | " << std::setw(8) << ns.size() << " | " << std::setw(8)
+        << std::setprecision(2) << row.total_ns / 1e6 << " | " << std::setw(7)
+        << std::setprecision(0) << static_cast<double>(row.total_ns) / ns.size()
+        << " | " << std::setw(7) << percentile(ns, 0.5) << " | " << std::setw(7)
+        << percentile(ns, 0.99) << std::endl;
+
+    if (!histogram) continue;
+
+    // Power of two buckets, starting with everything up to 64ns.
+    std::vector<std::size_t> buckets;
+    for (const auto value : ns) {
+      std::size_t bucket = 0;
+      while ((64u << bucket) < value && bucket < 24) bucket++;
+      if (buckets.size() <= bucket) buckets.resize(bucket + 1);
+      buckets[bucket]++;
+    }
+    const auto largest = *std::max_element(buckets.begin(), buckets.end());
+    std::size_t first = 0;
+    while (buckets[first] == 0) first++;
+    for (std::size_t bucket = first; bucket < buckets.size(); bucket++) {
+      out << std::setw(18) << "<= " << std::setw(9) << (64u << bucket) << " ns | "
+          << std::setw(8) << buckets[bucket] << " "
+          << std::string(buckets[bucket] * 40 / largest, '#') << std::endl;
+    }
+  }
+}
+
+// Counters kept by the decoders themselves, only available when built with
+// ENABLE_DECODER_PROFILING.
+void print_decoder_profile(std::ostream &out, std::size_t top) {
+  std::vector<const emugl::DecoderOpcodeStats*> rows;
+  for (const auto opcode_stats : {&gles1_decoder_context_t::opcodeStats,
+                                  &gles2_decoder_context_t::opcodeStats,
+                                  &renderControl_decoder_context_t::opcodeStats}) {
+    const emugl::DecoderOpcodeStats *stats = nullptr;
+    const auto count = opcode_stats(&stats);
+    for (std::size_t n = 0; n < count; n++) {
+      if (stats[n].calls > 0) rows.push_back(&stats[n]);
+    }
+  }
+  if (rows.empty()) return;
+
+  std::sort(rows.begin(), rows.end(), [](const emugl::DecoderOpcodeStats *a,
+                                         const emugl::DecoderOpcodeStats *b) {
+    return a->ns > b->ns;
+  });
+  if (rows.size() > top) rows.resize(top);
+
+  out << std::endl << "decoder profile:" << std::endl;
+  for (const auto row : rows) {
+    out << std::setw(32) << row->name << " | " << std::setw(6) << row->opcode
+        << " | " << std::setw(8) << row->calls << " | " << std::setw(8)
+        << std::setprecision(2) << row->ns / 1e6 << " ms" << std::endl;
+  }
+}
+}
+
+anbox::cmds::GlReplay::GlReplay()
+    : CommandWithFlagsAndAction{
+          cli::Name{"anbox-gl-replay"}, cli::Usage{"anbox-gl-replay [captures or directories]"},
+          cli::Description{"Replay recorded GLES streams and report decoder timings"}} {
+  flag(cli::make_flag(cli::Name{"renderer"},
+                      cli::Description{"Renderer to replay against: 'null' to only decode or 'pbuffer' for an offscreen host EGL renderer"},
+                      renderer_));
+  flag(cli::make_flag(cli::Name{"top"},
+                      cli::Description{"Number of opcodes to report, ordered by the time spent decoding them"},
+                      top_));
+  flag(cli::make_flag(cli::Name{"histogram"},
+                      cli::Description{"Print a histogram of decode times for every reported opcode"},
+                      histogram_));
+
+  action([this](const cli::Command::Context &ctxt) {
+    const auto paths = find_captures(ctxt.args);
+    if (paths.empty()) {
+      ctxt.cout << "No captures given" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    std::vector<graphics::StreamCapture> captures;
+    for (const auto &path : paths)
+      captures.push_back(graphics::StreamCapture::load(path));
+
+    if (renderer_ != "null" && renderer_ != "pbuffer") {
+      ctxt.cout << "Unknown renderer " << renderer_ << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Render offscreen without a display server if the EGL implementation
+    // supports it (honored by Mesa).
+    setenv("EGL_PLATFORM", "surfaceless", 0);
+
+    // The decoders resolve their GL entry points from the host libraries
+    // even when nothing is rendered.
+    if (!graphics::emugl::initialize(graphics::emugl::default_gl_libraries(), nullptr, nullptr)) {
+      ERROR("Failed to load host GL libraries");
+      return EXIT_FAILURE;
+    }
+
+    std::shared_ptr<::Renderer> renderer;
+    if (renderer_ == "pbuffer") {
+      renderer = std::make_shared<::Renderer>();
+      if (!renderer->initialize(EGL_DEFAULT_DISPLAY)) {
+        ERROR("Failed to initialize the renderer");
+        return EXIT_FAILURE;
+      }
+      registerRenderer(renderer);
+    }
+
+    graphics::StreamReplay replay(std::move(captures));
+    auto result = replay.run(renderer);
+
+    if (renderer) {
+      registerRenderer(nullptr);
+      renderer->finalize();
+    }
+
+    ctxt.cout << paths.size() << " captures" << std::endl;
+    print_summary(ctxt.cout, result);
+    print_opcodes(ctxt.cout, result, top_, histogram_);
+    print_decoder_profile(ctxt.cout, top_);
+    return EXIT_SUCCESS;
+  });
+}
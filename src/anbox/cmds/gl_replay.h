@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef ANBOX_CMDS_GL_REPLAY_H_
+#define ANBOX_CMDS_GL_REPLAY_H_
+
+#include <cstdint>
+#include <string>
+
+#include "anbox/cli.h"
+
+namespace anbox::cmds {
+// Replays GLES streams recorded with session-manager --gl-capture-dir
+// and reports how long decoding them took. Built as the standalone
+// anbox-gl-replay tool so it runs without any of the session setup.
+class GlReplay : public cli::CommandWithFlagsAndAction {
+ public:
+  GlReplay();
+
+ private:
+  std::string renderer_ = "null";
+  std::uint32_t top_ = 20;
+  bool histogram_ = false;
+};
+}
+#endif
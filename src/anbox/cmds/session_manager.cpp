@@ -88,7 +88,11 @@ void anbox::cmds::SessionManager::launch_appmgr_if_needed(const std::shared_ptr<
   launch_intent.component = default_appmgr_component;
   // As this will only be executed in single window mode we don't have
   // to specify and launch bounds.
-  android_api_stub->launch(launch_intent, graphics::Rect::Invalid, wm::Stack::Id::Default);
+  android_api_stub->launch_async(launch_intent, graphics::Rect::Invalid, wm::Stack::Id::Default,
+                                 [](const std::string &error) {
+                                   if (!error.empty())
+                                     ERROR("Failed to launch application manager: %s", error);
+                                 });
 }
 
 anbox::cmds::SessionManager::SessionManager()
@@ -131,6 +135,15 @@ anbox::cmds::SessionManager::SessionManager()
   flag(cli::make_flag(cli::Name{"rootless"},
                       cli::Description{"Run in rootless window mode"},
                       rootless_));
+  flag(cli::make_flag(cli::Name{"refresh-rate"},
+                      cli::Description{"Rate in Hz the display is updated with, 0 to present every frame immediately"},
+                      refresh_rate_));
+  flag(cli::make_flag(cli::Name{"gl-capture-dir"},
+                      cli::Description{"Record the GLES streams of all guest connections into the given directory for replay with anbox-gl-replay"},
+                      gl_capture_dir_));
+  flag(cli::make_flag(cli::Name{"audio-source"},
+                      cli::Description{"What Android records instead of the microphone: 'tone', 'tone:<frequency>' or the path of a WAV file"},
+                      audio_source_));
 
   action([this](const cli::Command::Context &) {
     auto trap = core::posix::trap_signals_for_process(
@@ -167,7 +180,7 @@ anbox::cmds::SessionManager::SessionManager()
     }
 
     auto input_manager = std::make_shared<input::Manager>(rt);
-    auto android_api_stub = std::make_shared<bridge::AndroidApiStub>();
+    auto android_api_stub = std::make_shared<bridge::AndroidApiStub>(rt);
 
     auto display_frame = graphics::Rect::Invalid;
     if (single_window_)
@@ -190,7 +203,8 @@ anbox::cmds::SessionManager::SessionManager()
 
     auto platform = platform::create(utils::get_env_value("ANBOX_PLATFORM", "sdl"),
                                      input_manager,
-                                     platform_config);
+                                     platform_config,
+                                     rt);
     if (!platform)
       return EXIT_FAILURE;
 
@@ -212,7 +226,9 @@ anbox::cmds::SessionManager::SessionManager()
 
     graphics::GLRendererServer::Config renderer_config{
         gl_driver,
-        single_window_};
+        using_single_window,
+        refresh_rate_,
+        SystemConfiguration::instance().program_cache_dir()};
     auto gl_server = std::make_shared<graphics::GLRendererServer>(renderer_config, window_manager);
 
     platform->set_window_manager(window_manager);
@@ -228,7 +244,7 @@ anbox::cmds::SessionManager::SessionManager()
           android_api_stub, wm::Stack::Id::Freeform);
     }
 
-    auto audio_server = std::make_shared<audio::Server>(rt, platform);
+    auto audio_server = std::make_shared<audio::Server>(rt, platform, audio_source_);
 
     const auto socket_path = SystemConfiguration::instance().socket_dir();
 
@@ -245,7 +261,7 @@ anbox::cmds::SessionManager::SessionManager()
     auto qemu_pipe_connector =
         std::make_shared<network::PublishedSocketConnector>(
             utils::string_format("%s/qemu_pipe", socket_path), rt,
-            std::make_shared<qemu::PipeConnectionCreator>(gl_server->renderer(), rt, sensors_state, gps_info_broker));
+            std::make_shared<qemu::PipeConnectionCreator>(gl_server->renderer(), rt, sensors_state, gps_info_broker, gl_capture_dir_));
 
     boost::asio::deadline_timer appmgr_start_timer(rt->service());
 
@@ -55,6 +55,9 @@ class SessionManager : public cli::CommandWithFlagsAndAction {
   bool no_touch_emulation_ = false;
   bool server_side_decoration_ = false;
   bool rootless_ = false;
+  std::uint32_t refresh_rate_ = 60;
+  std::string gl_capture_dir_;
+  std::string audio_source_;
 };
 }
 #endif
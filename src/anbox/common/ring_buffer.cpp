@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "anbox/common/ring_buffer.h"
+#include "anbox/common/fd.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <cassert>
+#include <cstring>
+#include <system_error>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+size_t round_up_capacity(size_t min_capacity) {
+  size_t capacity = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+  while (capacity < min_capacity) capacity <<= 1;
+  return capacity;
+}
+}
+
+namespace anbox::common {
+RingBuffer::RingBuffer(size_t min_capacity)
+    : capacity_(round_up_capacity(min_capacity)) {
+  base_ = map(capacity_);
+}
+
+RingBuffer::~RingBuffer() {
+  unmap(base_, capacity_);
+}
+
+void RingBuffer::commit(size_t size) {
+  assert(size <= free());
+  write_pos_ += size;
+}
+
+void RingBuffer::consume(size_t size) {
+  assert(size <= this->size());
+  read_pos_ += size;
+}
+
+void RingBuffer::grow(size_t min_capacity) {
+  if (min_capacity <= capacity_) return;
+
+  const auto capacity = round_up_capacity(min_capacity);
+  const auto base = map(capacity);
+  const auto used = size();
+  std::memcpy(base, read_ptr(), used);
+  unmap(base_, capacity_);
+
+  base_ = base;
+  capacity_ = capacity;
+  read_pos_ = 0;
+  write_pos_ = used;
+}
+
+std::uint8_t* RingBuffer::map(size_t capacity) {
+  Fd fd{::memfd_create("anbox-ring-buffer", MFD_CLOEXEC)};
+  if (fd < 0)
+    BOOST_THROW_EXCEPTION(std::system_error(errno, std::system_category(),
+                                            "Failed to create ring buffer memory"));
+
+  if (::ftruncate(fd, static_cast<off_t>(capacity)) < 0)
+    BOOST_THROW_EXCEPTION(std::system_error(errno, std::system_category(),
+                                            "Failed to size ring buffer memory"));
+
+  // Reserve twice the capacity first and then place the same pages in
+  // both halves of the reservation.
+  auto addr = ::mmap(nullptr, capacity * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (addr == MAP_FAILED)
+    BOOST_THROW_EXCEPTION(std::system_error(errno, std::system_category(),
+                                            "Failed to reserve ring buffer address space"));
+
+  auto base = static_cast<std::uint8_t*>(addr);
+  for (const auto half : {base, base + capacity}) {
+    if (::mmap(half, capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) {
+      const auto err = errno;
+      ::munmap(base, capacity * 2);
+      BOOST_THROW_EXCEPTION(std::system_error(err, std::system_category(),
+                                              "Failed to map ring buffer memory"));
+    }
+  }
+
+  return base;
+}
+
+void RingBuffer::unmap(std::uint8_t* base, size_t capacity) {
+  if (base) ::munmap(base, capacity * 2);
+}
+}
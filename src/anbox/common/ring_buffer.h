@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef ANBOX_COMMON_RING_BUFFER_H_
+#define ANBOX_COMMON_RING_BUFFER_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace anbox::common {
+// A single producer / single consumer byte ring. The backing memory is
+// mapped twice back to back so that the readable and the writable part
+// are always contiguous, even when they wrap around the end of the ring.
+// This allows a producer to receive straight into the ring and a consumer
+// to parse data in place without ever copying it.
+//
+// The ring does not synchronize by itself. Callers have to serialize the
+// calls which move the read or write position (commit(), consume() and
+// grow()), while the data itself can be accessed without holding a lock.
+class RingBuffer {
+ public:
+  // |min_capacity| is rounded up to the next power of two multiple of the
+  // page size.
+  explicit RingBuffer(size_t min_capacity);
+  ~RingBuffer();
+
+  RingBuffer(const RingBuffer&) = delete;
+  RingBuffer& operator=(const RingBuffer&) = delete;
+
+  size_t capacity() const { return capacity_; }
+  size_t size() const { return write_pos_ - read_pos_; }
+  size_t free() const { return capacity_ - size(); }
+  bool empty() const { return size() == 0; }
+  bool full() const { return size() == capacity_; }
+
+  // Producer side: returns the contiguous free space of free() bytes and
+  // makes |size| bytes written to it readable.
+  std::uint8_t* write_ptr() { return base_ + (write_pos_ & (capacity_ - 1)); }
+  void commit(size_t size);
+
+  // Consumer side: returns the contiguous readable data of size() bytes,
+  // which may be modified in place, and releases |size| bytes of it.
+  std::uint8_t* read_ptr() { return base_ + (read_pos_ & (capacity_ - 1)); }
+  void consume(size_t size);
+
+  // Grows the ring to hold at least |min_capacity| bytes and keeps all
+  // readable data. Neither side may access the ring while it is resized.
+  void grow(size_t min_capacity);
+
+ private:
+  static std::uint8_t* map(size_t capacity);
+  static void unmap(std::uint8_t* base, size_t capacity);
+
+  std::uint8_t* base_ = nullptr;
+  size_t capacity_ = 0;
+  size_t read_pos_ = 0;
+  size_t write_pos_ = 0;
+};
+}
+
+#endif
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#ifndef ANBOX_COMMON_SEQLOCK_H_
+#define ANBOX_COMMON_SEQLOCK_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <type_traits>
+
+namespace anbox::common {
+// Publishes a small trivially copyable value to any number of readers which
+// never take a lock. Writers are serialized by a mutex and bump a sequence
+// number around each change; a reader retries its copy if the sequence was
+// odd or moved while it was copying. The value is stored as atomic words so
+// a torn copy is discarded instead of being undefined behavior.
+template <typename T>
+class SeqLock {
+  static_assert(std::is_trivially_copyable<T>::value, "SeqLock needs a trivially copyable type");
+
+ public:
+  explicit SeqLock(const T& value = T{}) {
+    std::array<std::uint64_t, word_count> words{};
+    std::memcpy(words.data(), &value, sizeof(T));
+    for (std::size_t n = 0; n < word_count; n++)
+      words_[n].store(words[n], std::memory_order_relaxed);
+  }
+  SeqLock(const SeqLock&) = delete;
+  SeqLock& operator=(const SeqLock&) = delete;
+
+  // Returns a consistent copy of the value. If version isn't null it is set
+  // to the number of changes the copy includes.
+  T load(std::uint64_t* version = nullptr) const {
+    std::array<std::uint64_t, word_count> words;
+    for (;;) {
+      const auto before = sequence_.load(std::memory_order_acquire);
+      if (before & 1) continue;
+
+      for (std::size_t n = 0; n < word_count; n++)
+        words[n] = words_[n].load(std::memory_order_relaxed);
+
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (sequence_.load(std::memory_order_relaxed) != before) continue;
+
+      if (version) *version = before / 2;
+      T value;
+      std::memcpy(static_cast<void*>(&value), words.data(), sizeof(T));
+      return value;
+    }
+  }
+
+  // Number of changes published so far.
+  std::uint64_t version() const {
+    return sequence_.load(std::memory_order_acquire) / 2;
+  }
+
+  // Applies change to the current value and publishes the result.
+  template <typename Change>
+  void update(const Change& change) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    auto value = load();
+    change(value);
+    store_locked(value);
+  }
+
+  void store(const T& value) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    store_locked(value);
+  }
+
+ private:
+  static constexpr std::size_t word_count = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+  void store_locked(const T& value) {
+    std::array<std::uint64_t, word_count> words{};
+    std::memcpy(words.data(), &value, sizeof(T));
+
+    const auto sequence = sequence_.load(std::memory_order_relaxed);
+    sequence_.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (std::size_t n = 0; n < word_count; n++)
+      words_[n].store(words[n], std::memory_order_relaxed);
+    sequence_.store(sequence + 2, std::memory_order_release);
+  }
+
+  std::atomic<std::uint64_t> sequence_{0};
+  std::array<std::atomic<std::uint64_t>, word_count> words_;
+  std::mutex write_mutex_;
+};
+}
+
+#endif
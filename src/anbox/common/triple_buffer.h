@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef ANBOX_COMMON_TRIPLE_BUFFER_H_
+#define ANBOX_COMMON_TRIPLE_BUFFER_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace anbox::common {
+// A single producer / single consumer mailbox which always hands the most
+// recently published value to the consumer. The producer fills the back
+// slot and publishes it, the consumer latches the published slot into the
+// front. Neither side ever waits for the other one, a value published
+// before the consumer latched the previous one simply replaces it.
+template <typename T>
+class TripleBuffer {
+ public:
+  TripleBuffer() = default;
+  TripleBuffer(const TripleBuffer&) = delete;
+  TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+  // Producer side: the slot to fill for the next publish().
+  T& back() { return slots_[back_]; }
+
+  // Producer side: makes the back slot available to the consumer. Returns
+  // true if this dropped a value the consumer didn't latch yet.
+  bool publish() {
+    const auto previous = state_.exchange(back_ | fresh_bit, std::memory_order_acq_rel);
+    back_ = previous & index_mask;
+    return (previous & fresh_bit) != 0;
+  }
+
+  // Returns true if a value was published since the last latch().
+  bool pending() const {
+    return (state_.load(std::memory_order_acquire) & fresh_bit) != 0;
+  }
+
+  // Consumer side: makes the most recently published value the front slot.
+  // Returns false and keeps the current front if nothing new is available.
+  bool latch() {
+    if (!pending()) return false;
+    const auto previous = state_.exchange(front_, std::memory_order_acq_rel);
+    front_ = previous & index_mask;
+    return true;
+  }
+
+  // Consumer side: the value returned by the last successful latch().
+  T& front() { return slots_[front_]; }
+
+ private:
+  static constexpr std::uint8_t index_mask = 0x3;
+  static constexpr std::uint8_t fresh_bit = 0x4;
+
+  std::array<T, 3> slots_;
+  std::uint8_t front_ = 0;
+  std::uint8_t back_ = 1;
+  // Index of the slot in between both sides and whether it holds a value
+  // the consumer hasn't latched yet.
+  std::atomic<std::uint8_t> state_{2};
+};
+}
+
+#endif
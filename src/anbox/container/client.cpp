@@ -35,7 +35,8 @@ Client::Client(const std::shared_ptr<Runtime> &rt)
       rpc_channel_(std::make_shared<rpc::Channel>(pending_calls_, messenger_)),
       management_api_(std::make_shared<ManagementApiStub>(rpc_channel_)),
       processor_(
-          std::make_shared<rpc::MessageProcessor>(messenger_, pending_calls_)) {
+          std::make_shared<rpc::MessageProcessor>(messenger_, pending_calls_)),
+      buffer_pool_(network::ReceiveBufferPool::instance()) {
   read_next_message();
 }
 
@@ -60,9 +61,12 @@ void Client::register_terminate_handler(const TerminateCallback &callback) {
 }
 
 void Client::read_next_message() {
-  auto callback = std::bind(&Client::on_read_size, this, std::placeholders::_1,
-                            std::placeholders::_2);
-  messenger_->async_receive_msg(callback, ba::buffer(buffer_));
+  buffer_ = buffer_pool_->acquire(messenger_->available_bytes());
+  messenger_->async_receive_msg(
+      [this](const boost::system::error_code &error, std::size_t bytes_read) {
+        on_read_size(error, bytes_read);
+      },
+      ba::buffer(buffer_.data(), buffer_.capacity()));
 }
 
 void Client::on_read_size(const boost::system::error_code &error,
@@ -73,9 +77,7 @@ void Client::on_read_size(const boost::system::error_code &error,
     return;
   }
 
-  std::vector<std::uint8_t> data(bytes_read);
-  std::copy(buffer_.data(), buffer_.data() + bytes_read, data.data());
-
-  if (processor_->process_data(data)) read_next_message();
+  buffer_.resize(bytes_read);
+  if (processor_->process_data(std::move(buffer_))) read_next_message();
 }
 }
\ No newline at end of file
@@ -19,6 +19,7 @@
 #define ANBOX_CONTAINER_CLIENT_H_
 
 #include "anbox/container/configuration.h"
+#include "anbox/network/receive_buffer.h"
 #include "anbox/runtime.h"
 
 namespace anbox::rpc {
@@ -55,7 +56,8 @@ class Client {
   std::shared_ptr<rpc::Channel> rpc_channel_;
   std::shared_ptr<ManagementApiStub> management_api_;
   std::shared_ptr<rpc::MessageProcessor> processor_;
-  std::array<std::uint8_t, 8192> buffer_;
+  std::shared_ptr<network::ReceiveBufferPool> buffer_pool_;
+  network::ReceiveBuffer buffer_;
   TerminateCallback terminate_callback_;
 };
 }
@@ -22,7 +22,7 @@
 #include "anbox/android/intent.h"
 #include "anbox/logger.h"
 
-void ApplicationManagerServer::Launch(const std::map<std::string, sdbus::Variant>& intentDict, const std::string& stack) {
+void ApplicationManagerServer::Launch(sdbus::Result<>&& result, std::map<std::string, sdbus::Variant> intentDict, std::string stack) {
   anbox::android::Intent intent;
   intent.package = intentDict.count("package") ? intentDict.at("package").get<std::string>() : intent.package;
   intent.component = intentDict.count("component") ? intentDict.at("component").get<std::string>() : intent.component;
@@ -37,19 +37,26 @@ void ApplicationManagerServer::Launch(const std::map<std::string, sdbus::Variant
   }
 
   if (intent.package.length() == 0) {
-    throw sdbus::Error("org.anbox.InvalidArgument", "No package specified");
+    result.returnError(sdbus::Error("org.anbox.InvalidArgument", "No package specified"));
+    return;
   }
 
-  try {
-    if (!impl_->ready())
-      throw std::runtime_error("Anbox not yet ready to launch applications");
-
-    DEBUG("Launching %s", intent);
-    impl_->launch(intent, anbox::graphics::Rect::Invalid, launch_stack);
-  } catch (std::exception& err) {
-    ERROR("Failed to launch application: %s", err.what());
-    throw sdbus::Error("org.anbox.InternalError", err.what());
+  if (!impl_->ready()) {
+    ERROR("Failed to launch application: Anbox not yet ready to launch applications");
+    result.returnError(sdbus::Error("org.anbox.InternalError", "Anbox not yet ready to launch applications"));
+    return;
   }
+
+  DEBUG("Launching %s", intent);
+  auto reply = std::make_shared<sdbus::Result<>>(std::move(result));
+  impl_->launch_async(intent, anbox::graphics::Rect::Invalid, launch_stack, [reply](const std::string& error) {
+    if (!error.empty()) {
+      ERROR("Failed to launch application: %s", error);
+      reply->returnError(sdbus::Error("org.anbox.InternalError", error));
+      return;
+    }
+    reply->returnResults();
+  });
 }
 
 bool ApplicationManagerServer::Ready() {
@@ -32,7 +32,9 @@ class ApplicationManagerServer : public sdbus::AdaptorInterfaces<org::anbox::App
   }
 
  protected:
-  void Launch(const std::map<std::string, sdbus::Variant>& intentDict, const std::string& arg1) override;
+  // Replies once Android finished the launch, without blocking the bus
+  // for other launches meanwhile.
+  void Launch(sdbus::Result<>&& result, std::map<std::string, sdbus::Variant> intentDict, std::string arg1) override;
   bool Ready() override;
 
  private:
@@ -22,98 +22,124 @@
 #include "anbox/logger.h"
 #include "sdbus-c++/Error.h"
 
+namespace {
+sdbus::Struct<double, double, double> to_struct(const std::array<double, 3>& value) {
+  return sdbus::Struct<double, double, double>(value[0], value[1], value[2]);
+}
+
+std::array<double, 3> from_struct(const sdbus::Struct<double, double, double>& value) {
+  return {{std::get<0>(value), std::get<1>(value), std::get<2>(value)}};
+}
+}
+
 sdbus::Struct<double, double, double> SensorsServer::Acceleration() {
   if (impl_->disabled_sensors & anbox::application::SensorType::AccelerationSensor)
     throw sdbus::Error("org.anbox.SensorDisabled", "Acceleration sensor is disabled");
-  return sdbus::Struct<double, double, double>(impl_->acceleration);
+  return to_struct(impl_->values.load().acceleration);
 }
 
 void SensorsServer::Acceleration(const sdbus::Struct<double, double, double>& value) {
   if (impl_->disabled_sensors & anbox::application::SensorType::AccelerationSensor)
     throw sdbus::Error("org.anbox.SensorDisabled", "Acceleration sensor is disabled");
-  impl_->acceleration = value;
+  impl_->values.update([&](anbox::application::SensorsValues& values) {
+    values.acceleration = from_struct(value);
+  });
 }
 
 sdbus::Struct<double, double, double> SensorsServer::MagneticField() {
   if (impl_->disabled_sensors & anbox::application::SensorType::MagneticFieldSensor)
     throw sdbus::Error("org.anbox.SensorDisabled", "MagneticField sensor is disabled");
-  return sdbus::Struct<double, double, double>(impl_->magneticField);
+  return to_struct(impl_->values.load().magneticField);
 }
 
 void SensorsServer::MagneticField(const sdbus::Struct<double, double, double>& value) {
   if (impl_->disabled_sensors & anbox::application::SensorType::MagneticFieldSensor)
     throw sdbus::Error("org.anbox.SensorDisabled", "MagneticField sensor is disabled");
-  impl_->magneticField = value;
+  impl_->values.update([&](anbox::application::SensorsValues& values) {
+    values.magneticField = from_struct(value);
+  });
 }
 
 sdbus::Struct<double, double, double> SensorsServer::Orientation() {
   if (impl_->disabled_sensors & anbox::application::SensorType::OrientationSensor)
     throw sdbus::Error("org.anbox.SensorDisabled", "Orientation sensor is disabled");
-  return sdbus::Struct<double, double, double>(impl_->orientation);
+  return to_struct(impl_->values.load().orientation);
 }
 
 void SensorsServer::Orientation(const sdbus::Struct<double, double, double>& value) {
   if (impl_->disabled_sensors & anbox::application::SensorType::OrientationSensor)
     throw sdbus::Error("org.anbox.SensorDisabled", "Orientation sensor is disabled");
-  impl_->orientation = value;
+  impl_->values.update([&](anbox::application::SensorsValues& values) {
+    values.orientation = from_struct(value);
+  });
 }
 
 double SensorsServer::Temperature() {
   if (impl_->disabled_sensors & anbox::application::SensorType::TemperatureSensor)
     throw sdbus::Error("org.anbox.SensorDisabled", "Temperature sensor is disabled");
-  return impl_->temperature;
+  return impl_->values.load().temperature;
 }
 
 void SensorsServer::Temperature(const double& value) {
   if (impl_->disabled_sensors & anbox::application::SensorType::TemperatureSensor)
     throw sdbus::Error("org.anbox.SensorDisabled", "Temperature sensor is disabled");
-  impl_->temperature = value;
+  impl_->values.update([&](anbox::application::SensorsValues& values) {
+    values.temperature = value;
+  });
 }
 
 double SensorsServer::Proximity() {
   if (impl_->disabled_sensors & anbox::application::SensorType::ProximitySensor)
     throw sdbus::Error("org.anbox.SensorDisabled", "Proximity sensor is disabled");
-  return impl_->proximity;
+  return impl_->values.load().proximity;
 }
 
 void SensorsServer::Proximity(const double& value) {
   if (impl_->disabled_sensors & anbox::application::SensorType::ProximitySensor)
     throw sdbus::Error("org.anbox.SensorDisabled", "Proximity sensor is disabled");
-  impl_->proximity = value;
+  impl_->values.update([&](anbox::application::SensorsValues& values) {
+    values.proximity = value;
+  });
 }
 
 double SensorsServer::Light() {
   if (impl_->disabled_sensors & anbox::application::SensorType::LightSensor)
     throw sdbus::Error("org.anbox.SensorDisabled", "Light sensor is disabled");
-  return impl_->light;
+  return impl_->values.load().light;
 }
 
 void SensorsServer::Light(const double& value) {
   if (impl_->disabled_sensors & anbox::application::SensorType::LightSensor)
     throw sdbus::Error("org.anbox.SensorDisabled", "Light sensor is disabled");
-  impl_->light = value;
+  impl_->values.update([&](anbox::application::SensorsValues& values) {
+    values.light = value;
+  });
 }
 
 double SensorsServer::Pressure() {
   if (impl_->disabled_sensors & anbox::application::SensorType::PressureSensor)
     throw sdbus::Error("org.anbox.SensorDisabled", "Pressure sensor is disabled");
-  return impl_->pressure;
+  return impl_->values.load().pressure;
 }
 
 void SensorsServer::Pressure(const double& value) {
   if (impl_->disabled_sensors & anbox::application::SensorType::PressureSensor)
     throw sdbus::Error("org.anbox.SensorDisabled", "Pressure sensor is disabled");
-  impl_->pressure = value;
+  impl_->values.update([&](anbox::application::SensorsValues& values) {
+    values.pressure = value;
+  });
 }
 
 double SensorsServer::Humidity() {
   if (impl_->disabled_sensors & anbox::application::SensorType::HumiditySensor)
     throw sdbus::Error("org.anbox.SensorDisabled", "Humidity sensor is disabled");
-  return impl_->humidity;
+  return impl_->values.load().humidity;
 }
 
 void SensorsServer::Humidity(const double& value) {
   if (impl_->disabled_sensors & anbox::application::SensorType::HumiditySensor)
     throw sdbus::Error("org.anbox.SensorDisabled", "Humidity sensor is disabled");
-  impl_->humidity = value;
+  impl_->values.update([&](anbox::application::SensorsValues& values) {
+    values.humidity = value;
+  });
 }
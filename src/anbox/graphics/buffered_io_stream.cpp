@@ -18,14 +18,16 @@
 #include "anbox/graphics/buffered_io_stream.h"
 #include "anbox/logger.h"
 
+#include <algorithm>
+#include <cstring>
+
 namespace anbox::graphics {
 BufferedIOStream::BufferedIOStream(
     const std::shared_ptr<anbox::network::SocketMessenger> &messenger,
     size_t buffer_size)
     : IOStream(buffer_size),
       messenger_(messenger),
-      in_queue_(1024U),
-      out_queue_(16U),
+      in_ring_(default_ring_size),
       worker_thread_(&BufferedIOStream::thread_main, this) {
   write_buffer_.resize_noinit(buffer_size);
 }
@@ -44,92 +46,198 @@ void *BufferedIOStream::allocBuffer(size_t min_size) {
 size_t BufferedIOStream::commitBuffer(size_t size) {
   std::unique_lock<std::mutex> l(out_lock_);
   assert(size <= write_buffer_.size());
-  if (write_buffer_.isAllocated()) {
+
+  size_t offset = 0;
+  if (!writing_ && pending_writes_.empty()) {
+    // Nothing is queued in front of us so try to send the reply right
+    // away and only hand over to the worker what the socket didn't take.
+    const auto written = messenger_->send_raw(write_buffer_.data(), size);
+    if (written < 0) {
+      if (errno != EINTR && errno != EAGAIN) {
+        ERROR("Failed to write data: %s", std::strerror(errno));
+        return size;
+      }
+    } else {
+      offset = static_cast<size_t>(written);
+    }
+
+    if (offset == size) return size;
+  }
+
+  can_commit_.wait(l, [&]() {
+    return stopped_ || pending_write_size_ < max_pending_write_size;
+  });
+  if (stopped_) return size;
+
+  if (offset == 0 && write_buffer_.isAllocated()) {
     write_buffer_.resize(size);
-    out_queue_.push_locked(std::move(write_buffer_), l);
+    pending_writes_.push_back(std::move(write_buffer_));
   } else {
-    out_queue_.push_locked(
-        Buffer{write_buffer_.data(), write_buffer_.data() + size}, l);
+    pending_writes_.push_back(
+        Buffer{write_buffer_.data() + offset, write_buffer_.data() + size});
   }
+  pending_write_size_ += size - offset;
+  can_write_.notify_one();
   return size;
 }
 
 const unsigned char *BufferedIOStream::read(void *buf, size_t *inout_len) {
   std::unique_lock<std::mutex> l(lock_);
-  size_t wanted = *inout_len;
-  size_t count = 0U;
-  auto dst = static_cast<uint8_t *>(buf);
-  while (count < wanted) {
-    if (read_buffer_left_ > 0) {
-      size_t avail = std::min<size_t>(wanted - count, read_buffer_left_);
-      memcpy(dst + count,
-             read_buffer_.data() + (read_buffer_.size() - read_buffer_left_),
-             avail);
-      count += avail;
-      read_buffer_left_ -= avail;
-      continue;
-    }
+  can_read_.wait(l, [&]() { return closed_ || !in_ring_.empty(); });
+  if (in_ring_.empty()) return nullptr;
 
-    bool blocking = (count == 0);
-    auto result = -EIO;
-    if (blocking)
-      result = in_queue_.pop_locked(&read_buffer_, l);
-    else
-      result = in_queue_.try_pop_locked(&read_buffer_);
+  const auto count = std::min<size_t>(*inout_len, in_ring_.size());
+  memcpy(buf, in_ring_.read_ptr(), count);
+  in_ring_.consume(count);
+  can_receive_.notify_one();
+
+  *inout_len = count;
+  return static_cast<const unsigned char *>(buf);
+}
 
-    if (result == 0) {
-      read_buffer_left_ = read_buffer_.size();
+unsigned char *BufferedIOStream::readInPlace(size_t pending, size_t *out_len) {
+  std::unique_lock<std::mutex> l(lock_);
+  while (in_ring_.size() <= pending) {
+    if (closed_) return nullptr;
+
+    if (in_ring_.full()) {
+      // A single packet doesn't fit into the ring. The receiver can't hold
+      // on to any free space at this point so once it committed its last
+      // write we're the only user of the ring and can grow it.
+      can_read_.wait(l, [&]() { return closed_ || !receiving_; });
+      if (closed_) return nullptr;
+      in_ring_.grow(in_ring_.capacity() * 2);
+      can_receive_.notify_one();
       continue;
     }
 
-    if (count > 0) break;
-
-    // If we end up here something went wrong and we couldn't read
-    // any valid data.
-    return nullptr;
+    can_read_.wait(l);
   }
 
-  *inout_len = count;
-  return static_cast<const unsigned char *>(buf);
+  *out_len = in_ring_.size();
+  return in_ring_.read_ptr();
+}
+
+void BufferedIOStream::consume(size_t len) {
+  std::unique_lock<std::mutex> l(lock_);
+  in_ring_.consume(len);
+  can_receive_.notify_one();
+}
+
+void *BufferedIOStream::prepare_receive(size_t *available) {
+  std::unique_lock<std::mutex> l(lock_);
+  can_receive_.wait(l, [&]() { return closed_ || !in_ring_.full(); });
+  if (closed_) return nullptr;
+
+  receiving_ = true;
+  *available = in_ring_.free();
+  receive_ptr_ = in_ring_.write_ptr();
+  return receive_ptr_;
+}
+
+void BufferedIOStream::commit_receive(size_t size) {
+  // The space is still reserved for the receiver so it can be recorded
+  // without holding up the render thread.
+  if (capture_ && size > 0) capture_->append(receive_ptr_, size);
+
+  std::unique_lock<std::mutex> l(lock_);
+  in_ring_.commit(size);
+  receiving_ = false;
+  can_read_.notify_all();
 }
 
 void BufferedIOStream::forceStop() {
-  std::lock_guard<std::mutex> l(lock_);
-  in_queue_.close_locked();
-  out_queue_.close_locked();
+  {
+    std::lock_guard<std::mutex> l(lock_);
+    closed_ = true;
+    can_read_.notify_all();
+    can_receive_.notify_all();
+  }
+
+  std::lock_guard<std::mutex> l(out_lock_);
+  stopped_ = true;
+  can_write_.notify_all();
+  can_commit_.notify_all();
 }
 
 void BufferedIOStream::post_data(Buffer &&data) {
-  std::unique_lock<std::mutex> l(lock_);
-  in_queue_.push_locked(std::move(data), l);
+  size_t offset = 0;
+  while (offset < data.size()) {
+    size_t available = 0;
+    auto ptr = prepare_receive(&available);
+    if (!ptr) return;
+
+    const auto count = std::min<size_t>(available, data.size() - offset);
+    memcpy(ptr, data.data() + offset, count);
+    commit_receive(count);
+    offset += count;
+  }
+}
+
+void BufferedIOStream::set_capture(std::unique_ptr<StreamCaptureWriter> capture) {
+  capture_ = std::move(capture);
 }
 
 bool BufferedIOStream::needs_data() {
   std::unique_lock<std::mutex> l(lock_);
-  return !in_queue_.can_pop_locked();
+  return in_ring_.empty();
 }
 
 void BufferedIOStream::thread_main() {
+  std::vector<Buffer> buffers;
+  std::unique_lock<std::mutex> l(out_lock_);
   while (true) {
-    std::unique_lock<std::mutex> l(out_lock_);
-
-    Buffer buffer;
-    const auto result = out_queue_.pop_locked(&buffer, l);
-    if (result != 0 && result != -EAGAIN) break;
-
-    auto bytes_left = buffer.size();
-    while (bytes_left > 0) {
-      const auto written = messenger_->send_raw(
-          buffer.data() + (buffer.size() - bytes_left), bytes_left);
-      if (written < 0) {
-        if (errno != EINTR && errno != EAGAIN) {
-          ERROR("Failed to write data: %s", std::strerror(errno));
-          break;
-        }
-        // Socket is busy, lets try again
-      } else
-        bytes_left -= written;
+    // Replies which are already queued are still written out once we're
+    // stopped so that the client sees everything it was sent.
+    can_write_.wait(l, [&]() { return stopped_ || !pending_writes_.empty(); });
+    if (pending_writes_.empty()) break;
+
+    buffers.swap(pending_writes_);
+    pending_write_size_ = 0;
+    can_commit_.notify_all();
+
+    write_locked(buffers, l);
+    buffers.clear();
+  }
+}
+
+void BufferedIOStream::write_locked(std::vector<Buffer> &buffers,
+                                    std::unique_lock<std::mutex> &lock) {
+  writing_ = true;
+  lock.unlock();
+
+  size_t index = 0;
+  size_t offset = 0;
+  while (index < buffers.size()) {
+    iov_.clear();
+    for (size_t n = index; n < buffers.size() && iov_.size() < IOV_MAX; n++) {
+      const auto skip = (n == index) ? offset : 0;
+      iov_.push_back({buffers[n].data() + skip, buffers[n].size() - skip});
+    }
+
+    auto written = messenger_->send_raw_vectored(iov_.data(), iov_.size());
+    if (written < 0) {
+      if (errno != EINTR && errno != EAGAIN) {
+        ERROR("Failed to write data: %s", std::strerror(errno));
+        break;
+      }
+      // Socket is busy, lets try again
+      continue;
+    }
+
+    while (written > 0 && index < buffers.size()) {
+      const auto left = buffers[index].size() - offset;
+      const auto count = std::min<size_t>(left, static_cast<size_t>(written));
+      written -= static_cast<ssize_t>(count);
+      offset += count;
+      if (offset == buffers[index].size()) {
+        index++;
+        offset = 0;
+      }
     }
   }
+
+  lock.lock();
+  writing_ = false;
+}
 }
-}
\ No newline at end of file
@@ -20,16 +20,24 @@
 
 #include "external/android-emugl/host/include/libOpenglRender/IOStream.h"
 
+#include "anbox/common/ring_buffer.h"
 #include "anbox/graphics/buffer_queue.h"
+#include "anbox/graphics/stream_capture.h"
 #include "anbox/network/socket_messenger.h"
 
+#include <condition_variable>
 #include <memory>
 #include <thread>
+#include <vector>
+
+#include <sys/uio.h>
 
 namespace anbox::graphics {
 class BufferedIOStream : public IOStream {
  public:
   static const size_t default_buffer_size{384};
+  static const size_t default_ring_size{4 * 1024 * 1024};
+  static const size_t max_pending_write_size{4 * 1024 * 1024};
 
   explicit BufferedIOStream(
       const std::shared_ptr<anbox::network::SocketMessenger> &messenger,
@@ -41,21 +49,52 @@ class BufferedIOStream : public IOStream {
   size_t commitBuffer(size_t size) override;
   const unsigned char *read(void *buf, size_t *inout_len) override;
   void forceStop() override;
+
+  bool canReadInPlace() const override { return true; }
+  unsigned char *readInPlace(size_t pending, size_t *out_len) override;
+  void consume(size_t len) override;
+
+  // Receives incoming data directly into the ring. prepare_receive()
+  // blocks until the ring has free space and returns it, or nullptr when
+  // the stream was stopped. Every successful call has to be followed by
+  // commit_receive() with the number of bytes actually written.
+  void *prepare_receive(size_t *available);
+  void commit_receive(size_t size);
+
   void post_data(Buffer &&data);
 
+  // Records everything received from now on into |capture|. Has to be
+  // set before data is received.
+  void set_capture(std::unique_ptr<StreamCaptureWriter> capture);
+
   bool needs_data();
 
  private:
   void thread_main();
+  void write_locked(std::vector<Buffer> &buffers, std::unique_lock<std::mutex> &lock);
 
   std::shared_ptr<anbox::network::SocketMessenger> messenger_;
   std::mutex lock_;
   std::mutex out_lock_;
   Buffer write_buffer_;
-  Buffer read_buffer_;
-  size_t read_buffer_left_ = 0;
-  BufferQueue in_queue_;
-  BufferQueue out_queue_;
+  common::RingBuffer in_ring_;
+  bool receiving_ = false;
+  // Where the receiver currently writes to and what it gets recorded to,
+  // both only used by the receiver.
+  unsigned char *receive_ptr_ = nullptr;
+  std::unique_ptr<StreamCaptureWriter> capture_;
+  bool closed_ = false;
+  std::condition_variable can_receive_;
+  std::condition_variable can_read_;
+  // Replies which couldn't be written out right away. The worker thread
+  // sends all of them together with a single vectored write.
+  std::vector<Buffer> pending_writes_;
+  size_t pending_write_size_ = 0;
+  bool writing_ = false;
+  bool stopped_ = false;
+  std::condition_variable can_write_;
+  std::condition_variable can_commit_;
+  std::vector<struct iovec> iov_;
   std::thread worker_thread_;
 };
 }
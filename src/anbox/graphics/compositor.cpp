@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "anbox/graphics/compositor.h"
+#include "anbox/graphics/layer_composer.h"
+
+namespace anbox::graphics {
+Compositor::Compositor(const std::shared_ptr<LayerComposer> &composer,
+                       const std::chrono::nanoseconds &vsync_period)
+    : composer_(composer), vsync_period_(vsync_period),
+      thread_(&Compositor::run, this) {}
+
+Compositor::~Compositor() { stop(); }
+
+void Compositor::submit_layers(RenderableList &&renderables) {
+  {
+    // Only taken while waiting by the compositor thread so this doesn't
+    // wait for presentation. It serializes multiple guest threads posting
+    // frames as the mailbox only supports a single producer.
+    std::lock_guard<std::mutex> l(mutex_);
+    if (!running_) return;
+    mailbox_.back() = std::move(renderables);
+    if (mailbox_.publish()) dropped_frames_++;
+  }
+  frame_available_.notify_one();
+}
+
+void Compositor::stop() {
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    running_ = false;
+  }
+  frame_available_.notify_all();
+  if (thread_.joinable()) thread_.join();
+}
+
+void Compositor::run() {
+  const auto paced = vsync_period_.count() > 0;
+  const auto epoch = std::chrono::steady_clock::now();
+  auto next_vsync = epoch;
+
+  std::unique_lock<std::mutex> l(mutex_);
+  while (running_) {
+    frame_available_.wait(l, [&] { return !running_ || mailbox_.pending(); });
+
+    // Frames posted until the next vsync replace the one we woke up for.
+    if (paced)
+      frame_available_.wait_until(l, next_vsync, [&] { return !running_; });
+    if (!running_) break;
+
+    l.unlock();
+    if (mailbox_.latch()) composer_->submit_layers(mailbox_.front());
+
+    // Present at most once per period and stay aligned to the vsync
+    // grid, also after frames took longer than a period to present.
+    if (paced) {
+      const auto ticks = (std::chrono::steady_clock::now() - epoch) / vsync_period_ + 1;
+      next_vsync = epoch + ticks * vsync_period_;
+    }
+    l.lock();
+  }
+}
+}
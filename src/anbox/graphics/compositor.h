@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef ANBOX_GRAPHICS_COMPOSITOR_H_
+#define ANBOX_GRAPHICS_COMPOSITOR_H_
+
+#include "anbox/common/triple_buffer.h"
+#include "anbox/graphics/emugl/Renderable.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace anbox::graphics {
+class LayerComposer;
+
+// Presents the layers the guest posts on a thread of its own so that the
+// guest render thread never waits for the host to swap buffers. Only the
+// most recent layer list is kept, frames posted faster than they can be
+// presented replace each other. Presentation is paced to |vsync_period|,
+// a zero period presents every frame as soon as it arrives.
+class Compositor {
+ public:
+  Compositor(const std::shared_ptr<LayerComposer> &composer,
+             const std::chrono::nanoseconds &vsync_period);
+  ~Compositor();
+
+  Compositor(const Compositor&) = delete;
+  Compositor& operator=(const Compositor&) = delete;
+
+  // Hands the layers of the next frame to the compositor thread. Never
+  // blocks on presentation.
+  void submit_layers(RenderableList &&renderables);
+
+  // Presents nothing anymore after returning. Pending frames are dropped.
+  void stop();
+
+  std::chrono::nanoseconds vsync_period() const { return vsync_period_; }
+  std::uint64_t dropped_frames() const { return dropped_frames_; }
+
+ private:
+  void run();
+
+  std::shared_ptr<LayerComposer> composer_;
+  std::chrono::nanoseconds vsync_period_;
+  common::TripleBuffer<RenderableList> mailbox_;
+  std::atomic<std::uint64_t> dropped_frames_{0};
+
+  std::mutex mutex_;
+  std::condition_variable frame_available_;
+  bool running_ = true;
+  std::thread thread_;
+};
+}
+
+#endif
@@ -16,6 +16,9 @@
 
 #include "anbox/graphics/emugl/ColorBuffer.h"
 #include "anbox/graphics/emugl/DispatchTables.h"
+#include "anbox/graphics/emugl/EglBinding.h"
+#include "anbox/graphics/emugl/PixelTransfer.h"
+#include "anbox/graphics/emugl/RenderContext.h"
 #include "anbox/graphics/emugl/RenderThreadInfo.h"
 #include "anbox/graphics/emugl/TextureDraw.h"
 #include "anbox/graphics/emugl/TextureResize.h"
@@ -25,6 +28,21 @@
 
 #include <stdio.h>
 
+#include <algorithm>
+
+#ifndef GL_READ_FRAMEBUFFER
+#define GL_READ_FRAMEBUFFER 0x8CA8
+#endif
+#ifndef GL_DRAW_FRAMEBUFFER
+#define GL_DRAW_FRAMEBUFFER 0x8CA9
+#endif
+#ifndef GL_DRAW_FRAMEBUFFER_BINDING
+#define GL_DRAW_FRAMEBUFFER_BINDING 0x8CA6
+#endif
+#ifndef GL_READ_FRAMEBUFFER_BINDING
+#define GL_READ_FRAMEBUFFER_BINDING 0x8CAA
+#endif
+
 namespace {
 
 // <EGL/egl.h> defines many types as 'void*' while they're really
@@ -63,6 +81,14 @@ bool bindFbo(GLuint* fbo, GLuint tex) {
 
 void unbindFbo() { s_gles2.glBindFramebuffer(GL_FRAMEBUFFER, 0); }
 
+// Clear |tex| through the lazily created framebuffer object |fbo|.
+void clearTexture(GLuint* fbo, GLuint tex) {
+  if (!bindFbo(fbo, tex)) return;
+  s_gles2.glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+  s_gles2.glClear(GL_COLOR_BUFFER_BIT);
+  unbindFbo();
+}
+
 // Helper class to use a ColorBuffer::Helper context.
 // Usage is pretty simple:
 //
@@ -100,26 +126,29 @@ class ScopedHelperContext {
 }  // namespace
 
 // static
-ColorBuffer* ColorBuffer::create(EGLDisplay p_display, int p_width,
-                                 int p_height, GLenum p_internalFormat,
-                                 bool has_eglimage_texture_2d, Helper* helper) {
-  GLenum texInternalFormat = 0;
-
+GLenum ColorBuffer::getTextureFormat(GLenum p_internalFormat) {
   switch (p_internalFormat) {
     case GL_RGB:
     case GL_RGB565_OES:
-      texInternalFormat = GL_RGB;
-      break;
+      return GL_RGB;
 
     case GL_RGBA:
     case GL_RGB5_A1_OES:
     case GL_RGBA4_OES:
-      texInternalFormat = GL_RGBA;
-      break;
+      return GL_RGBA;
 
     default:
-      return NULL;
-      break;
+      return 0;
+  }
+}
+
+// static
+ColorBuffer* ColorBuffer::create(EGLDisplay p_display, int p_width,
+                                 int p_height, GLenum p_internalFormat,
+                                 bool has_eglimage_texture_2d, Helper* helper) {
+  const GLenum texInternalFormat = getTextureFormat(p_internalFormat);
+  if (!texInternalFormat) {
+    return NULL;
   }
 
   ScopedHelperContext context(helper);
@@ -132,12 +161,10 @@ ColorBuffer* ColorBuffer::create(EGLDisplay p_display, int p_width,
   s_gles2.glGenTextures(1, &cb->m_tex);
   s_gles2.glBindTexture(GL_TEXTURE_2D, cb->m_tex);
 
-  int nComp = (texInternalFormat == GL_RGB ? 3 : 4);
-
-  char* zBuff = static_cast<char*>(::calloc(nComp * p_width * p_height, 1));
+  // The initial content is cleared on the GPU below instead of uploading
+  // a zero-filled buffer.
   s_gles2.glTexImage2D(GL_TEXTURE_2D, 0, texInternalFormat, p_width, p_height,
-                       0, texInternalFormat, GL_UNSIGNED_BYTE, zBuff);
-  ::free(zBuff);
+                       0, texInternalFormat, GL_UNSIGNED_BYTE, NULL);
 
   s_gles2.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
   s_gles2.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -163,16 +190,18 @@ ColorBuffer* ColorBuffer::create(EGLDisplay p_display, int p_width,
 
   if (has_eglimage_texture_2d) {
     cb->m_eglImage = s_egl.eglCreateImageKHR(
-        p_display, s_egl.eglGetCurrentContext(), EGL_GL_TEXTURE_2D_KHR,
+        p_display, EglBinding::get()->context(), EGL_GL_TEXTURE_2D_KHR,
         reinterpret_cast<EGLClientBuffer>(SafePointerFromUInt(cb->m_tex)), NULL);
 
     cb->m_blitEGLImage = s_egl.eglCreateImageKHR(
-        p_display, s_egl.eglGetCurrentContext(), EGL_GL_TEXTURE_2D_KHR,
+        p_display, EglBinding::get()->context(), EGL_GL_TEXTURE_2D_KHR,
         reinterpret_cast<EGLClientBuffer>(SafePointerFromUInt(cb->m_blitTex)), NULL);
   }
 
   cb->m_resizer = new TextureResize(p_width, p_height);
 
+  clearTexture(&cb->m_fbo, cb->m_tex);
+
   return cb;
 }
 
@@ -187,6 +216,11 @@ ColorBuffer::ColorBuffer(EGLDisplay display, Helper* helper)
       m_helper(helper) {}
 
 ColorBuffer::~ColorBuffer() {
+  for (const auto& target : m_blitTargets) {
+    if (auto context = target.context.lock())
+      context->deleteLater(target.texture, target.framebuffer);
+  }
+
   ScopedHelperContext context(m_helper);
 
   if (m_blitEGLImage) {
@@ -214,11 +248,26 @@ void ColorBuffer::readPixels(int x, int y, int width, int height,
   }
 
   if (bindFbo(&m_fbo, m_tex)) {
-    s_gles2.glReadPixels(x, y, width, height, p_format, p_type, pixels);
+    // The guest expects the rows tightly packed.
+    s_gles2.glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    auto transfer = m_helper->getPixelTransfer();
+    if (!transfer ||
+        !transfer->readback(x, y, width, height, p_format, p_type, pixels))
+      s_gles2.glReadPixels(x, y, width, height, p_format, p_type, pixels);
     unbindFbo();
   }
 }
 
+void ColorBuffer::clear() {
+  ScopedHelperContext context(m_helper);
+  if (!context.isOk()) {
+    return;
+  }
+
+  clearTexture(&m_fbo, m_tex);
+  m_generation++;
+}
+
 void ColorBuffer::subUpdate(int x, int y, int width, int height,
                             GLenum p_format, GLenum p_type, void* pixels) {
   ScopedHelperContext context(m_helper);
@@ -228,8 +277,12 @@ void ColorBuffer::subUpdate(int x, int y, int width, int height,
 
   s_gles2.glBindTexture(GL_TEXTURE_2D, m_tex);
   s_gles2.glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-  s_gles2.glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, p_format,
-                          p_type, pixels);
+  auto transfer = m_helper->getPixelTransfer();
+  if (!transfer ||
+      !transfer->upload(x, y, width, height, p_format, p_type, pixels))
+    s_gles2.glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, p_format,
+                            p_type, pixels);
+  m_generation++;
 }
 
 bool ColorBuffer::blitFromCurrentReadBuffer() {
@@ -239,6 +292,11 @@ bool ColorBuffer::blitFromCurrentReadBuffer() {
     return false;
   }
 
+  if (m_eglImage && blitFramebufferFromCurrentReadBuffer(tInfo->currContext)) {
+    m_generation++;
+    return true;
+  }
+
   // Copy the content of the current read surface into m_blitEGLImage.
   // This is done by creating a temporary texture, bind it to the EGLImage
   // then call glCopyTexSubImage2D().
@@ -287,9 +345,69 @@ bool ColorBuffer::blitFromCurrentReadBuffer() {
   s_gles2.glViewport(vport[0], vport[1], vport[2], vport[3]);
   unbindFbo();
 
+  m_generation++;
   return true;
 }
 
+// Copies the read surface straight into the buffer's EGLImage from the
+// blit context of the current context. The buffer holds its rows top down
+// while the surface has them bottom up, so the blit flips them on the way.
+// This saves the copy into m_blitTex and the draw in the helper context.
+bool ColorBuffer::blitFramebufferFromCurrentReadBuffer(
+    const std::shared_ptr<RenderContext>& context) {
+  auto binding = EglBinding::get();
+  const auto prev = binding->current();
+  if (!context->bindBlitContext(prev.read)) {
+    binding->makeCurrent(m_display, prev.draw, prev.read, prev.context);
+    return false;
+  }
+
+  auto target = m_blitTargets.begin();
+  for (; target != m_blitTargets.end(); ++target) {
+    if (target->context.lock() == context) break;
+  }
+
+  bool ok = true;
+  if (target == m_blitTargets.end()) {
+    // Contexts which went away took their objects with them.
+    m_blitTargets.erase(
+        std::remove_if(m_blitTargets.begin(), m_blitTargets.end(),
+                       [](const BlitTarget& t) { return t.context.expired(); }),
+        m_blitTargets.end());
+
+    GLuint tex = 0, fbo = 0;
+    s_gles2.glGenTextures(1, &tex);
+    s_gles2.glBindTexture(GL_TEXTURE_2D, tex);
+    s_gles2.glEGLImageTargetTexture2DOES(GL_TEXTURE_2D, m_eglImage);
+    s_gles2.glGenFramebuffers(1, &fbo);
+    s_gles2.glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo);
+    s_gles2.glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                                   GL_TEXTURE_2D, tex, 0);
+    if (s_gles2.glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER) ==
+        GL_FRAMEBUFFER_COMPLETE) {
+      m_blitTargets.push_back({context, tex, fbo});
+    } else {
+      s_gles2.glDeleteFramebuffers(1, &fbo);
+      s_gles2.glDeleteTextures(1, &tex);
+      ok = false;
+    }
+  } else {
+    s_gles2.glBindFramebuffer(GL_DRAW_FRAMEBUFFER, target->framebuffer);
+  }
+
+  if (ok) {
+    // The blit context reads from the surface itself and nothing else
+    // changes its state, so no guest state needs to be saved around this.
+    s_gles2.glBlitFramebuffer(0, 0, m_width, m_height, 0, m_height, m_width,
+                              0, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    // The renderer only sees the result once it reached the driver.
+    s_gles2.glFlush();
+  }
+
+  binding->makeCurrent(m_display, prev.draw, prev.read, prev.context);
+  return ok;
+}
+
 bool ColorBuffer::bindToTexture() {
   if (!m_eglImage) {
     return false;
@@ -303,6 +421,8 @@ bool ColorBuffer::bindToTexture() {
   } else {
     s_gles1.glEGLImageTargetTexture2DOES(GL_TEXTURE_2D, m_eglImage);
   }
+  m_generation++;
+  m_boundToGuest = true;
   return true;
 }
 
@@ -321,6 +441,8 @@ bool ColorBuffer::bindToRenderbuffer() {
     s_gles1.glEGLImageTargetRenderbufferStorageOES(GL_RENDERBUFFER_OES,
                                                    m_eglImage);
   }
+  m_generation++;
+  m_boundToGuest = true;
   return true;
 }
 
@@ -336,7 +458,10 @@ void ColorBuffer::readback(unsigned char* img) {
   }
 }
 
-void ColorBuffer::bind() {
-  const auto id = m_resizer->update(m_tex);
-  s_gles2.glBindTexture(GL_TEXTURE_2D, id);
+void ColorBuffer::bind(GLint viewportWidth, GLint viewportHeight) {
+  s_gles2.glBindTexture(GL_TEXTURE_2D, getTexture(viewportWidth, viewportHeight));
+}
+
+GLuint ColorBuffer::getTexture(GLint viewportWidth, GLint viewportHeight) {
+  return m_resizer->update(m_tex, m_generation, viewportWidth, viewportHeight);
 }
@@ -21,7 +21,11 @@
 #include <GLES/gl.h>
 
 #include <memory>
+#include <vector>
 
+class RenderContext;
+
+class PixelTransfer;
 class TextureDraw;
 class TextureResize;
 
@@ -64,6 +68,9 @@ class ColorBuffer {
     virtual bool setupContext() = 0;
     virtual void teardownContext() = 0;
     virtual TextureDraw* getTextureDraw() const = 0;
+    // Return the engine used for streaming pixel transfers, or nullptr if
+    // the host doesn't support it.
+    virtual PixelTransfer* getPixelTransfer() const { return nullptr; }
   };
 
   // Create a new ColorBuffer instance.
@@ -79,6 +86,10 @@ class ColorBuffer {
                              GLenum p_internalFormat,
                              bool has_eglimage_texture_2d, Helper* helper);
 
+  // Return the texture format a ColorBuffer created with |p_internalFormat|
+  // uses, or 0 if the format isn't supported.
+  static GLenum getTextureFormat(GLenum p_internalFormat);
+
   // Destructor.
   ~ColorBuffer();
 
@@ -86,6 +97,13 @@ class ColorBuffer {
   GLuint getWidth() const { return m_width; }
   GLuint getHeight() const { return m_height; }
 
+  // Return the texture format of the ColorBuffer, either GL_RGB or GL_RGBA.
+  GLenum getInternalFormat() const { return m_internalFormat; }
+
+  // Reset the content of the whole buffer to transparent black. This is
+  // done on the GPU so no pixels need to be uploaded.
+  void clear();
+
   // Read the ColorBuffer instance's pixel values into host memory.
   void readPixels(int x, int y, int width, int height, GLenum p_format,
                   GLenum p_type, void* pixels);
@@ -106,6 +124,8 @@ class ColorBuffer {
 
   // Copy the content of the current context's read surface to this
   // ColorBuffer. This is used from WindowSurface::flushColorBuffer().
+  // GLES 3 capable contexts blit straight into the buffer, others go
+  // through an intermediate texture and the helper context.
   // Return true on success, false on failure (e.g. no current context).
   bool blitFromCurrentReadBuffer();
 
@@ -113,13 +133,44 @@ class ColorBuffer {
   // |img| must be a buffer large enough (i.e. width * height * 4).
   void readback(unsigned char* img);
 
-  void bind();
+  void bind(GLint viewportWidth, GLint viewportHeight);
+
+  // Return the texture to sample the buffer content from for a viewport of
+  // |viewportWidth| x |viewportHeight| at the origin. This may be a
+  // downscaled copy of the buffer, which is kept until the content of the
+  // buffer changes (see getGeneration()). Producing it changes the current
+  // program, framebuffer and texture bindings, so it has to be called before
+  // any draw state is set up.
+  GLuint getTexture(GLint viewportWidth, GLint viewportHeight);
+
+  // Returns a counter which is increased whenever the content of the
+  // buffer is changed by subUpdate() or blitFromCurrentReadBuffer(). As
+  // rendering into a buffer bound with bindToTexture() or
+  // bindToRenderbuffer() can't be tracked, binding counts as a change too
+  // and so does every markPosted() afterwards.
+  unsigned int getGeneration() const { return m_generation; }
+
+  // Called whenever the guest posts the buffer for composition. Buffers
+  // the guest renders into through bindToTexture() or bindToRenderbuffer()
+  // may have changed since the last post.
+  void markPosted() {
+    if (m_boundToGuest)
+      m_generation++;
+  }
+
+  // Return true once the buffer was bound with bindToTexture() or
+  // bindToRenderbuffer(). Guest textures and renderbuffers keep referring
+  // to its EGLImage for as long as the guest doesn't delete them.
+  bool isBoundToGuest() const { return m_boundToGuest; }
 
  private:
   ColorBuffer();  // no default constructor.
 
   explicit ColorBuffer(EGLDisplay display, Helper* helper);
 
+  bool blitFramebufferFromCurrentReadBuffer(
+      const std::shared_ptr<RenderContext>& context);
+
  private:
   GLuint m_tex;
   GLuint m_blitTex;
@@ -132,6 +183,18 @@ class ColorBuffer {
   EGLDisplay m_display;
   Helper* m_helper;
   TextureResize* m_resizer;
+  unsigned int m_generation = 0;
+  bool m_boundToGuest = false;
+
+  // Texture and framebuffer wrapping m_eglImage in the blit context of each
+  // guest context the buffer was blitted into from, created on first use.
+  // They belong to that context and are handed back to it for deletion.
+  struct BlitTarget {
+    std::weak_ptr<RenderContext> context;
+    GLuint texture;
+    GLuint framebuffer;
+  };
+  std::vector<BlitTarget> m_blitTargets;
 };
 
 typedef std::shared_ptr<ColorBuffer> ColorBufferPtr;
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "anbox/graphics/emugl/ColorBufferPool.h"
+
+#include <iterator>
+
+ColorBufferPool::ColorBufferPool(size_t maxBytes) : m_maxBytes(maxBytes) {}
+
+ColorBufferPool::~ColorBufferPool() { clear(); }
+
+size_t ColorBufferPool::bytesOf(const ColorBuffer& cb) {
+  // Every ColorBuffer has a second texture of the same size for blits.
+  const size_t bpp = cb.getInternalFormat() == GL_RGB ? 3 : 4;
+  return 2 * bpp * cb.getWidth() * cb.getHeight();
+}
+
+ColorBufferPtr ColorBufferPool::acquire(int width, int height,
+                                        GLenum internalFormat) {
+  const auto format = ColorBuffer::getTextureFormat(internalFormat);
+
+  // Prefer the most recently recycled buffer, its memory is the most
+  // likely to still be resident.
+  for (auto it = m_buffers.rbegin(); it != m_buffers.rend(); ++it) {
+    const auto& cb = *it;
+    if (cb->getWidth() != static_cast<GLuint>(width) ||
+        cb->getHeight() != static_cast<GLuint>(height) ||
+        cb->getInternalFormat() != format)
+      continue;
+
+    auto result = cb;
+    m_bytes -= bytesOf(*result);
+    m_buffers.erase(std::next(it).base());
+    m_hits++;
+
+    // Don't leak what the previous owner rendered into a new buffer.
+    result->clear();
+    return result;
+  }
+
+  m_misses++;
+  return ColorBufferPtr();
+}
+
+void ColorBufferPool::recycle(const ColorBufferPtr& cb) {
+  if (cb->isBoundToGuest()) return;
+
+  const auto bytes = bytesOf(*cb);
+  if (bytes > m_maxBytes) return;
+
+  m_buffers.push_back(cb);
+  m_bytes += bytes;
+
+  while (m_bytes > m_maxBytes) {
+    m_bytes -= bytesOf(*m_buffers.front());
+    m_buffers.pop_front();
+  }
+}
+
+void ColorBufferPool::clear() {
+  m_buffers.clear();
+  m_bytes = 0;
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef ANBOX_GRAPHICS_EMUGL_COLOR_BUFFER_POOL_H_
+#define ANBOX_GRAPHICS_EMUGL_COLOR_BUFFER_POOL_H_
+
+#include "anbox/graphics/emugl/ColorBuffer.h"
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+
+// Keeps ColorBuffers the guest closed around so that a later request for a
+// buffer of the same size and format can reuse its textures, EGLImages and
+// framebuffer instead of creating them again. Gralloc allocates and frees
+// lots of equally sized buffers while applications start or the display
+// rotates.
+//
+// The pool holds at most |maxBytes| worth of buffers and drops the least
+// recently recycled ones first. It does not synchronize by itself, callers
+// have to serialize access and hold whatever ColorBuffer operations need.
+class ColorBufferPool {
+ public:
+  explicit ColorBufferPool(size_t maxBytes);
+  ~ColorBufferPool();
+
+  ColorBufferPool(const ColorBufferPool&) = delete;
+  ColorBufferPool& operator=(const ColorBufferPool&) = delete;
+
+  // Return a buffer with the given properties from the pool or NULL if
+  // there is none. The content of a returned buffer is cleared.
+  ColorBufferPtr acquire(int width, int height, GLenum internalFormat);
+
+  // Keep |cb| for reuse. |cb| must not be referenced anywhere else.
+  // Buffers bound to guest textures or renderbuffers are dropped instead,
+  // their previous owner could still render into them.
+  void recycle(const ColorBufferPtr& cb);
+
+  // Destroy all pooled buffers.
+  void clear();
+
+  size_t size() const { return m_buffers.size(); }
+  size_t bytes() const { return m_bytes; }
+
+  // Number of acquire() calls which could and couldn't be served from the
+  // pool. Can be read from any thread.
+  std::uint64_t hits() const { return m_hits; }
+  std::uint64_t misses() const { return m_misses; }
+
+ private:
+  static size_t bytesOf(const ColorBuffer& cb);
+
+  size_t m_maxBytes;
+  size_t m_bytes = 0;
+  // Least recently recycled first.
+  std::deque<ColorBufferPtr> m_buffers;
+  std::atomic<std::uint64_t> m_hits{0};
+  std::atomic<std::uint64_t> m_misses{0};
+};
+
+#endif
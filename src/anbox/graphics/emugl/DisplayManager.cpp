@@ -31,4 +31,10 @@ void DisplayInfo::set_resolution(const std::uint32_t &vertical, const std::uint3
 std::uint32_t DisplayInfo::vertical_resolution() const { return vertical_resolution_; }
 
 std::uint32_t DisplayInfo::horizontal_resolution() const { return horizontal_resolution_; }
+
+void DisplayInfo::set_vsync_period(const std::chrono::nanoseconds &period) {
+  vsync_period_ = period;
+}
+
+std::chrono::nanoseconds DisplayInfo::vsync_period() const { return vsync_period_; }
 }
\ No newline at end of file
@@ -18,6 +18,7 @@
 #ifndef ANBOX_GRAPHICS_EMUGL_DISPLAY_INFO_H_
 #define ANBOX_GRAPHICS_EMUGL_DISPLAY_INFO_H_
 
+#include <chrono>
 #include <cstdint>
 #include <memory>
 
@@ -33,9 +34,15 @@ class DisplayInfo {
   std::uint32_t vertical_resolution() const;
   std::uint32_t horizontal_resolution() const;
 
+  // Time between two frames presented on the host. Reported to the guest
+  // so it paces its rendering to what the host actually presents.
+  void set_vsync_period(const std::chrono::nanoseconds &period);
+  std::chrono::nanoseconds vsync_period() const;
+
  private:
   std::uint32_t vertical_resolution_ = 1280;
   std::uint32_t horizontal_resolution_ = 720;
+  std::chrono::nanoseconds vsync_period_{std::chrono::seconds{1} / 60};
 };
 }
 #endif
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "anbox/graphics/emugl/EglBinding.h"
+
+#include "external/android-emugl/host/include/OpenGLESDispatch/EGLDispatch.h"
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wcast-align"
+#include "external/android-emugl/shared/emugl/common/lazy_instance.h"
+#include "external/android-emugl/shared/emugl/common/thread_store.h"
+#pragma GCC diagnostic pop
+
+#include <atomic>
+
+namespace {
+void destroyBinding(void *value) { delete static_cast<EglBinding *>(value); }
+
+class BindingStore : public ::emugl::ThreadStore {
+ public:
+  BindingStore() : ::emugl::ThreadStore(destroyBinding) {}
+};
+
+::emugl::LazyInstance<BindingStore> s_tls = LAZY_INSTANCE_INIT;
+
+std::atomic<std::uint64_t> s_switches{0};
+std::atomic<std::uint64_t> s_avoided{0};
+}  // namespace
+
+EglBinding *EglBinding::get() {
+  auto binding = static_cast<EglBinding *>(s_tls->get());
+  if (!binding) {
+    binding = new EglBinding;
+    s_tls->set(binding);
+  }
+  return binding;
+}
+
+bool EglBinding::makeCurrent(EGLDisplay display, EGLSurface draw,
+                             EGLSurface read, EGLContext context) {
+  // Releasing the context unbinds the surfaces whatever display the
+  // binding belonged to.
+  if (m_known &&
+      (context == EGL_NO_CONTEXT
+           ? m_state.context == EGL_NO_CONTEXT
+           : (m_state.display == display && m_state.draw == draw &&
+              m_state.read == read && m_state.context == context))) {
+    s_avoided++;
+    return true;
+  }
+
+  s_switches++;
+  if (!s_egl.eglMakeCurrent(display, draw, read, context)) {
+    // The binding should be unchanged but don't rely on every driver to
+    // get that right.
+    m_known = false;
+    return false;
+  }
+
+  if (context == EGL_NO_CONTEXT)
+    m_state = {EGL_NO_DISPLAY, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT};
+  else
+    m_state = {display, draw, read, context};
+  m_known = true;
+  return true;
+}
+
+const EglBinding::State &EglBinding::current() {
+  if (!m_known) {
+    m_state.context = s_egl.eglGetCurrentContext();
+    if (m_state.context == EGL_NO_CONTEXT) {
+      m_state = {EGL_NO_DISPLAY, EGL_NO_SURFACE, EGL_NO_SURFACE,
+                 EGL_NO_CONTEXT};
+    } else {
+      // The dispatch table has no eglGetCurrentDisplay(). Leaving the
+      // display unknown only costs one real switch on the next change.
+      m_state.display = EGL_NO_DISPLAY;
+      m_state.draw = s_egl.eglGetCurrentSurface(EGL_DRAW);
+      m_state.read = s_egl.eglGetCurrentSurface(EGL_READ);
+    }
+    m_known = true;
+  }
+  return m_state;
+}
+
+std::uint64_t EglBinding::switches() { return s_switches; }
+
+std::uint64_t EglBinding::avoided() { return s_avoided; }
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef ANBOX_GRAPHICS_EMUGL_EGL_BINDING_H_
+#define ANBOX_GRAPHICS_EMUGL_EGL_BINDING_H_
+
+#include <EGL/egl.h>
+
+#include <cstdint>
+
+// Remembers which display, surfaces and context are current on the calling
+// thread so that eglMakeCurrent() can be skipped when nothing changes and
+// eglGetCurrentContext() / eglGetCurrentSurface() don't have to go to the
+// driver. This only works as long as all host side bindings are changed
+// through makeCurrent(); anything else has to call invalidate() afterwards.
+class EglBinding {
+ public:
+  struct State {
+    EGLDisplay display;
+    EGLSurface draw;
+    EGLSurface read;
+    EGLContext context;
+  };
+
+  // Return the instance of the calling thread, creating it on first use.
+  static EglBinding* get();
+
+  // Equivalent of eglMakeCurrent(). Returns true without calling into EGL
+  // if the requested binding is current already.
+  bool makeCurrent(EGLDisplay display, EGLSurface draw, EGLSurface read,
+                   EGLContext context);
+
+  // Unbind whatever is current on |display|.
+  bool release(EGLDisplay display) {
+    return makeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE,
+                       EGL_NO_CONTEXT);
+  }
+
+  // The current binding. |display| is EGL_NO_DISPLAY if the binding was
+  // not made through makeCurrent(), restore it with the display the caller
+  // knows it belongs to.
+  const State& current();
+  EGLContext context() { return current().context; }
+  EGLSurface drawSurface() { return current().draw; }
+  EGLSurface readSurface() { return current().read; }
+
+  // Forget the cached binding, it is queried from EGL again when needed.
+  void invalidate() { m_known = false; }
+
+  // Number of eglMakeCurrent() calls made and avoided by all threads.
+  static std::uint64_t switches();
+  static std::uint64_t avoided();
+
+ private:
+  EglBinding() = default;
+
+  State m_state = {EGL_NO_DISPLAY, EGL_NO_SURFACE, EGL_NO_SURFACE,
+                   EGL_NO_CONTEXT};
+  bool m_known = false;
+};
+
+#endif
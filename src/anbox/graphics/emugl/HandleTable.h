@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef ANBOX_GRAPHICS_EMUGL_HANDLE_TABLE_H_
+#define ANBOX_GRAPHICS_EMUGL_HANDLE_TABLE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <utility>
+#include <vector>
+
+// Type of handles, a.k.a. "object names" in the GL specification.
+// These are integers used to uniquely identify a resource of a given type.
+typedef uint32_t HandleType;
+
+// Maps handles to objects of type T in constant time. Objects are kept in
+// a dense array of slots and the handle encodes the slot index, so a
+// lookup is a bounds check and a compare instead of a tree walk.
+//
+// A handle is laid out as
+//
+//   | tag (2 bits) | generation (14 bits) | slot index (16 bits) |
+//
+// The tag is fixed per table so handles of different tables never
+// collide. The generation of a slot is bumped whenever its object is
+// erased which keeps stale handles from resolving to a later object in
+// the same slot. Freed slots are reused in FIFO order so a slot has to be
+// reused 2^14 times before one of its old handles becomes valid again.
+//
+// Pointers returned by find() are invalidated by insert(). The table does
+// not synchronize by itself.
+template <typename T>
+class HandleTable {
+ public:
+  static constexpr unsigned int index_bits = 16;
+  static constexpr unsigned int generation_bits = 14;
+  static constexpr unsigned int tag_bits = 2;
+  static constexpr size_t max_size = (1 << index_bits) - 1;
+
+  // |tag| must be between 1 and 3 so no handle is ever 0.
+  explicit HandleTable(unsigned int tag) : m_tag(tag) {
+    // Slot 0 is never handed out.
+    m_slots.resize(1);
+  }
+
+  // Store |value| and return its handle or 0 if the table is full.
+  HandleType insert(T value) {
+    size_t index;
+    if (!m_free.empty()) {
+      index = m_free.front();
+      m_free.pop_front();
+    } else if (m_slots.size() <= max_size) {
+      index = m_slots.size();
+      m_slots.emplace_back();
+    } else {
+      return 0;
+    }
+
+    auto& slot = m_slots[index];
+    slot.value = std::move(value);
+    slot.used = true;
+    m_size++;
+    return handleOf(index, slot.generation);
+  }
+
+  // Return the object |handle| refers to or NULL if there is none.
+  T* find(HandleType handle) {
+    const auto index = handle & index_mask;
+    if (index == 0 || index >= m_slots.size()) return nullptr;
+    auto& slot = m_slots[index];
+    if (!slot.used || handle != handleOf(index, slot.generation))
+      return nullptr;
+    return &slot.value;
+  }
+
+  // Remove the object |handle| refers to. Returns false if there is none.
+  bool erase(HandleType handle) {
+    if (!find(handle)) return false;
+
+    const auto index = handle & index_mask;
+    auto& slot = m_slots[index];
+    slot.value = T();
+    slot.used = false;
+    slot.generation = (slot.generation + 1) & generation_mask;
+    m_free.push_back(index);
+    m_size--;
+    return true;
+  }
+
+  void clear() {
+    for (size_t index = 1; index < m_slots.size(); index++) {
+      if (m_slots[index].used) erase(handleOf(index, m_slots[index].generation));
+    }
+  }
+
+  size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+
+ private:
+  static constexpr HandleType index_mask = (1u << index_bits) - 1;
+  static constexpr HandleType generation_mask = (1u << generation_bits) - 1;
+
+  struct Slot {
+    T value = T();
+    HandleType generation = 0;
+    bool used = false;
+  };
+
+  HandleType handleOf(size_t index, HandleType generation) const {
+    return (m_tag << (index_bits + generation_bits)) |
+           (generation << index_bits) | static_cast<HandleType>(index);
+  }
+
+  HandleType m_tag;
+  std::vector<Slot> m_slots;
+  std::deque<size_t> m_free;
+  size_t m_size = 0;
+};
+
+#endif
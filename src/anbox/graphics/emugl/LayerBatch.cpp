@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "anbox/graphics/emugl/LayerBatch.h"
+#include "anbox/graphics/emugl/DispatchTables.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+
+#include <cstddef>
+
+namespace {
+// Indices are 16 bit wide and every layer uses four vertices.
+constexpr size_t max_layers{65536 / 4};
+
+// Layer transformations are applied on the CPU when the layer is added so
+// everything a layer needs travels with its vertices.
+const GLchar *const vshader = {
+    "attribute vec4 position;"
+    "attribute vec2 texcoord;"
+    "attribute float alpha;"
+    "uniform mat4 transform;"
+    "varying vec2 v_texcoord;"
+    "varying float v_alpha;"
+    "void main() {"
+    "   gl_Position = transform * position;"
+    "   v_texcoord = texcoord;"
+    "   v_alpha = alpha;"
+    "}"};
+
+const GLchar *const fshader = {
+    "precision mediump float;"
+    "uniform sampler2D tex;"
+    "varying vec2 v_texcoord;"
+    "varying float v_alpha;"
+    "void main() {"
+    "   gl_FragColor = v_alpha * texture2D(tex, v_texcoord);"
+    "}"};
+
+const GLvoid *bufferOffset(size_t offset) {
+  return reinterpret_cast<const GLvoid *>(offset);
+}
+}  // namespace
+
+LayerBatch::LayerBatch() {
+  m_program = m_family.add_program(vshader, fshader);
+  m_positionAttr = s_gles2.glGetAttribLocation(m_program, "position");
+  m_texcoordAttr = s_gles2.glGetAttribLocation(m_program, "texcoord");
+  m_alphaAttr = s_gles2.glGetAttribLocation(m_program, "alpha");
+  m_transformUniform = s_gles2.glGetUniformLocation(m_program, "transform");
+
+  // Uniform values are part of the program state so the sampler only has
+  // to be set up once.
+  s_gles2.glUseProgram(m_program);
+  s_gles2.glUniform1i(s_gles2.glGetUniformLocation(m_program, "tex"), 0);
+  s_gles2.glUseProgram(0);
+
+  s_gles2.glGenBuffers(1, &m_vertexBuffer);
+  s_gles2.glGenBuffers(1, &m_indexBuffer);
+}
+
+LayerBatch::~LayerBatch() {
+  s_gles2.glDeleteBuffers(1, &m_indexBuffer);
+  s_gles2.glDeleteBuffers(1, &m_vertexBuffer);
+}
+
+void LayerBatch::add(GLuint texture, const anbox::graphics::Rect &buffer_size,
+                     const Renderable &renderable) {
+  if (m_textures.size() >= max_layers) return;
+
+  const auto rect = renderable.screen_position();
+  const auto crop = renderable.crop();
+  const auto transformation = renderable.transformation();
+  const auto transformed = transformation != glm::mat4(1.0f);
+  const auto alpha = renderable.alpha();
+
+  const GLfloat tex_left = static_cast<GLfloat>(crop.left()) / buffer_size.width();
+  const GLfloat tex_top = static_cast<GLfloat>(crop.top()) / buffer_size.height();
+  const GLfloat tex_right = static_cast<GLfloat>(crop.right()) / buffer_size.width();
+  const GLfloat tex_bottom = static_cast<GLfloat>(crop.bottom()) / buffer_size.height();
+
+  // Layers are transformed around their center.
+  const glm::vec4 mid{rect.left() + rect.width() / 2.0f,
+                      rect.top() + rect.height() / 2.0f, 0.0f, 0.0f};
+
+  auto add_vertex = [&](GLfloat x, GLfloat y, GLfloat s, GLfloat t) {
+    glm::vec4 p{x, y, 0.0f, 1.0f};
+    if (transformed) p = transformation * (p - mid) + mid;
+    m_vertices.push_back({{p[0], p[1], p[2], p[3]}, {s, t}, alpha});
+  };
+
+  add_vertex(rect.left(), rect.top(), tex_left, tex_top);
+  add_vertex(rect.left(), rect.bottom(), tex_left, tex_bottom);
+  add_vertex(rect.right(), rect.top(), tex_right, tex_top);
+  add_vertex(rect.right(), rect.bottom(), tex_right, tex_bottom);
+
+  m_textures.push_back(texture);
+}
+
+void LayerBatch::reserveIndices(size_t layers) {
+  if (layers <= m_indexCapacity) return;
+
+  const auto capacity = std::min(std::max(layers, 2 * m_indexCapacity), max_layers);
+  std::vector<GLushort> indices;
+  indices.reserve(capacity * 6);
+  for (size_t n = 0; n < capacity; n++) {
+    const auto base = static_cast<GLushort>(n * 4);
+    for (const auto i : {0, 1, 2, 2, 1, 3})
+      indices.push_back(static_cast<GLushort>(base + i));
+  }
+
+  s_gles2.glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLushort),
+                       indices.data(), GL_STATIC_DRAW);
+  m_indexCapacity = capacity;
+}
+
+void LayerBatch::draw(const glm::mat4 &screen_to_gl_coords,
+                      const glm::mat4 &display_transform) {
+  if (m_textures.empty()) return;
+
+  const auto transform = display_transform * screen_to_gl_coords;
+
+  s_gles2.glUseProgram(m_program);
+  s_gles2.glUniformMatrix4fv(m_transformUniform, 1, GL_FALSE,
+                             glm::value_ptr(transform));
+
+  s_gles2.glActiveTexture(GL_TEXTURE0);
+  s_gles2.glEnable(GL_BLEND);
+  s_gles2.glBlendFuncSeparate(GL_ONE, GL_ONE_MINUS_SRC_ALPHA, GL_ONE,
+                              GL_ONE_MINUS_SRC_ALPHA);
+
+  s_gles2.glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+  reserveIndices(m_textures.size());
+
+  s_gles2.glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+  s_gles2.glBufferData(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(Vertex),
+                       m_vertices.data(), GL_STREAM_DRAW);
+
+  s_gles2.glVertexAttribPointer(m_positionAttr, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+                                bufferOffset(offsetof(Vertex, position)));
+  s_gles2.glVertexAttribPointer(m_texcoordAttr, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+                                bufferOffset(offsetof(Vertex, texcoord)));
+  s_gles2.glVertexAttribPointer(m_alphaAttr, 1, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+                                bufferOffset(offsetof(Vertex, alpha)));
+  s_gles2.glEnableVertexAttribArray(m_positionAttr);
+  s_gles2.glEnableVertexAttribArray(m_texcoordAttr);
+  s_gles2.glEnableVertexAttribArray(m_alphaAttr);
+
+  // One draw call for every run of layers sampling the same texture.
+  size_t first = 0;
+  for (size_t n = 1; n <= m_textures.size(); n++) {
+    if (n < m_textures.size() && m_textures[n] == m_textures[first]) continue;
+
+    s_gles2.glBindTexture(GL_TEXTURE_2D, m_textures[first]);
+    s_gles2.glDrawElements(GL_TRIANGLES, static_cast<GLsizei>((n - first) * 6),
+                           GL_UNSIGNED_SHORT,
+                           bufferOffset(first * 6 * sizeof(GLushort)));
+    first = n;
+  }
+
+  s_gles2.glDisableVertexAttribArray(m_alphaAttr);
+  s_gles2.glDisableVertexAttribArray(m_texcoordAttr);
+  s_gles2.glDisableVertexAttribArray(m_positionAttr);
+  s_gles2.glBindBuffer(GL_ARRAY_BUFFER, 0);
+  s_gles2.glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+  m_vertices.clear();
+  m_textures.clear();
+}
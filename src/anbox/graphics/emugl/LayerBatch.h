@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef ANBOX_GRAPHICS_EMUGL_LAYER_BATCH_H_
+#define ANBOX_GRAPHICS_EMUGL_LAYER_BATCH_H_
+
+#include "anbox/graphics/emugl/Renderable.h"
+#include "anbox/graphics/program_family.h"
+#include "anbox/graphics/rect.h"
+
+#include <GLES2/gl2.h>
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+// Helper class used to draw all layers of a frame with as few GL calls as
+// possible.
+//
+//   1) Create a LayerBatch instance while the context it will be used with
+//      is current.
+//
+//   2) For each frame, call add() for every layer in back to front order
+//      and then draw() once.
+//
+// The quads of all layers, including their transformation and alpha, are
+// written into a single vertex buffer so the per frame state is set up only
+// once. Consecutive layers sampling the same texture share a draw call.
+class LayerBatch {
+ public:
+  LayerBatch();
+  ~LayerBatch();
+
+  LayerBatch(const LayerBatch&) = delete;
+  LayerBatch& operator=(const LayerBatch&) = delete;
+
+  // Queue |renderable| to be drawn with |texture|. |buffer_size| is the
+  // size of the buffer the crop of the renderable refers to. The texture
+  // has to be resolved before (see ColorBuffer::getTexture()) as nothing
+  // may change the GL state between the calls to add() and draw().
+  void add(GLuint texture, const anbox::graphics::Rect& buffer_size,
+           const Renderable& renderable);
+
+  // Draw all queued layers into the current framebuffer and start over
+  // with an empty batch.
+  void draw(const glm::mat4& screen_to_gl_coords,
+            const glm::mat4& display_transform);
+
+  size_t size() const { return m_textures.size(); }
+  bool empty() const { return m_textures.empty(); }
+
+ private:
+  struct Vertex {
+    GLfloat position[4];
+    GLfloat texcoord[2];
+    GLfloat alpha;
+  };
+
+  void reserveIndices(size_t layers);
+
+  anbox::graphics::ProgramFamily m_family;
+  GLuint m_program = 0;
+  GLint m_positionAttr = -1;
+  GLint m_texcoordAttr = -1;
+  GLint m_alphaAttr = -1;
+  GLint m_transformUniform = -1;
+  GLuint m_vertexBuffer = 0;
+  GLuint m_indexBuffer = 0;
+  size_t m_indexCapacity = 0;
+
+  std::vector<Vertex> m_vertices;
+  std::vector<GLuint> m_textures;
+};
+
+#endif
@@ -0,0 +1,241 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "anbox/graphics/emugl/PixelTransfer.h"
+
+#include <GLES2/gl2ext.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+
+// Used to avoid adding GLES3/gl3.h to our headers.
+#ifndef GL_PIXEL_PACK_BUFFER
+#define GL_PIXEL_PACK_BUFFER 0x88EB
+#endif
+#ifndef GL_PIXEL_UNPACK_BUFFER
+#define GL_PIXEL_UNPACK_BUFFER 0x88EC
+#endif
+#ifndef GL_STREAM_READ
+#define GL_STREAM_READ 0x88E1
+#endif
+#ifndef GL_MAP_READ_BIT
+#define GL_MAP_READ_BIT 0x0001
+#endif
+#ifndef GL_MAP_WRITE_BIT
+#define GL_MAP_WRITE_BIT 0x0002
+#endif
+#ifndef GL_MAP_INVALIDATE_RANGE_BIT
+#define GL_MAP_INVALIDATE_RANGE_BIT 0x0004
+#endif
+#ifndef GL_MAP_UNSYNCHRONIZED_BIT
+#define GL_MAP_UNSYNCHRONIZED_BIT 0x0020
+#endif
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#endif
+#ifndef GL_SYNC_FLUSH_COMMANDS_BIT
+#define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#endif
+#ifndef GL_TIMEOUT_IGNORED
+#define GL_TIMEOUT_IGNORED 0xFFFFFFFFFFFFFFFFull
+#endif
+
+namespace {
+// Size of the band of rows transferred through one staging buffer. Small
+// enough for the GPU to work on one band while the CPU copies another.
+constexpr size_t band_size{1024 * 1024};
+
+size_t bytesPerPixel(GLenum format, GLenum type) {
+  switch (type) {
+    case GL_UNSIGNED_BYTE:
+      switch (format) {
+        case GL_ALPHA:
+        case GL_LUMINANCE:
+          return 1;
+        case GL_LUMINANCE_ALPHA:
+          return 2;
+        case GL_RGB:
+          return 3;
+        case GL_RGBA:
+        case GL_BGRA_EXT:
+          return 4;
+        default:
+          return 0;
+      }
+    case GL_UNSIGNED_SHORT_5_6_5:
+    case GL_UNSIGNED_SHORT_4_4_4_4:
+    case GL_UNSIGNED_SHORT_5_5_5_1:
+      return 2;
+    default:
+      return 0;
+  }
+}
+
+size_t rowSize(int width, GLenum format, GLenum type) {
+  return bytesPerPixel(format, type) * static_cast<size_t>(std::max(width, 0));
+}
+}  // namespace
+
+PixelTransfer::PixelTransfer() {
+  for (auto& slot : m_slots) s_gles2.glGenBuffers(1, &slot.buffer);
+}
+
+PixelTransfer::~PixelTransfer() {
+  for (auto& slot : m_slots) {
+    if (slot.fence) s_gles2.glDeleteSync(slot.fence);
+    s_gles2.glDeleteBuffers(1, &slot.buffer);
+  }
+}
+
+bool PixelTransfer::isSupported() {
+  if (!s_gles2.glMapBufferRange || !s_gles2.glUnmapBuffer ||
+      !s_gles2.glFenceSync || !s_gles2.glClientWaitSync ||
+      !s_gles2.glDeleteSync)
+    return false;
+
+  // The entry points may exist while the context doesn't provide them.
+  const auto version = reinterpret_cast<const char*>(s_gles2.glGetString(GL_VERSION));
+  int major = 0;
+  return version && sscanf(version, "OpenGL ES %d", &major) == 1 && major >= 3;
+}
+
+bool PixelTransfer::isWorthwhile(const char* renderer) {
+  if (!renderer) return false;
+  for (const auto name : {"llvmpipe", "softpipe", "swrast", "SwiftShader"}) {
+    if (strstr(renderer, name)) return false;
+  }
+  return true;
+}
+
+void PixelTransfer::acquire(Slot& slot, GLenum target, size_t size) {
+  if (slot.fence) {
+    s_gles2.glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+                             GL_TIMEOUT_IGNORED);
+    s_gles2.glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+  }
+
+  s_gles2.glBindBuffer(target, slot.buffer);
+  if (slot.size < size) {
+    s_gles2.glBufferData(target, size, nullptr,
+                         target == GL_PIXEL_PACK_BUFFER ? GL_STREAM_READ : GL_STREAM_DRAW);
+    slot.size = size;
+  }
+}
+
+void PixelTransfer::release(Slot& slot) {
+  slot.fence = s_gles2.glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+bool PixelTransfer::upload(int x, int y, int width, int height, GLenum format,
+                           GLenum type, const void* pixels) {
+  const auto row_size = rowSize(width, format, type);
+  if (row_size == 0 || height <= 0) return false;
+
+  const auto rows_per_band = std::max<size_t>(1, band_size / row_size);
+  const auto src = static_cast<const uint8_t*>(pixels);
+
+  for (size_t row = 0; row < static_cast<size_t>(height); row += rows_per_band) {
+    const auto rows = std::min(rows_per_band, height - row);
+    const auto size = rows * row_size;
+
+    auto& slot = m_slots[m_next];
+    m_next = (m_next + 1) % m_slots.size();
+
+    acquire(slot, GL_PIXEL_UNPACK_BUFFER, size);
+    // The GPU is done with the slot so there is no need to synchronize.
+    auto dst = s_gles2.glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size,
+                                        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT |
+                                        GL_MAP_UNSYNCHRONIZED_BIT);
+    if (!dst) {
+      // Transfer what is left synchronously.
+      s_gles2.glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+      s_gles2.glTexSubImage2D(GL_TEXTURE_2D, 0, x, y + row, width, height - row,
+                              format, type, src + row * row_size);
+      return true;
+    }
+    ::memcpy(dst, src + row * row_size, size);
+    s_gles2.glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+    s_gles2.glTexSubImage2D(GL_TEXTURE_2D, 0, x, y + row, width, rows, format,
+                            type, nullptr);
+    release(slot);
+  }
+
+  s_gles2.glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  return true;
+}
+
+bool PixelTransfer::readback(int x, int y, int width, int height,
+                             GLenum format, GLenum type, void* pixels) {
+  const auto row_size = rowSize(width, format, type);
+  if (row_size == 0 || height <= 0) return false;
+
+  const auto rows_per_band = std::max<size_t>(1, band_size / row_size);
+  const auto bands = (height + rows_per_band - 1) / rows_per_band;
+  const auto dst = static_cast<uint8_t*>(pixels);
+
+  auto rows_of = [&](size_t band) {
+    return std::min(rows_per_band, height - band * rows_per_band);
+  };
+  auto size_of = [&](size_t band) {
+    return rows_of(band) * row_size;
+  };
+  auto slot_of = [&](size_t band) -> Slot& {
+    return m_slots[(m_next + band) % m_slots.size()];
+  };
+
+  // Keep the GPU busy with the following bands while the finished ones
+  // are copied out.
+  size_t issued = 0;
+  auto issue = [&]() {
+    auto& slot = slot_of(issued);
+    acquire(slot, GL_PIXEL_PACK_BUFFER, size_of(issued));
+    s_gles2.glReadPixels(x, y + issued * rows_per_band, width, rows_of(issued),
+                         format, type, nullptr);
+    release(slot);
+    issued++;
+  };
+
+  bool ok = true;
+  for (size_t band = 0; band < bands; band++) {
+    while (issued < bands && issued < band + m_slots.size()) issue();
+
+    auto& slot = slot_of(band);
+    const auto size = size_of(band);
+    // Waits for the fence of the band.
+    acquire(slot, GL_PIXEL_PACK_BUFFER, size);
+    auto src = s_gles2.glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+    if (src) {
+      ::memcpy(dst + band * rows_per_band * row_size, src, size);
+      s_gles2.glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    } else {
+      ok = false;
+    }
+  }
+
+  m_next = (m_next + bands) % m_slots.size();
+  s_gles2.glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+  if (!ok) {
+    s_gles2.glReadPixels(x, y, width, height, format, type, pixels);
+  }
+  return true;
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef ANBOX_GRAPHICS_EMUGL_PIXEL_TRANSFER_H_
+#define ANBOX_GRAPHICS_EMUGL_PIXEL_TRANSFER_H_
+
+#include "anbox/graphics/emugl/DispatchTables.h"
+
+#include <GLES2/gl2.h>
+
+#include <array>
+#include <cstddef>
+
+// Moves pixels between host memory and textures or framebuffers through a
+// small ring of pixel buffer objects instead of client memory.
+//
+// Uploads only copy the pixels into a staging buffer and return while the
+// GPU fetches them. Readbacks are split into bands; while the pixels of one
+// band are copied out, the GPU already writes the next ones. Every staging
+// buffer carries a fence so it is only reused once the GPU is done with it.
+//
+// Pixel rows in host memory are tightly packed, which is how the guest
+// sends and expects them. Callers have to set GL_PACK_ALIGNMENT and
+// GL_UNPACK_ALIGNMENT to 1 for the synchronous fallbacks to match.
+//
+// All methods need the context the instance was created with (or one
+// sharing objects with it) to be current. Requires GLES 3.0, use
+// isSupported() to check whether the host provides it.
+class PixelTransfer {
+ public:
+  PixelTransfer();
+  ~PixelTransfer();
+
+  PixelTransfer(const PixelTransfer&) = delete;
+  PixelTransfer& operator=(const PixelTransfer&) = delete;
+
+  // Return true if the current context supports pixel buffer objects and
+  // fences.
+  static bool isSupported();
+
+  // Return false for software rasterizers. Their textures live in host
+  // memory already so staging buffers only add another copy.
+  static bool isWorthwhile(const char* renderer);
+
+  // Same as glTexSubImage2D() on the texture bound to GL_TEXTURE_2D. Returns
+  // false without doing anything if the format isn't supported.
+  bool upload(int x, int y, int width, int height, GLenum format, GLenum type,
+              const void* pixels);
+
+  // Same as glReadPixels() from the current read framebuffer. Returns false
+  // without doing anything if the format isn't supported.
+  bool readback(int x, int y, int width, int height, GLenum format,
+                GLenum type, void* pixels);
+
+ private:
+  struct Slot {
+    GLuint buffer = 0;
+    size_t size = 0;
+    GLsync fence = nullptr;
+  };
+
+  // Wait until the GPU is done with |slot| and make sure it can hold
+  // |size| bytes. The slot's buffer is left bound to |target|.
+  void acquire(Slot& slot, GLenum target, size_t size);
+  void release(Slot& slot);
+
+  std::array<Slot, 3> m_slots;
+  size_t m_next = 0;
+};
+
+#endif
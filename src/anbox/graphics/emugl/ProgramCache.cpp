@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "anbox/graphics/emugl/ProgramCache.h"
+#include "anbox/graphics/emugl/DispatchTables.h"
+#include "anbox/graphics/emugl/RenderThreadInfo.h"
+#include "anbox/graphics/program_binary_cache.h"
+
+#include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+// Binary formats of the host driver, empty if it can't hand out program
+// binaries. Needs a current context on the first call.
+const std::vector<GLint>& binaryFormats() {
+  static const std::vector<GLint> formats = []() {
+    std::vector<GLint> formats;
+    const auto extensions = reinterpret_cast<const char*>(s_gles2.glGetString(GL_EXTENSIONS));
+    if (!extensions || !strstr(extensions, "GL_OES_get_program_binary") ||
+        !s_gles2.glGetProgramBinaryOES || !s_gles2.glProgramBinaryOES)
+      return formats;
+
+    GLint count = 0;
+    s_gles2.glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS_OES, &count);
+    if (count > 0) {
+      formats.resize(count);
+      s_gles2.glGetIntegerv(GL_PROGRAM_BINARY_FORMATS_OES, formats.data());
+    }
+    return formats;
+  }();
+  return formats;
+}
+
+std::string glString(GLenum name) {
+  const auto value = s_gles2.glGetString(name);
+  return value ? reinterpret_cast<const char*>(value) : "";
+}
+
+// Describes everything linking |program| depends on. Returns false for
+// programs which can't come from the cache, e.g. because one of their
+// shaders doesn't compile.
+bool programKey(GLuint program, const std::map<std::string, GLuint> &bindings, std::string &key) {
+  GLint count = 0;
+  s_gles2.glGetProgramiv(program, GL_ATTACHED_SHADERS, &count);
+  if (count <= 0)
+    return false;
+
+  std::vector<GLuint> shaders(count);
+  s_gles2.glGetAttachedShaders(program, count, &count, shaders.data());
+
+  std::vector<std::string> sources;
+  for (GLint n = 0; n < count; n++) {
+    GLint type = 0, compiled = GL_FALSE, length = 0;
+    s_gles2.glGetShaderiv(shaders[n], GL_SHADER_TYPE, &type);
+    s_gles2.glGetShaderiv(shaders[n], GL_COMPILE_STATUS, &compiled);
+    s_gles2.glGetShaderiv(shaders[n], GL_SHADER_SOURCE_LENGTH, &length);
+    if (compiled != GL_TRUE || length <= 0)
+      return false;
+
+    std::string source(length, '\0');
+    GLsizei written = 0;
+    s_gles2.glGetShaderSource(shaders[n], length, &written, &source[0]);
+    source.resize(written);
+    sources.push_back("shader " + std::to_string(type) + " " +
+                      std::to_string(source.size()) + "\n" + source + "\n");
+  }
+  // The order shaders were attached in doesn't matter.
+  std::sort(sources.begin(), sources.end());
+
+  key = "renderer " + glString(GL_RENDERER) + "\n" +
+        "version " + glString(GL_VERSION) + "\n";
+  for (const auto &binding : bindings)
+    key += "attrib " + std::to_string(binding.second) + " " + binding.first + "\n";
+  for (const auto &source : sources)
+    key += source;
+  return true;
+}
+
+bool loadProgram(GLuint program, const anbox::graphics::ProgramBinaryCache::Binary &binary) {
+  // Unknown formats would raise a GL error the guest could see.
+  const auto &formats = binaryFormats();
+  if (std::find(formats.begin(), formats.end(), static_cast<GLint>(binary.format)) == formats.end())
+    return false;
+
+  s_gles2.glProgramBinaryOES(program, binary.format, binary.data.data(), binary.data.size());
+  GLint linked = GL_FALSE;
+  s_gles2.glGetProgramiv(program, GL_LINK_STATUS, &linked);
+  return linked == GL_TRUE;
+}
+
+void storeProgram(GLuint program, const std::string &key, anbox::graphics::ProgramBinaryCache &cache) {
+  GLint linked = GL_FALSE, length = 0;
+  s_gles2.glGetProgramiv(program, GL_LINK_STATUS, &linked);
+  if (linked != GL_TRUE)
+    return;
+  s_gles2.glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH_OES, &length);
+  if (length <= 0)
+    return;
+
+  anbox::graphics::ProgramBinaryCache::Binary binary;
+  binary.data.resize(length);
+  GLsizei written = 0;
+  GLenum format = 0;
+  s_gles2.glGetProgramBinaryOES(program, length, &written, &format, binary.data.data());
+  if (written <= 0)
+    return;
+
+  binary.data.resize(written);
+  binary.format = format;
+  cache.store(key, binary);
+}
+
+GLuint gles2_APIENTRY s_glCreateProgram() {
+  const auto program = s_gles2.glCreateProgram();
+  auto tInfo = RenderThreadInfo::get();
+  if (program && tInfo)
+    tInfo->m_programAttribBindings[program].clear();
+  return program;
+}
+
+void gles2_APIENTRY s_glDeleteProgram(GLuint program) {
+  s_gles2.glDeleteProgram(program);
+  auto tInfo = RenderThreadInfo::get();
+  if (tInfo)
+    tInfo->m_programAttribBindings.erase(program);
+}
+
+void gles2_APIENTRY s_glBindAttribLocation(GLuint program, GLuint index, const GLchar *name) {
+  s_gles2.glBindAttribLocation(program, index, name);
+  auto tInfo = RenderThreadInfo::get();
+  if (!tInfo)
+    return;
+  auto bindings = tInfo->m_programAttribBindings.find(program);
+  if (bindings != tInfo->m_programAttribBindings.end())
+    bindings->second[name] = index;
+}
+
+void gles2_APIENTRY s_glLinkProgram(GLuint program) {
+  auto tInfo = RenderThreadInfo::get();
+  if (!tInfo || !tInfo->m_programCache || binaryFormats().empty()) {
+    s_gles2.glLinkProgram(program);
+    return;
+  }
+
+  const auto bindings = tInfo->m_programAttribBindings.find(program);
+  std::string key;
+  if (bindings == tInfo->m_programAttribBindings.end() ||
+      !programKey(program, bindings->second, key)) {
+    s_gles2.glLinkProgram(program);
+    return;
+  }
+
+  auto &cache = *tInfo->m_programCache;
+  anbox::graphics::ProgramBinaryCache::Binary binary;
+  if (cache.load(key, binary)) {
+    if (loadProgram(program, binary))
+      return;
+    cache.reject(key);
+  }
+
+  s_gles2.glLinkProgram(program);
+  storeProgram(program, key, cache);
+}
+}
+
+void initProgramCache(GLESv2Decoder *dec) {
+  dec->glCreateProgram = s_glCreateProgram;
+  dec->glDeleteProgram = s_glDeleteProgram;
+  dec->glBindAttribLocation = s_glBindAttribLocation;
+  dec->glLinkProgram = s_glLinkProgram;
+}
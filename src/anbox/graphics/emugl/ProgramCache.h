@@ -0,0 +1,35 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef ANBOX_GRAPHICS_EMUGL_PROGRAM_CACHE_H_
+#define ANBOX_GRAPHICS_EMUGL_PROGRAM_CACHE_H_
+
+class GLESv2Decoder;
+
+// Routes the glLinkProgram() calls decoded by |dec| through the program
+// binary cache of the calling thread's RenderThreadInfo. Programs whose
+// binary is cached are loaded with glProgramBinaryOES() instead of being
+// linked; all others are linked and their binary is added to the cache.
+// Without OES_get_program_binary support on the host every call goes
+// straight to the driver.
+//
+// Attribute bindings are tracked per render thread, so only programs
+// created on the thread linking them use the cache.
+void initProgramCache(GLESv2Decoder *dec);
+
+#endif
@@ -15,9 +15,13 @@
 */
 
 #include "anbox/graphics/emugl/RenderContext.h"
+#include "anbox/graphics/emugl/DispatchTables.h"
+#include "anbox/graphics/emugl/EglBinding.h"
 
 #include "OpenGLESDispatch/EGLDispatch.h"
 
+#include <string.h>
+
 RenderContext* RenderContext::create(EGLDisplay display, EGLConfig config,
                                      EGLContext sharedContext, bool isGl2) {
   const EGLint contextAttribs[] = {EGL_CONTEXT_CLIENT_VERSION, isGl2 ? 2 : 1,
@@ -28,14 +32,73 @@ RenderContext* RenderContext::create(EGLDisplay display, EGLConfig config,
     return NULL;
   }
 
-  return new RenderContext(display, context, isGl2);
+  return new RenderContext(display, config, context, isGl2);
 }
 
-RenderContext::RenderContext(EGLDisplay display, EGLContext context, bool isGl2)
-    : mDisplay(display), mContext(context), mIsGl2(isGl2), mContextData() {}
+RenderContext::RenderContext(EGLDisplay display, EGLConfig config,
+                             EGLContext context, bool isGl2)
+    : mDisplay(display),
+      mConfig(config),
+      mContext(context),
+      mIsGl2(isGl2),
+      mContextData() {}
 
 RenderContext::~RenderContext() {
+  // Takes the objects still waiting for deletion with it.
+  if (mBlitContext != EGL_NO_CONTEXT) {
+    s_egl.eglDestroyContext(mDisplay, mBlitContext);
+  }
   if (mContext != EGL_NO_CONTEXT) {
     s_egl.eglDestroyContext(mDisplay, mContext);
   }
 }
+
+bool RenderContext::bindBlitContext(EGLSurface surface) {
+  if (!mIsGl2 || !s_gles2.glBlitFramebuffer ||
+      (mFramebufferBlitChecked && !mFramebufferBlitSupported))
+    return false;
+
+  if (mBlitContext == EGL_NO_CONTEXT) {
+    const EGLint contextAttribs[] = {EGL_CONTEXT_CLIENT_VERSION, 2, EGL_NONE};
+    mBlitContext = s_egl.eglCreateContext(mDisplay, mConfig, EGL_NO_CONTEXT,
+                                          contextAttribs);
+    if (mBlitContext == EGL_NO_CONTEXT) {
+      mFramebufferBlitChecked = true;
+      return false;
+    }
+  }
+
+  if (!EglBinding::get()->makeCurrent(mDisplay, surface, surface,
+                                      mBlitContext))
+    return false;
+
+  if (!mFramebufferBlitChecked) {
+    // Hosts usually hand out a GLES 3 context when asked for GLES 2, as
+    // it is backwards compatible, so the check can't be done up front.
+    const char* version =
+        reinterpret_cast<const char*>(s_gles2.glGetString(GL_VERSION));
+    mFramebufferBlitSupported =
+        version && strncmp(version, "OpenGL ES 3", 11) == 0;
+    mFramebufferBlitChecked = true;
+    if (!mFramebufferBlitSupported)
+      return false;
+  }
+
+  deletePendingObjects();
+  return true;
+}
+
+void RenderContext::deleteLater(GLuint texture, GLuint framebuffer) {
+  mPendingTextures.push_back(texture);
+  mPendingFramebuffers.push_back(framebuffer);
+}
+
+void RenderContext::deletePendingObjects() {
+  if (mPendingTextures.empty())
+    return;
+
+  s_gles2.glDeleteFramebuffers(mPendingFramebuffers.size(), mPendingFramebuffers.data());
+  s_gles2.glDeleteTextures(mPendingTextures.size(), mPendingTextures.data());
+  mPendingFramebuffers.clear();
+  mPendingTextures.clear();
+}
@@ -20,8 +20,10 @@
 #include "external/android-emugl/shared/OpenglCodecCommon/GLDecoderContextData.h"
 
 #include <EGL/egl.h>
+#include <GLES/gl.h>
 
 #include <memory>
+#include <vector>
 
 // A class used to model a guest EGLContext. This simply wraps a host
 // EGLContext, associated with an GLDecoderContextData instance that is
@@ -50,16 +52,39 @@ class RenderContext {
   // RenderContext instance.
   GLDecoderContextData& decoderContextData() { return mContextData; }
 
+  // Make the blit context of this context current on |surface|. It is
+  // created on first use with the same config but shares no objects with
+  // this context, so the host can keep textures and framebuffers in it
+  // without taking names a GLES 2 guest may bind without generating them.
+  // Return false if it can't be created or doesn't support
+  // glBlitFramebuffer(). The caller restores its binding in either case.
+  bool bindBlitContext(EGLSurface surface);
+
+  // Queue a texture and framebuffer of the blit context for deletion. Used
+  // by ColorBuffers which go away while it isn't current.
+  void deleteLater(GLuint texture, GLuint framebuffer);
+
  private:
   RenderContext();
 
-  RenderContext(EGLDisplay display, EGLContext context, bool isGl2);
+  RenderContext(EGLDisplay display, EGLConfig config, EGLContext context,
+                bool isGl2);
+
+  // Delete everything queued with deleteLater(). The blit context has to
+  // be current on the calling thread.
+  void deletePendingObjects();
 
  private:
   EGLDisplay mDisplay;
+  EGLConfig mConfig;
   EGLContext mContext;
   bool mIsGl2;
   GLDecoderContextData mContextData;
+  EGLContext mBlitContext = EGL_NO_CONTEXT;
+  bool mFramebufferBlitChecked = false;
+  bool mFramebufferBlitSupported = false;
+  std::vector<GLuint> mPendingTextures;
+  std::vector<GLuint> mPendingFramebuffers;
 };
 
 typedef std::shared_ptr<RenderContext> RenderContextPtr;
@@ -20,7 +20,7 @@
 #include "anbox/graphics/emugl/RenderThreadInfo.h"
 #include "anbox/graphics/emugl/Renderer.h"
 #include "anbox/graphics/emugl/RendererConfig.h"
-#include "anbox/graphics/layer_composer.h"
+#include "anbox/graphics/compositor.h"
 #include "anbox/logger.h"
 
 #include "external/android-emugl/shared/OpenglCodecCommon/ChecksumCalculatorThreadInfo.h"
@@ -31,12 +31,12 @@
 #include <sstream>
 
 static const GLint rendererVersion = 1;
-static std::shared_ptr<anbox::graphics::LayerComposer> composer;
+static std::shared_ptr<anbox::graphics::Compositor> compositor;
 static std::shared_ptr<Renderer> renderer;
 
-void registerLayerComposer(
-    const std::shared_ptr<anbox::graphics::LayerComposer> &c) {
-  composer = c;
+void registerCompositor(
+    const std::shared_ptr<anbox::graphics::Compositor> &c) {
+  compositor = c;
 }
 
 void registerRenderer(const std::shared_ptr<Renderer> &r) {
@@ -158,7 +158,8 @@ static EGLint rcGetGLString(EGLenum name, void* buffer, EGLint bufferSize) {
 static EGLint rcGetNumConfigs(uint32_t *p_numAttribs) {
   int numConfigs = 0, numAttribs = 0;
 
-  renderer->getConfigs()->getPackInfo(&numConfigs, &numAttribs);
+  if (renderer)
+    renderer->getConfigs()->getPackInfo(&numConfigs, &numAttribs);
   if (p_numAttribs) {
     *p_numAttribs = static_cast<uint32_t>(numAttribs);
   }
@@ -166,6 +167,9 @@ static EGLint rcGetNumConfigs(uint32_t *p_numAttribs) {
 }
 
 static EGLint rcGetConfigs(uint32_t bufSize, GLuint *buffer) {
+  if (!renderer)
+    return 0;
+
   GLuint bufferSize = static_cast<GLuint>(bufSize);
   return renderer->getConfigs()->packConfigs(bufferSize, buffer);
 }
@@ -398,11 +402,11 @@ int rcGetDisplayDpiY(uint32_t display_id) {
 
 int rcGetDisplayVsyncPeriod(uint32_t display_id) {
   (void)display_id;
-  return 1;
+  // The hwcomposer hands this to SurfaceFlinger as vsync period in
+  // nanoseconds.
+  return static_cast<int>(anbox::graphics::emugl::DisplayInfo::get()->vsync_period().count());
 }
 
-static std::vector<Renderable> frame_layers;
-
 bool is_layer_blacklisted(const std::string &name) {
   static std::vector<std::string> blacklist = {
       // The 'Sprite' layer is the mouse cursor Android uses as soon
@@ -419,19 +423,29 @@ void rcPostLayer(const char *name, uint32_t color_buffer, float alpha,
                  int32_t sourceCropRight, int32_t sourceCropBottom,
                  int32_t displayFrameLeft, int32_t displayFrameTop,
                  int32_t displayFrameRight, int32_t displayFrameBottom) {
-  Renderable r{
+  RenderThreadInfo *tInfo = RenderThreadInfo::get();
+  if (!tInfo)
+    return;
+
+  if (renderer)
+    renderer->postColorBuffer(color_buffer);
+
+  tInfo->m_frameLayers.emplace_back(
       name,
       color_buffer,
       alpha,
-      {displayFrameLeft, displayFrameTop, displayFrameRight, displayFrameBottom},
-      {sourceCropLeft, sourceCropTop, sourceCropRight, sourceCropBottom}};
-  frame_layers.push_back(r);
+      anbox::graphics::Rect{displayFrameLeft, displayFrameTop, displayFrameRight, displayFrameBottom},
+      anbox::graphics::Rect{sourceCropLeft, sourceCropTop, sourceCropRight, sourceCropBottom});
 }
 
 void rcPostAllLayersDone() {
-  if (composer) composer->submit_layers(frame_layers);
+  RenderThreadInfo *tInfo = RenderThreadInfo::get();
+  if (!tInfo)
+    return;
+
+  if (compositor) compositor->submit_layers(std::move(tInfo->m_frameLayers));
 
-  frame_layers.clear();
+  tInfo->m_frameLayers.clear();
 }
 
 void initRenderControlContext(renderControl_decoder_context_t *dec) {
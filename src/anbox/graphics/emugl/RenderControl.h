@@ -25,11 +25,11 @@
 class Renderer;
 
 namespace anbox::graphics {
-class LayerComposer;
+class Compositor;
 }
 void initRenderControlContext(renderControl_decoder_context_t *dec);
-void registerLayerComposer(
-    const std::shared_ptr<anbox::graphics::LayerComposer> &c);
+void registerCompositor(
+    const std::shared_ptr<anbox::graphics::Compositor> &c);
 void registerRenderer(const std::shared_ptr<Renderer> &r);
 
 #endif
@@ -15,6 +15,7 @@
 */
 
 #include "anbox/graphics/emugl/RenderThread.h"
+#include "anbox/graphics/emugl/ProgramCache.h"
 #include "anbox/graphics/emugl/ReadBuffer.h"
 #include "anbox/graphics/emugl/RenderControl.h"
 #include "anbox/graphics/emugl/RenderThreadInfo.h"
@@ -29,67 +30,94 @@
 
 #define STREAM_BUFFER_SIZE 4 * 1024 * 1024
 
-RenderThread::RenderThread(const std::shared_ptr<Renderer> &renderer, IOStream *stream, std::mutex &m)
-    : emugl::Thread(), renderer_(renderer), m_lock(m), m_stream(stream) {}
+RenderThread::RenderThread(const std::shared_ptr<Renderer> &renderer, IOStream *stream)
+    : emugl::Thread(), renderer_(renderer), m_stream(stream) {}
 
 RenderThread::~RenderThread() {
   forceStop();
 }
 
-RenderThread *RenderThread::create(const std::shared_ptr<Renderer> &renderer, IOStream *stream, std::mutex &m) {
-  return new RenderThread(renderer, stream, m);
+RenderThread *RenderThread::create(const std::shared_ptr<Renderer> &renderer, IOStream *stream) {
+  return new RenderThread(renderer, stream);
 }
 
 void RenderThread::forceStop() { m_stream->forceStop(); }
 
+size_t RenderThread::decode(RenderThreadInfo &threadInfo, unsigned char *buf, size_t len) {
+  size_t total = 0;
+  bool progress;
+  do {
+    progress = false;
+
+    size_t last =
+        threadInfo.m_glDec.decode(buf + total, len - total, m_stream);
+    if (last > 0) {
+      progress = true;
+      total += last;
+    }
+
+    last =
+        threadInfo.m_gl2Dec.decode(buf + total, len - total, m_stream);
+    if (last > 0) {
+      progress = true;
+      total += last;
+    }
+
+    last = threadInfo.m_rcDec.decode(buf + total, len - total, m_stream);
+    if (last > 0) {
+      progress = true;
+      total += last;
+    }
+
+  } while (progress);
+
+  return total;
+}
+
 intptr_t RenderThread::main() {
   RenderThreadInfo threadInfo;
   ChecksumCalculatorThreadInfo threadChecksumInfo;
 
   threadInfo.m_glDec.initGL(gles1_dispatch_get_proc_func, NULL);
   threadInfo.m_gl2Dec.initGL(gles2_dispatch_get_proc_func, NULL);
+  if (renderer_ && renderer_->getProgramBinaryCache()) {
+    threadInfo.m_programCache = renderer_->getProgramBinaryCache();
+    initProgramCache(&threadInfo.m_gl2Dec);
+  }
   initRenderControlContext(&threadInfo.m_rcDec);
 
-  ReadBuffer readBuf(STREAM_BUFFER_SIZE);
-
-  while (true) {
-    int stat = readBuf.getData(m_stream);
-    if (stat <= 0)
-      break;
-
-    bool progress;
-    do {
-      progress = false;
-
-      std::unique_lock<std::mutex> l(m_lock);
-
-      size_t last =
-          threadInfo.m_glDec.decode(readBuf.buf(), readBuf.validData(), m_stream);
-      if (last > 0) {
-        progress = true;
-        readBuf.consume(last);
-      }
-
-      last =
-          threadInfo.m_gl2Dec.decode(readBuf.buf(), readBuf.validData(), m_stream);
-      if (last > 0) {
-        progress = true;
-        readBuf.consume(last);
-      }
-
-      last = threadInfo.m_rcDec.decode(readBuf.buf(), readBuf.validData(), m_stream);
-      if (last > 0) {
-        readBuf.consume(last);
-        progress = true;
-      }
-
-    } while (progress);
-
+  if (m_stream->canReadInPlace()) {
+    // Decode directly out of the stream's buffer. Anything left over is
+    // an incomplete packet and we wait until more data arrives.
+    size_t pending = 0;
+    while (true) {
+      size_t len = 0;
+      auto buf = m_stream->readInPlace(pending, &len);
+      if (!buf)
+        break;
+
+      const auto consumed = decode(threadInfo, buf, len);
+      m_stream->consume(consumed);
+      pending = len - consumed;
+    }
+  } else {
+    ReadBuffer readBuf(STREAM_BUFFER_SIZE);
+
+    while (true) {
+      int stat = readBuf.getData(m_stream);
+      if (stat <= 0)
+        break;
+
+      readBuf.consume(decode(threadInfo, readBuf.buf(), readBuf.validData()));
+    }
   }
 
   threadInfo.m_gl2Dec.freeShader();
   threadInfo.m_gl2Dec.freeProgram();
 
+  if (!renderer_)
+    return 0;
+
   // Release references to the current thread's context/surfaces if any
   renderer_->bindContext(0, 0, 0);
   if (threadInfo.currContext || threadInfo.currDrawSurf || threadInfo.currReadSurf)
@@ -22,9 +22,9 @@
 #include "emugl/common/thread.h"
 
 #include <memory>
-#include <mutex>
 
 class Renderer;
+struct RenderThreadInfo;
 
 // A class used to model a thread of the RenderServer. Each one of them
 // handles a single guest client / protocol byte stream.
@@ -33,11 +33,10 @@ class RenderThread : public emugl::Thread {
   // Create a new RenderThread instance.
   // |stream| is an input stream that will be read from the thread,
   // and deleted by it when it exits.
-  // |mutex| is a pointer to a shared mutex used to serialize
-  // decoding operations between all threads.
-  // TODO(digit): Why is this needed here? Shouldn't this be handled
-  //              by the decoders themselves or at a lower-level?
-  static RenderThread* create(const std::shared_ptr<Renderer>& renderer, IOStream* stream, std::mutex &m);
+  // Decoding runs concurrently with all other render threads. Shared
+  // state (handle maps, color buffers, the helper context) is protected
+  // by the Renderer itself.
+  static RenderThread* create(const std::shared_ptr<Renderer>& renderer, IOStream* stream);
 
   // Destructor.
   virtual ~RenderThread();
@@ -52,12 +51,15 @@ class RenderThread : public emugl::Thread {
  private:
   RenderThread();  // No default constructor
 
-  RenderThread(const std::shared_ptr<Renderer>& renderer, IOStream* stream, std::mutex &m);
+  RenderThread(const std::shared_ptr<Renderer>& renderer, IOStream* stream);
 
   virtual intptr_t main();
 
+  // Runs all decoders over |buf| until none of them makes progress anymore
+  // and returns the number of bytes consumed.
+  size_t decode(RenderThreadInfo& threadInfo, unsigned char* buf, size_t len);
+
   std::shared_ptr<Renderer> renderer_;
-  std::mutex &m_lock;
   IOStream* m_stream;
 };
 
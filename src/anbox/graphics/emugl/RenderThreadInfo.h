@@ -18,6 +18,7 @@
 #define _LIB_OPENGL_RENDER_THREAD_INFO_H
 
 #include "anbox/graphics/emugl/RenderContext.h"
+#include "anbox/graphics/emugl/Renderable.h"
 #include "anbox/graphics/emugl/WindowSurface.h"
 
 #include "external/android-emugl/host/libs/GLESv1_dec/GLESv1Decoder.h"
@@ -26,7 +27,14 @@
 // Generated with emugl at build time
 #include "renderControl_dec.h"
 
+#include <map>
+#include <memory>
 #include <set>
+#include <string>
+
+namespace anbox::graphics {
+class ProgramBinaryCache;
+}
 
 typedef uint32_t HandleType;
 typedef std::set<HandleType> ThreadContextSet;
@@ -59,6 +67,16 @@ struct RenderThreadInfo {
   ThreadContextSet m_contextSet;
   // all the window surfaces that are created by this render thread
   WindowSurfaceSet m_windowSet;
+
+  // layers posted through rcPostLayer() by this render thread which are
+  // submitted together on the next rcPostAllLayersDone()
+  RenderableList m_frameLayers;
+
+  // Cache glLinkProgram() loads program binaries from, if any, and the
+  // attribute bindings of the programs created by this thread, which are
+  // part of what a cached binary is looked up by.
+  std::shared_ptr<anbox::graphics::ProgramBinaryCache> m_programCache;
+  std::map<GLuint, std::map<std::string, GLuint>> m_programAttribBindings;
 };
 
 #endif
@@ -16,8 +16,10 @@
 #define GLM_ENABLE_EXPERIMENTAL
 #include "anbox/graphics/emugl/Renderer.h"
 #include "anbox/graphics/emugl/DispatchTables.h"
+#include "anbox/graphics/emugl/EglBinding.h"
 #include "anbox/graphics/emugl/RenderThreadInfo.h"
 #include "anbox/graphics/emugl/TimeUtils.h"
+#include "anbox/graphics/frame_exporter.h"
 #include "anbox/graphics/gl_extensions.h"
 #include "anbox/logger.h"
 
@@ -27,12 +29,22 @@
 #include "gles2_dec.h"
 
 #include <stdio.h>
+#include <string.h>
+
+#include <deque>
+#include <vector>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtx/transform.hpp>
 
 namespace {
+// Number of frames we keep the damage of for buffer age based repaints.
+constexpr const size_t max_buffer_age{4};
+
+// Closed ColorBuffers are kept for reuse up to this size. That is enough
+// for a handful of full screen buffers.
+constexpr const size_t max_pooled_color_buffer_bytes{64 * 1024 * 1024};
 
 // Helper class to call the bind_locked() / unbind_locked() properly.
 class ScopedBind {
@@ -76,18 +88,27 @@ class ColorBufferHelper : public ColorBuffer::Helper {
 
   virtual TextureDraw *getTextureDraw() const { return mFb->getTextureDraw(); }
 
+  virtual PixelTransfer *getPixelTransfer() const {
+    return mFb->getPixelTransfer();
+  }
+
  private:
   Renderer *mFb;
 };
 }  // namespace
 
-HandleType Renderer::s_nextHandle = 0;
-
 void Renderer::finalize() {
   m_colorbuffers.clear();
+  DEBUG("ColorBuffer pool: %llu hits, %llu misses",
+        static_cast<unsigned long long>(m_colorBufferPool.hits()),
+        static_cast<unsigned long long>(m_colorBufferPool.misses()));
+  m_colorBufferPool.clear();
+  DEBUG("EGL bindings: %llu switches made, %llu avoided",
+        static_cast<unsigned long long>(EglBinding::switches()),
+        static_cast<unsigned long long>(EglBinding::avoided()));
   m_windows.clear();
   m_contexts.clear();
-  s_egl.eglMakeCurrent(m_eglDisplay, NULL, NULL, NULL);
+  EglBinding::get()->release(m_eglDisplay);
   s_egl.eglDestroyContext(m_eglDisplay, m_eglContext);
   s_egl.eglDestroyContext(m_eglDisplay, m_pbufContext);
   s_egl.eglDestroySurface(m_eglDisplay, m_pbufSurface);
@@ -111,22 +132,38 @@ bool Renderer::initialize(EGLNativeDisplayType nativeDisplay) {
   if (!surfaceless_supported)
     DEBUG("EGL doesn't support surfaceless context");
 
+  // Used to only redraw and present the parts of a window which changed.
+  m_caps.has_partial_update = egl_extensions.support("EGL_KHR_partial_update") && s_egl.eglSetDamageRegionKHR;
+  m_caps.has_buffer_age = m_caps.has_partial_update || egl_extensions.support("EGL_EXT_buffer_age");
+  if (egl_extensions.support("EGL_KHR_swap_buffers_with_damage"))
+    m_swapBuffersWithDamage = s_egl.eglSwapBuffersWithDamageKHR;
+  else if (egl_extensions.support("EGL_EXT_swap_buffers_with_damage"))
+    m_swapBuffersWithDamage = s_egl.eglSwapBuffersWithDamageEXT;
+
   s_egl.eglBindAPI(EGL_OPENGL_ES_API);
 
   // Create EGL context for framebuffer post rendering.
   GLint surfaceType = EGL_WINDOW_BIT | EGL_PBUFFER_BIT;
-  const GLint configAttribs[] = {EGL_RED_SIZE, 8,
-                                 EGL_GREEN_SIZE, 8,
-                                 EGL_BLUE_SIZE, 8,
-                                 EGL_SURFACE_TYPE, surfaceType,
-                                 EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
-                                 EGL_NONE};
+  GLint configAttribs[] = {EGL_RED_SIZE, 8,
+                           EGL_GREEN_SIZE, 8,
+                           EGL_BLUE_SIZE, 8,
+                           EGL_SURFACE_TYPE, surfaceType,
+                           EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
+                           EGL_NONE};
 
   int n;
   if ((s_egl.eglChooseConfig(m_eglDisplay, configAttribs, &m_eglConfig,
                              1, &n) == EGL_FALSE) || n == 0) {
-    ERROR("Failed to select EGL configuration");
-    return false;
+    // Displays without a window system (e.g. Mesa's surfaceless platform)
+    // only offer pbuffers. Everything but presenting to native windows
+    // still works with them.
+    configAttribs[7] = EGL_PBUFFER_BIT;
+    if ((s_egl.eglChooseConfig(m_eglDisplay, configAttribs, &m_eglConfig,
+                               1, &n) == EGL_FALSE) || n == 0) {
+      ERROR("Failed to select EGL configuration");
+      return false;
+    }
+    DEBUG("No EGL configuration for windows, rendering offscreen only");
   }
 
   static const GLint glContextAttribs[] = {EGL_CONTEXT_CLIENT_VERSION, 2,
@@ -240,8 +277,14 @@ bool Renderer::initialize(EGLNativeDisplayType nativeDisplay) {
     return false;
   }
 
-  m_defaultProgram = m_family.add_program(vshader, defaultFShader);
-  m_alphaProgram = m_family.add_program(vshader, alphaFShader);
+  m_layerBatch = new LayerBatch;
+
+  if (!PixelTransfer::isSupported())
+    DEBUG("Pixel buffer objects not supported, using synchronous transfers");
+  else if (!PixelTransfer::isWorthwhile(m_glRenderer))
+    DEBUG("Software renderer %s, using synchronous transfers", m_glRenderer);
+  else
+    m_pixelTransfer = new PixelTransfer;
 
   bind.release();
 
@@ -250,30 +293,22 @@ bool Renderer::initialize(EGLNativeDisplayType nativeDisplay) {
   return true;
 }
 
-Renderer::Program::Program(GLuint program_id) {
-  id = program_id;
-  position_attr = s_gles2.glGetAttribLocation(id, "position");
-  texcoord_attr = s_gles2.glGetAttribLocation(id, "texcoord");
-  tex_uniform = s_gles2.glGetUniformLocation(id, "tex");
-  center_uniform = s_gles2.glGetUniformLocation(id, "center");
-  display_transform_uniform =
-      s_gles2.glGetUniformLocation(id, "display_transform");
-  transform_uniform = s_gles2.glGetUniformLocation(id, "transform");
-  screen_to_gl_coords_uniform =
-      s_gles2.glGetUniformLocation(id, "screen_to_gl_coords");
-  alpha_uniform = s_gles2.glGetUniformLocation(id, "alpha");
-}
-
 Renderer::Renderer()
     : m_configs(NULL),
       m_eglDisplay(EGL_NO_DISPLAY),
+      m_contexts(1),
+      m_windows(2),
+      m_colorbuffers(3),
       m_colorBufferHelper(new ColorBufferHelper(this)),
+      m_colorBufferPool(max_pooled_color_buffer_bytes),
       m_eglContext(EGL_NO_CONTEXT),
       m_pbufContext(EGL_NO_CONTEXT),
       m_prevContext(EGL_NO_CONTEXT),
       m_prevReadSurf(EGL_NO_SURFACE),
       m_prevDrawSurf(EGL_NO_SURFACE),
       m_textureDraw(NULL),
+      m_layerBatch(NULL),
+      m_pixelTransfer(NULL),
       m_lastPostedColorBuffer(0),
       m_statsNumFrames(0),
       m_statsStartTime(0LL),
@@ -284,6 +319,8 @@ Renderer::Renderer()
 }
 
 Renderer::~Renderer() {
+  delete m_pixelTransfer;
+  delete m_layerBatch;
   delete m_textureDraw;
   delete m_configs;
   delete m_colorBufferHelper;
@@ -295,10 +332,24 @@ struct RendererWindow {
   anbox::graphics::Rect viewport;
   glm::mat4 screen_to_gl_coords = glm::mat4(1.0f);
   glm::mat4 display_transform = glm::mat4(1.0f);
+  // Content generation of every ColorBuffer presented with the last frame.
+  std::map<HandleType, unsigned int> generations;
+  // Damage of the last frames, most recent first. Used together with the
+  // buffer age to find out what needs to be repainted in the back buffer.
+  std::deque<anbox::graphics::Rect> damage_history;
+
+  // Offscreen windows render into a pbuffer of |surface_width| x
+  // |surface_height| and publish every frame through |exporter|.
+  bool offscreen = false;
+  std::shared_ptr<anbox::graphics::FrameExporter> exporter;
+  int surface_width = 0;
+  int surface_height = 0;
+  std::vector<uint8_t> readback;
 };
 
 RendererWindow *Renderer::createNativeWindow(
     EGLNativeWindowType native_window) {
+  std::lock_guard<std::mutex> window_lock(m_windowLock);
   m_lock.lock();
 
   auto window = new RendererWindow;
@@ -331,13 +382,74 @@ RendererWindow *Renderer::createNativeWindow(
   return window;
 }
 
-void Renderer::destroyNativeWindow(EGLNativeWindowType native_window) {
-  auto w = m_nativeWindows.find(native_window);
-  if (w == m_nativeWindows.end()) return;
+RendererWindow *Renderer::createOffscreenWindow(
+    EGLNativeWindowType key,
+    const std::shared_ptr<anbox::graphics::FrameExporter> &exporter) {
+  std::unique_lock<std::mutex> l(m_lock);
+
+  if (m_nativeWindows.find(key) != m_nativeWindows.end())
+    return nullptr;
+
+  // The pbuffer is only created once the size of the first frame is known.
+  auto window = new RendererWindow;
+  window->native_window = key;
+  window->offscreen = true;
+  window->exporter = exporter;
+  m_nativeWindows.insert({key, window});
+  return window;
+}
+
+bool Renderer::resizeOffscreenSurface_locked(RendererWindow *window, int width, int height) {
+  if (window->surface != EGL_NO_SURFACE) {
+    s_egl.eglDestroySurface(m_eglDisplay, window->surface);
+    window->surface = EGL_NO_SURFACE;
+  }
+  window->surface_width = 0;
+  window->surface_height = 0;
+
+  const EGLint attribs[] = {EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE};
+  window->surface = s_egl.eglCreatePbufferSurface(m_eglDisplay, m_eglConfig, attribs);
+  if (window->surface == EGL_NO_SURFACE) {
+    ERROR("Failed to create %dx%d pbuffer surface: error=0x%x", width, height, s_egl.eglGetError());
+    return false;
+  }
 
+  window->surface_width = width;
+  window->surface_height = height;
+  return true;
+}
+
+void Renderer::exportFrame_locked(RendererWindow *window,
+                                  const anbox::graphics::Rect &bounds,
+                                  const anbox::graphics::Rect &damage) {
+  const auto target = window->exporter->begin_frame(bounds.width(), bounds.height(), damage);
+  const auto &region = target.region;
+  if (!region.empty()) {
+    const size_t row_size = region.width() * 4;
+    window->readback.resize(row_size * region.height());
+    s_gles2.glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    s_gles2.glReadPixels(region.left(), bounds.height() - region.bottom(),
+                         region.width(), region.height(), GL_RGBA,
+                         GL_UNSIGNED_BYTE, window->readback.data());
+
+    // GL returns the rows bottom up.
+    for (int32_t y = 0; y < region.height(); y++)
+      memcpy(target.pixels + (region.top() + y) * target.stride + region.left() * 4,
+             window->readback.data() + (region.height() - 1 - y) * row_size, row_size);
+  }
+  window->exporter->end_frame();
+}
+
+void Renderer::destroyNativeWindow(EGLNativeWindowType native_window) {
   m_lock.lock();
 
-  s_egl.eglMakeCurrent(m_eglDisplay, nullptr, nullptr, nullptr);
+  auto w = m_nativeWindows.find(native_window);
+  if (w == m_nativeWindows.end()) {
+    m_lock.unlock();
+    return;
+  }
+
+  EglBinding::get()->release(m_eglDisplay);
 
   if (w->second->surface != EGL_NO_SURFACE)
     s_egl.eglDestroySurface(m_eglDisplay, w->second->surface);
@@ -348,29 +460,19 @@ void Renderer::destroyNativeWindow(EGLNativeWindowType native_window) {
   m_lock.unlock();
 }
 
-HandleType Renderer::genHandle() {
-  HandleType id;
-  do {
-    id = ++s_nextHandle;
-  } while (id == 0 || m_contexts.find(id) != m_contexts.end() ||
-           m_windows.find(id) != m_windows.end());
-
-  return id;
-}
-
 HandleType Renderer::createColorBuffer(int p_width, int p_height,
                                        GLenum p_internalFormat) {
   std::unique_lock<std::mutex> l(m_lock);
 
   HandleType ret = 0;
 
-  ColorBufferPtr cb(ColorBuffer::create(
-      getDisplay(), p_width, p_height, p_internalFormat,
-      getCaps().has_eglimage_texture_2d, m_colorBufferHelper));
+  auto cb = m_colorBufferPool.acquire(p_width, p_height, p_internalFormat);
+  if (!cb)
+    cb.reset(ColorBuffer::create(
+        getDisplay(), p_width, p_height, p_internalFormat,
+        getCaps().has_eglimage_texture_2d, m_colorBufferHelper));
   if (cb) {
-    ret = genHandle();
-    m_colorbuffers[ret].cb = cb;
-    m_colorbuffers[ret].refcount = 1;
+    ret = m_colorbuffers.insert({cb, 1});
   }
   return ret;
 }
@@ -388,11 +490,11 @@ HandleType Renderer::createRenderContext(int p_config, HandleType p_share,
 
   RenderContextPtr share(NULL);
   if (p_share != 0) {
-    RenderContextMap::iterator s(m_contexts.find(p_share));
-    if (s == m_contexts.end()) {
+    RenderContextPtr *s = m_contexts.find(p_share);
+    if (!s) {
       return ret;
     }
-    share = (*s).second;
+    share = *s;
   }
   EGLContext sharedContext =
       share ? share->getEGLContext() : EGL_NO_CONTEXT;
@@ -400,8 +502,8 @@ HandleType Renderer::createRenderContext(int p_config, HandleType p_share,
   RenderContextPtr rctx(RenderContext::create(
       m_eglDisplay, config->getEglConfig(), sharedContext, p_isGL2));
   if (rctx) {
-    ret = genHandle();
-    m_contexts[ret] = rctx;
+    ret = m_contexts.insert(rctx);
+    if (!ret) return ret;
     RenderThreadInfo *tinfo = RenderThreadInfo::get();
     tinfo->m_contextSet.insert(ret);
   }
@@ -422,8 +524,8 @@ HandleType Renderer::createWindowSurface(int p_config, int p_width,
   WindowSurfacePtr win(WindowSurface::create(
       getDisplay(), config->getEglConfig(), p_width, p_height));
   if (win) {
-    ret = genHandle();
-    m_windows[ret] = std::pair<WindowSurfacePtr, HandleType>(win, 0);
+    ret = m_windows.insert(std::pair<WindowSurfacePtr, HandleType>(win, 0));
+    if (!ret) return ret;
     RenderThreadInfo *tinfo = RenderThreadInfo::get();
     tinfo->m_windowSet.insert(ret);
   }
@@ -452,13 +554,14 @@ void Renderer::drainWindowSurface() {
   for (std::set<HandleType>::iterator it = tinfo->m_windowSet.begin();
        it != tinfo->m_windowSet.end(); ++it) {
     HandleType windowHandle = *it;
-    if (m_windows.find(windowHandle) != m_windows.end()) {
-      HandleType oldColorBufferHandle = m_windows[windowHandle].second;
+    auto w = m_windows.find(windowHandle);
+    if (w) {
+      HandleType oldColorBufferHandle = w->second;
       if (oldColorBufferHandle) {
-        ColorBufferMap::iterator cit(m_colorbuffers.find(oldColorBufferHandle));
-        if (cit != m_colorbuffers.end()) {
-          if (--(*cit).second.refcount == 0) {
-            m_colorbuffers.erase(cit);
+        ColorBufferRef *c = m_colorbuffers.find(oldColorBufferHandle);
+        if (c) {
+          if (--c->refcount == 0) {
+            releaseColorBuffer_locked(oldColorBufferHandle);
           }
         }
       }
@@ -480,8 +583,7 @@ void Renderer::DestroyRenderContext(HandleType p_context) {
 void Renderer::DestroyWindowSurface(HandleType p_surface) {
   std::unique_lock<std::mutex> l(m_lock);
 
-  if (m_windows.find(p_surface) != m_windows.end()) {
-    m_windows.erase(p_surface);
+  if (m_windows.erase(p_surface)) {
     RenderThreadInfo *tinfo = RenderThreadInfo::get();
     if (tinfo->m_windowSet.empty()) return;
     tinfo->m_windowSet.erase(p_surface);
@@ -491,44 +593,54 @@ void Renderer::DestroyWindowSurface(HandleType p_surface) {
 int Renderer::openColorBuffer(HandleType p_colorbuffer) {
   std::unique_lock<std::mutex> l(m_lock);
 
-  ColorBufferMap::iterator c(m_colorbuffers.find(p_colorbuffer));
-  if (c == m_colorbuffers.end()) {
+  ColorBufferRef *c = m_colorbuffers.find(p_colorbuffer);
+  if (!c) {
     // bad colorbuffer handle
     ERROR("FB: openColorBuffer cb handle %#x not found", p_colorbuffer);
     return -1;
   }
-  (*c).second.refcount++;
+  c->refcount++;
   return 0;
 }
 
 void Renderer::closeColorBuffer(HandleType p_colorbuffer) {
   std::unique_lock<std::mutex> l(m_lock);
 
-  ColorBufferMap::iterator c(m_colorbuffers.find(p_colorbuffer));
-  if (c == m_colorbuffers.end()) {
+  ColorBufferRef *c = m_colorbuffers.find(p_colorbuffer);
+  if (!c) {
     // This is harmless: it is normal for guest system to issue
     // closeColorBuffer command when the color buffer is already
     // garbage collected on the host. (we dont have a mechanism
     // to give guest a notice yet)
     return;
   }
-  if (--(*c).second.refcount == 0) {
-    m_colorbuffers.erase(c);
+  if (--c->refcount == 0) {
+    releaseColorBuffer_locked(p_colorbuffer);
   }
 }
 
+void Renderer::releaseColorBuffer_locked(HandleType p_colorbuffer) {
+  const auto cb = m_colorbuffers.find(p_colorbuffer)->cb;
+  m_colorbuffers.erase(p_colorbuffer);
+
+  // A buffer still attached to a window surface stays alive until it gets
+  // detached and can't be reused before.
+  if (cb.use_count() == 1)
+    m_colorBufferPool.recycle(cb);
+}
+
 bool Renderer::flushWindowSurfaceColorBuffer(HandleType p_surface) {
   std::unique_lock<std::mutex> l(m_lock);
 
-  WindowSurfaceMap::iterator w(m_windows.find(p_surface));
-  if (w == m_windows.end()) {
+  auto w = m_windows.find(p_surface);
+  if (!w) {
     ERROR("FB::flushWindowSurfaceColorBuffer: window handle %#x not found",
         p_surface);
     // bad surface handle
     return false;
   }
 
-  auto surface = (*w).second.first;
+  auto surface = w->first;
   if (!surface)
     return false;
 
@@ -541,22 +653,22 @@ bool Renderer::setWindowSurfaceColorBuffer(HandleType p_surface,
                                            HandleType p_colorbuffer) {
   std::unique_lock<std::mutex> l(m_lock);
 
-  WindowSurfaceMap::iterator w(m_windows.find(p_surface));
-  if (w == m_windows.end()) {
+  auto w = m_windows.find(p_surface);
+  if (!w) {
     // bad surface handle
     ERROR("%s: bad window surface handle %#x", __FUNCTION__, p_surface);
     return false;
   }
 
-  ColorBufferMap::iterator c(m_colorbuffers.find(p_colorbuffer));
-  if (c == m_colorbuffers.end()) {
+  ColorBufferRef *c = m_colorbuffers.find(p_colorbuffer);
+  if (!c) {
     DEBUG("%s: bad color buffer handle %#x", __FUNCTION__, p_colorbuffer);
     // bad colorbuffer handle
     return false;
   }
 
-  (*w).second.first->setColorBuffer((*c).second.cb);
-  (*w).second.second = p_colorbuffer;
+  w->first->setColorBuffer(c->cb);
+  w->second = p_colorbuffer;
   return true;
 }
 
@@ -565,13 +677,13 @@ void Renderer::readColorBuffer(HandleType p_colorbuffer, int x, int y,
                                GLenum type, void *pixels) {
   std::unique_lock<std::mutex> l(m_lock);
 
-  ColorBufferMap::iterator c(m_colorbuffers.find(p_colorbuffer));
-  if (c == m_colorbuffers.end()) {
+  ColorBufferRef *c = m_colorbuffers.find(p_colorbuffer);
+  if (!c) {
     // bad colorbuffer handle
     return;
   }
 
-  (*c).second.cb->readPixels(x, y, width, height, format, type, pixels);
+  c->cb->readPixels(x, y, width, height, format, type, pixels);
 }
 
 bool Renderer::updateColorBuffer(HandleType p_colorbuffer, int x, int y,
@@ -579,13 +691,13 @@ bool Renderer::updateColorBuffer(HandleType p_colorbuffer, int x, int y,
                                  GLenum type, void *pixels) {
   std::unique_lock<std::mutex> l(m_lock);
 
-  ColorBufferMap::iterator c(m_colorbuffers.find(p_colorbuffer));
-  if (c == m_colorbuffers.end()) {
+  ColorBufferRef *c = m_colorbuffers.find(p_colorbuffer);
+  if (!c) {
     // bad colorbuffer handle
     return false;
   }
 
-  (*c).second.cb->subUpdate(x, y, width, height, format, type, pixels);
+  c->cb->subUpdate(x, y, width, height, format, type, pixels);
 
   return true;
 }
@@ -593,25 +705,37 @@ bool Renderer::updateColorBuffer(HandleType p_colorbuffer, int x, int y,
 bool Renderer::bindColorBufferToTexture(HandleType p_colorbuffer) {
   std::unique_lock<std::mutex> l(m_lock);
 
-  ColorBufferMap::iterator c(m_colorbuffers.find(p_colorbuffer));
-  if (c == m_colorbuffers.end()) {
+  ColorBufferRef *c = m_colorbuffers.find(p_colorbuffer);
+  if (!c) {
     // bad colorbuffer handle
     return false;
   }
 
-  return (*c).second.cb->bindToTexture();
+  return c->cb->bindToTexture();
 }
 
 bool Renderer::bindColorBufferToRenderbuffer(HandleType p_colorbuffer) {
   std::unique_lock<std::mutex> l(m_lock);
 
-  ColorBufferMap::iterator c(m_colorbuffers.find(p_colorbuffer));
-  if (c == m_colorbuffers.end()) {
+  ColorBufferRef *c = m_colorbuffers.find(p_colorbuffer);
+  if (!c) {
     // bad colorbuffer handle
     return false;
   }
 
-  return (*c).second.cb->bindToRenderbuffer();
+  return c->cb->bindToRenderbuffer();
+}
+
+void Renderer::postColorBuffer(HandleType p_colorbuffer) {
+  std::unique_lock<std::mutex> l(m_lock);
+
+  ColorBufferRef *c = m_colorbuffers.find(p_colorbuffer);
+  if (!c) {
+    // bad colorbuffer handle
+    return;
+  }
+
+  c->cb->markPosted();
 }
 
 bool Renderer::bindContext(HandleType p_context, HandleType p_drawSurface,
@@ -625,36 +749,36 @@ bool Renderer::bindContext(HandleType p_context, HandleType p_drawSurface,
   // if this is not an unbind operation - make sure all handles are good
   //
   if (p_context || p_drawSurface || p_readSurface) {
-    RenderContextMap::iterator r(m_contexts.find(p_context));
-    if (r == m_contexts.end()) {
+    RenderContextPtr *r = m_contexts.find(p_context);
+    if (!r) {
       // bad context handle
       return false;
     }
 
-    ctx = (*r).second;
-    WindowSurfaceMap::iterator w(m_windows.find(p_drawSurface));
-    if (w == m_windows.end()) {
+    ctx = *r;
+    auto w = m_windows.find(p_drawSurface);
+    if (!w) {
       // bad surface handle
       return false;
     }
-    draw = (*w).second.first;
+    draw = w->first;
 
     if (p_readSurface != p_drawSurface) {
-      WindowSurfaceMap::iterator w(m_windows.find(p_readSurface));
-      if (w == m_windows.end()) {
+      auto w = m_windows.find(p_readSurface);
+      if (!w) {
         // bad surface handle
         return false;
       }
-      read = (*w).second.first;
+      read = w->first;
     } else {
       read = draw;
     }
   }
 
-  if (!s_egl.eglMakeCurrent(m_eglDisplay,
-                            draw ? draw->getEGLSurface() : EGL_NO_SURFACE,
-                            read ? read->getEGLSurface() : EGL_NO_SURFACE,
-                            ctx ? ctx->getEGLContext() : EGL_NO_CONTEXT)) {
+  if (!EglBinding::get()->makeCurrent(
+          m_eglDisplay, draw ? draw->getEGLSurface() : EGL_NO_SURFACE,
+          read ? read->getEGLSurface() : EGL_NO_SURFACE,
+          ctx ? ctx->getEGLContext() : EGL_NO_CONTEXT)) {
     ERROR("eglMakeCurrent failed: 0x%04x", s_egl.eglGetError());
     return false;
   }
@@ -702,16 +826,18 @@ bool Renderer::bindContext(HandleType p_context, HandleType p_drawSurface,
 
 HandleType Renderer::createClientImage(HandleType context, EGLenum target,
                                        GLuint buffer) {
+  std::unique_lock<std::mutex> l(m_lock);
+
   RenderContextPtr ctx(NULL);
 
   if (context) {
-    RenderContextMap::iterator r(m_contexts.find(context));
-    if (r == m_contexts.end()) {
+    RenderContextPtr *r = m_contexts.find(context);
+    if (!r) {
       // bad context handle
       return false;
     }
 
-    ctx = (*r).second;
+    ctx = *r;
   }
 
   EGLContext eglContext = ctx ? ctx->getEGLContext() : EGL_NO_CONTEXT;
@@ -731,42 +857,40 @@ EGLBoolean Renderer::destroyClientImage(HandleType image) {
 // The framebuffer lock should be held when calling this function !
 //
 bool Renderer::bind_locked() {
-  EGLContext prevContext = s_egl.eglGetCurrentContext();
-  EGLSurface prevReadSurf = s_egl.eglGetCurrentSurface(EGL_READ);
-  EGLSurface prevDrawSurf = s_egl.eglGetCurrentSurface(EGL_DRAW);
+  auto binding = EglBinding::get();
+  const auto prev = binding->current();
 
-  if (!s_egl.eglMakeCurrent(m_eglDisplay, m_pbufSurface, m_pbufSurface,
+  if (!binding->makeCurrent(m_eglDisplay, m_pbufSurface, m_pbufSurface,
                             m_pbufContext)) {
     ERROR("eglMakeCurrent failed: 0x%04x", s_egl.eglGetError());
     return false;
   }
 
-  m_prevContext = prevContext;
-  m_prevReadSurf = prevReadSurf;
-  m_prevDrawSurf = prevDrawSurf;
+  m_prevContext = prev.context;
+  m_prevReadSurf = prev.read;
+  m_prevDrawSurf = prev.draw;
   return true;
 }
 
 bool Renderer::bindWindow_locked(RendererWindow *window) {
-  EGLContext prevContext = s_egl.eglGetCurrentContext();
-  EGLSurface prevReadSurf = s_egl.eglGetCurrentSurface(EGL_READ);
-  EGLSurface prevDrawSurf = s_egl.eglGetCurrentSurface(EGL_DRAW);
+  auto binding = EglBinding::get();
+  const auto prev = binding->current();
 
-  if (!s_egl.eglMakeCurrent(m_eglDisplay, window->surface, window->surface,
+  if (!binding->makeCurrent(m_eglDisplay, window->surface, window->surface,
                             m_eglContext)) {
     ERROR("eglMakeCurrent failed");
     return false;
   }
 
-  m_prevContext = prevContext;
-  m_prevReadSurf = prevReadSurf;
-  m_prevDrawSurf = prevDrawSurf;
+  m_prevContext = prev.context;
+  m_prevReadSurf = prev.read;
+  m_prevDrawSurf = prev.draw;
   return true;
 }
 
 bool Renderer::unbind_locked() {
-  if (!s_egl.eglMakeCurrent(m_eglDisplay, m_prevDrawSurf, m_prevReadSurf,
-                            m_prevContext)) {
+  if (!EglBinding::get()->makeCurrent(m_eglDisplay, m_prevDrawSurf,
+                                      m_prevReadSurf, m_prevContext)) {
     return false;
   }
 
@@ -776,40 +900,6 @@ bool Renderer::unbind_locked() {
   return true;
 }
 
-const GLchar *const Renderer::vshader = {
-    "attribute vec3 position;"
-    "attribute vec2 texcoord;"
-    "uniform mat4 screen_to_gl_coords;"
-    "uniform mat4 display_transform;"
-    "uniform mat4 transform;"
-    "uniform vec2 center;"
-    "varying vec2 v_texcoord;"
-    "void main() {"
-    "   vec4 mid = vec4(center, 0.0, 0.0);"
-    "   vec4 transformed = (transform * (vec4(position, 1.0) - mid)) + mid;"
-    "   gl_Position = display_transform * screen_to_gl_coords * transformed;"
-    "   v_texcoord = texcoord;"
-    "}"};
-
-const GLchar *const Renderer::alphaFShader = {
-    "precision mediump float;"
-    "uniform sampler2D tex;"
-    "uniform float alpha;"
-    "varying vec2 v_texcoord;"
-    "void main() {"
-    "   vec4 frag = texture2D(tex, v_texcoord);"
-    "   gl_FragColor = alpha*frag;"
-    "}"};
-
-const GLchar *const Renderer::defaultFShader =
-    {  // This is the fastest fragment shader. Use it when you can.
-        "precision mediump float;"
-        "uniform sampler2D tex;"
-        "varying vec2 v_texcoord;"
-        "void main() {"
-        "   gl_FragColor = texture2D(tex, v_texcoord);"
-        "}"};
-
 void Renderer::setupViewport(RendererWindow *window,
                              const anbox::graphics::Rect &rect) {
   /*
@@ -847,118 +937,176 @@ void Renderer::setupViewport(RendererWindow *window,
   window->viewport = rect;
 }
 
-void Renderer::tessellate(std::vector<anbox::graphics::Primitive> &primitives,
-                          const anbox::graphics::Rect &buf_size,
-                          const Renderable &renderable) {
-  auto rect = renderable.screen_position();
-  GLfloat left = rect.left();
-  GLfloat right = rect.right();
-  GLfloat top = rect.top();
-  GLfloat bottom = rect.bottom();
-
-  anbox::graphics::Primitive rectangle;
-  rectangle.tex_id = 0;
-  rectangle.type = GL_TRIANGLE_STRIP;
+bool Renderer::draw(EGLNativeWindowType native_window,
+                    const anbox::graphics::Rect &window_frame,
+                    const RenderableList &renderables) {
+  return draw_with_damage(native_window, window_frame, renderables,
+                          {0, 0, window_frame.width(), window_frame.height()});
+}
 
-  GLfloat tex_left =
-      static_cast<GLfloat>(renderable.crop().left()) / buf_size.width();
-  GLfloat tex_top =
-      static_cast<GLfloat>(renderable.crop().top()) / buf_size.height();
-  GLfloat tex_right =
-      static_cast<GLfloat>(renderable.crop().right()) / buf_size.width();
-  GLfloat tex_bottom =
-      static_cast<GLfloat>(renderable.crop().bottom()) / buf_size.height();
+bool Renderer::draw_with_damage(EGLNativeWindowType native_window,
+                                const anbox::graphics::Rect &window_frame,
+                                const RenderableList &renderables,
+                                const anbox::graphics::Rect &damage) {
+  // Within a frame the window lock is held already and the context stays
+  // bound for the next window.
+  const auto batched = m_frameThread == std::this_thread::get_id();
+  std::unique_lock<std::mutex> window_lock(m_windowLock, std::defer_lock);
+  if (!batched)
+    window_lock.lock();
+  std::unique_lock<std::mutex> l(m_lock);
 
-  auto &vertices = rectangle.vertices;
-  vertices[0] = {{left, top, 0.0f}, {tex_left, tex_top}};
-  vertices[1] = {{left, bottom, 0.0f}, {tex_left, tex_bottom}};
-  vertices[2] = {{right, top, 0.0f}, {tex_right, tex_top}};
-  vertices[3] = {{right, bottom, 0.0f}, {tex_right, tex_bottom}};
+  auto w = m_nativeWindows.find(native_window);
+  if (w == m_nativeWindows.end()) return false;
 
-  primitives.resize(1);
-  primitives[0] = rectangle;
-}
+  auto window = w->second;
+  const anbox::graphics::Rect bounds{0, 0, window_frame.width(), window_frame.height()};
+  const glm::mat4 identity(1.0f);
 
-void Renderer::draw(RendererWindow *window, const Renderable &renderable,
-                    const Program &prog) {
-  const auto &color_buffer = m_colorbuffers.find(renderable.buffer());
-  if (color_buffer == m_colorbuffers.end()) return;
+  auto add_damage = [](anbox::graphics::Rect &target, const anbox::graphics::Rect &rect) {
+    if (target.empty())
+      target = rect;
+    else
+      target.merge(rect);
+  };
 
-  const auto &cb = color_buffer->second.cb;
+  // Layers can stay the same while the content of their buffer changes,
+  // e.g. for buffers the guest updates in place.
+  auto frame_damage = damage;
+  std::map<HandleType, unsigned int> generations;
+  for (const auto &r : renderables) {
+    const auto cb = m_colorbuffers.find(r.buffer());
+    if (!cb) continue;
 
-  s_gles2.glUseProgram(prog.id);
-  s_gles2.glUniform1i(prog.tex_uniform, 0);
-  s_gles2.glUniformMatrix4fv(prog.display_transform_uniform, 1, GL_FALSE,
-                             glm::value_ptr(window->display_transform));
-  s_gles2.glUniformMatrix4fv(prog.screen_to_gl_coords_uniform, 1, GL_FALSE,
-                             glm::value_ptr(window->screen_to_gl_coords));
+    const auto generation = cb->cb->getGeneration();
+    generations[r.buffer()] = generation;
 
-  s_gles2.glActiveTexture(GL_TEXTURE0);
+    const auto last = window->generations.find(r.buffer());
+    if (last != window->generations.end() && last->second == generation) continue;
 
-  auto const &rect = renderable.screen_position();
-  GLfloat centerx = rect.left() + rect.width() / 2.0f;
-  GLfloat centery = rect.top() + rect.height() / 2.0f;
-  s_gles2.glUniform2f(prog.center_uniform, centerx, centery);
+    if (r.transformation() != identity)
+      frame_damage = bounds;
+    else
+      add_damage(frame_damage, r.screen_position());
+  }
+  frame_damage.intersect(bounds);
 
-  s_gles2.glUniformMatrix4fv(prog.transform_uniform, 1, GL_FALSE,
-                             glm::value_ptr(renderable.transformation()));
+  const auto size_changed = window->viewport.width() != window_frame.width() ||
+                            window->viewport.height() != window_frame.height();
+  if (frame_damage.empty() && !size_changed) return true;
 
-  if (prog.alpha_uniform >= 0)
-    s_gles2.glUniform1f(prog.alpha_uniform, renderable.alpha());
+  if (window->offscreen && (window->surface_width != bounds.width() ||
+                            window->surface_height != bounds.height())) {
+    if (!resizeOffscreenSurface_locked(window, bounds.width(), bounds.height()))
+      return false;
+  }
 
-  s_gles2.glEnableVertexAttribArray(prog.position_attr);
-  s_gles2.glEnableVertexAttribArray(prog.texcoord_attr);
+  if (!bindWindow_locked(window))
+    return false;
 
-  m_primitives.clear();
-  tessellate(m_primitives, {
-             static_cast<int32_t>(cb->getWidth()),
-             static_cast<int32_t>(cb->getHeight())}, renderable);
+  // The back buffer still holds the content of the frame presented |age|
+  // frames ago so everything damaged since then has to be repainted.
+  bool full_repaint = size_changed || frame_damage == bounds ||
+                      (!window->offscreen && !m_caps.has_buffer_age);
+  auto repaint = frame_damage;
+  if (!full_repaint) {
+    // A pbuffer is never swapped and always holds the last frame.
+    EGLint age = 1;
+    if (!window->offscreen &&
+        !s_egl.eglQuerySurface(m_eglDisplay, window->surface, EGL_BUFFER_AGE_EXT, &age))
+      age = 0;
+
+    if (age <= 0 || static_cast<size_t>(age - 1) > window->damage_history.size()) {
+      full_repaint = true;
+    } else {
+      for (auto n = 0; n < age - 1; n++)
+        add_damage(repaint, window->damage_history[n]);
+    }
+  }
+  if (full_repaint) {
+    frame_damage = bounds;
+    repaint = bounds;
+  }
 
-  for (auto const &p : m_primitives) {
-    cb->bind();
+  // Rectangles handed to EGL have their origin in the bottom left corner.
+  EGLint repaint_rect[] = {repaint.left(), bounds.height() - repaint.bottom(),
+                                 repaint.width(), repaint.height()};
+  if (m_caps.has_partial_update && !window->offscreen)
+    s_egl.eglSetDamageRegionKHR(m_eglDisplay, window->surface,
+                                repaint_rect, 1);
 
-    s_gles2.glVertexAttribPointer(prog.position_attr, 3, GL_FLOAT, GL_FALSE,
-                                  sizeof(anbox::graphics::Vertex),
-                                  &p.vertices[0].position);
-    s_gles2.glVertexAttribPointer(prog.texcoord_attr, 2, GL_FLOAT, GL_FALSE,
-                                  sizeof(anbox::graphics::Vertex),
-                                  &p.vertices[0].texcoord);
+  setupViewport(window, window_frame);
+  s_gles2.glViewport(0, 0, window_frame.width(), window_frame.height());
 
-    s_gles2.glEnable(GL_BLEND);
-    s_gles2.glBlendFuncSeparate(GL_ONE, GL_ONE_MINUS_SRC_ALPHA, GL_ONE,
-                                GL_ONE_MINUS_SRC_ALPHA);
+  // Resolving the textures may render downscaled copies of the buffers
+  // for the current viewport, so it has to happen before the scissor and
+  // draw state is set up.
+  for (const auto &r : renderables) {
+    if (!full_repaint && r.transformation() == identity &&
+        !r.screen_position().intersects(repaint))
+      continue;
+
+    const auto cb = m_colorbuffers.find(r.buffer());
+    if (!cb) continue;
+
+    const auto &color_buffer = cb->cb;
+    const auto texture =
+        color_buffer->getTexture(window_frame.width(), window_frame.height());
+    m_layerBatch->add(texture,
+                      {0, 0, static_cast<int32_t>(color_buffer->getWidth()),
+                       static_cast<int32_t>(color_buffer->getHeight())},
+                      r);
+  }
 
-    s_gles2.glDrawArrays(p.type, 0, p.nvertices);
+  if (!full_repaint) {
+    s_gles2.glEnable(GL_SCISSOR_TEST);
+    s_gles2.glScissor(repaint_rect[0], repaint_rect[1], repaint_rect[2], repaint_rect[3]);
   }
+  s_gles2.glClearColor(0.0, 0.0, 0.0, 1.0);
+  s_gles2.glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+  s_gles2.glClear(GL_COLOR_BUFFER_BIT);
 
-  s_gles2.glDisableVertexAttribArray(prog.texcoord_attr);
-  s_gles2.glDisableVertexAttribArray(prog.position_attr);
-}
+  m_layerBatch->draw(window->screen_to_gl_coords, window->display_transform);
 
-bool Renderer::draw(EGLNativeWindowType native_window,
-                    const anbox::graphics::Rect &window_frame,
-                    const RenderableList &renderables) {
+  if (!full_repaint)
+    s_gles2.glDisable(GL_SCISSOR_TEST);
 
-  std::unique_lock<std::mutex> l(m_lock);
+  if (window->offscreen) {
+    exportFrame_locked(window, bounds, frame_damage);
+  } else if (m_swapBuffersWithDamage) {
+    const EGLint damage_rect[] = {frame_damage.left(), bounds.height() - frame_damage.bottom(),
+                                  frame_damage.width(), frame_damage.height()};
+    m_swapBuffersWithDamage(m_eglDisplay, window->surface, damage_rect, 1);
+  } else {
+    s_egl.eglSwapBuffers(m_eglDisplay, window->surface);
+  }
 
-  auto w = m_nativeWindows.find(native_window);
-  if (w == m_nativeWindows.end()) return false;
+  window->generations.swap(generations);
+  window->damage_history.push_front(frame_damage);
+  if (window->damage_history.size() > max_buffer_age)
+    window->damage_history.pop_back();
 
-  if (!bindWindow_locked(w->second))
-    return false;
+  if (!batched)
+    unbind_locked();
 
-  setupViewport(w->second, window_frame);
-  s_gles2.glViewport(0, 0, window_frame.width(), window_frame.height());
-  s_gles2.glClearColor(0.0, 0.0, 0.0, 1.0);
-  s_gles2.glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
-  s_gles2.glClear(GL_COLOR_BUFFER_BIT);
+  return true;
+}
 
-  for (const auto &r : renderables)
-    draw(w->second, r, r.alpha() < 1.0f ? m_alphaProgram : m_defaultProgram);
+void Renderer::begin_frame() {
+  m_windowLock.lock();
+  m_frameThread = std::this_thread::get_id();
 
-  s_egl.eglSwapBuffers(m_eglDisplay, w->second->surface);
+  const auto prev = EglBinding::get()->current();
+  m_framePrevContext = prev.context;
+  m_framePrevReadSurf = prev.read;
+  m_framePrevDrawSurf = prev.draw;
+}
 
-  unbind_locked();
+void Renderer::end_frame() {
+  if (!EglBinding::get()->makeCurrent(m_eglDisplay, m_framePrevDrawSurf,
+                                      m_framePrevReadSurf, m_framePrevContext))
+    ERROR("Failed to restore context after frame: 0x%04x", s_egl.eglGetError());
 
-  return false;
+  m_frameThread = std::thread::id();
+  m_windowLock.unlock();
 }
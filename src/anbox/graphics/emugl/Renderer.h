@@ -17,35 +17,37 @@
 #define _LIBRENDER_FRAMEBUFFER_H
 
 #include "anbox/graphics/emugl/ColorBuffer.h"
+#include "anbox/graphics/emugl/ColorBufferPool.h"
+#include "anbox/graphics/emugl/HandleTable.h"
+#include "anbox/graphics/emugl/LayerBatch.h"
+#include "anbox/graphics/emugl/PixelTransfer.h"
 #include "anbox/graphics/emugl/RenderContext.h"
 #include "anbox/graphics/emugl/RendererConfig.h"
 #include "anbox/graphics/emugl/TextureDraw.h"
 #include "anbox/graphics/emugl/WindowSurface.h"
 #include "anbox/graphics/emugl/Renderable.h"
 
-#include "anbox/graphics/primitives.h"
-#include "anbox/graphics/program_family.h"
 #include "anbox/graphics/renderer.h"
 
 #include <EGL/egl.h>
+#include <EGL/eglext.h>
 
+#include <atomic>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <thread>
 
 #include <stdint.h>
 
-// Type of handles, a.k.a. "object names" in the GL specification.
-// These are integers used to uniquely identify a resource of a given type.
-typedef uint32_t HandleType;
-
 struct ColorBufferRef {
   ColorBufferPtr cb;
   uint32_t refcount;  // number of client-side references
 };
-typedef std::map<HandleType, RenderContextPtr> RenderContextMap;
-typedef std::map<HandleType, std::pair<WindowSurfacePtr, HandleType>>
-    WindowSurfaceMap;
-typedef std::map<HandleType, ColorBufferRef> ColorBufferMap;
+typedef HandleTable<RenderContextPtr> RenderContextTable;
+typedef HandleTable<std::pair<WindowSurfacePtr, HandleType>>
+    WindowSurfaceTable;
+typedef HandleTable<ColorBufferRef> ColorBufferTable;
 
 // A structure used to list the capabilities of the underlying EGL
 // implementation that the FrameBuffer instance depends on.
@@ -53,17 +55,26 @@ typedef std::map<HandleType, ColorBufferRef> ColorBufferMap;
 // extension is supported.
 // |has_eglimage_renderbuffer| is true iff the EGL_KHR_gl_renderbuffer_image
 // extension is supported.
+// |has_buffer_age| is true iff EGL_EXT_buffer_age or EGL_KHR_partial_update
+// is supported and |has_partial_update| iff the latter one is.
 // |eglMajor| and |eglMinor| are the major and minor version numbers of
 // the underlying EGL implementation.
 struct RendererCaps {
   bool has_eglimage_texture_2d;
   bool has_eglimage_renderbuffer;
+  bool has_buffer_age = false;
+  bool has_partial_update = false;
   EGLint eglMajor;
   EGLint eglMinor;
 };
 
 struct RendererWindow;
 
+namespace anbox::graphics {
+class FrameExporter;
+class ProgramBinaryCache;
+}
+
 // The FrameBuffer class holds the global state of the emulation library on
 // top of the underlying EGL/GLES implementation. It should probably be
 // named "Display" instead of "FrameBuffer".
@@ -105,6 +116,13 @@ class Renderer : public anbox::graphics::Renderer {
   }
 
   RendererWindow* createNativeWindow(EGLNativeWindowType native_window);
+  // Creates a window which renders into a pbuffer of the size of its frame
+  // instead of a native window surface. Every drawn frame is read back and
+  // published through |exporter|. |key| only identifies the window for
+  // draw() and destroyNativeWindow().
+  RendererWindow* createOffscreenWindow(
+      EGLNativeWindowType key,
+      const std::shared_ptr<anbox::graphics::FrameExporter>& exporter);
   void destroyNativeWindow(RendererWindow* window);
   void destroyNativeWindow(EGLNativeWindowType native_window);
 
@@ -197,6 +215,10 @@ class Renderer : public anbox::graphics::Renderer {
   // Returns true on success, false on failure.
   bool bindColorBufferToRenderbuffer(HandleType p_colorbuffer);
 
+  // Tell a ColorBuffer instance that the guest posted it for composition.
+  // See ColorBuffer::markPosted().
+  void postColorBuffer(HandleType p_colorbuffer);
+
   // Read the content of a given ColorBuffer into client memory.
   // |p_colorbuffer| is the ColorBuffer's handle value. Similar
   // to glReadPixels(), this can be a slow operation.
@@ -224,6 +246,19 @@ class Renderer : public anbox::graphics::Renderer {
   bool draw(EGLNativeWindowType native_window,
             const anbox::graphics::Rect& window_frame,
             const RenderableList& renderables) override;
+  // Only redraws the parts of the window which changed since the last
+  // frame. Besides |damage| this covers all layers whose ColorBuffer content
+  // changed. Nothing is drawn nor presented when nothing changed at all.
+  bool draw_with_damage(EGLNativeWindowType native_window,
+                        const anbox::graphics::Rect& window_frame,
+                        const RenderableList& renderables,
+                        const anbox::graphics::Rect& damage) override;
+
+  // Keep the compositor context bound across all windows drawn until
+  // end_frame(). Other threads can't draw or create windows in between but
+  // render threads only wait for the window currently being drawn.
+  void begin_frame() override;
+  void end_frame() override;
 
   // Return the host EGLDisplay used by this instance.
   EGLDisplay getDisplay() const { return m_eglDisplay; }
@@ -232,6 +267,24 @@ class Renderer : public anbox::graphics::Renderer {
   // and windows created by this instance.
   TextureDraw* getTextureDraw() const { return m_textureDraw; }
 
+  // Return the engine used for streaming uploads and readbacks of
+  // ColorBuffers, or NULL if the host GL doesn't support it.
+  PixelTransfer* getPixelTransfer() const { return m_pixelTransfer; }
+
+  // Return the pool closed ColorBuffers are recycled through. Its hit and
+  // miss counters can be read at any time.
+  const ColorBufferPool& getColorBufferPool() const { return m_colorBufferPool; }
+
+  // Set the cache which render threads started afterwards load guest
+  // programs from instead of linking them. NULL disables it.
+  void setProgramBinaryCache(
+      const std::shared_ptr<anbox::graphics::ProgramBinaryCache>& cache) {
+    m_programBinaryCache = cache;
+  }
+  const std::shared_ptr<anbox::graphics::ProgramBinaryCache>& getProgramBinaryCache() const {
+    return m_programBinaryCache;
+  }
+
   HandleType createClientImage(HandleType context, EGLenum target,
                                GLuint buffer);
   EGLBoolean destroyClientImage(HandleType image);
@@ -241,29 +294,32 @@ class Renderer : public anbox::graphics::Renderer {
   bool unbind_locked();
 
  private:
-  HandleType genHandle();
-
   bool bindWindow_locked(RendererWindow* window);
+  void releaseColorBuffer_locked(HandleType p_colorbuffer);
 
   void setupViewport(RendererWindow* window, const anbox::graphics::Rect& rect);
-  struct Program;
-  void draw(RendererWindow* window, const Renderable& renderable,
-            const Program& prog);
-  void tessellate(std::vector<anbox::graphics::Primitive>& primitives,
-                  const anbox::graphics::Rect& buf_size,
-                  const Renderable& renderable);
+  bool resizeOffscreenSurface_locked(RendererWindow* window, int width, int height);
+  void exportFrame_locked(RendererWindow* window, const anbox::graphics::Rect& bounds,
+                          const anbox::graphics::Rect& damage);
 
  private:
   static Renderer* s_renderer;
-  static HandleType s_nextHandle;
+  // Render threads decode concurrently; this lock serializes access to the
+  // handle tables below, the helper context (m_pbufContext) and all
+  // ColorBuffer/EGLImage operations which go through it.
   std::mutex m_lock;
+  // An EGL context can only be current on one thread. This lock is held
+  // while m_eglContext is bound to a window surface, for a single draw or
+  // from begin_frame() to end_frame(). Taken before m_lock.
+  std::mutex m_windowLock;
   RendererConfigList* m_configs;
   RendererCaps m_caps;
   EGLDisplay m_eglDisplay;
-  RenderContextMap m_contexts;
-  WindowSurfaceMap m_windows;
-  ColorBufferMap m_colorbuffers;
+  RenderContextTable m_contexts;
+  WindowSurfaceTable m_windows;
+  ColorBufferTable m_colorbuffers;
   ColorBuffer::Helper* m_colorBufferHelper;
+  ColorBufferPool m_colorBufferPool;
 
   EGLContext m_eglContext;
   EGLSurface m_pbufSurface;
@@ -272,7 +328,17 @@ class Renderer : public anbox::graphics::Renderer {
   EGLContext m_prevContext;
   EGLSurface m_prevReadSurf;
   EGLSurface m_prevDrawSurf;
+
+  // Thread between begin_frame() and end_frame(), which holds
+  // m_windowLock, and what it had bound before.
+  std::atomic<std::thread::id> m_frameThread{std::thread::id()};
+  EGLContext m_framePrevContext = EGL_NO_CONTEXT;
+  EGLSurface m_framePrevReadSurf = EGL_NO_SURFACE;
+  EGLSurface m_framePrevDrawSurf = EGL_NO_SURFACE;
+
   TextureDraw* m_textureDraw;
+  LayerBatch* m_layerBatch;
+  PixelTransfer* m_pixelTransfer;
   EGLConfig m_eglConfig;
   HandleType m_lastPostedColorBuffer;
 
@@ -285,29 +351,7 @@ class Renderer : public anbox::graphics::Renderer {
   const char* m_glVersion;
 
   std::map<EGLNativeWindowType, RendererWindow*> m_nativeWindows;
-
-  anbox::graphics::ProgramFamily m_family;
-  struct Program {
-    GLuint id = 0;
-    GLint tex_uniform = -1;
-    GLint position_attr = -1;
-    GLint texcoord_attr = -1;
-    GLint center_uniform = -1;
-    GLint display_transform_uniform = -1;
-    GLint transform_uniform = -1;
-    GLint screen_to_gl_coords_uniform = -1;
-    GLint alpha_uniform = -1;
-    mutable long long last_used_frameno = 0;
-
-    Program(GLuint program_id);
-    Program() {}
-  };
-  Program m_defaultProgram, m_alphaProgram;
-
-  std::vector<anbox::graphics::Primitive> m_primitives;
-
-  static const GLchar* const vshader;
-  static const GLchar* const defaultFShader;
-  static const GLchar* const alphaFShader;
+  PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC m_swapBuffersWithDamage = nullptr;
+  std::shared_ptr<anbox::graphics::ProgramBinaryCache> m_programBinaryCache;
 };
 #endif
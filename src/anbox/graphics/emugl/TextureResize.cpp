@@ -188,7 +188,11 @@ static void attachShaders(TextureResize::Framebuffer* fb,
 TextureResize::TextureResize(GLuint width, GLuint height)
     : mWidth(width),
       mHeight(height),
-      mFactor(1) {
+      mFactor(1),
+      mCached(false),
+      mCachedTexture(0),
+      mCachedGeneration(0),
+      mCachedResult(0) {
   s_gles2.glGenTextures(1, &mFBWidth.texture);
   s_gles2.glBindTexture(GL_TEXTURE_2D, mFBWidth.texture);
   s_gles2.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -228,15 +232,10 @@ TextureResize::~TextureResize() {
   s_gles2.glDeleteBuffers(1, &mVertexBuffer);
 }
 
-GLuint TextureResize::update(GLuint texture) {
-  // Store the viewport. The viewport is clobbered due to the framebuffers.
-  GLint vport[4] = {
-      0,
-  };
-  s_gles2.glGetIntegerv(GL_VIEWPORT, vport);
-
+GLuint TextureResize::update(GLuint texture, unsigned int generation,
+                             GLint viewportWidth, GLint viewportHeight) {
   // Correctly deal with rotated screens.
-  GLint tWidth = vport[2], tHeight = vport[3];
+  GLint tWidth = viewportWidth, tHeight = viewportHeight;
   if ((mWidth < mHeight) != (tWidth < tHeight)) {
     std::swap(tWidth, tHeight);
   }
@@ -254,20 +253,34 @@ GLuint TextureResize::update(GLuint texture) {
     return texture;
   }
 
+  // Nothing changed since the last time, neither the scaled copy nor the
+  // outcome of trying to produce it.
+  if (mCached && factor == mFactor && texture == mCachedTexture &&
+      generation == mCachedGeneration) {
+    return mCachedResult;
+  }
+
   s_gles2.glGetError();  // Clear any GL errors.
   setupFramebuffers(factor);
   resize(texture);
-  s_gles2.glViewport(vport[0], vport[1], vport[2],
-                     vport[3]);  // Restore the viewport.
+  // Restore the viewport, which is clobbered due to the framebuffers.
+  s_gles2.glViewport(0, 0, viewportWidth, viewportHeight);
+
+  mCached = true;
+  mCachedTexture = texture;
+  mCachedGeneration = generation;
+  mCachedResult = mFBHeight.texture;
 
   // If there was an error while resizing, just use the unscaled texture.
+  // Drivers which can't render into the intermediate framebuffer fail the
+  // same way every time, so that is kept until the content changes too.
   GLenum error = s_gles2.glGetError();
   if (error != GL_NO_ERROR) {
     ERROR("GL error while resizing: 0x%x (ignored)", error);
-    return texture;
+    mCachedResult = texture;
   }
 
-  return mFBHeight.texture;
+  return mCachedResult;
 }
 
 void TextureResize::setupFramebuffers(unsigned int factor) {
@@ -24,9 +24,13 @@ class TextureResize {
   TextureResize(GLuint width, GLuint height);
   ~TextureResize();
 
-  // Scales the given texture for the current viewport and returns the scaled
-  // texture. May return the input if no scaling is required.
-  GLuint update(GLuint texture);
+  // Scales the given texture for a viewport of |viewportWidth| x
+  // |viewportHeight| at the origin and returns the scaled texture. May return
+  // the input if no scaling is required. |generation| identifies the content
+  // of |texture|; as long as it and the scaling factor stay the same the
+  // previous result is returned without rendering anything.
+  GLuint update(GLuint texture, unsigned int generation, GLint viewportWidth,
+                GLint viewportHeight);
 
   struct Framebuffer {
     GLuint texture = 0;
@@ -44,6 +48,12 @@ class TextureResize {
   GLuint mWidth;
   GLuint mHeight;
   unsigned int mFactor;
+  // The last input and what update() returned for it, which is either the
+  // scaled copy or the input itself if scaling it failed.
+  bool mCached;
+  GLuint mCachedTexture;
+  unsigned int mCachedGeneration;
+  GLuint mCachedResult;
   Framebuffer mFBWidth;
   Framebuffer mFBHeight;
   GLuint mVertexBuffer;
@@ -15,6 +15,7 @@
 */
 
 #include "anbox/graphics/emugl/WindowSurface.h"
+#include "anbox/graphics/emugl/EglBinding.h"
 #include "anbox/graphics/emugl/RendererConfig.h"
 #include "anbox/logger.h"
 
@@ -104,12 +105,12 @@ bool WindowSurface::flushColorBuffer() {
     return false;
   }
 
-  // Make the surface current
-  EGLContext prevContext = s_egl.eglGetCurrentContext();
-  EGLSurface prevReadSurf = s_egl.eglGetCurrentSurface(EGL_READ);
-  EGLSurface prevDrawSurf = s_egl.eglGetCurrentSurface(EGL_DRAW);
+  // Make the surface current. Guests flush from within eglSwapBuffers()
+  // so usually it is current already and both switches are skipped.
+  auto binding = EglBinding::get();
+  const auto prev = binding->current();
 
-  if (!s_egl.eglMakeCurrent(mDisplay, mSurface, mSurface,
+  if (!binding->makeCurrent(mDisplay, mSurface, mSurface,
                             mDrawContext->getEGLContext())) {
     ERROR("Failed to make draw context current");
     return false;
@@ -118,7 +119,7 @@ bool WindowSurface::flushColorBuffer() {
   mAttachedColorBuffer->blitFromCurrentReadBuffer();
 
   // restore current context/surface
-  s_egl.eglMakeCurrent(mDisplay, prevDrawSurf, prevReadSurf, prevContext);
+  binding->makeCurrent(mDisplay, prev.draw, prev.read, prev.context);
 
   return true;
 }
@@ -129,16 +130,17 @@ bool WindowSurface::resize(unsigned int p_width, unsigned int p_height) {
     return true;
   }
 
-  EGLContext prevContext = s_egl.eglGetCurrentContext();
-  EGLSurface prevReadSurf = s_egl.eglGetCurrentSurface(EGL_READ);
-  EGLSurface prevDrawSurf = s_egl.eglGetCurrentSurface(EGL_DRAW);
+  auto binding = EglBinding::get();
+  const auto prev = binding->current();
+  EGLContext prevContext = prev.context;
+  EGLSurface prevReadSurf = prev.read;
+  EGLSurface prevDrawSurf = prev.draw;
   EGLSurface prevPbuf = mSurface;
   bool needRebindContext =
       mSurface && (prevReadSurf == mSurface || prevDrawSurf == mSurface);
 
   if (needRebindContext) {
-    s_egl.eglMakeCurrent(mDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE,
-                         EGL_NO_CONTEXT);
+    binding->release(mDisplay);
   }
 
   if (mSurface) {
@@ -162,7 +164,7 @@ bool WindowSurface::resize(unsigned int p_width, unsigned int p_height) {
   mHeight = p_height;
 
   if (needRebindContext) {
-    s_egl.eglMakeCurrent(
+    binding->makeCurrent(
         mDisplay, (prevDrawSurf == prevPbuf) ? mSurface : prevDrawSurf,
         (prevReadSurf == prevPbuf) ? mSurface : prevReadSurf, prevContext);
   }
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef ANBOX_GRAPHICS_FRAME_EXPORT_H_
+#define ANBOX_GRAPHICS_FRAME_EXPORT_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace anbox::graphics {
+// One frame in the shared memory of a FrameExportHeader. Pixels are RGBA
+// with 8 bits per channel, rows top to bottom, stride bytes apart.
+struct FrameExportSlot {
+  // Frames are numbered from 1 in the order they were composed.
+  std::uint64_t sequence;
+  std::uint32_t width;
+  std::uint32_t height;
+  std::uint32_t stride;
+  // What changed since the frame the consumer latched before this one,
+  // origin in the top left corner. A consumer which has no previous
+  // frame yet has to take the whole frame.
+  std::int32_t damage_left;
+  std::int32_t damage_top;
+  std::int32_t damage_right;
+  std::int32_t damage_bottom;
+  std::uint32_t reserved;
+};
+
+// Start of the shared memory the headless platform exports the composed
+// frames of a window through. The slots form a triple buffer like
+// common::TripleBuffer: the compositor fills the back slot and publishes
+// it, a single consumer latches the most recently published slot into the
+// front. Neither side ever waits for the other and the compositor never
+// touches the front slot, so the consumer can read it at its own pace.
+struct FrameExportHeader {
+  static constexpr std::uint32_t magic_value = 0x5846414e;  // "NAFX"
+  static constexpr std::uint32_t slot_count = 3;
+  static constexpr std::uint32_t index_mask = 0x3;
+  static constexpr std::uint32_t fresh_bit = 0x4;
+  static constexpr std::uint32_t data_offset = 4096;
+
+  std::uint32_t magic;
+  // The Android task the window shows, 0 in single window mode.
+  std::int32_t task;
+  // Bytes per slot; frames larger than that are cropped.
+  std::uint64_t slot_size;
+
+  // Index of the slot between both sides, with fresh_bit set while it
+  // holds a frame the consumer didn't latch yet.
+  alignas(64) std::atomic<std::uint32_t> state;
+  // Index of the slot the consumer reads from; only the consumer changes it.
+  std::atomic<std::uint32_t> front;
+  // Set once the window is gone; no more frames will follow.
+  std::atomic<std::uint32_t> closed;
+  // Number of frames published so far, for consumers to poll cheaply.
+  std::atomic<std::uint64_t> published;
+
+  alignas(64) FrameExportSlot slots[slot_count];
+};
+static_assert(sizeof(FrameExportHeader) <= FrameExportHeader::data_offset,
+              "Frames would overlap the frame export header");
+static_assert(ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2,
+              "Frame export state is shared between processes and has to be lock free");
+
+inline std::size_t frame_export_size(std::uint64_t slot_size) {
+  return FrameExportHeader::data_offset + FrameExportHeader::slot_count * slot_size;
+}
+}
+#endif
@@ -0,0 +1,205 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "anbox/graphics/frame_exporter.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+#include <boost/throw_exception.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+constexpr std::size_t page_size{4096};
+// Slots which come back to the producer after more frames than this are
+// copied completely.
+constexpr std::size_t max_damage_history{8};
+
+void add_damage(anbox::graphics::Rect &target, const anbox::graphics::Rect &rect) {
+  if (rect.empty())
+    return;
+  if (target.empty())
+    target = rect;
+  else
+    target.merge(rect);
+}
+
+[[noreturn]] void throw_error(const std::string &what) {
+  BOOST_THROW_EXCEPTION(std::runtime_error(what + ": " + std::strerror(errno)));
+}
+}
+
+namespace anbox::graphics {
+constexpr std::uint32_t FrameExportHeader::magic_value;
+constexpr std::uint32_t FrameExportHeader::slot_count;
+constexpr std::uint32_t FrameExportHeader::index_mask;
+constexpr std::uint32_t FrameExportHeader::fresh_bit;
+constexpr std::uint32_t FrameExportHeader::data_offset;
+
+FrameExporter::FrameExporter(std::int32_t task, std::uint32_t max_width, std::uint32_t max_height) :
+  max_pixels_(std::uint64_t{max_width} * max_height) {
+  const auto slot_size = (max_pixels_ * 4 + page_size - 1) / page_size * page_size;
+  mapping_size_ = frame_export_size(slot_size);
+
+  fd_ = Fd(::memfd_create("anbox-frames", MFD_CLOEXEC | MFD_ALLOW_SEALING));
+  if (fd_ < 0)
+    throw_error("Failed to create frame export");
+
+  // The consumer must not be able to shrink the memory under our feet.
+  if (::ftruncate(fd_, static_cast<off_t>(mapping_size_)) < 0 ||
+      ::fcntl(fd_, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) < 0)
+    throw_error("Failed to size frame export");
+
+  mapping_ = ::mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+  if (mapping_ == MAP_FAILED) {
+    mapping_ = nullptr;
+    throw_error("Failed to map frame export");
+  }
+
+  // A fresh memfd is zeroed, so all slots start out empty.
+  header_ = new (mapping_) FrameExportHeader;
+  header_->magic = FrameExportHeader::magic_value;
+  header_->task = task;
+  header_->slot_size = slot_size;
+  header_->state.store(2);
+  header_->front.store(0);
+  header_->closed.store(0);
+  header_->published.store(0);
+}
+
+FrameExporter::~FrameExporter() {
+  close();
+  ::munmap(mapping_, mapping_size_);
+}
+
+std::uint8_t *FrameExporter::pixels(std::uint32_t index) {
+  return static_cast<std::uint8_t*>(mapping_) + FrameExportHeader::data_offset + index * header_->slot_size;
+}
+
+FrameExporter::Target FrameExporter::begin_frame(std::uint32_t width, std::uint32_t height, const Rect &damage) {
+  width = static_cast<std::uint32_t>(std::min<std::uint64_t>(width, max_pixels_));
+  if (width > 0)
+    height = static_cast<std::uint32_t>(std::min<std::uint64_t>(height, max_pixels_ / width));
+
+  const Rect bounds{static_cast<std::int32_t>(width), static_cast<std::int32_t>(height)};
+  frame_damage_ = damage;
+  frame_damage_.intersect(bounds);
+
+  auto &back = slot(back_);
+  auto region = frame_damage_;
+  // The back slot still holds an older frame and misses everything which
+  // changed since then.
+  const auto missing = sequence_ - back.sequence;
+  if (back.sequence == 0 || back.width != width || back.height != height ||
+      missing > damage_history_.size()) {
+    region = bounds;
+  } else {
+    for (std::size_t n = 0; n < missing; n++)
+      add_damage(region, damage_history_[n]);
+  }
+
+  back.width = width;
+  back.height = height;
+  back.stride = width * 4;
+  return Target{pixels(back_), back.stride, region};
+}
+
+void FrameExporter::end_frame() {
+  auto &back = slot(back_);
+  back.sequence = ++sequence_;
+
+  // A consumer which didn't latch the previous frame will skip it, so this
+  // one has to tell about its changes as well.
+  auto damage = frame_damage_;
+  if (header_->state.load(std::memory_order_acquire) & FrameExportHeader::fresh_bit)
+    add_damage(damage, last_published_damage_);
+  back.damage_left = damage.left();
+  back.damage_top = damage.top();
+  back.damage_right = damage.right();
+  back.damage_bottom = damage.bottom();
+
+  const auto previous = header_->state.exchange(back_ | FrameExportHeader::fresh_bit, std::memory_order_acq_rel);
+  back_ = previous & FrameExportHeader::index_mask;
+  header_->published.fetch_add(1, std::memory_order_release);
+
+  last_published_damage_ = damage;
+  damage_history_.push_front(frame_damage_);
+  if (damage_history_.size() > max_damage_history)
+    damage_history_.pop_back();
+}
+
+void FrameExporter::close() {
+  header_->closed.store(1, std::memory_order_release);
+}
+
+FrameExportReader::FrameExportReader(const Fd &fd) {
+  struct stat st;
+  if (::fstat(fd, &st) < 0)
+    throw_error("Failed to query frame export");
+  if (static_cast<std::size_t>(st.st_size) < sizeof(FrameExportHeader))
+    BOOST_THROW_EXCEPTION(std::runtime_error("Not a frame export"));
+
+  mapping_size_ = static_cast<std::size_t>(st.st_size);
+  mapping_ = ::mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (mapping_ == MAP_FAILED) {
+    mapping_ = nullptr;
+    throw_error("Failed to map frame export");
+  }
+
+  header_ = static_cast<FrameExportHeader*>(mapping_);
+  if (header_->magic != FrameExportHeader::magic_value ||
+      frame_export_size(header_->slot_size) > mapping_size_) {
+    ::munmap(mapping_, mapping_size_);
+    BOOST_THROW_EXCEPTION(std::runtime_error("Not a frame export"));
+  }
+}
+
+FrameExportReader::~FrameExportReader() {
+  ::munmap(mapping_, mapping_size_);
+}
+
+bool FrameExportReader::closed() const {
+  return header_->closed.load(std::memory_order_acquire) != 0;
+}
+
+bool FrameExportReader::latch() {
+  if (!(header_->state.load(std::memory_order_acquire) & FrameExportHeader::fresh_bit))
+    return false;
+
+  const auto front = header_->front.load(std::memory_order_relaxed);
+  const auto previous = header_->state.exchange(front, std::memory_order_acq_rel);
+  header_->front.store(previous & FrameExportHeader::index_mask, std::memory_order_relaxed);
+  return true;
+}
+
+FrameExportReader::Frame FrameExportReader::current() const {
+  const auto front = header_->front.load(std::memory_order_relaxed) & FrameExportHeader::index_mask;
+  const auto &slot = header_->slots[front];
+  return Frame{slot.sequence, slot.width, slot.height, slot.stride,
+               Rect{slot.damage_left, slot.damage_top, slot.damage_right, slot.damage_bottom},
+               static_cast<const std::uint8_t*>(mapping_) + FrameExportHeader::data_offset +
+                   front * header_->slot_size};
+}
+}
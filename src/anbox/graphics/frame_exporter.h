@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef ANBOX_GRAPHICS_FRAME_EXPORTER_H_
+#define ANBOX_GRAPHICS_FRAME_EXPORTER_H_
+
+#include "anbox/common/fd.h"
+#include "anbox/graphics/frame_export.h"
+#include "anbox/graphics/rect.h"
+
+#include <cstdint>
+#include <deque>
+
+namespace anbox::graphics {
+// Producer side of a FrameExportHeader in a sealed memfd which can be
+// passed to a consumer process. Only the pixels the back slot is missing
+// compared to the frame being published are copied into it.
+class FrameExporter {
+ public:
+  struct Target {
+    std::uint8_t *pixels;
+    std::uint32_t stride;
+    // The part of the frame which has to be written to pixels; always
+    // covers the damage passed to begin_frame().
+    Rect region;
+  };
+
+  // The memory is only committed as frames are written, so max_width and
+  // max_height can be generous. Throws std::runtime_error if the shared
+  // memory can't be set up.
+  FrameExporter(std::int32_t task, std::uint32_t max_width, std::uint32_t max_height);
+  ~FrameExporter();
+
+  FrameExporter(const FrameExporter&) = delete;
+  FrameExporter& operator=(const FrameExporter&) = delete;
+
+  Fd fd() const { return fd_; }
+
+  // Starts a frame of the given size which differs from the previous one
+  // in damage. Frames larger than the slots are cropped.
+  Target begin_frame(std::uint32_t width, std::uint32_t height, const Rect &damage);
+  // Publishes the frame started last.
+  void end_frame();
+
+  // Tells the consumer no more frames will follow.
+  void close();
+
+ private:
+  FrameExportSlot &slot(std::uint32_t index) { return header_->slots[index]; }
+  std::uint8_t *pixels(std::uint32_t index);
+
+  const std::uint64_t max_pixels_;
+  Fd fd_;
+  void *mapping_ = nullptr;
+  std::size_t mapping_size_ = 0;
+  FrameExportHeader *header_ = nullptr;
+
+  std::uint32_t back_ = 1;
+  std::uint64_t sequence_ = 0;
+  Rect frame_damage_;
+  Rect last_published_damage_;
+  // Damage of the last frames, most recent first, to find out what a
+  // slot which still holds an older frame is missing.
+  std::deque<Rect> damage_history_;
+};
+
+// Consumer side of a FrameExportHeader, e.g. for tools which record or
+// stream what the headless platform renders.
+class FrameExportReader {
+ public:
+  struct Frame {
+    std::uint64_t sequence;
+    std::uint32_t width;
+    std::uint32_t height;
+    std::uint32_t stride;
+    Rect damage;
+    const std::uint8_t *pixels;
+  };
+
+  // Throws std::runtime_error unless fd holds a frame export.
+  explicit FrameExportReader(const Fd &fd);
+  ~FrameExportReader();
+
+  FrameExportReader(const FrameExportReader&) = delete;
+  FrameExportReader& operator=(const FrameExportReader&) = delete;
+
+  std::int32_t task() const { return header_->task; }
+  bool closed() const;
+
+  // Makes the most recently published frame the current one. Returns
+  // false and keeps the current frame if there is nothing newer.
+  bool latch();
+  // The frame returned by the last successful latch(); its sequence is 0
+  // before the first one.
+  Frame current() const;
+
+ private:
+  void *mapping_ = nullptr;
+  std::size_t mapping_size_ = 0;
+  FrameExportHeader *header_ = nullptr;
+};
+}
+#endif
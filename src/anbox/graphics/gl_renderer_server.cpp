@@ -16,11 +16,14 @@
  */
 
 #include "anbox/graphics/gl_renderer_server.h"
+#include "anbox/graphics/compositor.h"
+#include "anbox/graphics/emugl/DisplayManager.h"
 #include "anbox/graphics/emugl/RenderApi.h"
 #include "anbox/graphics/emugl/RenderControl.h"
 #include "anbox/graphics/emugl/Renderer.h"
 #include "anbox/graphics/layer_composer.h"
 #include "anbox/graphics/multi_window_composer_strategy.h"
+#include "anbox/graphics/program_binary_cache.h"
 #include "anbox/graphics/single_window_composer_strategy.h"
 #include "anbox/logger.h"
 #include "anbox/wm/manager.h"
@@ -102,9 +105,28 @@ GLRendererServer::GLRendererServer(const Config &config, const std::shared_ptr<w
 
   renderer_->initialize(0);
 
+  if (!config.program_cache_dir.empty()) {
+    try {
+      renderer_->setProgramBinaryCache(
+          std::make_shared<ProgramBinaryCache>(config.program_cache_dir));
+    } catch (const std::exception &err) {
+      WARNING("Not caching GL programs: %s", err.what());
+    }
+  }
+
+  std::chrono::nanoseconds vsync_period{0};
+  if (config.refresh_rate > 0) {
+    vsync_period = std::chrono::seconds{1} / config.refresh_rate;
+    emugl::DisplayInfo::get()->set_vsync_period(vsync_period);
+  }
+  compositor_ = std::make_shared<Compositor>(composer_, vsync_period);
+
   registerRenderer(renderer_);
-  registerLayerComposer(composer_);
+  registerCompositor(compositor_);
 }
 
-GLRendererServer::~GLRendererServer() { renderer_->finalize(); }
+GLRendererServer::~GLRendererServer() {
+  compositor_->stop();
+  renderer_->finalize();
+}
 }
\ No newline at end of file
@@ -18,6 +18,7 @@
 #ifndef ANBOX_GRAPHICS_GL_RENDERER_SERVER_H_
 #define ANBOX_GRAPHICS_GL_RENDERER_SERVER_H_
 
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -32,6 +33,7 @@ namespace anbox::wm {
 }
 
 namespace anbox::graphics {
+class Compositor;
 class LayerComposer;
 class GLRendererServer {
  public:
@@ -46,6 +48,12 @@ class GLRendererServer {
     };
     Driver driver;
     bool single_window;
+    // Rate in Hz frames are presented with. Zero presents every frame as
+    // soon as the guest posted it.
+    std::uint32_t refresh_rate = 60;
+    // Directory linked guest programs are cached in across sessions. An
+    // empty path disables the cache.
+    std::string program_cache_dir;
   };
 
   GLRendererServer(const Config &config, const std::shared_ptr<wm::Manager> &wm);
@@ -57,6 +65,7 @@ class GLRendererServer {
   std::shared_ptr<Renderer> renderer_;
   std::shared_ptr<wm::Manager> wm_;
   std::shared_ptr<LayerComposer> composer_;
+  std::shared_ptr<Compositor> compositor_;
 };
 
 }
@@ -20,6 +20,8 @@
 #include "anbox/logger.h"
 #include "anbox/wm/manager.h"
 
+#include <algorithm>
+
 namespace anbox::graphics {
 LayerComposer::LayerComposer(const std::shared_ptr<Renderer> renderer, const std::shared_ptr<Strategy> &strategy)
     : renderer_(renderer), strategy_(strategy) {}
@@ -28,10 +30,72 @@ LayerComposer::~LayerComposer() {}
 
 void LayerComposer::submit_layers(const RenderableList &renderables) {
   auto win_layers = strategy_->process_layers(renderables);
+  if (!win_layers.empty())
+    renderer_->begin_frame();
+
   for (auto &w : win_layers) {
-    renderer_->draw(w.first->native_handle(),
-                    Rect{0, 0, w.first->frame().width(), w.first->frame().height()},
-                    w.second);
+    const auto native_window = w.first->native_handle();
+    const Rect frame{0, 0, w.first->frame().width(), w.first->frame().height()};
+
+    // Windows we haven't presented anything in yet or which changed their
+    // size are always drawn completely.
+    auto last = last_frames_.find(native_window);
+    bool drawn = false;
+    if (last == last_frames_.end() || last->second.window.lock() != w.first ||
+        last->second.frame != frame) {
+      drawn = renderer_->draw(native_window, frame, w.second);
+    } else {
+      const auto damage = damage_between(last->second.renderables, w.second, frame);
+      if (damage == frame)
+        drawn = renderer_->draw(native_window, frame, w.second);
+      else
+        drawn = renderer_->draw_with_damage(native_window, frame, w.second, damage);
+    }
+
+    if (drawn)
+      last_frames_[native_window] = WindowFrame{w.first, frame, w.second};
+    else
+      last_frames_.erase(native_window);
+  }
+
+  if (!win_layers.empty())
+    renderer_->end_frame();
+
+  for (auto iter = last_frames_.begin(); iter != last_frames_.end();) {
+    if (iter->second.window.expired())
+      iter = last_frames_.erase(iter);
+    else
+      ++iter;
+  }
+}
+
+Rect LayerComposer::damage_between(const RenderableList &last,
+                                   const RenderableList &next,
+                                   const Rect &bounds) {
+  // Layers are compared by their position in the stack. Whenever one
+  // differs, both the area it covered before and the one it covers now
+  // need to be redrawn.
+  Rect damage = Rect::Empty;
+  const glm::mat4 identity(1.0f);
+  const auto count = std::max(last.size(), next.size());
+  for (size_t n = 0; n < count; n++) {
+    const Renderable *before = n < last.size() ? &last[n] : nullptr;
+    const Renderable *after = n < next.size() ? &next[n] : nullptr;
+    if (before && after && *before == *after) continue;
+
+    for (const auto r : {before, after}) {
+      if (!r) continue;
+      // The screen position doesn't tell which area a transformed layer
+      // covers so we have to redraw everything.
+      if (r->transformation() != identity) return bounds;
+      if (damage.empty())
+        damage = r->screen_position();
+      else
+        damage.merge(r->screen_position());
+    }
   }
+
+  damage.intersect(bounds);
+  return damage;
 }
 }
\ No newline at end of file
@@ -46,8 +46,21 @@ class LayerComposer {
   void submit_layers(const RenderableList &renderables);
 
  private:
+  // What was last presented in a window. Used to find out which parts of
+  // the window changed with the next frame.
+  struct WindowFrame {
+    std::weak_ptr<wm::Window> window;
+    Rect frame;
+    RenderableList renderables;
+  };
+
+  static Rect damage_between(const RenderableList &last,
+                             const RenderableList &next,
+                             const Rect &bounds);
+
   std::shared_ptr<Renderer> renderer_;
   std::shared_ptr<Strategy> strategy_;
+  std::map<EGLNativeWindowType, WindowFrame> last_frames_;
 };
 }
 #endif
@@ -26,11 +26,10 @@
 #include <queue>
 
 namespace anbox::graphics {
-std::mutex OpenGlesMessageProcessor::global_lock{};
-
 OpenGlesMessageProcessor::OpenGlesMessageProcessor(
     const std::shared_ptr<Renderer> &renderer,
-    const std::shared_ptr<network::SocketMessenger> &messenger)
+    const std::shared_ptr<network::SocketMessenger> &messenger,
+    const std::string &capture_path)
     : messenger_(messenger),
       stream_(std::make_shared<BufferedIOStream>(messenger_)) {
   // We have to read the client flags first before we can continue
@@ -40,7 +39,16 @@ OpenGlesMessageProcessor::OpenGlesMessageProcessor(
       boost::asio::buffer(&client_flags, sizeof(unsigned int)));
   if (err) ERROR("%s", err.message());
 
-  render_thread_.reset(RenderThread::create(renderer, stream_.get(), std::ref(global_lock)));
+  if (!capture_path.empty()) {
+    try {
+      stream_->set_capture(std::make_unique<StreamCaptureWriter>(capture_path, client_flags));
+      INFO("Recording GL stream to %s", capture_path);
+    } catch (const std::exception &e) {
+      ERROR("%s", e.what());
+    }
+  }
+
+  render_thread_.reset(RenderThread::create(renderer, stream_.get()));
   if (!render_thread_->start())
     BOOST_THROW_EXCEPTION(
         std::runtime_error("Failed to start renderer thread"));
@@ -53,8 +61,7 @@ OpenGlesMessageProcessor::~OpenGlesMessageProcessor() {
 
 bool OpenGlesMessageProcessor::process_data(
     network::MessageBuffer &&data) {
-  auto stream = std::static_pointer_cast<BufferedIOStream>(stream_);
-  stream->post_data(std::move(data));
+  stream_->post_data(std::move(data));
   return true;
 }
 }
@@ -28,7 +28,7 @@
 #include <boost/asio.hpp>
 
 #include <memory>
-#include <mutex>
+#include <string>
 
 class IOStream;
 class RenderThread;
@@ -37,18 +37,23 @@ class Renderer;
 namespace anbox::graphics {
 class OpenGlesMessageProcessor : public network::MessageProcessor {
  public:
+  // Everything the guest sends is recorded to |capture_path| unless it
+  // is empty.
   OpenGlesMessageProcessor(
       const std::shared_ptr<Renderer> &renderer,
-      const std::shared_ptr<network::SocketMessenger> &messenger);
+      const std::shared_ptr<network::SocketMessenger> &messenger,
+      const std::string &capture_path = "");
   ~OpenGlesMessageProcessor();
 
   bool process_data(network::MessageBuffer &&data) override;
 
- private:
-  static std::mutex global_lock;
+  // The stream the render thread decodes from. OpenGlesSocketConnection
+  // receives into it directly rather than going through process_data().
+  std::shared_ptr<BufferedIOStream> stream() const { return stream_; }
 
+ private:
   std::shared_ptr<network::SocketMessenger> messenger_;
-  std::shared_ptr<IOStream> stream_;
+  std::shared_ptr<BufferedIOStream> stream_;
   std::shared_ptr<RenderThread> render_thread_;
 };
 }
@@ -41,32 +41,38 @@ OpenGlesSocketConnection::OpenGlesSocketConnection(
       std::shared_ptr<network::MessageReceiver> const& message_receiver,
       std::shared_ptr<network::MessageSender> const& message_sender, int id,
       std::shared_ptr<network::Connections<network::SocketConnection>> const& connections,
-      std::shared_ptr<network::MessageProcessor> const& processor):
+      std::shared_ptr<OpenGlesMessageProcessor> const& processor):
       SocketConnection(message_receiver,
                       message_sender, id,
-                      connections, processor) {}
+                      connections, processor),
+      stream_(processor->stream()) {}
 
 void OpenGlesSocketConnection::read_next_message() {
-  auto callback = std::bind(&OpenGlesSocketConnection::on_read_size, this, std::placeholders::_1, std::placeholders::_2);
-  message_receiver_->async_receive_msg(callback, ba::buffer(buffer_));
+  // Receive straight into the free space of the stream's ring buffer which
+  // the render thread then decodes in place.
+  size_t available = 0;
+  auto data = stream_->prepare_receive(&available);
+  if (!data) {
+    connections_->remove(id());
+    return;
+  }
+
+  message_receiver_->async_receive_msg(
+      [this](const boost::system::error_code& error, std::size_t bytes_read) {
+        on_read_size(error, bytes_read);
+      },
+      ba::buffer(data, available));
 }
 
 void OpenGlesSocketConnection::on_read_size(const boost::system::error_code& error, std::size_t bytes_read) {
+  stream_->commit_receive(error ? 0 : bytes_read);
+
   if (error) {
     connections_->remove(id());
     return;
   }
 
-  Buffer data{};
-  data.resize_noinit(bytes_read);
-
-  // Use memcpy here, its faster then std::copy
-  memcpy(data.data(), buffer_.data(), bytes_read);
-
-  if (processor_->process_data(std::move(data)))
-    read_next_message();
-  else
-      connections_->remove(id());
+  read_next_message();
 }
 }  // namespace anbox
 }  // namespace graphics
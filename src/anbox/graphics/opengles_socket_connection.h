@@ -38,11 +38,13 @@ public:
       std::shared_ptr<network::MessageReceiver> const& message_receiver,
       std::shared_ptr<network::MessageSender> const& message_sender, int id,
       std::shared_ptr<network::Connections<network::SocketConnection>> const& connections,
-      std::shared_ptr<network::MessageProcessor> const& processor);
+      std::shared_ptr<OpenGlesMessageProcessor> const& processor);
   void read_next_message() override;
 private:
   void on_read_size(const boost::system::error_code& ec,
                         std::size_t bytes_read) override;
+
+  std::shared_ptr<BufferedIOStream> stream_;
 };
 }  // namespace anbox
 }  // namespace graphics
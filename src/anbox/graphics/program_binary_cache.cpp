@@ -0,0 +1,268 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "anbox/graphics/program_binary_cache.h"
+#include "anbox/logger.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <stdexcept>
+#include <tuple>
+
+#include <boost/throw_exception.hpp>
+
+namespace fs = boost::filesystem;
+
+namespace {
+constexpr std::uint32_t entry_magic{0x43425041};  // 'APBC'
+constexpr std::size_t entry_name_length{16};
+
+struct EntryHeader {
+  std::uint32_t magic;
+  std::uint32_t version;
+  std::uint32_t format;
+  std::uint32_t reserved;
+  std::uint64_t key_size;
+  std::uint64_t data_size;
+};
+
+// FNV-1a, which unlike std::hash is guaranteed to give the same names
+// across builds.
+std::string entry_name(const std::string &key) {
+  std::uint64_t hash = 0xcbf29ce484222325ULL;
+  for (const auto c : key) {
+    hash ^= static_cast<std::uint8_t>(c);
+    hash *= 0x100000001b3ULL;
+  }
+  char name[entry_name_length + 1];
+  snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(hash));
+  return name;
+}
+
+bool is_entry_name(const std::string &name) {
+  return name.size() == entry_name_length &&
+         std::all_of(name.begin(), name.end(), [](char c) { return std::isxdigit(c); });
+}
+}
+
+namespace anbox::graphics {
+constexpr std::uint32_t ProgramBinaryCache::version;
+constexpr std::uint64_t ProgramBinaryCache::default_max_size;
+
+ProgramBinaryCache::ProgramBinaryCache(const fs::path &path, std::uint64_t max_size)
+    : dir_{path / ("v" + std::to_string(version))}, max_size_{max_size} {
+  boost::system::error_code err;
+  fs::create_directories(dir_, err);
+  if (err)
+    BOOST_THROW_EXCEPTION(std::runtime_error("Failed to create program cache directory " +
+                                             dir_.string() + ": " + err.message()));
+
+  // Binaries written by other versions of the cache are never read again.
+  for (fs::directory_iterator it{path, err}, end; !err && it != end; it.increment(err)) {
+    if (it->path() != dir_ && it->path().filename().string()[0] == 'v' &&
+        fs::is_directory(it->path()))
+      fs::remove_all(it->path(), err);
+  }
+
+  scan();
+}
+
+ProgramBinaryCache::~ProgramBinaryCache() {
+  const auto stats = statistics();
+  DEBUG("Program cache: %d hits, %d misses, %d stores, %d rejects, %d evictions, %d entries (%d bytes)",
+        stats.hits, stats.misses, stats.stores, stats.rejects, stats.evictions,
+        stats.entries, stats.size);
+}
+
+fs::path ProgramBinaryCache::path_for(const std::string &name) const {
+  return dir_ / name;
+}
+
+void ProgramBinaryCache::scan() {
+  // Last use is kept in the modification time of the entries so the
+  // eviction order survives restarts.
+  std::vector<std::tuple<std::time_t, std::string, std::uint64_t>> found;
+  boost::system::error_code err;
+  for (fs::directory_iterator it{dir_, err}, end; !err && it != end; it.increment(err)) {
+    const auto name = it->path().filename().string();
+    if (!is_entry_name(name)) {
+      // Leftovers of stores which didn't finish.
+      fs::remove(it->path(), err);
+      continue;
+    }
+    boost::system::error_code entry_err;
+    const auto size = fs::file_size(it->path(), entry_err);
+    const auto mtime = fs::last_write_time(it->path(), entry_err);
+    if (!entry_err)
+      found.emplace_back(mtime, name, size);
+  }
+
+  std::sort(found.begin(), found.end(), [](const auto &a, const auto &b) {
+    return std::get<0>(a) > std::get<0>(b);
+  });
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto &f : found) {
+    lru_.push_back(std::get<1>(f));
+    entries_[std::get<1>(f)] = Entry{std::get<2>(f), std::prev(lru_.end())};
+    stats_.size += std::get<2>(f);
+  }
+  evict_locked();
+}
+
+bool ProgramBinaryCache::load(const std::string &key, Binary &binary) {
+  const auto name = entry_name(key);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (entries_.find(name) == entries_.end()) {
+      stats_.misses++;
+      return false;
+    }
+  }
+
+  const auto path = path_for(name);
+  boost::system::error_code size_err;
+  const auto file_size = fs::file_size(path, size_err);
+  std::ifstream in(path.string(), std::ios::binary);
+  EntryHeader header;
+  // The sizes come from disk, only trust them if they add up to the size
+  // of the file.
+  bool valid = !size_err && file_size >= sizeof(header) &&
+               in.read(reinterpret_cast<char*>(&header), sizeof(header)) &&
+               header.magic == entry_magic && header.version == version &&
+               header.key_size <= file_size - sizeof(header) &&
+               header.data_size == file_size - sizeof(header) - header.key_size;
+  std::string stored_key;
+  Binary stored;
+  if (valid && header.key_size == key.size()) {
+    stored_key.resize(header.key_size);
+    stored.format = header.format;
+    stored.data.resize(header.data_size);
+    valid = in.read(&stored_key[0], stored_key.size()) &&
+            in.read(reinterpret_cast<char*>(stored.data.data()), stored.data.size());
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!valid) {
+    WARNING("Removing corrupt program binary %s", path.string());
+    stats_.misses++;
+    stats_.rejects++;
+    remove_locked(name);
+    return false;
+  }
+
+  // Another program which happens to have the same name; leave it alone.
+  if (stored_key != key) {
+    stats_.misses++;
+    return false;
+  }
+
+  stats_.hits++;
+  binary = std::move(stored);
+
+  auto entry = entries_.find(name);
+  if (entry != entries_.end())
+    lru_.splice(lru_.begin(), lru_, entry->second.lru);
+  boost::system::error_code err;
+  fs::last_write_time(path, std::time(nullptr), err);
+  return true;
+}
+
+void ProgramBinaryCache::store(const std::string &key, const Binary &binary) {
+  const auto size = sizeof(EntryHeader) + key.size() + binary.data.size();
+  if (size > max_size_)
+    return;
+
+  const auto name = entry_name(key);
+  // Write to a temporary file first so a concurrent load() or a crash
+  // never sees a partial entry.
+  boost::system::error_code err;
+  const auto tmp_path = fs::unique_path(dir_ / "%%%%%%%%.tmp", err);
+  if (err)
+    return;
+
+  {
+    std::ofstream out(tmp_path.string(), std::ios::binary | std::ios::trunc);
+    const EntryHeader header{entry_magic, version, binary.format, 0, key.size(), binary.data.size()};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(key.data(), key.size());
+    out.write(reinterpret_cast<const char*>(binary.data.data()), binary.data.size());
+    if (!out.flush()) {
+      WARNING("Failed to write program binary to %s", tmp_path.string());
+      out.close();
+      fs::remove(tmp_path, err);
+      return;
+    }
+  }
+
+  fs::rename(tmp_path, path_for(name), err);
+  if (err) {
+    fs::remove(tmp_path, err);
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto entry = entries_.find(name);
+  if (entry != entries_.end()) {
+    stats_.size -= entry->second.size;
+    entry->second.size = size;
+    lru_.splice(lru_.begin(), lru_, entry->second.lru);
+  } else {
+    lru_.push_front(name);
+    entries_[name] = Entry{size, lru_.begin()};
+  }
+  stats_.size += size;
+  stats_.stores++;
+  evict_locked();
+}
+
+void ProgramBinaryCache::reject(const std::string &key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_.rejects++;
+  remove_locked(entry_name(key));
+}
+
+ProgramBinaryCache::Statistics ProgramBinaryCache::statistics() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto stats = stats_;
+  stats.entries = entries_.size();
+  return stats;
+}
+
+void ProgramBinaryCache::remove_locked(const std::string &name) {
+  auto entry = entries_.find(name);
+  if (entry == entries_.end())
+    return;
+
+  boost::system::error_code err;
+  fs::remove(path_for(name), err);
+  stats_.size -= entry->second.size;
+  lru_.erase(entry->second.lru);
+  entries_.erase(entry);
+}
+
+void ProgramBinaryCache::evict_locked() {
+  while (stats_.size > max_size_ && !lru_.empty()) {
+    remove_locked(lru_.back());
+    stats_.evictions++;
+  }
+}
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef ANBOX_GRAPHICS_PROGRAM_BINARY_CACHE_H_
+#define ANBOX_GRAPHICS_PROGRAM_BINARY_CACHE_H_
+
+#include <boost/filesystem.hpp>
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace anbox::graphics {
+// On-disk cache of linked GL program binaries which survives container and
+// session restarts. Entries are looked up by a key describing everything
+// the link result depends on (shader sources, attribute bindings and the
+// host driver); the full key is stored with each entry so a hash collision
+// never hands out the wrong program. Once the cache grows beyond its size
+// limit the least recently used entries are removed.
+class ProgramBinaryCache {
+ public:
+  struct Binary {
+    std::uint32_t format = 0;
+    std::vector<std::uint8_t> data;
+  };
+
+  struct Statistics {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t stores = 0;
+    // Entries the driver refused to load, e.g. after a driver update
+    // which didn't change its version string.
+    std::uint64_t rejects = 0;
+    std::uint64_t evictions = 0;
+    std::size_t entries = 0;
+    std::uint64_t size = 0;
+  };
+
+  // Bumped whenever the layout of the entry files changes. Entries written
+  // with other versions are removed when the cache is opened.
+  static constexpr std::uint32_t version{1};
+  static constexpr std::uint64_t default_max_size{64 * 1024 * 1024};
+
+  // Throws std::runtime_error if |path| can't be created.
+  explicit ProgramBinaryCache(const boost::filesystem::path &path,
+                              std::uint64_t max_size = default_max_size);
+  ~ProgramBinaryCache();
+
+  ProgramBinaryCache(const ProgramBinaryCache&) = delete;
+  ProgramBinaryCache& operator=(const ProgramBinaryCache&) = delete;
+
+  // Returns false and leaves |binary| untouched on a miss.
+  bool load(const std::string &key, Binary &binary);
+  void store(const std::string &key, const Binary &binary);
+  // Removes an entry load() returned but the driver failed to link.
+  void reject(const std::string &key);
+
+  Statistics statistics() const;
+
+ private:
+  struct Entry {
+    std::uint64_t size;
+    std::list<std::string>::iterator lru;
+  };
+
+  boost::filesystem::path path_for(const std::string &name) const;
+  void scan();
+  void remove_locked(const std::string &name);
+  void evict_locked();
+
+  const boost::filesystem::path dir_;
+  const std::uint64_t max_size_;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, Entry> entries_;
+  // Entry names, most recently used first.
+  std::list<std::string> lru_;
+  Statistics stats_;
+};
+}
+
+#endif
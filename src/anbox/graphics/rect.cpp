@@ -34,6 +34,19 @@ void Rect::merge(const Rect &rhs) {
   bottom_ = std::max(bottom_, rhs.bottom());
 }
 
+void Rect::intersect(const Rect &rhs) {
+  left_ = std::max(left_, rhs.left());
+  top_ = std::max(top_, rhs.top());
+  right_ = std::min(right_, rhs.right());
+  bottom_ = std::min(bottom_, rhs.bottom());
+  if (empty()) clear();
+}
+
+bool Rect::intersects(const Rect &rhs) const {
+  return left_ < rhs.right() && rhs.left() < right_ &&
+         top_ < rhs.bottom() && rhs.top() < bottom_;
+}
+
 void Rect::translate(const std::int32_t &x, const std::int32_t &y) {
   auto old_width = width();
   auto old_height = height();
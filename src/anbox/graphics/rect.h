@@ -41,6 +41,8 @@ class Rect {
 
   inline bool valid() const { return width() >= 0 && height() >= 0; }
 
+  inline bool empty() const { return width() <= 0 || height() <= 0; }
+
   inline std::int32_t width() const { return right_ - left_; }
 
   inline std::int32_t height() const { return bottom_ - top_; }
@@ -62,6 +64,10 @@ class Rect {
 
   void merge(const Rect &rhs);
 
+  void intersect(const Rect &rhs);
+
+  bool intersects(const Rect &rhs) const;
+
   void translate(const std::int32_t &x, const std::int32_t &y);
 
   void resize(const std::int32_t &width, const std::int32_t &height);
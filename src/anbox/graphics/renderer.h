@@ -30,6 +30,22 @@ class Renderer {
   virtual bool draw(EGLNativeWindowType native_window,
                     const anbox::graphics::Rect& window_frame,
                     const RenderableList& renderables) = 0;
+
+  // Like draw() but only |damage| of the window changed since the last
+  // frame. Renderers which can't restrict drawing to parts of the window
+  // redraw it completely.
+  virtual bool draw_with_damage(EGLNativeWindowType native_window,
+                                const anbox::graphics::Rect& window_frame,
+                                const RenderableList& renderables,
+                                const anbox::graphics::Rect& /* damage */) {
+    return draw(native_window, window_frame, renderables);
+  }
+
+  // Bracket the draws of all windows which make up one frame. Renderers
+  // can keep their context bound between them instead of binding and
+  // releasing it for every window.
+  virtual void begin_frame() {}
+  virtual void end_frame() {}
 };
 }
 #endif
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "anbox/graphics/stream_capture.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+constexpr char magic[8] = {'A', 'N', 'B', 'X', 'G', 'L', 'C', '1'};
+// Captures are written from the thread receiving guest data, keep the
+// number of writes to the file low.
+constexpr std::size_t file_buffer_size{1024 * 1024};
+
+struct Header {
+  char magic[8];
+  std::uint32_t client_flags;
+  std::uint32_t reserved;
+};
+
+struct RecordHeader {
+  std::uint64_t timestamp_ns;
+  std::uint32_t size;
+} __attribute__((packed));
+}
+
+namespace anbox::graphics {
+StreamCaptureWriter::StreamCaptureWriter(const std::string &path,
+                                         std::uint32_t client_flags)
+    : file_(std::fopen(path.c_str(), "wb")), file_buffer_(file_buffer_size) {
+  if (!file_)
+    BOOST_THROW_EXCEPTION(std::runtime_error("Failed to create capture " + path +
+                                             ": " + std::strerror(errno)));
+
+  std::setvbuf(file_, file_buffer_.data(), _IOFBF, file_buffer_.size());
+
+  Header header{};
+  std::memcpy(header.magic, magic, sizeof(magic));
+  header.client_flags = client_flags;
+  std::fwrite(&header, sizeof(header), 1, file_);
+}
+
+StreamCaptureWriter::~StreamCaptureWriter() {
+  std::fclose(file_);
+}
+
+void StreamCaptureWriter::append(const void *data, std::size_t size) {
+  const auto now = std::chrono::steady_clock::now().time_since_epoch();
+  const RecordHeader record{
+      static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count()),
+      static_cast<std::uint32_t>(size)};
+  std::fwrite(&record, sizeof(record), 1, file_);
+  std::fwrite(data, 1, size, file_);
+}
+
+StreamCapture StreamCapture::load(const std::string &path) {
+  auto file = std::fopen(path.c_str(), "rb");
+  if (!file)
+    BOOST_THROW_EXCEPTION(std::runtime_error("Failed to open capture " + path +
+                                             ": " + std::strerror(errno)));
+
+  StreamCapture capture;
+  capture.path_ = path;
+
+  Header header;
+  if (std::fread(&header, sizeof(header), 1, file) != 1 ||
+      std::memcmp(header.magic, magic, sizeof(magic)) != 0) {
+    std::fclose(file);
+    BOOST_THROW_EXCEPTION(std::runtime_error(path + " is not a GL stream capture"));
+  }
+  capture.client_flags_ = header.client_flags;
+
+  RecordHeader record;
+  while (std::fread(&record, sizeof(record), 1, file) == 1) {
+    const auto offset = capture.data_.size();
+    capture.data_.resize(offset + record.size);
+    // The session may have been killed while writing the last record.
+    const auto size = std::fread(capture.data_.data() + offset, 1, record.size, file);
+    capture.data_.resize(offset + size);
+    if (size > 0)
+      capture.chunks_.push_back({record.timestamp_ns, offset, size});
+    if (size < record.size) break;
+  }
+
+  std::fclose(file);
+  return capture;
+}
+}
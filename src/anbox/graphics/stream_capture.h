@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef ANBOX_GRAPHICS_STREAM_CAPTURE_H_
+#define ANBOX_GRAPHICS_STREAM_CAPTURE_H_
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace anbox::graphics {
+// Captures hold the raw bytes a guest sent over one opengles pipe
+// connection so they can be replayed without a guest. A capture starts
+// with a header followed by one record per chunk of bytes in the order
+// they were received:
+//
+//   header: "ANBXGLC1", uint32 client flags, uint32 reserved
+//   record: uint64 steady clock time in ns, uint32 size, |size| bytes
+//
+// All integers are stored in host byte order. The timestamps of all
+// captures of a session share the same clock so the connections can be
+// interleaved again on replay.
+class StreamCaptureWriter {
+ public:
+  // Throws std::runtime_error if |path| can't be created.
+  StreamCaptureWriter(const std::string &path, std::uint32_t client_flags);
+  ~StreamCaptureWriter();
+
+  StreamCaptureWriter(const StreamCaptureWriter&) = delete;
+  StreamCaptureWriter& operator=(const StreamCaptureWriter&) = delete;
+
+  // Records |size| bytes received just now. Must not be called
+  // concurrently.
+  void append(const void *data, std::size_t size);
+
+ private:
+  std::FILE *file_;
+  std::vector<char> file_buffer_;
+};
+
+class StreamCapture {
+ public:
+  struct Chunk {
+    std::uint64_t timestamp_ns;
+    std::size_t offset;
+    std::size_t size;
+  };
+
+  // Reads the whole capture at |path| into memory. Throws
+  // std::runtime_error if it can't be read or isn't a capture.
+  static StreamCapture load(const std::string &path);
+
+  const std::string &path() const { return path_; }
+  std::uint32_t client_flags() const { return client_flags_; }
+  // All received bytes back to back. |chunks| refer into it.
+  const std::vector<std::uint8_t> &data() const { return data_; }
+  const std::vector<Chunk> &chunks() const { return chunks_; }
+
+ private:
+  std::string path_;
+  std::uint32_t client_flags_ = 0;
+  std::vector<std::uint8_t> data_;
+  std::vector<Chunk> chunks_;
+};
+}
+
+#endif
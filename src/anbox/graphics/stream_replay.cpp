@@ -0,0 +1,234 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "anbox/graphics/stream_replay.h"
+#include "anbox/graphics/emugl/RenderThread.h"
+#include "anbox/logger.h"
+
+#include "external/android-emugl/host/include/libOpenglRender/IOStream.h"
+
+// Generated with emugl at build time
+#include "renderControl_opcodes.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+// Every packet starts with its opcode and its size including this header.
+constexpr std::size_t packet_header_size{8};
+constexpr std::size_t default_reply_size{4096};
+
+std::uint32_t read_u32(const std::uint8_t *data) {
+  std::uint32_t value;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+bool ends_frame(std::uint32_t opcode) {
+  return opcode == OP_rcPostAllLayersDone || opcode == OP_rcFBPost;
+}
+}
+
+namespace anbox::graphics {
+struct StreamReplay::Schedule {
+  struct Entry {
+    std::size_t stream;
+    // Amount of data of |stream| which is available once the chunk of
+    // this entry was received.
+    std::size_t end;
+  };
+
+  bool finished() const { return position >= entries.size(); }
+
+  std::vector<Entry> entries;
+  std::mutex mutex;
+  std::condition_variable turn_changed;
+  // The stream of the current entry is the only one decoding.
+  std::size_t position = 0;
+  // Streams which don't decode anymore, their data is skipped.
+  std::vector<bool> stopped;
+  std::vector<Clock::time_point> frames;
+};
+
+class StreamReplay::Stream : public IOStream {
+ public:
+  Stream(std::size_t index, const StreamCapture &capture, Schedule &schedule)
+      : IOStream(default_reply_size),
+        index_(index),
+        capture_(capture),
+        schedule_(schedule) {}
+
+  // Replies are dropped.
+  void *allocBuffer(size_t min_size) override {
+    if (reply_.size() < min_size) reply_.resize(min_size);
+    return reply_.data();
+  }
+  size_t commitBuffer(size_t size) override { return size; }
+
+  const unsigned char *read(void *, size_t *) override { return nullptr; }
+
+  void forceStop() override {
+    std::lock_guard<std::mutex> l(schedule_.mutex);
+    schedule_.stopped[index_] = true;
+    schedule_.turn_changed.notify_all();
+  }
+
+  bool canReadInPlace() const override { return true; }
+
+  unsigned char *readInPlace(size_t pending, size_t *out_len) override {
+    std::unique_lock<std::mutex> l(schedule_.mutex);
+    while (!schedule_.stopped[index_] && !schedule_.finished()) {
+      const auto &entry = schedule_.entries[schedule_.position];
+      if (entry.stream != index_ && !schedule_.stopped[entry.stream]) {
+        schedule_.turn_changed.wait(l);
+        continue;
+      }
+
+      const auto end = entry.stream == index_ ? next_packet_end(pending, entry.end) : 0;
+      if (end > 0) {
+        *out_len = end - read_pos_;
+        start_ = Clock::now();
+        return const_cast<unsigned char *>(capture_.data().data()) + read_pos_;
+      }
+
+      // Everything received so far is decoded (or the stream it was
+      // received on is gone), continue with whatever was received next.
+      schedule_.position++;
+      schedule_.turn_changed.notify_all();
+    }
+    return nullptr;
+  }
+
+  void consume(size_t len) override {
+    const auto now = Clock::now();
+    if (len == 0) return;
+
+    const auto opcode = read_u32(capture_.data().data() + read_pos_);
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - start_);
+    result_.opcode_ns[opcode].push_back(static_cast<std::uint32_t>(
+        std::min<std::chrono::nanoseconds::rep>(elapsed.count(), UINT32_MAX)));
+    result_.decode_time += elapsed;
+    result_.packets++;
+    result_.bytes += len;
+    read_pos_ += len;
+
+    if (ends_frame(opcode)) {
+      std::lock_guard<std::mutex> l(schedule_.mutex);
+      schedule_.frames.push_back(now);
+    }
+  }
+
+  const Result &result() const { return result_; }
+
+ private:
+  // Returns where the first complete packet after the |pending| bytes the
+  // decoders couldn't handle yet ends or 0 if it wasn't received yet.
+  std::size_t next_packet_end(std::size_t pending, std::size_t received) {
+    const auto data = capture_.data().data();
+    auto end = read_pos_;
+    while (end - read_pos_ <= pending) {
+      if (received - end < packet_header_size) return 0;
+
+      const auto size = read_u32(data + end + 4);
+      if (size < packet_header_size) {
+        ERROR("Invalid packet in %s at offset %d", capture_.path(), end);
+        schedule_.stopped[index_] = true;
+        return 0;
+      }
+      if (received - end < size) return 0;
+      end += size;
+    }
+    return end;
+  }
+
+  const std::size_t index_;
+  const StreamCapture &capture_;
+  Schedule &schedule_;
+  std::vector<std::uint8_t> reply_;
+  std::size_t read_pos_ = 0;
+  Clock::time_point start_;
+  Result result_;
+};
+
+StreamReplay::StreamReplay(std::vector<StreamCapture> captures)
+    : captures_(std::move(captures)) {}
+
+StreamReplay::~StreamReplay() {}
+
+StreamReplay::Result StreamReplay::run(const std::shared_ptr<::Renderer> &renderer) {
+  Schedule schedule;
+  std::vector<std::uint64_t> timestamps;
+  for (std::size_t n = 0; n < captures_.size(); n++) {
+    for (const auto &chunk : captures_[n].chunks()) {
+      schedule.entries.push_back({n, chunk.offset + chunk.size});
+      timestamps.push_back(chunk.timestamp_ns);
+    }
+  }
+
+  std::vector<std::size_t> order(schedule.entries.size());
+  for (std::size_t n = 0; n < order.size(); n++) order[n] = n;
+  std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+    return timestamps[a] < timestamps[b];
+  });
+  std::vector<Schedule::Entry> entries;
+  for (const auto n : order) entries.push_back(schedule.entries[n]);
+  schedule.entries.swap(entries);
+  schedule.stopped.resize(captures_.size(), false);
+
+  std::vector<std::unique_ptr<Stream>> streams;
+  std::vector<std::unique_ptr<RenderThread>> threads;
+  for (std::size_t n = 0; n < captures_.size(); n++) {
+    streams.push_back(std::make_unique<Stream>(n, captures_[n], schedule));
+    threads.emplace_back(RenderThread::create(renderer, streams.back().get()));
+  }
+
+  const auto start = Clock::now();
+  for (auto &t : threads) t->start();
+  for (auto &t : threads) t->wait(nullptr);
+  const auto stop = Clock::now();
+  threads.clear();
+
+  Result result;
+  result.wall_time = std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start);
+  if (!timestamps.empty()) {
+    const auto range = std::minmax_element(timestamps.begin(), timestamps.end());
+    result.captured_time = std::chrono::nanoseconds(*range.second - *range.first);
+  }
+
+  for (const auto &stream : streams) {
+    const auto &r = stream->result();
+    result.bytes += r.bytes;
+    result.packets += r.packets;
+    result.decode_time += r.decode_time;
+    for (const auto &op : r.opcode_ns) {
+      auto &ns = result.opcode_ns[op.first];
+      ns.insert(ns.end(), op.second.begin(), op.second.end());
+    }
+  }
+
+  for (std::size_t n = 1; n < schedule.frames.size(); n++)
+    result.frame_times.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        schedule.frames[n] - schedule.frames[n - 1]));
+
+  return result;
+}
+}
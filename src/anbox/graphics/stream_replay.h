@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef ANBOX_GRAPHICS_STREAM_REPLAY_H_
+#define ANBOX_GRAPHICS_STREAM_REPLAY_H_
+
+#include "anbox/graphics/stream_capture.h"
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+class Renderer;
+
+namespace anbox::graphics {
+// Feeds captured opengles streams through the emugl decoders again. Every
+// capture gets a render thread of its own like its connection had, but
+// only one of them decodes at a time: chunks are handed out in the order
+// they were received across all captures so objects one connection
+// creates exist before another one uses them, e.g. color buffers
+// allocated by gralloc and composed by SurfaceFlinger.
+//
+// Packets are handed to the decoders one by one which allows to time each
+// of them without touching the decoders.
+class StreamReplay {
+ public:
+  struct Result {
+    std::size_t bytes = 0;
+    std::size_t packets = 0;
+    // Time spent in the decoders, the whole replay and the session the
+    // captures were recorded in.
+    std::chrono::nanoseconds decode_time{0};
+    std::chrono::nanoseconds wall_time{0};
+    std::chrono::nanoseconds captured_time{0};
+    // Decode time of every packet, by opcode.
+    std::map<std::uint32_t, std::vector<std::uint32_t>> opcode_ns;
+    // Time between two frames posted by the guest.
+    std::vector<std::chrono::nanoseconds> frame_times;
+  };
+
+  explicit StreamReplay(std::vector<StreamCapture> captures);
+  ~StreamReplay();
+
+  // Replays all captures against |renderer|. Without a renderer render
+  // control calls are dropped and GLES calls go to whatever context is
+  // current, which still measures the decoders.
+  Result run(const std::shared_ptr<::Renderer> &renderer);
+
+ private:
+  class Stream;
+  struct Schedule;
+
+  std::vector<StreamCapture> captures_;
+};
+}
+
+#endif
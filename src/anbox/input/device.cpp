@@ -18,9 +18,8 @@
 #include "anbox/input/device.h"
 #include "anbox/logger.h"
 #include "anbox/network/delegate_connection_creator.h"
-#include "anbox/network/delegate_message_processor.h"
-#include "anbox/network/local_socket_messenger.h"
-#include "anbox/qemu/null_message_processor.h"
+
+#include <algorithm>
 
 #include <time.h>
 
@@ -44,49 +43,169 @@ std::shared_ptr<Device> Device::create(
   return sp;
 }
 
-Device::Device()
-    : next_connection_id_(0),
-      connections_(
-          std::make_shared<network::Connections<network::SocketConnection>>()) {
+Device::Device() : latency_probe_("input device") {
   ::memset(&info_, 0, sizeof(info_));
+  queued_.reserve(max_queued_events);
+  sending_.reserve(max_queued_events);
 }
 
 Device::~Device() {}
 
 void Device::send_events(const std::vector<Event> &events) {
-  struct CompatEvent {
-    // NOTE: A bit dirty but as we're running currently a 64 bit container
-    // struct input_event has a different size. We rebuild the struct here
-    // to reach the correct size.
-    std::uint64_t sec;
-    std::uint64_t usec;
-    std::uint16_t type;
-    std::uint16_t code;
-    std::uint32_t value;
-  };
+  queue_events(events);
+  flush();
+}
 
+void Device::queue_events(const std::vector<Event> &events) {
   struct timespec spec;
   clock_gettime(CLOCK_MONOTONIC, &spec);
 
-  auto data = new CompatEvent[events.size()];
-  int n = 0;
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (queued_.size() + events.size() > max_queued_events) {
+    if (!dropping_)
+      WARNING("Clients of input device %s don't keep up, dropping events", info_.name);
+    dropping_ = true;
+    return;
+  }
+
   for (const auto &event : events) {
-    data[n].sec = spec.tv_sec;
-    data[n].usec = spec.tv_nsec / 1000;
-    data[n].type = event.type;
-    data[n].code = event.code;
-    data[n].value = event.value;
-    n++;
+    queued_.push_back({static_cast<std::uint64_t>(spec.tv_sec),
+                       static_cast<std::uint64_t>(spec.tv_nsec / 1000),
+                       event.type, event.code, static_cast<std::uint32_t>(event.value)});
+    if (event.type == EV_SYN && event.code == SYN_REPORT)
+      merge_last_report();
   }
+}
+
+void Device::merge_last_report() {
+  const auto end = queued_.size();
+  const auto is_motion = [](const CompatEvent &event) {
+    return event.type == EV_REL || (event.type == EV_ABS && event.code != ABS_MT_TRACKING_ID);
+  };
 
-  for (unsigned n = 0; n < connections_->size(); n++) {
-    connections_->at(n)->send(reinterpret_cast<const char *>(data),
-                              events.size() * sizeof(struct CompatEvent));
+  // Anything else than motion, like buttons or fingers going up or down,
+  // is never merged so no transition gets lost.
+  if (end - 1 == report_start_ ||
+      !std::all_of(queued_.begin() + report_start_, queued_.begin() + end - 1, is_motion)) {
+    have_previous_report_ = false;
+    report_start_ = end;
+    return;
   }
+
+  const auto merge = [&](bool apply) {
+    // Multitouch axes belong to the slot selected last.
+    auto axes_start = previous_report_start_;
+    for (auto n = previous_report_start_; n < report_start_ - 1; n++) {
+      if (queued_[n].type == EV_ABS && queued_[n].code == ABS_MT_SLOT)
+        axes_start = n;
+    }
+    const bool have_slot = queued_[axes_start].type == EV_ABS && queued_[axes_start].code == ABS_MT_SLOT;
+
+    for (auto n = report_start_; n < end - 1; n++) {
+      const auto &event = queued_[n];
+      if (event.type == EV_ABS && event.code == ABS_MT_SLOT) {
+        if (!have_slot || queued_[axes_start].value != event.value)
+          return false;
+        continue;
+      }
+
+      auto target = std::find_if(queued_.begin() + axes_start, queued_.begin() + report_start_ - 1,
+                                 [&](const CompatEvent &e) { return e.type == event.type && e.code == event.code; });
+      if (target == queued_.begin() + report_start_ - 1)
+        return false;
+      if (!apply)
+        continue;
+      // Absolute axes take the latest value, relative ones add up.
+      if (event.type == EV_ABS)
+        target->value = event.value;
+      else
+        target->value += event.value;
+    }
+
+    if (apply) {
+      for (auto n = previous_report_start_; n < report_start_; n++) {
+        queued_[n].sec = queued_[end - 1].sec;
+        queued_[n].usec = queued_[end - 1].usec;
+      }
+    }
+    return true;
+  };
+
+  if (have_previous_report_ && merge(false)) {
+    merge(true);
+    queued_.resize(report_start_);
+    return;
+  }
+
+  previous_report_start_ = report_start_;
+  have_previous_report_ = true;
+  report_start_ = end;
+}
+
+void Device::flush() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  start_send();
+}
+
+void Device::start_send() {
+  if (writes_in_flight_ > 0 || queued_.empty())
+    return;
+
+  // Like the kernel we don't keep events around for clients which
+  // connect later.
+  if (!clients_.empty()) {
+    std::swap(queued_, sending_);
+    writes_in_flight_ = clients_.size();
+
+    const auto self = shared_from_this();
+    const auto buffer = boost::asio::buffer(sending_.data(), sending_.size() * sizeof(CompatEvent));
+    for (const auto &client : clients_) {
+      boost::asio::async_write(*client, buffer, [self, client](const boost::system::error_code &err, std::size_t) {
+        self->on_sent(client, err);
+      });
+    }
+  }
+
+  queued_.clear();
+  report_start_ = 0;
+  have_previous_report_ = false;
+  dropping_ = false;
+}
+
+void Device::on_sent(const std::shared_ptr<Socket> &socket, const boost::system::error_code &err) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (err) {
+    DEBUG("Lost client of input device %s: %s", info_.name, err.message());
+    clients_.erase(std::remove(clients_.begin(), clients_.end(), socket), clients_.end());
+  }
+
+  if (--writes_in_flight_ > 0)
+    return;
+
+  struct timespec spec;
+  clock_gettime(CLOCK_MONOTONIC, &spec);
+  const auto now = std::chrono::seconds(spec.tv_sec) + std::chrono::nanoseconds(spec.tv_nsec);
+  for (std::size_t n = 0; n < sending_.size(); n++) {
+    const auto &event = sending_[n];
+    if (n + 1 < sending_.size() && !(event.type == EV_SYN && event.code == SYN_REPORT))
+      continue;
+    const auto queued = std::chrono::seconds(event.sec) + std::chrono::microseconds(event.usec);
+    latency_probe_.record(std::chrono::duration_cast<std::chrono::microseconds>(now - queued));
+  }
+  latency_probe_.maybe_report();
+  sending_.clear();
+
+  start_send();
+}
+
+LatencyProbe::Summary Device::latency() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return latency_probe_.summary();
 }
 
 void Device::set_name(const std::string &name) {
   snprintf(info_.name, 80, "%s", name.c_str());
+  latency_probe_.set_name(info_.name);
 }
 
 void Device::set_driver_version(const int &version) {
@@ -150,21 +269,19 @@ void Device::set_unique_id(const std::string &unique_id) {
 
 std::string Device::socket_path() const { return connector_->socket_file(); }
 
-int Device::next_id() { return next_connection_id_++; }
-
-void Device::new_client(
-    std::shared_ptr<boost::asio::local::stream_protocol::socket> const
-        &socket) {
-  auto const messenger =
-      std::make_shared<network::LocalSocketMessenger>(socket);
-  auto const &connection = std::make_shared<network::SocketConnection>(
-      messenger, messenger, next_id(), connections_,
-      std::make_shared<qemu::NullMessageProcessor>());
-  connection->set_name("input-device");
-  connections_->add(connection);
-
+void Device::new_client(std::shared_ptr<Socket> const &socket) {
   // Send all necessary information about our device so that the remote
-  // side can properly configure itself for this input device
-  connection->send(reinterpret_cast<char const *>(&info_), sizeof(info_));
+  // side can properly configure itself for this input device. Events only
+  // go out to it once that is done.
+  const auto self = shared_from_this();
+  boost::asio::async_write(*socket, boost::asio::buffer(&info_, sizeof(info_)),
+                           [self, socket](const boost::system::error_code &err, std::size_t) {
+    if (err) {
+      DEBUG("Failed to set up client of input device %s: %s", self->info_.name, err.message());
+      return;
+    }
+    std::lock_guard<std::mutex> lock(self->mutex_);
+    self->clients_.push_back(socket);
+  });
+}
 }
-}
\ No newline at end of file
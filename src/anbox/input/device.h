@@ -18,11 +18,11 @@
 #ifndef ANBOX_INPUT_DEVICE_H_
 #define ANBOX_INPUT_DEVICE_H_
 
-#include "anbox/network/connections.h"
+#include "anbox/input/latency_probe.h"
 #include "anbox/network/published_socket_connector.h"
-#include "anbox/network/socket_connection.h"
 #include "anbox/runtime.h"
 
+#include <mutex>
 #include <vector>
 
 #include <linux/input.h>
@@ -42,9 +42,18 @@ class Device : public std::enable_shared_from_this<Device> {
   Device();
   ~Device();
 
+  // Queues events and starts sending them right away.
   void send_events(const std::vector<Event> &events);
-  void send_event(const std::uint16_t &code, const std::uint16_t &event,
-                  const std::int32_t &value);
+  // Queues events for the next flush(). A report (the events up to a
+  // SYN_REPORT) which only moves axes the report queued right before it
+  // moves too is merged into that one, so a client which falls behind
+  // gets the latest positions instead of a growing backlog.
+  void queue_events(const std::vector<Event> &events);
+  // Sends everything queued to all clients. While a send is still in
+  // flight the events stay queued and go out as soon as it completes.
+  void flush();
+
+  LatencyProbe::Summary latency() const;
 
   void set_name(const std::string &name);
   void set_driver_version(const int &version);
@@ -65,9 +74,27 @@ class Device : public std::enable_shared_from_this<Device> {
   std::string socket_path() const;
 
  private:
-  int next_id();
-  void new_client(std::shared_ptr<
-                  boost::asio::local::stream_protocol::socket> const &socket);
+  typedef boost::asio::local::stream_protocol::socket Socket;
+
+  // NOTE: A bit dirty but as we're running currently a 64 bit container
+  // struct input_event has a different size. We rebuild the struct here
+  // to reach the correct size.
+  struct CompatEvent {
+    std::uint64_t sec;
+    std::uint64_t usec;
+    std::uint16_t type;
+    std::uint16_t code;
+    std::uint32_t value;
+  };
+
+  // Queued events beyond this are dropped until the clients catch up.
+  static constexpr std::size_t max_queued_events = 4096;
+
+  void new_client(std::shared_ptr<Socket> const &socket);
+  void merge_last_report();
+  void start_send();
+  void on_sent(const std::shared_ptr<Socket> &socket,
+               const boost::system::error_code &err);
 
   // NOTE: If you modify this struct you have to modify the version on
   // the Android side too. See
@@ -92,9 +119,22 @@ class Device : public std::enable_shared_from_this<Device> {
   void set_bit(std::uint8_t *array, const std::uint64_t &bit);
 
   std::shared_ptr<network::PublishedSocketConnector> connector_;
-  std::atomic<int> next_connection_id_;
-  std::shared_ptr<network::Connections<network::SocketConnection>> connections_;
   Info info_;
+
+  mutable std::mutex mutex_;
+  std::vector<std::shared_ptr<Socket>> clients_;
+  // Events are collected in queued_ while sending_ is being written to
+  // the clients; both keep their capacity so sending doesn't allocate.
+  std::vector<CompatEvent> queued_;
+  std::vector<CompatEvent> sending_;
+  std::size_t writes_in_flight_ = 0;
+  // Where the report being queued and the complete one before it start
+  // in queued_; the latter is only set while it can still be merged into.
+  std::size_t report_start_ = 0;
+  std::size_t previous_report_start_ = 0;
+  bool have_previous_report_ = false;
+  bool dropping_ = false;
+  LatencyProbe latency_probe_;
 };
 }
 #endif
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "anbox/input/latency_probe.h"
+#include "anbox/logger.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace anbox::input {
+constexpr std::size_t LatencyProbe::max_samples;
+
+LatencyProbe::LatencyProbe(const std::string &name, std::chrono::seconds report_interval) :
+  name_(name),
+  report_interval_(report_interval),
+  last_report_(Clock::now()) {}
+
+void LatencyProbe::record(std::chrono::microseconds latency) {
+  const auto us = std::min<std::int64_t>(std::max<std::int64_t>(latency.count(), 0),
+                                         std::numeric_limits<std::uint32_t>::max());
+  samples_[next_] = static_cast<std::uint32_t>(us);
+  next_ = (next_ + 1) % max_samples;
+  count_ = std::min(count_ + 1, max_samples);
+  recorded_since_report_++;
+}
+
+LatencyProbe::Summary LatencyProbe::summary() const {
+  Summary summary{count_, {}, {}, {}, {}};
+  if (count_ == 0)
+    return summary;
+
+  std::vector<std::uint32_t> sorted(samples_.begin(), samples_.begin() + count_);
+  std::sort(sorted.begin(), sorted.end());
+  const auto at = [&](double p) {
+    return std::chrono::microseconds(sorted[std::min(count_ - 1, static_cast<std::size_t>(count_ * p))]);
+  };
+  summary.p50 = at(0.5);
+  summary.p90 = at(0.9);
+  summary.p99 = at(0.99);
+  summary.max = std::chrono::microseconds(sorted.back());
+  return summary;
+}
+
+void LatencyProbe::maybe_report() {
+  const auto now = Clock::now();
+  if (now - last_report_ < report_interval_ || recorded_since_report_ == 0)
+    return;
+
+  const auto s = summary();
+  DEBUG("%s: %d events in the last %d s, host to socket latency p50 %d us, p90 %d us, p99 %d us, max %d us",
+        name_, recorded_since_report_,
+        std::chrono::duration_cast<std::chrono::seconds>(now - last_report_).count(),
+        s.p50.count(), s.p90.count(), s.p99.count(), s.max.count());
+  last_report_ = now;
+  recorded_since_report_ = 0;
+}
+}
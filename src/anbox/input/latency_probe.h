@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef ANBOX_INPUT_LATENCY_PROBE_H_
+#define ANBOX_INPUT_LATENCY_PROBE_H_
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace anbox::input {
+// Collects how long input events took from the host to the socket and
+// logs percentiles of the most recent ones at debug level from time to
+// time. Not thread safe; the owner serializes calls.
+class LatencyProbe {
+ public:
+  typedef std::chrono::steady_clock Clock;
+
+  struct Summary {
+    std::size_t count;
+    std::chrono::microseconds p50;
+    std::chrono::microseconds p90;
+    std::chrono::microseconds p99;
+    std::chrono::microseconds max;
+  };
+
+  explicit LatencyProbe(const std::string &name,
+                        std::chrono::seconds report_interval = std::chrono::seconds{10});
+
+  void set_name(const std::string &name) { name_ = name; }
+
+  void record(std::chrono::microseconds latency);
+
+  // Percentiles over the last samples recorded.
+  Summary summary() const;
+
+  // Logs the summary if report_interval passed since the last time.
+  void maybe_report();
+
+ private:
+  static constexpr std::size_t max_samples = 1024;
+
+  std::string name_;
+  const std::chrono::seconds report_interval_;
+  Clock::time_point last_report_;
+  std::array<std::uint32_t, max_samples> samples_;
+  std::size_t next_ = 0;
+  std::size_t count_ = 0;
+  std::uint64_t recorded_since_report_ = 0;
+};
+}
+#endif
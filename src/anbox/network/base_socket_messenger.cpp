@@ -79,6 +79,18 @@ ssize_t BaseSocketMessenger<stream_protocol>::send_raw(char const* data,
   return ::send(socket_fd, data, length, MSG_NOSIGNAL);
 }
 
+template <typename stream_protocol>
+ssize_t BaseSocketMessenger<stream_protocol>::send_raw_vectored(
+    struct iovec const* iov, size_t count) {
+  struct msghdr msg;
+  ::memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = const_cast<struct iovec*>(iov);
+  msg.msg_iovlen = count;
+
+  std::unique_lock<std::mutex> lg(message_lock);
+  return ::sendmsg(socket_fd, &msg, MSG_NOSIGNAL);
+}
+
 template <typename stream_protocol>
 void BaseSocketMessenger<stream_protocol>::send(char const* data,
                                                 size_t length) {
@@ -120,8 +132,9 @@ bs::error_code BaseSocketMessenger<stream_protocol>::receive_msg(
 template <typename stream_protocol>
 size_t BaseSocketMessenger<stream_protocol>::available_bytes() {
   boost::asio::socket_base::bytes_readable command{true};
-  socket->io_control(command);
-  return command.get();
+  boost::system::error_code err;
+  socket->io_control(command, err);
+  return err ? 0 : command.get();
 }
 
 template <typename stream_protocol>
@@ -21,6 +21,7 @@
 #include <cstdint>
 #include <vector>
 #include "anbox/common/small_vector.h"
+#include "anbox/network/receive_buffer.h"
 
 namespace anbox::network {
 using MessageBuffer = anbox::common::SmallFixedVector<char, 512>;
@@ -29,6 +30,11 @@ class MessageProcessor {
   virtual ~MessageProcessor() {}
   virtual bool process_data(const std::vector<std::uint8_t> &) { return false; }
   virtual bool process_data(MessageBuffer &&) { return false; }
+  // Socket connections hand over what they received with this. Processors
+  // which don't consume the buffer in place get a copy of its bytes.
+  virtual bool process_data(ReceiveBuffer &&buffer) {
+    return process_data(std::vector<std::uint8_t>(buffer.begin(), buffer.end()));
+  }
 };
 }
 #endif
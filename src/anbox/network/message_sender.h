@@ -20,6 +20,7 @@
 #define ANBOX_NETWORK_MESSAGE_SENDER_H_
 
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <cstddef>
 
 namespace anbox::network {
@@ -27,6 +28,16 @@ class MessageSender {
  public:
   virtual void send(char const* data, size_t length) = 0;
   virtual ssize_t send_raw(char const* data, size_t length) = 0;
+  // Gathers up to |count| buffers into a single non-blocking write and
+  // returns the number of bytes written like writev(2) does. The default
+  // implementation only writes out the first non-empty buffer.
+  virtual ssize_t send_raw_vectored(struct iovec const* iov, size_t count) {
+    for (size_t n = 0; n < count; n++) {
+      if (iov[n].iov_len > 0)
+        return send_raw(static_cast<char const*>(iov[n].iov_base), iov[n].iov_len);
+    }
+    return 0;
+  }
 
  protected:
   MessageSender() = default;
@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "anbox/network/receive_buffer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace anbox {
+namespace network {
+struct ReceiveBuffer::Block {
+  Block(std::size_t capacity, std::size_t size_class)
+      : storage(new std::uint8_t[capacity]), capacity(capacity), size_class(size_class) {}
+
+  std::atomic<unsigned int> refs{0};
+  // Set while the block is handed out, keeps the pool alive meanwhile.
+  std::shared_ptr<ReceiveBufferPool> pool;
+  std::unique_ptr<std::uint8_t[]> storage;
+  const std::size_t capacity;
+  const std::size_t size_class;
+  std::size_t size = 0;
+};
+
+ReceiveBuffer::ReceiveBuffer(const ReceiveBuffer &other) : block_(other.block_) {
+  if (block_) block_->refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+ReceiveBuffer::ReceiveBuffer(ReceiveBuffer &&other) noexcept : block_(other.block_) {
+  other.block_ = nullptr;
+}
+
+ReceiveBuffer &ReceiveBuffer::operator=(ReceiveBuffer other) noexcept {
+  std::swap(block_, other.block_);
+  return *this;
+}
+
+ReceiveBuffer::~ReceiveBuffer() {
+  if (!block_ || block_->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+  auto pool = std::move(block_->pool);
+  pool->release(block_);
+}
+
+std::uint8_t *ReceiveBuffer::data() { return block_ ? block_->storage.get() : nullptr; }
+
+const std::uint8_t *ReceiveBuffer::data() const { return block_ ? block_->storage.get() : nullptr; }
+
+std::size_t ReceiveBuffer::size() const { return block_ ? block_->size : 0; }
+
+std::size_t ReceiveBuffer::capacity() const { return block_ ? block_->capacity : 0; }
+
+void ReceiveBuffer::resize(std::size_t size) {
+  if (block_) block_->size = std::min(size, block_->capacity);
+}
+
+std::shared_ptr<ReceiveBufferPool> ReceiveBufferPool::create() {
+  return std::shared_ptr<ReceiveBufferPool>(new ReceiveBufferPool);
+}
+
+std::shared_ptr<ReceiveBufferPool> ReceiveBufferPool::instance() {
+  static const auto pool = create();
+  return pool;
+}
+
+ReceiveBufferPool::ReceiveBufferPool() {
+  for (auto &blocks : free_blocks_) blocks.reserve(max_cached);
+}
+
+ReceiveBufferPool::~ReceiveBufferPool() {
+  for (auto &blocks : free_blocks_) {
+    for (auto block : blocks) delete block;
+  }
+}
+
+ReceiveBuffer ReceiveBufferPool::acquire(std::size_t size) {
+  std::size_t size_class = 0;
+  std::size_t capacity = min_size;
+  while (capacity < std::min(size, max_size)) {
+    capacity *= 2;
+    size_class++;
+  }
+
+  ReceiveBuffer::Block *block = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &blocks = free_blocks_[size_class];
+    if (!blocks.empty()) {
+      block = blocks.back();
+      blocks.pop_back();
+    }
+  }
+
+  if (block) {
+    reuses_++;
+  } else {
+    block = new ReceiveBuffer::Block(capacity, size_class);
+    allocations_++;
+  }
+
+  block->refs.store(1, std::memory_order_relaxed);
+  block->pool = shared_from_this();
+  block->size = 0;
+  return ReceiveBuffer(block);
+}
+
+void ReceiveBufferPool::release(ReceiveBuffer::Block *block) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &blocks = free_blocks_[block->size_class];
+    if (blocks.size() < max_cached) {
+      blocks.push_back(block);
+      return;
+    }
+  }
+  delete block;
+}
+
+ReceiveBufferPool::Stats ReceiveBufferPool::stats() const {
+  return {allocations_.load(), reuses_.load()};
+}
+
+void ReceiveBufferChain::append(ReceiveBuffer &&buffer) {
+  if (buffer.empty()) return;
+  size_ += buffer.size();
+  buffers_.push_back(std::move(buffer));
+}
+
+std::size_t ReceiveBufferChain::copy(void *dest, std::size_t count, std::size_t offset) const {
+  auto out = static_cast<std::uint8_t *>(dest);
+  std::size_t copied = 0;
+  offset += offset_;
+  for (const auto &buffer : buffers_) {
+    if (copied == count) break;
+    if (offset >= buffer.size()) {
+      offset -= buffer.size();
+      continue;
+    }
+    const auto n = std::min(count - copied, buffer.size() - offset);
+    std::memcpy(out + copied, buffer.data() + offset, n);
+    copied += n;
+    offset = 0;
+  }
+  return copied;
+}
+
+std::size_t ReceiveBufferChain::find(std::uint8_t value) const {
+  std::size_t position = 0;
+  std::size_t offset = offset_;
+  for (const auto &buffer : buffers_) {
+    const auto begin = buffer.data() + offset;
+    const auto found = static_cast<const std::uint8_t *>(
+        std::memchr(begin, value, buffer.size() - offset));
+    if (found) return position + static_cast<std::size_t>(found - begin);
+    position += buffer.size() - offset;
+    offset = 0;
+  }
+  return npos;
+}
+
+void ReceiveBufferChain::consume(std::size_t count) {
+  count = std::min(count, size_);
+  size_ -= count;
+
+  std::size_t drop = 0;
+  while (count > 0) {
+    const auto available = buffers_[drop].size() - offset_;
+    if (count < available) {
+      offset_ += count;
+      break;
+    }
+    count -= available;
+    offset_ = 0;
+    drop++;
+  }
+  buffers_.erase(buffers_.begin(), buffers_.begin() + drop);
+}
+}  // namespace network
+}  // namespace anbox
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef ANBOX_NETWORK_RECEIVE_BUFFER_H_
+#define ANBOX_NETWORK_RECEIVE_BUFFER_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace anbox {
+namespace network {
+class ReceiveBufferPool;
+
+// A block of received bytes handed out by a ReceiveBufferPool. Copies
+// share the block through a reference count and the block goes back to
+// its pool once the last of them is gone, so passing buffers around never
+// copies the bytes nor allocates.
+class ReceiveBuffer {
+ public:
+  ReceiveBuffer() = default;
+  ReceiveBuffer(const ReceiveBuffer &other);
+  ReceiveBuffer(ReceiveBuffer &&other) noexcept;
+  ReceiveBuffer &operator=(ReceiveBuffer other) noexcept;
+  ~ReceiveBuffer();
+
+  std::uint8_t *data();
+  const std::uint8_t *data() const;
+  std::size_t size() const;
+  std::size_t capacity() const;
+  bool empty() const { return size() == 0; }
+
+  const std::uint8_t *begin() const { return data(); }
+  const std::uint8_t *end() const { return data() + size(); }
+
+  // Sets the number of valid bytes, at most capacity().
+  void resize(std::size_t size);
+
+ private:
+  friend class ReceiveBufferPool;
+  struct Block;
+
+  explicit ReceiveBuffer(Block *block) : block_(block) {}
+
+  Block *block_ = nullptr;
+};
+
+// Hands out receive buffers and keeps released ones around for reuse. The
+// buffers come in power of two sizes between min_size and max_size so a
+// reader can size each read after what is waiting on its socket.
+class ReceiveBufferPool : public std::enable_shared_from_this<ReceiveBufferPool> {
+ public:
+  static constexpr std::size_t min_size{8 * 1024};
+  static constexpr std::size_t max_size{256 * 1024};
+  // Number of released buffers kept for reuse per size.
+  static constexpr std::size_t max_cached{32};
+
+  struct Stats {
+    // Buffers which had to be allocated as none could be reused.
+    std::size_t allocations;
+    // Buffers handed out again after being released.
+    std::size_t reuses;
+  };
+
+  static std::shared_ptr<ReceiveBufferPool> create();
+  // The pool shared by all socket connections.
+  static std::shared_ptr<ReceiveBufferPool> instance();
+
+  ~ReceiveBufferPool();
+
+  // Returns an empty buffer with a capacity of at least |size| bytes,
+  // limited to max_size.
+  ReceiveBuffer acquire(std::size_t size);
+
+  Stats stats() const;
+
+ private:
+  friend class ReceiveBuffer;
+
+  static constexpr std::size_t size_classes{6};
+
+  ReceiveBufferPool();
+
+  void release(ReceiveBuffer::Block *block);
+
+  mutable std::mutex mutex_;
+  std::array<std::vector<ReceiveBuffer::Block *>, size_classes> free_blocks_;
+  std::atomic<std::size_t> allocations_{0};
+  std::atomic<std::size_t> reuses_{0};
+};
+
+// Bytes received across several buffers which aren't consumed yet, e.g.
+// the beginning of a message whose remaining bytes didn't arrive yet. The
+// buffers are kept as they are instead of copying their bytes together.
+class ReceiveBufferChain {
+ public:
+  static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+  void append(ReceiveBuffer &&buffer);
+
+  // Number of bytes not consumed yet.
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  // Copies |count| bytes starting |offset| bytes into the chain to |dest|
+  // and returns the number of bytes copied.
+  std::size_t copy(void *dest, std::size_t count, std::size_t offset = 0) const;
+
+  // Returns the offset of the first byte with |value| or npos.
+  std::size_t find(std::uint8_t value) const;
+
+  // Drops |count| bytes from the front of the chain.
+  void consume(std::size_t count);
+
+ private:
+  std::vector<ReceiveBuffer> buffers_;
+  std::size_t offset_ = 0;
+  std::size_t size_ = 0;
+};
+}  // namespace network
+}  // namespace anbox
+
+#endif
@@ -38,12 +38,14 @@ SocketConnection::SocketConnection(
     std::shared_ptr<MessageReceiver> const& message_receiver,
     std::shared_ptr<MessageSender> const& message_sender, int id_,
     std::shared_ptr<Connections<SocketConnection>> const& connections,
-    std::shared_ptr<MessageProcessor> const& processor)
+    std::shared_ptr<MessageProcessor> const& processor,
+    std::shared_ptr<ReceiveBufferPool> const& buffer_pool)
     : message_receiver_(message_receiver),
       message_sender_(message_sender),
       id_(id_),
       connections_(connections),
-      processor_(processor) {}
+      processor_(processor),
+      buffer_pool_(buffer_pool) {}
 
 SocketConnection::~SocketConnection() noexcept {}
 
@@ -52,20 +54,27 @@ void SocketConnection::send(char const* data, size_t length) {
 }
 
 void SocketConnection::read_next_message() {
-  auto callback = std::bind(&SocketConnection::on_read_size, this, std::placeholders::_1, std::placeholders::_2);
-  message_receiver_->async_receive_msg(callback, ba::buffer(buffer_));
+  // Size the buffer after what is already waiting so a burst of data is
+  // picked up with as few reads as possible.
+  buffer_ = buffer_pool_->acquire(message_receiver_->available_bytes());
+  // A callback capturing nothing but this is stored in place by
+  // std::function, avoiding an allocation per read.
+  message_receiver_->async_receive_msg(
+      [this](const boost::system::error_code& error, std::size_t bytes_read) {
+        on_read_size(error, bytes_read);
+      },
+      ba::buffer(buffer_.data(), buffer_.capacity()));
 }
 
 void SocketConnection::on_read_size(const boost::system::error_code& error, std::size_t bytes_read) {
   if (error) {
+    buffer_ = ReceiveBuffer();
     connections_->remove(id());
     return;
   }
 
-  std::vector<std::uint8_t> data(bytes_read);
-  std::copy(buffer_.data(), buffer_.data() + bytes_read, data.data());
-
-  if (processor_->process_data(data))
+  buffer_.resize(bytes_read);
+  if (processor_->process_data(std::move(buffer_)))
     read_next_message();
   else
       connections_->remove(id());
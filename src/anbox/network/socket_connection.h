@@ -23,6 +23,7 @@
 #include "anbox/network/message_processor.h"
 #include "anbox/network/message_receiver.h"
 #include "anbox/network/message_sender.h"
+#include "anbox/network/receive_buffer.h"
 
 #include <boost/asio.hpp>
 
@@ -35,7 +36,8 @@ class SocketConnection {
       std::shared_ptr<MessageReceiver> const& message_receiver,
       std::shared_ptr<MessageSender> const& message_sender, int id,
       std::shared_ptr<Connections<SocketConnection>> const& connections,
-      std::shared_ptr<MessageProcessor> const& processor);
+      std::shared_ptr<MessageProcessor> const& processor,
+      std::shared_ptr<ReceiveBufferPool> const& buffer_pool = ReceiveBufferPool::instance());
 
   virtual ~SocketConnection() noexcept;
 
@@ -55,7 +57,8 @@ protected:
   int id_;
   std::shared_ptr<Connections<SocketConnection>> const connections_;
   std::shared_ptr<MessageProcessor> processor_;
-  std::array<std::uint8_t, 8192> buffer_;
+  std::shared_ptr<ReceiveBufferPool> const buffer_pool_;
+  ReceiveBuffer buffer_;
   std::string name_;
 };
 }
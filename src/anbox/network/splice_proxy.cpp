@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "anbox/network/splice_proxy.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace ba = boost::asio;
+namespace bs = boost::system;
+
+namespace {
+// Large enough for a whole adb write packet in one go. Growing the pipe is
+// best effort as it is capped by /proc/sys/fs/pipe-max-size.
+constexpr const int preferred_pipe_size{1024 * 1024};
+// Number of splice calls a direction makes before it lets other handlers
+// run on the thread, so a busy stream can't starve the other direction.
+constexpr const unsigned int max_splices_per_turn{32};
+}
+
+namespace anbox::network {
+template <typename A, typename B>
+SpliceProxy<A, B>::SpliceProxy(const std::shared_ptr<Runtime> &rt,
+                               const std::shared_ptr<ba::basic_stream_socket<A>> &a,
+                               const std::shared_ptr<ba::basic_stream_socket<B>> &b)
+    : strand_{rt->service()} {
+  a_to_b_.source = a;
+  a_to_b_.sink = b;
+  b_to_a_.source = b;
+  b_to_a_.sink = a;
+
+  open_pipe(a_to_b_);
+  open_pipe(b_to_a_);
+
+  // splice(2) only gives up instead of blocking when the sockets are
+  // non-blocking too. Synchronous asio operations on them keep working as
+  // asio polls for them in that case.
+  a->native_non_blocking(true);
+  b->native_non_blocking(true);
+}
+
+template <typename A, typename B>
+SpliceProxy<A, B>::~SpliceProxy() {}
+
+template <typename A, typename B>
+template <typename Source, typename Sink>
+void SpliceProxy<A, B>::open_pipe(Pump<Source, Sink> &pump) {
+  int fds[2];
+  if (::pipe2(fds, O_NONBLOCK | O_CLOEXEC) < 0)
+    BOOST_THROW_EXCEPTION(std::runtime_error("Failed to create pipe for proxy"));
+
+  pump.pipe_read = Fd{fds[0]};
+  pump.pipe_write = Fd{fds[1]};
+
+  ::fcntl(fds[1], F_SETPIPE_SZ, preferred_pipe_size);
+  const auto size = ::fcntl(fds[1], F_GETPIPE_SZ);
+  pump.pipe_size = size > 0 ? static_cast<std::size_t>(size) : 65536;
+}
+
+template <typename A, typename B>
+void SpliceProxy<A, B>::start(const CloseHandler &handler) {
+  auto self = this->shared_from_this();
+  strand_.dispatch([self, handler]() {
+    self->close_handler_ = handler;
+    self->running_ = true;
+    self->run(self->a_to_b_);
+    self->run(self->b_to_a_);
+  });
+}
+
+template <typename A, typename B>
+void SpliceProxy<A, B>::stop() {
+  auto self = this->shared_from_this();
+  strand_.dispatch([self]() {
+    self->close_handler_ = nullptr;
+    self->finish(bs::error_code{});
+  });
+}
+
+template <typename A, typename B>
+typename SpliceProxy<A, B>::Stats SpliceProxy<A, B>::stats() const {
+  return {a_to_b_.transferred.load(), b_to_a_.transferred.load()};
+}
+
+template <typename A, typename B>
+template <typename Source, typename Sink>
+void SpliceProxy<A, B>::run(Pump<Source, Sink> &pump) {
+  // Both sockets are watched edge triggered by the asio reactor, so we only
+  // wait for readiness after an operation ran dry and keep going otherwise.
+  for (unsigned int n = 0; n < max_splices_per_turn; n++) {
+    if (!running_)
+      return;
+
+    if (pump.pending > 0) {
+      const auto written = ::splice(pump.pipe_read, nullptr, pump.sink->native_handle(), nullptr,
+                                    pump.pending, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+      if (written < 0) {
+        if (errno == EINTR)
+          continue;
+        if (errno != EAGAIN) {
+          finish(bs::error_code{errno, bs::system_category()});
+          return;
+        }
+
+        wait(pump, *pump.sink, ba::socket_base::wait_write);
+        return;
+      }
+
+      pump.pending -= written;
+      pump.transferred += written;
+      continue;
+    }
+
+    const auto read = ::splice(pump.source->native_handle(), nullptr, pump.pipe_write, nullptr,
+                               pump.pipe_size, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+    if (read < 0) {
+      if (errno == EINTR)
+        continue;
+      // The pipe is empty at this point so running out of room in it can't
+      // be the reason we would block.
+      if (errno != EAGAIN) {
+        finish(bs::error_code{errno, bs::system_category()});
+        return;
+      }
+
+      wait(pump, *pump.source, ba::socket_base::wait_read);
+      return;
+    }
+
+    if (read == 0) {
+      finish(ba::error::eof);
+      return;
+    }
+
+    pump.pending += read;
+  }
+
+  auto self = this->shared_from_this();
+  strand_.post([self, &pump]() { self->run(pump); });
+}
+
+template <typename A, typename B>
+template <typename Source, typename Sink, typename Socket>
+void SpliceProxy<A, B>::wait(Pump<Source, Sink> &pump, Socket &socket,
+                             ba::socket_base::wait_type type) {
+  auto self = this->shared_from_this();
+  socket.async_wait(type, strand_.wrap([self, &pump](const bs::error_code &err) {
+    if (err) {
+      self->finish(err);
+      return;
+    }
+    self->run(pump);
+  }));
+}
+
+template <typename A, typename B>
+void SpliceProxy<A, B>::finish(const bs::error_code &error) {
+  if (!running_)
+    return;
+
+  running_ = false;
+
+  // Completes whatever the other direction is still waiting for. Its
+  // handler sees running_ unset and returns.
+  bs::error_code ignored;
+  a_to_b_.source->cancel(ignored);
+  b_to_a_.source->cancel(ignored);
+
+  CloseHandler handler;
+  std::swap(handler, close_handler_);
+  if (handler)
+    handler(error);
+}
+
+template class SpliceProxy<ba::local::stream_protocol, ba::local::stream_protocol>;
+template class SpliceProxy<ba::local::stream_protocol, ba::ip::tcp>;
+}
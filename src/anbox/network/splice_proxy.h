@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef ANBOX_NETWORK_SPLICE_PROXY_H_
+#define ANBOX_NETWORK_SPLICE_PROXY_H_
+
+#include "anbox/common/fd.h"
+#include "anbox/runtime.h"
+
+#include <boost/asio.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace anbox::network {
+// Forwards a byte stream in both directions between two connected stream
+// sockets. Each direction moves the data with splice(2) from its source
+// socket into a kernel pipe and from there into the sink socket, so it
+// never gets copied into user space.
+//
+// A direction only reads from its source once its pipe was flushed to the
+// sink. A sink which doesn't keep up therefore makes the proxy stop reading
+// the other side instead of queueing data, and its peer gets blocked by the
+// kernel once the socket buffers are full.
+template <typename A, typename B>
+class SpliceProxy : public std::enable_shared_from_this<SpliceProxy<A, B>> {
+ public:
+  typedef std::function<void(const boost::system::error_code &)> CloseHandler;
+
+  struct Stats {
+    std::uint64_t a_to_b;
+    std::uint64_t b_to_a;
+  };
+
+  // Throws std::runtime_error if the pipes can't be created.
+  SpliceProxy(const std::shared_ptr<Runtime> &rt,
+              const std::shared_ptr<boost::asio::basic_stream_socket<A>> &a,
+              const std::shared_ptr<boost::asio::basic_stream_socket<B>> &b);
+  ~SpliceProxy();
+
+  // Starts forwarding. The handler is called once either side reached the
+  // end of its stream or failed; the sockets are left open.
+  void start(const CloseHandler &handler);
+
+  // Stops forwarding without calling the close handler.
+  void stop();
+
+  Stats stats() const;
+
+ private:
+  template <typename Source, typename Sink>
+  struct Pump {
+    std::shared_ptr<boost::asio::basic_stream_socket<Source>> source;
+    std::shared_ptr<boost::asio::basic_stream_socket<Sink>> sink;
+    Fd pipe_read;
+    Fd pipe_write;
+    std::size_t pipe_size = 0;
+    // Bytes read from the source which are still in the pipe.
+    std::size_t pending = 0;
+    std::atomic<std::uint64_t> transferred{0};
+  };
+
+  template <typename Source, typename Sink>
+  static void open_pipe(Pump<Source, Sink> &pump);
+
+  template <typename Source, typename Sink>
+  void run(Pump<Source, Sink> &pump);
+
+  template <typename Source, typename Sink, typename Socket>
+  void wait(Pump<Source, Sink> &pump, Socket &socket,
+            boost::asio::socket_base::wait_type type);
+
+  void finish(const boost::system::error_code &error);
+
+  boost::asio::io_service::strand strand_;
+  Pump<A, B> a_to_b_;
+  Pump<B, A> b_to_a_;
+  CloseHandler close_handler_;
+  bool running_ = false;
+};
+}
+
+#endif
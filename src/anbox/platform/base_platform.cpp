@@ -16,6 +16,7 @@
  */
 
 #include "anbox/platform/base_platform.h"
+#include "anbox/platform/headless/platform.h"
 #include "anbox/platform/null/platform.h"
 #include "anbox/platform/sdl/platform.h"
 #include "anbox/logger.h"
@@ -23,13 +24,17 @@
 namespace anbox::platform {
 std::shared_ptr<BasePlatform> create(const std::string &name,
                                      const std::shared_ptr<input::Manager> &input_manager,
-                                     const Configuration &config) {
+                                     const Configuration &config,
+                                     const std::shared_ptr<Runtime> &rt) {
   if (name.empty())
     return std::make_shared<NullPlatform>();
 
   if (name == "sdl")
     return std::make_shared<sdl::Platform>(input_manager, config);
 
+  if (name == "headless")
+    return std::make_shared<headless::Platform>(input_manager, config, rt);
+
   WARNING("Unsupported platform '%s'", name);
 
   return nullptr;
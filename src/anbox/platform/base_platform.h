@@ -39,6 +39,10 @@ namespace anbox::input {
   class Manager;
 }
 
+namespace anbox {
+  class Runtime;
+}
+
 namespace anbox::platform {
 class BasePlatform {
  public:
@@ -70,8 +74,11 @@ struct Configuration {
   bool rootless = false;
 };
 
+// Platforms serving local sockets (e.g. "headless") need the runtime to
+// run them on.
 std::shared_ptr<BasePlatform> create(const std::string &name,
                                      const std::shared_ptr<input::Manager> &input_manager,
-                                     const Configuration &config);
+                                     const Configuration &config,
+                                     const std::shared_ptr<Runtime> &rt = nullptr);
 }
 #endif
@@ -0,0 +1,250 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "anbox/platform/headless/input_injector.h"
+#include "anbox/network/delegate_connection_creator.h"
+#include "anbox/logger.h"
+
+#include <boost/asio/steady_timer.hpp>
+
+#include <sstream>
+
+#include <sys/stat.h>
+
+namespace anbox::platform::headless {
+constexpr std::size_t InputInjector::max_fingers;
+
+class InputInjector::Session : public std::enable_shared_from_this<Session> {
+ public:
+  Session(const std::shared_ptr<InputInjector> &injector, const std::shared_ptr<Socket> &socket) :
+    injector_(injector),
+    socket_(socket),
+    timer_(injector->runtime_->service()) {}
+
+  void read_next() {
+    auto self = shared_from_this();
+    boost::asio::async_read_until(*socket_, buffer_, '\n',
+                                  [self](const boost::system::error_code &err, std::size_t) {
+                                    self->on_line(err);
+                                  });
+  }
+
+ private:
+  void on_line(const boost::system::error_code &err) {
+    if (err)
+      return;
+
+    std::istream in(&buffer_);
+    std::string line;
+    std::getline(in, line);
+
+    auto injector = injector_.lock();
+    if (!injector)
+      return;
+
+    auto result = injector->execute(line);
+    if (result.reply.empty()) {
+      read_next();
+      return;
+    }
+    reply_ = result.reply + "\n";
+
+    auto self = shared_from_this();
+    timer_.expires_from_now(result.delay);
+    timer_.async_wait([self](const boost::system::error_code &err) {
+      if (err)
+        return;
+      boost::asio::async_write(*self->socket_, boost::asio::buffer(self->reply_),
+                               [self](const boost::system::error_code &err, std::size_t) {
+                                 if (!err)
+                                   self->read_next();
+                               });
+    });
+  }
+
+  std::weak_ptr<InputInjector> injector_;
+  std::shared_ptr<Socket> socket_;
+  boost::asio::steady_timer timer_;
+  boost::asio::streambuf buffer_;
+  std::string reply_;
+};
+
+std::shared_ptr<InputInjector> InputInjector::create(const std::string &path,
+                                                     const std::shared_ptr<Runtime> &rt,
+                                                     const std::shared_ptr<input::Device> &touch,
+                                                     const std::shared_ptr<input::Device> &keyboard) {
+  auto sp = std::make_shared<InputInjector>(rt, touch, keyboard);
+  std::weak_ptr<InputInjector> wp = sp;
+
+  auto delegate_connector = std::make_shared<
+      network::DelegateConnectionCreator<boost::asio::local::stream_protocol>>(
+      [wp](std::shared_ptr<Socket> const &socket) {
+        if (auto injector = wp.lock())
+          std::make_shared<Session>(injector, socket)->read_next();
+      });
+
+  sp->connector_ = std::make_shared<network::PublishedSocketConnector>(path, rt, delegate_connector);
+  ::chmod(path.c_str(), S_IRUSR | S_IWUSR);
+
+  return sp;
+}
+
+InputInjector::InputInjector(const std::shared_ptr<Runtime> &rt,
+                             const std::shared_ptr<input::Device> &touch,
+                             const std::shared_ptr<input::Device> &keyboard) :
+  runtime_(rt),
+  touch_(touch),
+  keyboard_(keyboard) {}
+
+InputInjector::Result InputInjector::execute(const std::string &command) {
+  std::istringstream in(command);
+  std::string verb;
+  if (!(in >> verb) || verb[0] == '#')
+    return Result{};
+
+  std::lock_guard<std::mutex> l(mutex_);
+
+  auto arguments_valid = [&in]() {
+    std::string rest;
+    return !in.fail() && !(in >> rest);
+  };
+
+  std::string error;
+  std::chrono::milliseconds delay{0};
+
+  if (verb == "down" || verb == "move") {
+    std::size_t slot = 0;
+    std::int32_t x = 0, y = 0;
+    in >> slot >> x >> y;
+    if (!arguments_valid())
+      error = "usage: " + verb + " <slot> <x> <y>";
+    else if (verb == "down")
+      error = finger_down(slot, x, y);
+    else
+      error = finger_move(slot, x, y);
+  } else if (verb == "up") {
+    std::size_t slot = 0;
+    in >> slot;
+    error = arguments_valid() ? finger_up(slot) : "usage: up <slot>";
+  } else if (verb == "tap") {
+    std::int32_t x = 0, y = 0;
+    in >> x >> y;
+    std::size_t slot = 0;
+    while (slot < max_fingers && fingers_[slot])
+      slot++;
+    if (!arguments_valid())
+      error = "usage: tap <x> <y>";
+    else if (slot == max_fingers)
+      error = "no free finger";
+    else if ((error = finger_down(slot, x, y)).empty())
+      error = finger_up(slot);
+  } else if (verb == "key") {
+    std::uint16_t code = 0;
+    in >> code;
+    int value = -1;
+    if (!(in >> value) && !in.bad()) {
+      in.clear();
+      value = -1;
+    }
+    if (!arguments_valid() || code == 0 || code > KEY_MAX || value < -1 || value > 1) {
+      error = "usage: key <code> [1|0]";
+    } else if (!keyboard_) {
+      error = "no keyboard";
+    } else {
+      std::vector<input::Event> events;
+      if (value != 0)
+        events.insert(events.end(), {{EV_KEY, code, 1}, {EV_SYN, SYN_REPORT, 0}});
+      if (value != 1)
+        events.insert(events.end(), {{EV_KEY, code, 0}, {EV_SYN, SYN_REPORT, 0}});
+      keyboard_->send_events(events);
+    }
+  } else if (verb == "sleep") {
+    unsigned int ms = 0;
+    in >> ms;
+    if (!arguments_valid())
+      error = "usage: sleep <ms>";
+    else
+      delay = std::chrono::milliseconds(ms);
+  } else {
+    error = "unknown command '" + verb + "'";
+  }
+
+  if (!error.empty()) {
+    DEBUG("Rejected injected input '%s': %s", command, error);
+    return Result{"ERROR " + error};
+  }
+  return Result{"OK", delay};
+}
+
+void InputInjector::select_slot(std::size_t slot, std::vector<input::Event> &events) {
+  if (last_slot_ == static_cast<int>(slot))
+    return;
+  events.push_back({EV_ABS, ABS_MT_SLOT, static_cast<std::int32_t>(slot)});
+  last_slot_ = static_cast<int>(slot);
+}
+
+std::string InputInjector::finger_down(std::size_t slot, std::int32_t x, std::int32_t y) {
+  if (!touch_)
+    return "no touch screen";
+  if (slot >= max_fingers)
+    return "slot out of range";
+  if (fingers_[slot])
+    return "finger is already down";
+
+  std::vector<input::Event> events;
+  select_slot(slot, events);
+  events.push_back({EV_ABS, ABS_MT_TRACKING_ID, static_cast<std::int32_t>(slot + 1)});
+  events.push_back({EV_ABS, ABS_MT_POSITION_X, x});
+  events.push_back({EV_ABS, ABS_MT_POSITION_Y, y});
+  events.push_back({EV_SYN, SYN_REPORT, 0});
+  touch_->send_events(events);
+
+  fingers_[slot] = true;
+  return "";
+}
+
+std::string InputInjector::finger_move(std::size_t slot, std::int32_t x, std::int32_t y) {
+  if (!touch_)
+    return "no touch screen";
+  if (slot >= max_fingers || !fingers_[slot])
+    return "finger is not down";
+
+  std::vector<input::Event> events;
+  select_slot(slot, events);
+  events.push_back({EV_ABS, ABS_MT_POSITION_X, x});
+  events.push_back({EV_ABS, ABS_MT_POSITION_Y, y});
+  events.push_back({EV_SYN, SYN_REPORT, 0});
+  touch_->send_events(events);
+  return "";
+}
+
+std::string InputInjector::finger_up(std::size_t slot) {
+  if (!touch_)
+    return "no touch screen";
+  if (slot >= max_fingers || !fingers_[slot])
+    return "finger is not down";
+
+  std::vector<input::Event> events;
+  select_slot(slot, events);
+  events.push_back({EV_ABS, ABS_MT_TRACKING_ID, -1});
+  events.push_back({EV_SYN, SYN_REPORT, 0});
+  touch_->send_events(events);
+
+  fingers_[slot] = false;
+  return "";
+}
+}
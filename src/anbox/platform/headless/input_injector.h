@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef ANBOX_PLATFORM_HEADLESS_INPUT_INJECTOR_H_
+#define ANBOX_PLATFORM_HEADLESS_INPUT_INJECTOR_H_
+
+#include "anbox/input/device.h"
+#include "anbox/network/published_socket_connector.h"
+#include "anbox/runtime.h"
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace anbox::platform::headless {
+// Lets test scripts drive the touch screen and keyboard of a headless
+// session. Clients connect to a local socket and send one command per
+// line, each of which is answered with "OK" or "ERROR <reason>":
+//
+//   down <slot> <x> <y>   put a finger down
+//   move <slot> <x> <y>   move a finger which is down
+//   up <slot>             lift a finger
+//   tap <x> <y>           down and up with a free finger
+//   key <code> [1|0]      press and/or release a Linux key code
+//   sleep <ms>            answer only after the given time
+//
+// Empty lines and lines starting with '#' are ignored.
+class InputInjector : public std::enable_shared_from_this<InputInjector> {
+ public:
+  static constexpr std::size_t max_fingers{10};
+
+  static std::shared_ptr<InputInjector> create(const std::string &path,
+                                               const std::shared_ptr<Runtime> &rt,
+                                               const std::shared_ptr<input::Device> &touch,
+                                               const std::shared_ptr<input::Device> &keyboard);
+
+  InputInjector(const std::shared_ptr<Runtime> &rt,
+                const std::shared_ptr<input::Device> &touch,
+                const std::shared_ptr<input::Device> &keyboard);
+
+  struct Result {
+    std::string reply;
+    // How long to wait before the reply is sent.
+    std::chrono::milliseconds delay{0};
+  };
+  Result execute(const std::string &command);
+
+ private:
+  typedef boost::asio::local::stream_protocol::socket Socket;
+  class Session;
+
+  std::string finger_down(std::size_t slot, std::int32_t x, std::int32_t y);
+  std::string finger_move(std::size_t slot, std::int32_t x, std::int32_t y);
+  std::string finger_up(std::size_t slot);
+  void select_slot(std::size_t slot, std::vector<input::Event> &events);
+
+  std::shared_ptr<Runtime> runtime_;
+  std::shared_ptr<input::Device> touch_;
+  std::shared_ptr<input::Device> keyboard_;
+  std::shared_ptr<network::PublishedSocketConnector> connector_;
+
+  // Sessions run on any of the runtime's threads.
+  std::mutex mutex_;
+  std::array<bool, max_fingers> fingers_{};
+  int last_slot_ = -1;
+};
+}
+#endif
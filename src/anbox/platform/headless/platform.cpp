@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "anbox/platform/headless/platform.h"
+#include "anbox/audio/null_sink.h"
+#include "anbox/audio/tone_source.h"
+#include "anbox/graphics/emugl/DisplayManager.h"
+#include "anbox/input/device.h"
+#include "anbox/input/manager.h"
+#include "anbox/network/delegate_connection_creator.h"
+#include "anbox/network/fd_socket_transmission.h"
+#include "anbox/system_configuration.h"
+#include "anbox/logger.h"
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+
+#include <stdlib.h>
+#include <sys/stat.h>
+
+namespace fs = boost::filesystem;
+
+namespace {
+const anbox::graphics::Rect default_display_frame{0, 0, 1024, 768};
+}
+
+namespace anbox::platform::headless {
+Platform::Platform(const std::shared_ptr<input::Manager> &input_manager,
+                   const Configuration &config,
+                   const std::shared_ptr<Runtime> &rt) :
+  display_frame_(config.display_frame) {
+  if (!rt)
+    BOOST_THROW_EXCEPTION(std::runtime_error("The headless platform needs a runtime"));
+
+  // Render offscreen without a display server if the EGL implementation
+  // supports it (honored by Mesa).
+  setenv("EGL_PLATFORM", "surfaceless", 0);
+
+  if (display_frame_ == graphics::Rect::Invalid)
+    display_frame_ = default_display_frame;
+  graphics::emugl::DisplayInfo::get()->set_resolution(display_frame_.width(), display_frame_.height());
+
+  keyboard_ = input_manager->create_device();
+  keyboard_->set_name("anbox-keyboard");
+  keyboard_->set_driver_version(1);
+  keyboard_->set_input_id({BUS_VIRTUAL, 3, 3, 3});
+  keyboard_->set_physical_location("none");
+  keyboard_->set_key_bit(BTN_MISC);
+  keyboard_->set_key_bit(KEY_OK);
+
+  touch_ = input_manager->create_device();
+  touch_->set_name("anbox-touch");
+  touch_->set_driver_version(1);
+  touch_->set_input_id({BUS_VIRTUAL, 4, 4, 4});
+  touch_->set_physical_location("none");
+  touch_->set_abs_bit(ABS_MT_SLOT);
+  touch_->set_abs_max(ABS_MT_SLOT, InputInjector::max_fingers - 1);
+  touch_->set_abs_bit(ABS_MT_TOUCH_MAJOR);
+  touch_->set_abs_max(ABS_MT_TOUCH_MAJOR, 127);
+  touch_->set_abs_bit(ABS_MT_TOUCH_MINOR);
+  touch_->set_abs_max(ABS_MT_TOUCH_MINOR, 127);
+  touch_->set_abs_bit(ABS_MT_POSITION_X);
+  touch_->set_abs_max(ABS_MT_POSITION_X, display_frame_.width());
+  touch_->set_abs_bit(ABS_MT_POSITION_Y);
+  touch_->set_abs_max(ABS_MT_POSITION_Y, display_frame_.height());
+  touch_->set_abs_bit(ABS_MT_TRACKING_ID);
+  touch_->set_abs_max(ABS_MT_TRACKING_ID, InputInjector::max_fingers);
+  touch_->set_prop_bit(INPUT_PROP_DIRECT);
+
+  const fs::path dir = SystemConfiguration::instance().headless_dir();
+  fs::create_directories(dir);
+
+  input_injector_ = InputInjector::create((dir / "input").string(), rt, touch_, keyboard_);
+
+  auto delegate_connector = std::make_shared<
+      network::DelegateConnectionCreator<boost::asio::local::stream_protocol>>(
+      [this](std::shared_ptr<Socket> const &socket) { new_frame_consumer(socket); });
+  const auto frames_path = (dir / "frames").string();
+  frames_connector_ = std::make_shared<network::PublishedSocketConnector>(frames_path, rt, delegate_connector);
+  ::chmod(frames_path.c_str(), S_IRUSR | S_IWUSR);
+}
+
+Platform::~Platform() {
+  // Stop accepting consumers before the state they are handled with goes.
+  frames_connector_.reset();
+}
+
+std::shared_ptr<wm::Window> Platform::create_window(
+    const anbox::wm::Task::Id &task, const anbox::graphics::Rect &frame, const std::string &title) {
+  const auto window_frame = frame == graphics::Rect::Invalid ? display_frame_ : frame;
+
+  std::shared_ptr<Window> window;
+  try {
+    window = std::make_shared<Window>(renderer_, task, window_frame, title,
+                                      display_frame_.width(), display_frame_.height());
+  } catch (const std::exception &err) {
+    ERROR("Failed to create window for task %d: %s", task, err.what());
+    return nullptr;
+  }
+
+  std::lock_guard<std::mutex> l(lock_);
+  windows_.erase(std::remove_if(windows_.begin(), windows_.end(),
+                                [](const std::weak_ptr<Window> &w) { return w.expired(); }),
+                 windows_.end());
+  windows_.push_back(window);
+
+  frame_consumers_.erase(std::remove_if(frame_consumers_.begin(), frame_consumers_.end(),
+                                        [&](const std::shared_ptr<Socket> &socket) {
+                                          return !send_exporter(socket, *window);
+                                        }),
+                         frame_consumers_.end());
+  return window;
+}
+
+void Platform::new_frame_consumer(const std::shared_ptr<Socket> &socket) {
+  std::lock_guard<std::mutex> l(lock_);
+  for (const auto &w : windows_) {
+    const auto window = w.lock();
+    if (window && !send_exporter(socket, *window))
+      return;
+  }
+  frame_consumers_.push_back(socket);
+}
+
+bool Platform::send_exporter(const std::shared_ptr<Socket> &socket, const Window &window) {
+  try {
+    send_fds(Fd{IntOwnedFd{socket->native_handle()}}, {window.exporter()->fd()});
+  } catch (const std::exception &err) {
+    DEBUG("Dropping frame consumer: %s", err.what());
+    return false;
+  }
+  return true;
+}
+
+void Platform::set_renderer(const std::shared_ptr<Renderer> &renderer) {
+  renderer_ = renderer;
+}
+
+void Platform::set_window_manager(const std::shared_ptr<wm::Manager> &window_manager) {
+  (void) window_manager;
+}
+
+void Platform::set_clipboard_data(const ClipboardData &data) {
+  std::lock_guard<std::mutex> l(lock_);
+  clipboard_ = data;
+}
+
+Platform::ClipboardData Platform::get_clipboard_data() {
+  std::lock_guard<std::mutex> l(lock_);
+  return clipboard_;
+}
+
+std::shared_ptr<audio::Sink> Platform::create_audio_sink() {
+  return std::make_shared<audio::NullSink>();
+}
+
+std::shared_ptr<audio::Source> Platform::create_audio_source() {
+  // Without a microphone a tone at least lets recording apps be tested.
+  return std::make_shared<audio::ToneSource>();
+}
+
+bool Platform::supports_multi_window() const {
+  return false;
+}
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef ANBOX_PLATFORM_HEADLESS_PLATFORM_H_
+#define ANBOX_PLATFORM_HEADLESS_PLATFORM_H_
+
+#include "anbox/platform/base_platform.h"
+#include "anbox/platform/headless/input_injector.h"
+#include "anbox/platform/headless/window.h"
+#include "anbox/network/published_socket_connector.h"
+#include "anbox/runtime.h"
+
+#include <mutex>
+#include <vector>
+
+class Renderer;
+
+namespace anbox::input {
+  class Device;
+  class Manager;
+}
+
+namespace anbox::platform::headless {
+// Runs a session without any display server, audio device or input
+// hardware, e.g. on CI machines. Windows are rendered offscreen and local
+// consumers get their frames through shared memory: every client of the
+// frames socket in SystemConfiguration::headless_dir() receives the fd of
+// a FrameExportHeader per window, including those created later. Input is
+// injected through the InputInjector socket next to it.
+class Platform : public std::enable_shared_from_this<Platform>,
+                 public platform::BasePlatform {
+ public:
+  Platform(const std::shared_ptr<input::Manager> &input_manager,
+           const Configuration &config,
+           const std::shared_ptr<Runtime> &rt);
+  ~Platform();
+
+  std::shared_ptr<wm::Window> create_window(
+      const anbox::wm::Task::Id &task,
+      const anbox::graphics::Rect &frame,
+      const std::string &title) override;
+
+  void set_renderer(const std::shared_ptr<Renderer> &renderer) override;
+  void set_window_manager(const std::shared_ptr<wm::Manager> &window_manager) override;
+
+  void set_clipboard_data(const ClipboardData &data) override;
+  ClipboardData get_clipboard_data() override;
+
+  std::shared_ptr<audio::Sink> create_audio_sink() override;
+  std::shared_ptr<audio::Source> create_audio_source() override;
+
+  bool supports_multi_window() const override;
+
+ private:
+  typedef boost::asio::local::stream_protocol::socket Socket;
+
+  void new_frame_consumer(const std::shared_ptr<Socket> &socket);
+  bool send_exporter(const std::shared_ptr<Socket> &socket, const Window &window);
+
+  graphics::Rect display_frame_;
+  std::shared_ptr<Renderer> renderer_;
+  std::shared_ptr<input::Device> touch_;
+  std::shared_ptr<input::Device> keyboard_;
+  std::shared_ptr<InputInjector> input_injector_;
+  std::shared_ptr<network::PublishedSocketConnector> frames_connector_;
+
+  std::mutex lock_;
+  std::vector<std::weak_ptr<Window>> windows_;
+  std::vector<std::shared_ptr<Socket>> frame_consumers_;
+  ClipboardData clipboard_;
+};
+}
+#endif
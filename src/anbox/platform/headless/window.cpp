@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "anbox/platform/headless/window.h"
+#include "anbox/graphics/emugl/Renderer.h"
+
+namespace anbox::platform::headless {
+Window::Window(const std::shared_ptr<Renderer> &renderer,
+               const wm::Task::Id &task,
+               const graphics::Rect &frame,
+               const std::string &title,
+               std::uint32_t max_width,
+               std::uint32_t max_height)
+    : wm::Window(renderer, task, frame, title),
+      exporter_(std::make_shared<graphics::FrameExporter>(task, max_width, max_height)) {}
+
+Window::~Window() {
+  // The renderer has to forget about us while native_handle() still
+  // resolves to this class.
+  release();
+  exporter_->close();
+}
+
+bool Window::attach() {
+  if (!renderer_)
+    return false;
+  attached_ = renderer_->createOffscreenWindow(native_handle(), exporter_) != nullptr;
+  return attached_;
+}
+
+EGLNativeWindowType Window::native_handle() const {
+  // Only used as a key by the renderer.
+  return reinterpret_cast<EGLNativeWindowType>(this);
+}
+}
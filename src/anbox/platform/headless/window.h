@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef ANBOX_PLATFORM_HEADLESS_WINDOW_H_
+#define ANBOX_PLATFORM_HEADLESS_WINDOW_H_
+
+#include "anbox/graphics/frame_exporter.h"
+#include "anbox/wm/window.h"
+
+#include <memory>
+
+class Renderer;
+
+namespace anbox::platform::headless {
+// A window without any native surface. The renderer draws it offscreen and
+// publishes its frames through a FrameExporter.
+class Window : public wm::Window {
+ public:
+  // Frames are exported up to max_width x max_height.
+  Window(const std::shared_ptr<Renderer> &renderer,
+         const wm::Task::Id &task,
+         const graphics::Rect &frame,
+         const std::string &title,
+         std::uint32_t max_width,
+         std::uint32_t max_height);
+  ~Window();
+
+  bool attach() override;
+  EGLNativeWindowType native_handle() const override;
+
+  std::shared_ptr<graphics::FrameExporter> exporter() const { return exporter_; }
+
+ private:
+  std::shared_ptr<graphics::FrameExporter> exporter_;
+};
+}
+#endif
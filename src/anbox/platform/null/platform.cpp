@@ -16,6 +16,8 @@
  */
 
 #include "anbox/platform/null/platform.h"
+#include "anbox/audio/null_sink.h"
+#include "anbox/audio/tone_source.h"
 #include "anbox/wm/window.h"
 #include "anbox/logger.h"
 
@@ -49,13 +51,12 @@ NullPlatform::ClipboardData NullPlatform::get_clipboard_data() {
 }
 
 std::shared_ptr<audio::Sink> NullPlatform::create_audio_sink() {
-  ERROR("Not implemented");
-  return nullptr;
+  return std::make_shared<audio::NullSink>();
 }
 
 std::shared_ptr<audio::Source> NullPlatform::create_audio_source() {
-  ERROR("Not implemented");
-  return nullptr;
+  // Without a microphone a tone at least lets recording apps be tested.
+  return std::make_shared<audio::ToneSource>();
 }
 
 void NullPlatform::set_renderer(const std::shared_ptr<Renderer> &renderer) {
@@ -18,42 +18,108 @@
 #include "anbox/platform/sdl/audio_sink.h"
 #include "anbox/logger.h"
 
-#include <stdexcept>
-
-#include <boost/throw_exception.hpp>
+#include <algorithm>
+#include <cstring>
 
 namespace {
-const constexpr size_t max_queue_size{16};
+// Upper bound of input frames converted in one go; keeps the conversion
+// buffers small and lets the device start on the first part of a large
+// write while the rest is still being converted.
+constexpr std::size_t max_chunk_frames{1024};
+
+std::uint16_t period_frames_for(std::uint32_t rate) {
+  const auto wanted = rate * anbox::platform::sdl::AudioSink::device_period.count() / 1000;
+  std::uint16_t frames = 64;
+  while (frames < wanted && frames < 8192)
+    frames *= 2;
+  return frames;
+}
 }
 
 namespace anbox::platform::sdl {
+constexpr std::chrono::milliseconds AudioSink::max_latency;
+constexpr std::chrono::milliseconds AudioSink::device_period;
+
 AudioSink::AudioSink() :
-  device_id_(0),
-  queue_(max_queue_size) {
+  input_format_(audio::default_stream_format),
+  device_id_(0) {
 }
 
-AudioSink::~AudioSink() {}
+AudioSink::~AudioSink() {
+  std::unique_lock<std::mutex> l(lock_);
+  disconnect_audio();
+}
 
 void AudioSink::on_data_requested(void *user_data, std::uint8_t *buffer, int size) {
   auto thiz = static_cast<AudioSink*>(user_data);
   thiz->read_data(buffer, size);
 }
 
+std::uint16_t AudioSink::set_format(const audio::StreamFormat &format) {
+  std::unique_lock<std::mutex> l(lock_);
+  input_format_ = format;
+  partial_size_ = 0;
+
+  if (device_id_ == 0)
+    return connect_audio() ? latency_ms_ : 0;
+
+  try {
+    converter_ = std::make_unique<audio::Converter>(input_format_, converter_->output());
+  } catch (const std::exception &err) {
+    ERROR("Unsupported audio format: %s", err.what());
+    disconnect_audio();
+    return 0;
+  }
+  return latency_ms_;
+}
+
 bool AudioSink::connect_audio() {
   if (device_id_ > 0)
     return true;
 
-  SDL_memset(&spec_, 0, sizeof(spec_));
-  spec_.freq = 44100;
-  spec_.format = AUDIO_S16;
-  spec_.channels = 2;
-  spec_.samples = 1024;
-  spec_.callback = &AudioSink::on_data_requested;
-  spec_.userdata = this;
+  SDL_AudioSpec desired;
+  SDL_memset(&desired, 0, sizeof(desired));
+  desired.freq = static_cast<int>(input_format_.rate);
+  desired.format = input_format_.sample == audio::StreamFormat::Sample::F32 ? AUDIO_F32SYS : AUDIO_S16SYS;
+  desired.channels = input_format_.channels;
+  desired.samples = period_frames_for(input_format_.rate);
+  desired.callback = &AudioSink::on_data_requested;
+  desired.userdata = this;
+
+  // We resample and remix ourselves, so take whatever rate and channel
+  // layout suits the device best instead of having SDL convert behind our
+  // back with an extra buffer.
+  device_id_ = SDL_OpenAudioDevice(nullptr, 0, &desired, &spec_,
+                                   SDL_AUDIO_ALLOW_FREQUENCY_CHANGE | SDL_AUDIO_ALLOW_CHANNELS_CHANGE);
+  if (!device_id_) {
+    DEBUG("Failed to open audio device: %s", SDL_GetError());
+    return false;
+  }
 
-  device_id_ = SDL_OpenAudioDevice(nullptr, 0, &spec_, nullptr, 0);
-  if (!device_id_)
+  const audio::StreamFormat output{static_cast<std::uint32_t>(spec_.freq), spec_.channels,
+                                   input_format_.sample, 0};
+  try {
+    converter_ = std::make_unique<audio::Converter>(input_format_, output);
+  } catch (const std::exception &err) {
+    ERROR("Unsupported audio format: %s", err.what());
+    disconnect_audio();
     return false;
+  }
+
+  // The device takes a period at a time. A frame written while the ring is
+  // full has to wait for as many periods as the ring holds, up to one more
+  // until the next period starts, and one while the device plays it.
+  // Sizing the ring in whole periods keeps that within max_latency.
+  const std::size_t period = spec_.samples;
+  const std::size_t budget = output.rate * max_latency.count() / 1000;
+  const auto periods = std::max<std::size_t>(budget / period, 4) - 2;
+  ring_ = std::make_unique<audio::FrameRing>(audio::frame_size(output), periods * period);
+  prefill_frames_ = (periods - 1) * period;
+  playing_ = false;
+  latency_ms_ = static_cast<std::uint16_t>((periods + 2) * period * 1000 / output.rate);
+
+  DEBUG("Opened audio device: %d Hz, %d channels, %d frames per period, %d ms latency",
+        spec_.freq, static_cast<int>(spec_.channels), spec_.samples, latency_ms_);
 
   SDL_PauseAudioDevice(device_id_, 0);
 
@@ -64,52 +130,113 @@ void AudioSink::disconnect_audio() {
   if (device_id_ == 0)
     return;
 
+  // Waits for a running callback to finish, so the ring can go after it.
   SDL_CloseAudioDevice(device_id_);
   device_id_ = 0;
+  ring_.reset();
+  converter_.reset();
 }
 
 void AudioSink::read_data(std::uint8_t *buffer, int size) {
-  std::unique_lock<std::mutex> l(lock_);
-  const auto wanted = size;
-  int count = 0;
-  auto dst = buffer;
-
-  while (count < wanted) {
-    if (read_buffer_left_ > 0) {
-      size_t avail = std::min<size_t>(wanted - count, read_buffer_left_);
-      memcpy(dst + count,
-             read_buffer_.data() + (read_buffer_.size() - read_buffer_left_),
-             avail);
-      count += avail;
-      read_buffer_left_ -= avail;
-      continue;
+  const auto frames = static_cast<std::size_t>(size) / ring_->frame_size();
+
+  // Start (again) only once the ring is all but full. Playback then stays
+  // that far behind the client, which is the slack that absorbs a client
+  // delivering late; starting right away would underrun on every hiccup.
+  if (!playing_) {
+    if (ring_->size() < prefill_frames_) {
+      std::memset(buffer, 0, static_cast<std::size_t>(size));
+      return;
     }
+    playing_ = true;
+  }
 
-    bool blocking = (count == 0);
-    auto result = -EIO;
-    if (blocking)
-      result = queue_.pop_locked(&read_buffer_, l);
-    else
-      result = queue_.try_pop_locked(&read_buffer_);
+  const auto read = ring_->read(buffer, frames);
+  played_frames_.fetch_add(read, std::memory_order_relaxed);
+  if (read < frames)
+    playing_ = false;
 
-    if (result == 0) {
-      read_buffer_left_ = read_buffer_.size();
-      continue;
-    }
-
-    if (count > 0) break;
+  space_available_.notify_one();
+}
 
+void AudioSink::write_data(const std::uint8_t *data, std::size_t size) {
+  std::unique_lock<std::mutex> l(lock_);
+  if (!connect_audio()) {
+    WARNING("Audio server not connected, skipping %d bytes", size);
     return;
   }
+
+  const auto frame_size = audio::frame_size(input_format_);
+  if (partial_size_ > 0) {
+    const auto n = std::min(frame_size - partial_size_, size);
+    std::memcpy(partial_frame_.data() + partial_size_, data, n);
+    partial_size_ += n;
+    data += n;
+    size -= n;
+    if (partial_size_ < frame_size)
+      return;
+    queue_frames(partial_frame_.data(), 1, l);
+    partial_size_ = 0;
+  }
+
+  const auto frames = size / frame_size;
+  queue_frames(data, frames, l);
+
+  partial_size_ = size - frames * frame_size;
+  std::memcpy(partial_frame_.data(), data + frames * frame_size, partial_size_);
 }
 
-void AudioSink::write_data(const std::vector<std::uint8_t> &data) {
-  std::unique_lock<std::mutex> l(lock_);
-  if (!connect_audio()) {
-    WARNING("Audio server not connected, skipping %d bytes", data.size());
+void AudioSink::queue_frames(const std::uint8_t *data, std::size_t count, std::unique_lock<std::mutex> &lock) {
+  const auto frame_size = audio::frame_size(input_format_);
+
+  if (converter_->passthrough()) {
+    push_frames(data, count, lock);
     return;
   }
-  graphics::Buffer buffer{data.data(), data.data() + data.size()};
-  queue_.push_locked(std::move(buffer), l);
+
+  while (count > 0) {
+    const auto chunk = std::min(count, max_chunk_frames);
+    converted_.resize(converter_->max_output_frames(chunk) * ring_->frame_size());
+    const auto converted = converter_->convert(data, chunk, converted_.data());
+    push_frames(converted_.data(), converted, lock);
+    data += chunk * frame_size;
+    count -= chunk;
+  }
+}
+
+void AudioSink::push_frames(const std::uint8_t *frames, std::size_t count, std::unique_lock<std::mutex> &lock) {
+  // The device frees a period every device_period, so having to wait much
+  // longer than the whole ring takes to drain means it has stalled.
+  const auto deadline = std::chrono::steady_clock::now() + max_latency;
+  for (;;) {
+    const auto written = ring_->write(frames, count);
+    frames += written * ring_->frame_size();
+    count -= written;
+    if (count == 0)
+      return;
+
+    if (std::chrono::steady_clock::now() >= deadline) {
+      ring_->drop(count);
+      return;
+    }
+
+    // The callback doesn't take the lock before notifying, so a wakeup can
+    // be missed; the timeout bounds what that costs.
+    space_available_.wait_for(lock, std::chrono::milliseconds{2});
+  }
+}
+
+AudioSink::Stats AudioSink::stats() const {
+  std::unique_lock<std::mutex> l(lock_);
+  if (!ring_)
+    return Stats{{0, 0, 0, 0}, 0, 0, 0, 0};
+
+  return Stats{
+    ring_->stats(),
+    played_frames_.load(std::memory_order_relaxed),
+    ring_->size(),
+    spec_.samples,
+    static_cast<std::uint32_t>(spec_.freq),
+  };
+}
 }
-}
\ No newline at end of file
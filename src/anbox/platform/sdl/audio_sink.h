@@ -18,33 +18,78 @@
 #ifndef ANBOX_PLATFORM_SDL_AUDIO_SINK_H_
 #define ANBOX_PLATFORM_SDL_AUDIO_SINK_H_
 
+#include "anbox/audio/converter.h"
+#include "anbox/audio/frame_ring.h"
 #include "anbox/audio/sink.h"
-#include "anbox/graphics/buffer_queue.h"
 #include "anbox/platform/sdl/sdl_wrapper.h"
 
-#include <thread>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace anbox::platform::sdl {
+// Plays a single client stream. Incoming data is converted to whatever the
+// device settled on and queued in a lock-free ring the SDL callback reads
+// from, so the callback never blocks. The ring is sized so that data waits
+// no longer than max_latency until the device has played it; when it is full
+// the writer waits for the device to catch up, which pushes back on the
+// client through its socket, and only drops data if the device stalls.
 class AudioSink : public audio::Sink {
  public:
+  static constexpr std::chrono::milliseconds max_latency{40};
+  // Length of one device period we ask SDL for, rounded up to a power of
+  // two number of frames.
+  static constexpr std::chrono::milliseconds device_period{5};
+
+  struct Stats {
+    audio::FrameRing::Stats ring;
+    // Frames handed to the device so far and frames waiting in the ring.
+    std::uint64_t played_frames;
+    std::size_t queued_frames;
+    std::size_t period_frames;
+    std::uint32_t rate;
+  };
+
   AudioSink();
   ~AudioSink();
 
-  void write_data(const std::vector<std::uint8_t> &data) override;
+  std::uint16_t set_format(const audio::StreamFormat &format) override;
+  void write_data(const std::uint8_t *data, std::size_t size) override;
+
+  Stats stats() const;
 
  private:
   bool connect_audio();
   void disconnect_audio();
+  void queue_frames(const std::uint8_t *data, std::size_t count, std::unique_lock<std::mutex> &lock);
+  void push_frames(const std::uint8_t *frames, std::size_t count, std::unique_lock<std::mutex> &lock);
   void read_data(std::uint8_t *buffer, int size);
 
   static void on_data_requested(void *user_data, std::uint8_t *buffer, int size);
 
-  std::mutex lock_;
+  mutable std::mutex lock_;
+  std::condition_variable space_available_;
+  audio::StreamFormat input_format_;
   SDL_AudioSpec spec_;
   SDL_AudioDeviceID device_id_;
-  graphics::BufferQueue queue_;
-  graphics::Buffer read_buffer_;
-  size_t read_buffer_left_ = 0;
+  std::uint16_t latency_ms_ = 0;
+  std::unique_ptr<audio::Converter> converter_;
+  std::unique_ptr<audio::FrameRing> ring_;
+  std::vector<std::uint8_t> converted_;
+  // Clients may split frames across writes; the start of such a frame is
+  // kept here until the rest arrives.
+  std::array<std::uint8_t, 32> partial_frame_;
+  std::size_t partial_size_ = 0;
+
+  // Only touched by the SDL callback, apart from the reset before the
+  // device is opened.
+  bool playing_ = false;
+  std::size_t prefill_frames_ = 0;
+  std::atomic<std::uint64_t> played_frames_{0};
 };
 }
 #endif
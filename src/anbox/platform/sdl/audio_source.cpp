@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "anbox/platform/sdl/audio_source.h"
+#include "anbox/logger.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+// Upper bound of device frames converted in one go.
+constexpr std::size_t max_chunk_frames{1024};
+
+std::uint16_t period_frames_for(std::uint32_t rate) {
+  const auto wanted = rate * anbox::platform::sdl::AudioSource::device_period.count() / 1000;
+  std::uint16_t frames = 64;
+  while (frames < wanted && frames < 8192)
+    frames *= 2;
+  return frames;
+}
+}
+
+namespace anbox::platform::sdl {
+constexpr std::chrono::milliseconds AudioSource::max_buffered;
+constexpr std::chrono::milliseconds AudioSource::device_period;
+
+AudioSource::AudioSource() :
+  format_(audio::default_stream_format),
+  device_id_(0) {
+}
+
+AudioSource::~AudioSource() {
+  std::lock_guard<std::mutex> l(lock_);
+  disconnect_audio();
+}
+
+void AudioSource::on_data_available(void *user_data, std::uint8_t *buffer, int size) {
+  auto thiz = static_cast<AudioSource*>(user_data);
+  thiz->write_data(buffer, size);
+}
+
+void AudioSource::set_format(const audio::StreamFormat &format) {
+  std::lock_guard<std::mutex> l(lock_);
+  format_ = format;
+  converted_.clear();
+  converted_offset_ = 0;
+  if (device_id_ == 0)
+    return;
+
+  try {
+    converter_ = std::make_unique<audio::Converter>(converter_->input(), format_);
+  } catch (const std::exception &err) {
+    ERROR("Unsupported audio format: %s", err.what());
+    disconnect_audio();
+  }
+}
+
+bool AudioSource::connect_audio() {
+  if (device_id_ > 0)
+    return true;
+
+  SDL_AudioSpec desired;
+  SDL_memset(&desired, 0, sizeof(desired));
+  desired.freq = static_cast<int>(format_.rate);
+  desired.format = format_.sample == audio::StreamFormat::Sample::F32 ? AUDIO_F32SYS : AUDIO_S16SYS;
+  desired.channels = format_.channels;
+  desired.samples = period_frames_for(format_.rate);
+  desired.callback = &AudioSource::on_data_available;
+  desired.userdata = this;
+
+  device_id_ = SDL_OpenAudioDevice(nullptr, 1, &desired, &spec_,
+                                   SDL_AUDIO_ALLOW_FREQUENCY_CHANGE | SDL_AUDIO_ALLOW_CHANNELS_CHANGE);
+  if (!device_id_) {
+    DEBUG("Failed to open audio capture device: %s", SDL_GetError());
+    return false;
+  }
+
+  const audio::StreamFormat input{static_cast<std::uint32_t>(spec_.freq), spec_.channels,
+                                  format_.sample, 0};
+  try {
+    converter_ = std::make_unique<audio::Converter>(input, format_);
+  } catch (const std::exception &err) {
+    ERROR("Unsupported audio format: %s", err.what());
+    disconnect_audio();
+    return false;
+  }
+
+  const auto capacity = std::max<std::size_t>(input.rate * max_buffered.count() / 1000, spec_.samples);
+  ring_ = std::make_unique<audio::FrameRing>(audio::frame_size(input), capacity);
+  primed_ = false;
+
+  SDL_PauseAudioDevice(device_id_, 0);
+  return true;
+}
+
+void AudioSource::disconnect_audio() {
+  if (device_id_ == 0)
+    return;
+
+  // Waits for a running callback to finish, so the ring can go after it.
+  SDL_CloseAudioDevice(device_id_);
+  device_id_ = 0;
+  ring_.reset();
+  converter_.reset();
+}
+
+void AudioSource::write_data(const std::uint8_t *buffer, int size) {
+  const auto frames = static_cast<std::size_t>(size) / ring_->frame_size();
+  const auto written = ring_->write(buffer, frames);
+  ring_->drop(frames - written);
+}
+
+void AudioSource::read_data(std::vector<std::uint8_t> &data) {
+  std::lock_guard<std::mutex> l(lock_);
+  if (!connect_audio()) {
+    std::fill(data.begin(), data.end(), 0);
+    return;
+  }
+
+  const auto frame_size = audio::frame_size(format_);
+  const auto wanted = data.size() / frame_size * frame_size;
+
+  if (!primed_)
+    primed_ = ring_->size() >= spec_.samples;
+
+  std::size_t filled = 0;
+  while (primed_ && filled < wanted) {
+    if (converted_offset_ == converted_.size()) {
+      const auto available = std::min(ring_->size(), max_chunk_frames);
+      if (available == 0) {
+        primed_ = false;
+        break;
+      }
+
+      recorded_.resize(available * ring_->frame_size());
+      ring_->read(recorded_.data(), available);
+      converted_.resize(converter_->max_output_frames(available) * frame_size);
+      const auto converted = converter_->convert(recorded_.data(), available, converted_.data());
+      converted_.resize(converted * frame_size);
+      converted_offset_ = 0;
+      continue;
+    }
+
+    const auto n = std::min(wanted - filled, converted_.size() - converted_offset_);
+    std::memcpy(data.data() + filled, converted_.data() + converted_offset_, n);
+    filled += n;
+    converted_offset_ += n;
+  }
+
+  std::fill(data.begin() + static_cast<std::ptrdiff_t>(filled), data.end(), 0);
+}
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef ANBOX_PLATFORM_SDL_AUDIO_SOURCE_H_
+#define ANBOX_PLATFORM_SDL_AUDIO_SOURCE_H_
+
+#include "anbox/audio/converter.h"
+#include "anbox/audio/frame_ring.h"
+#include "anbox/audio/source.h"
+#include "anbox/platform/sdl/sdl_wrapper.h"
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace anbox::platform::sdl {
+// Records from the default capture device. The SDL callback queues what
+// the device delivers in a lock-free ring without ever blocking, and
+// read_data() converts it to the format the client wants. When the client
+// falls behind by more than max_buffered the newest audio is dropped;
+// when the device is late the client gets silence.
+class AudioSource : public audio::Source {
+ public:
+  static constexpr std::chrono::milliseconds max_buffered{200};
+  // Length of one device period we ask SDL for, rounded up to a power of
+  // two number of frames.
+  static constexpr std::chrono::milliseconds device_period{10};
+
+  AudioSource();
+  ~AudioSource();
+
+  void set_format(const audio::StreamFormat &format) override;
+  void read_data(std::vector<std::uint8_t> &data) override;
+
+ private:
+  bool connect_audio();
+  void disconnect_audio();
+  void write_data(const std::uint8_t *buffer, int size);
+
+  static void on_data_available(void *user_data, std::uint8_t *buffer, int size);
+
+  std::mutex lock_;
+  audio::StreamFormat format_;
+  SDL_AudioSpec spec_;
+  SDL_AudioDeviceID device_id_;
+  std::unique_ptr<audio::Converter> converter_;
+  std::unique_ptr<audio::FrameRing> ring_;
+  // Whether we hand out recorded audio; only once a device period is
+  // queued, so a device delivering a bit late doesn't cause a gap each time.
+  bool primed_ = false;
+  std::vector<std::uint8_t> recorded_;
+  std::vector<std::uint8_t> converted_;
+  std::size_t converted_offset_ = 0;
+};
+}
+#endif
@@ -24,6 +24,7 @@
 #include "anbox/platform/sdl/keycode_converter.h"
 #include "anbox/platform/sdl/window.h"
 #include "anbox/platform/sdl/audio_sink.h"
+#include "anbox/platform/sdl/audio_source.h"
 #include "anbox/wm/manager.h"
 
 #include <boost/throw_exception.hpp>
@@ -161,47 +162,65 @@ void Platform::process_events() {
 
   while (event_thread_running_) {
     SDL_Event event;
-    while (SDL_WaitEventTimeout(&event, 100)) {
-      switch (event.type) {
-        case SDL_QUIT:
-          video_has_been_closed_ = true;
-          DEBUG("SDL_QUIT");
-          break;
-        case SDL_WINDOWEVENT:
-          for (auto &iter : windows_) {
-            if (auto w = iter.second.lock()) {
-              if (w->window_id() == event.window.windowID) {
-                w->process_event(event);
-                break;
-              }
-            }
+    if (!SDL_WaitEventTimeout(&event, 100))
+      continue;
+
+    // Handle everything that piled up before sending any input so motion
+    // arriving faster than we run here goes out in one batch per device.
+    do {
+      process_event(event);
+    } while (SDL_PollEvent(&event));
+
+    for (const auto &device : {pointer_, keyboard_, touch_}) {
+      if (device)
+        device->flush();
+    }
+  }
+}
+
+void Platform::process_event(const SDL_Event &event) {
+  switch (event.type) {
+    case SDL_QUIT:
+      video_has_been_closed_ = true;
+      DEBUG("SDL_QUIT");
+      break;
+    case SDL_WINDOWEVENT:
+      for (auto &iter : windows_) {
+        if (auto w = iter.second.lock()) {
+          if (w->window_id() == event.window.windowID) {
+            w->process_event(event);
+            break;
           }
-          break;
-        case SDL_KEYDOWN:
-        case SDL_KEYUP:
-          if (keyboard_)
-            process_input_event(event);
-          break;
-        case SDL_MOUSEMOTION:
-        case SDL_MOUSEBUTTONDOWN:
-        case SDL_MOUSEBUTTONUP:
-        case SDL_MOUSEWHEEL:
-        case SDL_FINGERDOWN:
-        case SDL_FINGERUP:
-        case SDL_FINGERMOTION:
-          process_input_event(event);
-          break;
-        default:
-          break;
+        }
       }
-    }
+      break;
+    case SDL_KEYDOWN:
+    case SDL_KEYUP:
+      if (keyboard_)
+        process_input_event(event);
+      break;
+    case SDL_MOUSEMOTION:
+    case SDL_MOUSEBUTTONDOWN:
+    case SDL_MOUSEBUTTONUP:
+    case SDL_MOUSEWHEEL:
+    case SDL_FINGERDOWN:
+    case SDL_FINGERUP:
+    case SDL_FINGERMOTION:
+      process_input_event(event);
+      break;
+    default:
+      break;
   }
 }
 
 void Platform::process_input_event(const SDL_Event &event) {
-  std::vector<input::Event> mouse_events;
-  std::vector<input::Event> keyboard_events;
-  std::vector<input::Event> touch_events;
+  // Reused for every event; they keep their capacity.
+  auto &mouse_events = mouse_events_;
+  auto &keyboard_events = keyboard_events_;
+  auto &touch_events = touch_events_;
+  mouse_events.clear();
+  keyboard_events.clear();
+  touch_events.clear();
 
   std::int32_t x = 0;
   std::int32_t y = 0;
@@ -297,14 +316,14 @@ void Platform::process_input_event(const SDL_Event &event) {
 
   if (mouse_events.size() > 0) {
     mouse_events.push_back({EV_SYN, SYN_REPORT, 0});      
-    pointer_->send_events(mouse_events);
+    pointer_->queue_events(mouse_events);
   }
 
   if (keyboard_events.size() > 0)
-    keyboard_->send_events(keyboard_events);
+    keyboard_->queue_events(keyboard_events);
 
   if (touch_events.size() > 0)
-    touch_->send_events(touch_events);
+    touch_->queue_events(touch_events);
 }
 
 int Platform::find_touch_slot(int id){
@@ -520,8 +539,7 @@ std::shared_ptr<audio::Sink> Platform::create_audio_sink() {
 }
 
 std::shared_ptr<audio::Source> Platform::create_audio_source() {
-  ERROR("Not implemented");
-  return nullptr;
+  return std::make_shared<AudioSource>();
 }
 
 bool Platform::supports_multi_window() const {
@@ -72,6 +72,7 @@ class Platform : public std::enable_shared_from_this<Platform>,
 
  private:
   void process_events();
+  void process_event(const SDL_Event &event);
   void process_input_event(const SDL_Event &event);
 
   bool adjust_coordinates(std::int32_t &x, std::int32_t &y);
@@ -94,6 +95,9 @@ class Platform : public std::enable_shared_from_this<Platform>,
   std::shared_ptr<input::Device> pointer_;
   std::shared_ptr<input::Device> keyboard_;
   std::shared_ptr<input::Device> touch_;
+  std::vector<input::Event> mouse_events_;
+  std::vector<input::Event> keyboard_events_;
+  std::vector<input::Event> touch_events_;
   graphics::Rect display_frame_;
   bool window_size_immutable_ = false;
   std::uint32_t focused_sdl_window_id_ = 0;
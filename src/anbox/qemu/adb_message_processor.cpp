@@ -19,6 +19,7 @@
 #include "anbox/network/delegate_connection_creator.h"
 #include "anbox/network/delegate_message_processor.h"
 #include "anbox/network/tcp_socket_messenger.h"
+#include "anbox/logger.h"
 #include "anbox/utils.h"
 
 #include <fstream>
@@ -48,17 +49,22 @@ std::mutex AdbMessageProcessor::active_instance_{};
 
 AdbMessageProcessor::AdbMessageProcessor(
     const std::shared_ptr<Runtime> &rt,
-    const std::shared_ptr<network::SocketMessenger> &messenger)
+    const std::shared_ptr<network::SocketMessenger> &messenger,
+    const std::shared_ptr<boost::asio::local::stream_protocol::socket> &socket)
     : runtime_(rt),
       state_(waiting_for_guest_accept_command),
       expected_command_(accept_command),
       messenger_(messenger),
+      socket_(socket),
       lock_(active_instance_, std::defer_lock) {
 }
 
 AdbMessageProcessor::~AdbMessageProcessor() {
   state_ = closed_by_host;
 
+  if (proxy_)
+    proxy_->stop();
+
   host_connector_.reset();
 }
 
@@ -85,8 +91,9 @@ void AdbMessageProcessor::advance_state() {
       expected_command_ = start_command;
       break;
     case waiting_for_guest_start_command:
+      // Our SocketConnection hands the pipe over to start_proxy() once it
+      // sees us in this state.
       state_ = proxying_data;
-      read_next_host_message();
       break;
     case proxying_data:
       break;
@@ -134,6 +141,7 @@ void AdbMessageProcessor::wait_for_host_connection() {
 }
 
 void AdbMessageProcessor::on_host_connection(std::shared_ptr<boost::asio::basic_stream_socket<boost::asio::ip::tcp>> const &socket) {
+  host_socket_ = socket;
   host_messenger_ = std::make_shared<network::TcpSocketMessenger>(socket);
 
   // set_no_delay() reduces the latency of sending data, at the cost
@@ -151,53 +159,51 @@ void AdbMessageProcessor::on_host_connection(std::shared_ptr<boost::asio::basic_
   expected_command_ = start_command;
 }
 
-void AdbMessageProcessor::read_next_host_message() {
-  auto callback = std::bind(&AdbMessageProcessor::on_host_read_size, this, _1, _2);
-  host_messenger_->async_receive_msg(callback, boost::asio::buffer(host_buffer_));
-}
+void AdbMessageProcessor::start_proxy(const std::function<void()> &closed) {
+  // Whatever adbd sent right behind the start command has to reach the host
+  // before the proxy takes over.
+  if (!buffer_.empty()) {
+    std::string pending(buffer_.size(), '\0');
+    buffer_.copy(&pending[0], pending.size());
+    buffer_.consume(pending.size());
+    host_messenger_->send(pending.data(), pending.size());
+  }
 
-void AdbMessageProcessor::on_host_read_size(const boost::system::error_code &error, std::size_t bytes_read) {
-  if (error) {
-    // When AdbMessageProcessor is destroyed on program termination, the sockets
-    // are closed and the standing operations are canceled. But, the callback is
-    // still called even in that case, and the object has already been
-    // deleted. We detect that condition by looking at the error code and avoid
-    // touching *this in that case.
-    if (error == boost::system::errc::operation_canceled)
-      return;
-
-    // For other errors, we assume the connection with the host is dropped. We
-    // close the connection to the container's adbd, which will trigger the
-    // deletion of this AdbMessageProcessor instance and free resources (most
-    // importantly, default_host_listen_port and the lock). The standing
-    // connection that adbd opened can then proceed and wait for the host to be
-    // up again.
-    state_ = closed_by_host;
+  try {
+    proxy_ = std::make_shared<network::SpliceProxy<boost::asio::local::stream_protocol,
+                                                   boost::asio::ip::tcp>>(runtime_, socket_, host_socket_);
+  } catch (const std::exception &err) {
+    ERROR("Failed to set up adb proxy: %s", err.what());
     messenger_->close();
+    closed();
     return;
   }
 
-  messenger_->send(reinterpret_cast<const char *>(host_buffer_.data()), bytes_read);
-  read_next_host_message();
+  // Once either side is gone we close the pipe to the container's adbd which
+  // then gets this processor deleted and frees default_host_listen_port and
+  // the lock. The standing connection that adbd opened can then proceed and
+  // wait for the host to be up again. The handler must not touch *this as
+  // the proxy may outlive us.
+  auto messenger = messenger_;
+  proxy_->start([messenger, closed](const boost::system::error_code &) {
+    messenger->close();
+    closed();
+  });
 }
 
-bool AdbMessageProcessor::process_data(const std::vector<std::uint8_t> &data) {
-  if (state_ == proxying_data) {
-    host_messenger_->send(reinterpret_cast<const char *>(data.data()),
-                          data.size());
-    return true;
-  }
-
-  for (const auto &byte : data) buffer_.push_back(byte);
+bool AdbMessageProcessor::process_data(network::ReceiveBuffer &&buffer) {
+  buffer_.append(std::move(buffer));
 
   if (expected_command_.size() > 0 &&
       buffer_.size() >= expected_command_.size()) {
-    if (::memcmp(buffer_.data(), expected_command_.data(), data.size()) != 0) {
+    std::string command(expected_command_.size(), '\0');
+    buffer_.copy(&command[0], command.size());
+    if (command != expected_command_) {
       // We got not the command we expected and will terminate here
       return false;
     }
 
-    buffer_.erase(buffer_.begin(), buffer_.begin() + expected_command_.size());
+    buffer_.consume(expected_command_.size());
     expected_command_.clear();
 
     advance_state();
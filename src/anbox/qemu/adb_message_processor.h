@@ -21,12 +21,14 @@
 #include "anbox/network/message_processor.h"
 #include "anbox/network/socket_connection.h"
 #include "anbox/network/socket_messenger.h"
+#include "anbox/network/splice_proxy.h"
 #include "anbox/network/tcp_socket_connector.h"
 #include "anbox/network/tcp_socket_messenger.h"
 #include "anbox/runtime.h"
 
 #include <boost/asio.hpp>
 
+#include <functional>
 #include <mutex>
 
 namespace anbox {
@@ -35,10 +37,21 @@ class AdbMessageProcessor : public network::MessageProcessor {
  public:
   AdbMessageProcessor(
       const std::shared_ptr<Runtime> &rt,
-      const std::shared_ptr<network::SocketMessenger> &messenger);
+      const std::shared_ptr<network::SocketMessenger> &messenger,
+      const std::shared_ptr<boost::asio::local::stream_protocol::socket> &socket);
   ~AdbMessageProcessor();
 
-  bool process_data(const std::vector<std::uint8_t> &data) override;
+  bool process_data(network::ReceiveBuffer &&buffer) override;
+
+  // Whether adbd started its session and the data should be forwarded
+  // through start_proxy() from now on.
+  bool proxying() const { return state_ == proxying_data; }
+
+  // Forwards all further data between the pipe and the adb host connection
+  // without it passing through the pipe's SocketConnection, which must not
+  // read from the pipe anymore. closed is called once either side went
+  // away and the pipe was closed.
+  void start_proxy(const std::function<void()> &closed);
 
  private:
   enum State {
@@ -55,18 +68,18 @@ class AdbMessageProcessor : public network::MessageProcessor {
   void wait_for_host_connection();
   void on_host_connection(std::shared_ptr<boost::asio::basic_stream_socket<
                               boost::asio::ip::tcp>> const &socket);
-  void read_next_host_message();
-  void on_host_read_size(const boost::system::error_code &error,
-                         std::size_t bytes_read);
 
   std::shared_ptr<Runtime> runtime_;
   State state_ = waiting_for_guest_accept_command;
   std::string expected_command_;
   std::shared_ptr<network::SocketMessenger> const messenger_;
-  std::vector<std::uint8_t> buffer_;
+  std::shared_ptr<boost::asio::local::stream_protocol::socket> const socket_;
+  network::ReceiveBufferChain buffer_;
   std::shared_ptr<network::TcpSocketConnector> host_connector_;
   std::shared_ptr<network::TcpSocketMessenger> host_messenger_;
-  std::array<std::uint8_t, 8192> host_buffer_;
+  std::shared_ptr<boost::asio::ip::tcp::socket> host_socket_;
+  std::shared_ptr<network::SpliceProxy<boost::asio::local::stream_protocol,
+                                       boost::asio::ip::tcp>> proxy_;
   std::unique_lock<std::mutex> lock_;
 
   static std::mutex active_instance_;
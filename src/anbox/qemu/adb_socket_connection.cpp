@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "anbox/qemu/adb_socket_connection.h"
+
+namespace anbox::qemu {
+AdbSocketConnection::AdbSocketConnection(
+    std::shared_ptr<network::MessageReceiver> const& message_receiver,
+    std::shared_ptr<network::MessageSender> const& message_sender, int id,
+    std::shared_ptr<network::Connections<network::SocketConnection>> const& connections,
+    std::shared_ptr<AdbMessageProcessor> const& processor)
+    : SocketConnection(message_receiver, message_sender, id, connections, processor),
+      adb_processor_(processor) {}
+
+void AdbSocketConnection::read_next_message() {
+  if (!adb_processor_->proxying()) {
+    SocketConnection::read_next_message();
+    return;
+  }
+
+  // The proxy may report the end of the session after we're gone already.
+  const auto connections = connections_;
+  const auto connection_id = id();
+  adb_processor_->start_proxy([connections, connection_id]() {
+    connections->remove(connection_id);
+  });
+}
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef ANBOX_QEMU_ADB_SOCKET_CONNECTION_H_
+#define ANBOX_QEMU_ADB_SOCKET_CONNECTION_H_
+
+#include "anbox/network/connections.h"
+#include "anbox/network/message_receiver.h"
+#include "anbox/network/message_sender.h"
+#include "anbox/network/socket_connection.h"
+#include "anbox/qemu/adb_message_processor.h"
+
+namespace anbox::qemu {
+// Reads the adb pipe like any other qemud pipe until adbd started its
+// session and hands the pipe over to the processor's proxy afterwards.
+class AdbSocketConnection : public network::SocketConnection {
+ public:
+  AdbSocketConnection(
+      std::shared_ptr<network::MessageReceiver> const& message_receiver,
+      std::shared_ptr<network::MessageSender> const& message_sender, int id,
+      std::shared_ptr<network::Connections<network::SocketConnection>> const& connections,
+      std::shared_ptr<AdbMessageProcessor> const& processor);
+
+  void read_next_message() override;
+
+ private:
+  std::shared_ptr<AdbMessageProcessor> const adb_processor_;
+};
+}
+
+#endif
@@ -25,9 +25,8 @@ CameraMessageProcessor::CameraMessageProcessor(
 
 CameraMessageProcessor::~CameraMessageProcessor() {}
 
-bool CameraMessageProcessor::process_data(
-    const std::vector<std::uint8_t> &data) {
-  for (const auto &byte : data) buffer_.push_back(byte);
+bool CameraMessageProcessor::process_data(network::ReceiveBuffer &&buffer) {
+  buffer_.append(std::move(buffer));
 
   process_commands();
 
@@ -36,15 +35,14 @@ bool CameraMessageProcessor::process_data(
 
 void CameraMessageProcessor::process_commands() {
   while (buffer_.size() > 0) {
-    size_t size = 0;
-    while (size < buffer_.size()) {
-      if (buffer_.at(size) == 0x0) break;
-      size++;
-    }
-
-    std::string command;
-    command.insert(0, reinterpret_cast<const char *>(buffer_.data()), size);
-    buffer_.erase(buffer_.begin(), buffer_.begin() + size + 1);
+    // Commands are terminated by a null byte, wait for the rest of one
+    // which didn't arrive completely yet.
+    const auto size = buffer_.find(0x0);
+    if (size == network::ReceiveBufferChain::npos) break;
+
+    std::string command(size, '\0');
+    buffer_.copy(&command[0], size);
+    buffer_.consume(size + 1);
 
     handle_command(command);
   }
@@ -29,7 +29,7 @@ class CameraMessageProcessor : public network::MessageProcessor {
       const std::shared_ptr<network::SocketMessenger> &messenger);
   ~CameraMessageProcessor();
 
-  bool process_data(const std::vector<std::uint8_t> &data) override;
+  bool process_data(network::ReceiveBuffer &&buffer) override;
 
  private:
   void process_commands();
@@ -38,7 +38,7 @@ class CameraMessageProcessor : public network::MessageProcessor {
   void list();
 
   std::shared_ptr<network::SocketMessenger> messenger_;
-  std::vector<std::uint8_t> buffer_;
+  network::ReceiveBufferChain buffer_;
 };
 }  // namespace graphics
 }  // namespace anbox
@@ -33,8 +33,8 @@ GpsMessageProcessor::~GpsMessageProcessor() {
   gps_info_broker_->newNmeaSentence.disconnect(connection_);
 }
 
-bool GpsMessageProcessor::process_data(const std::vector<std::uint8_t> &data) {
-  ERROR("Got unexpected GPS data: " + std::to_string(data.size()));
+bool GpsMessageProcessor::process_data(network::ReceiveBuffer &&buffer) {
+  ERROR("Got unexpected GPS data: " + std::to_string(buffer.size()));
   return true;
 }
 }
\ No newline at end of file
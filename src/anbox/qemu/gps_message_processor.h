@@ -28,7 +28,7 @@ class GpsMessageProcessor : public network::MessageProcessor {
   GpsMessageProcessor(const std::shared_ptr<network::SocketMessenger> &messenger, const std::shared_ptr<anbox::application::GpsInfoBroker> &gpsInfoBroker);
   ~GpsMessageProcessor();
 
-  bool process_data(const std::vector<std::uint8_t> &data) override;
+  bool process_data(network::ReceiveBuffer &&buffer) override;
 
  private:
   std::shared_ptr<network::SocketMessenger> messenger_;
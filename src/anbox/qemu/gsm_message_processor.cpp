@@ -57,8 +57,8 @@ GsmMessageProcessor::GsmMessageProcessor(
 
 GsmMessageProcessor::~GsmMessageProcessor() {}
 
-bool GsmMessageProcessor::process_data(const std::vector<std::uint8_t> &data) {
-  for (const auto &byte : data) buffer_.push_back(byte);
+bool GsmMessageProcessor::process_data(network::ReceiveBuffer &&buffer) {
+  buffer_.insert(buffer_.end(), buffer.begin(), buffer.end());
 
   parser_->process_data(buffer_);
   return true;
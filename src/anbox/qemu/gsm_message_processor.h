@@ -30,7 +30,7 @@ class GsmMessageProcessor : public network::MessageProcessor {
       const std::shared_ptr<network::SocketMessenger> &messenger);
   ~GsmMessageProcessor();
 
-  bool process_data(const std::vector<std::uint8_t> &data) override;
+  bool process_data(network::ReceiveBuffer &&buffer) override;
 
  private:
   enum class technology {
@@ -26,8 +26,8 @@ NullMessageProcessor::NullMessageProcessor() {}
 
 NullMessageProcessor::~NullMessageProcessor() {}
 
-bool NullMessageProcessor::process_data(const std::vector<std::uint8_t> &data) {
-  (void)data;
+bool NullMessageProcessor::process_data(network::ReceiveBuffer &&buffer) {
+  (void)buffer;
   return true;
 }
 }
\ No newline at end of file
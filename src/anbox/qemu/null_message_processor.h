@@ -27,7 +27,7 @@ class NullMessageProcessor : public network::MessageProcessor {
   NullMessageProcessor();
   ~NullMessageProcessor();
 
-  bool process_data(const std::vector<std::uint8_t> &data) override;
+  bool process_data(network::ReceiveBuffer &&buffer) override;
 };
 }  // namespace graphics
 }  // namespace anbox
@@ -22,6 +22,7 @@
 #include "anbox/logger.h"
 #include "anbox/network/local_socket_messenger.h"
 #include "anbox/qemu/adb_message_processor.h"
+#include "anbox/qemu/adb_socket_connection.h"
 #include "anbox/qemu/boot_properties_message_processor.h"
 #include "anbox/qemu/bootanimation_message_processor.h"
 #include "anbox/qemu/camera_message_processor.h"
@@ -68,12 +69,15 @@ std::string client_type_to_string(
 }
 }
 namespace anbox::qemu {
-PipeConnectionCreator::PipeConnectionCreator(std::shared_ptr<Renderer> renderer, std::shared_ptr<Runtime> rt, std::shared_ptr<anbox::application::SensorsState> sensors_state, std::shared_ptr<anbox::application::GpsInfoBroker> gpsInfoBroker)
+PipeConnectionCreator::PipeConnectionCreator(std::shared_ptr<Renderer> renderer, std::shared_ptr<Runtime> rt, std::shared_ptr<anbox::application::SensorsState> sensors_state, std::shared_ptr<anbox::application::GpsInfoBroker> gpsInfoBroker,
+                                             const std::string &gl_capture_dir)
     : renderer_(renderer),
       runtime_(rt),
-      sensors_state_(sensors_state),
+      sensors_hub_(std::make_shared<SensorsHub>(rt, sensors_state)),
       gps_info_broker_(gpsInfoBroker),
       next_connection_id_(0),
+      gl_capture_dir_(gl_capture_dir),
+      next_capture_id_(0),
       connections_(
           std::make_shared<network::Connections<network::SocketConnection>>()) {
 }
@@ -87,14 +91,19 @@ void PipeConnectionCreator::create_connection_for(
         &socket) {
   auto const messenger = std::make_shared<network::LocalSocketMessenger>(socket);
   const auto type = identify_client(messenger);
-  auto const processor = create_processor(type, messenger);
+  auto const processor = create_processor(type, messenger, socket);
   if (!processor)
     BOOST_THROW_EXCEPTION(std::runtime_error("Unhandled client type"));
 
   std::shared_ptr<network::SocketConnection> connection;
   if (type == client_type::opengles)
     connection = std::make_shared<graphics::OpenGlesSocketConnection>(
-        messenger, messenger, next_id(), connections_, processor);
+        messenger, messenger, next_id(), connections_,
+        std::static_pointer_cast<graphics::OpenGlesMessageProcessor>(processor));
+  else if (type == client_type::qemud_adb)
+    connection = std::make_shared<AdbSocketConnection>(
+        messenger, messenger, next_id(), connections_,
+        std::static_pointer_cast<AdbMessageProcessor>(processor));
   else
     connection = std::make_shared<network::SocketConnection>(
         messenger, messenger, next_id(), connections_, processor);
@@ -152,15 +161,21 @@ PipeConnectionCreator::client_type PipeConnectionCreator::identify_client(
 std::shared_ptr<network::MessageProcessor>
 PipeConnectionCreator::create_processor(
     const client_type &type,
-    const std::shared_ptr<network::SocketMessenger> &messenger) {
-  if (type == client_type::opengles)
-    return std::make_shared<graphics::OpenGlesMessageProcessor>(renderer_, messenger);
+    const std::shared_ptr<network::SocketMessenger> &messenger,
+    const std::shared_ptr<boost::asio::local::stream_protocol::socket> &socket) {
+  if (type == client_type::opengles) {
+    std::string capture_path;
+    if (!gl_capture_dir_.empty())
+      capture_path = utils::string_format("%s/opengles-%d.glcap", gl_capture_dir_,
+                                          next_capture_id_.fetch_add(1));
+    return std::make_shared<graphics::OpenGlesMessageProcessor>(renderer_, messenger, capture_path);
+  }
   else if (type == client_type::qemud_boot_properties)
     return std::make_shared<qemu::BootPropertiesMessageProcessor>(messenger);
   else if (type == client_type::qemud_hw_control)
     return std::make_shared<qemu::HwControlMessageProcessor>(messenger);
   else if (type == client_type::qemud_sensors)
-    return std::make_shared<qemu::SensorsMessageProcessor>(messenger, sensors_state_);
+    return std::make_shared<qemu::SensorsMessageProcessor>(messenger, sensors_hub_);
   else if (type == client_type::qemud_camera)
     return std::make_shared<qemu::CameraMessageProcessor>(messenger);
   else if (type == client_type::qemud_fingerprint)
@@ -168,7 +183,7 @@ PipeConnectionCreator::create_processor(
   else if (type == client_type::qemud_gsm)
     return std::make_shared<qemu::GsmMessageProcessor>(messenger);
   else if (type == client_type::qemud_adb)
-    return std::make_shared<qemu::AdbMessageProcessor>(runtime_, messenger);
+    return std::make_shared<qemu::AdbMessageProcessor>(runtime_, messenger, socket);
   else if (type == client_type::qemud_gps)
     return std::make_shared<qemu::GpsMessageProcessor>(messenger, gps_info_broker_);
 
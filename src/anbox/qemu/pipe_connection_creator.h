@@ -21,6 +21,7 @@
 #include <boost/asio.hpp>
 
 #include <memory>
+#include <string>
 
 #include "anbox/application/sensors_state.h"
 #include "anbox/application/gps_info_broker.h"
@@ -29,6 +30,7 @@
 #include "anbox/network/connections.h"
 #include "anbox/network/socket_connection.h"
 #include "anbox/network/socket_messenger.h"
+#include "anbox/qemu/sensors_hub.h"
 #include "anbox/runtime.h"
 
 class Renderer;
@@ -37,7 +39,8 @@ namespace anbox::qemu {
 class PipeConnectionCreator
     : public network::ConnectionCreator<boost::asio::local::stream_protocol> {
  public:
-  PipeConnectionCreator(std::shared_ptr<Renderer> renderer, std::shared_ptr<Runtime> rt, std::shared_ptr<anbox::application::SensorsState> ss, std::shared_ptr<anbox::application::GpsInfoBroker> gpsInfoBroker);
+  PipeConnectionCreator(std::shared_ptr<Renderer> renderer, std::shared_ptr<Runtime> rt, std::shared_ptr<anbox::application::SensorsState> ss, std::shared_ptr<anbox::application::GpsInfoBroker> gpsInfoBroker,
+                        const std::string &gl_capture_dir = "");
   ~PipeConnectionCreator() noexcept;
 
   void create_connection_for(
@@ -65,13 +68,17 @@ class PipeConnectionCreator
       std::shared_ptr<network::SocketMessenger> const &messenger);
   std::shared_ptr<network::MessageProcessor> create_processor(
       const client_type &type,
-      const std::shared_ptr<network::SocketMessenger> &messenger);
+      const std::shared_ptr<network::SocketMessenger> &messenger,
+      const std::shared_ptr<boost::asio::local::stream_protocol::socket> &socket);
 
   std::shared_ptr<Renderer> renderer_;
   std::shared_ptr<Runtime> runtime_;
-  std::shared_ptr<application::SensorsState> sensors_state_;
+  std::shared_ptr<SensorsHub> sensors_hub_;
   std::shared_ptr<application::GpsInfoBroker> gps_info_broker_;
   std::atomic<int> next_connection_id_;
+  // Records every opengles connection into this directory if not empty.
+  std::string gl_capture_dir_;
+  std::atomic<int> next_capture_id_;
   std::shared_ptr<network::Connections<network::SocketConnection>> const connections_;
 };
 }
@@ -32,10 +32,8 @@ QemudMessageProcessor::QemudMessageProcessor(
 
 QemudMessageProcessor::~QemudMessageProcessor() {}
 
-bool QemudMessageProcessor::process_data(const std::vector<std::uint8_t> &data) {
-  for (const auto &byte : data)
-    buffer_.push_back(byte);
-
+bool QemudMessageProcessor::process_data(network::ReceiveBuffer &&buffer) {
+  buffer_.append(std::move(buffer));
   return process_commands();
 }
 
@@ -44,8 +42,8 @@ bool QemudMessageProcessor::process_commands() {
     if (buffer_.size() < header_size)
       break;
 
-    char header[header_size] = {0};
-    ::memcpy(header, buffer_.data(), header_size);
+    char header[header_size + 1] = {0};
+    buffer_.copy(header, header_size);
 
     unsigned int body_size = 0;
     ::sscanf(header, "%04x", &body_size);
@@ -56,20 +54,11 @@ bool QemudMessageProcessor::process_commands() {
     if (buffer_.size() < total_size)
       break;
 
-    std::string command;
-    // Make sure we only copy as much bytes as we have to and not more
-    command.insert(0,
-                   reinterpret_cast<const char *>(buffer_.data()) + header_size,
-                   body_size);
+    std::string command(body_size, '\0');
+    buffer_.copy(&command[0], body_size, header_size);
+    buffer_.consume(total_size);
 
     handle_command(command);
-
-    const auto consumed = header_size + body_size;
-    buffer_.erase(buffer_.begin(), buffer_.begin() + consumed);
-
-    const auto remaining = buffer_.size() - consumed;
-    if (remaining <= 0)
-      break;
   }
 
   return true;
@@ -29,7 +29,7 @@ class QemudMessageProcessor : public network::MessageProcessor {
       const std::shared_ptr<network::SocketMessenger> &messenger);
   ~QemudMessageProcessor();
 
-  bool process_data(const std::vector<std::uint8_t> &data) override;
+  bool process_data(network::ReceiveBuffer &&buffer) override;
 
  protected:
   virtual void handle_command(const std::string &command) = 0;
@@ -42,7 +42,7 @@ class QemudMessageProcessor : public network::MessageProcessor {
  private:
   bool process_commands();
 
-  std::vector<std::uint8_t> buffer_;
+  network::ReceiveBufferChain buffer_;
 };
 }  // namespace graphics
 }  // namespace anbox
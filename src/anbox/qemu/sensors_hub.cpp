@@ -0,0 +1,281 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "anbox/qemu/sensors_hub.h"
+#include "anbox/application/sensor_type.h"
+#include "anbox/logger.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+#include <sys/time.h>
+
+namespace {
+// Enough for every sensor with the longest values %g prints plus sync.
+constexpr std::size_t max_messages_size{1024};
+constexpr std::size_t qemud_header_size{4};
+
+// Appends a qemud message, its payload prefixed with the payload length as
+// four hex digits. Leaves the buffer as it is if the message doesn't fit.
+std::size_t append_message(char *buffer, std::size_t size, std::size_t offset, const char *format, ...) {
+  if (offset + qemud_header_size >= size) return offset;
+
+  va_list args;
+  va_start(args, format);
+  const auto length = std::vsnprintf(buffer + offset + qemud_header_size,
+                                     size - offset - qemud_header_size, format, args);
+  va_end(args);
+  if (length < 0 || offset + qemud_header_size + length >= size) return offset;
+
+  char header[qemud_header_size + 1];
+  std::snprintf(header, sizeof(header), "%04x", length);
+  std::copy(header, header + qemud_header_size, buffer + offset);
+  return offset + qemud_header_size + length;
+}
+
+std::size_t append_vector(char *buffer, std::size_t size, std::size_t offset,
+                          const char *name, const std::array<double, 3> &value) {
+  return append_message(buffer, size, offset, "%s:%g:%g:%g", name, value[0], value[1], value[2]);
+}
+
+std::size_t append_scalar(char *buffer, std::size_t size, std::size_t offset,
+                          const char *name, double value) {
+  return append_message(buffer, size, offset, "%s:%g", name, value);
+}
+}
+
+namespace anbox::qemu {
+constexpr std::chrono::milliseconds SensorsHub::default_delay;
+constexpr std::chrono::milliseconds SensorsHub::min_delay;
+constexpr std::chrono::milliseconds SensorsHub::max_idle;
+
+struct SensorsHub::Subscription {
+  std::shared_ptr<network::SocketMessenger> messenger;
+  std::uint32_t sensors = 0;
+  std::chrono::milliseconds delay = default_delay;
+  Clock::time_point next_due;
+  Clock::time_point last_sent;
+  std::uint64_t sent_version = 0;
+  std::uint32_t sent_sensors = 0;
+  // What the buffer holds while it is being sent. A full pipe takes only
+  // part of it and the rest goes out the next time the pipe is due.
+  bool sending = false;
+  std::size_t size = 0;
+  std::size_t written = 0;
+  std::uint64_t version = 0;
+  std::uint32_t formatted_sensors = 0;
+  std::array<char, max_messages_size> buffer;
+};
+
+SensorsHub::SensorsHub(const std::shared_ptr<Runtime> &rt,
+                       const std::shared_ptr<application::SensorsState> &state)
+    : state_(state), timer_(rt->service()) {}
+
+SensorsHub::~SensorsHub() {}
+
+std::shared_ptr<SensorsHub::Subscription> SensorsHub::subscribe(
+    const std::shared_ptr<network::SocketMessenger> &messenger) {
+  auto subscription = std::make_shared<Subscription>();
+  subscription->messenger = messenger;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  subscriptions_.push_back(subscription);
+  return subscription;
+}
+
+void SensorsHub::unsubscribe(const std::shared_ptr<Subscription> &subscription) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  subscriptions_.erase(std::remove(subscriptions_.begin(), subscriptions_.end(), subscription),
+                       subscriptions_.end());
+  arm_timer(Clock::now());
+}
+
+void SensorsHub::set_enabled_sensors(const std::shared_ptr<Subscription> &subscription,
+                                     std::uint32_t sensors) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto now = Clock::now();
+  sensors &= ~static_cast<std::uint32_t>(state_->disabled_sensors);
+  // Sensors which just got enabled get their first values right away.
+  if (sensors & ~subscription->sensors)
+    subscription->next_due = now;
+  subscription->sensors = sensors;
+  arm_timer(now);
+}
+
+void SensorsHub::set_delay(const std::shared_ptr<Subscription> &subscription,
+                           std::chrono::milliseconds delay) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto now = Clock::now();
+  subscription->delay = std::max(delay, min_delay);
+  subscription->next_due = std::min(subscription->next_due, now + subscription->delay);
+  arm_timer(now);
+}
+
+void SensorsHub::arm_timer(Clock::time_point now) {
+  auto expiry = Clock::time_point::max();
+  for (const auto &subscription : subscriptions_) {
+    if (subscription->sensors)
+      expiry = std::min(expiry, subscription->next_due);
+  }
+
+  if (expiry == Clock::time_point::max()) {
+    if (timer_armed_) {
+      timer_generation_++;
+      timer_armed_ = false;
+      timer_.cancel();
+    }
+    return;
+  }
+
+  expiry = std::max(expiry, now);
+  if (timer_armed_ && timer_expiry_ <= expiry)
+    return;
+
+  const auto generation = ++timer_generation_;
+  timer_armed_ = true;
+  timer_expiry_ = expiry;
+  timer_.expires_at(expiry);
+
+  std::weak_ptr<SensorsHub> weak_self = shared_from_this();
+  timer_.async_wait([weak_self, generation](const boost::system::error_code &err) {
+    if (err)
+      return;
+    if (auto self = weak_self.lock())
+      self->on_timer(generation);
+  });
+}
+
+void SensorsHub::on_timer(std::uint64_t generation) {
+  const auto now = Clock::now();
+  std::vector<std::shared_ptr<Subscription>> due;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (generation != timer_generation_)
+      return;
+
+    timer_armed_ = false;
+
+    std::uint64_t version = 0;
+    const auto values = state_->values.load(&version);
+
+    for (const auto &subscription : subscriptions_) {
+      if (!subscription->sensors || now < subscription->next_due)
+        continue;
+
+      // Stay on the rate the guest asked for but don't try to catch up on
+      // ticks we missed.
+      subscription->next_due += subscription->delay;
+      if (subscription->next_due <= now)
+        subscription->next_due = now + subscription->delay;
+
+      // A previous tick is still writing to this pipe.
+      if (subscription->sending)
+        continue;
+
+      // Finish the messages the pipe only took part of before.
+      if (subscription->written < subscription->size) {
+        subscription->sending = true;
+        due.push_back(subscription);
+        continue;
+      }
+
+      if (version == subscription->sent_version &&
+          subscription->sensors == subscription->sent_sensors &&
+          now - subscription->last_sent < max_idle)
+        continue;
+
+      prepare(*subscription, values, version);
+      due.push_back(subscription);
+    }
+
+    arm_timer(now);
+  }
+
+  for (const auto &subscription : due)
+    send(*subscription, now);
+}
+
+void SensorsHub::prepare(Subscription &subscription, const application::SensorsValues &values,
+                         std::uint64_t version) {
+  struct timeval tv;
+  gettimeofday(&tv, nullptr);
+  subscription.size = format_messages(values, subscription.sensors,
+                                      tv.tv_sec * 1000000LL + tv.tv_usec,
+                                      subscription.buffer.data(), subscription.buffer.size());
+  subscription.version = version;
+  subscription.formatted_sensors = subscription.sensors;
+  subscription.written = 0;
+  subscription.sending = true;
+}
+
+void SensorsHub::send(Subscription &subscription, Clock::time_point now) {
+  // The pipe is non-blocking so a guest not reading from it doesn't hold
+  // up the pipes sent to after it.
+  const auto sent = subscription.messenger->send_raw(subscription.buffer.data() + subscription.written,
+                                                     subscription.size - subscription.written);
+  const auto error = errno;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  subscription.sending = false;
+  if (sent < 0) {
+    if (error == EAGAIN || error == EWOULDBLOCK)
+      return;
+    // The pipe is going away, its processor will unsubscribe soon.
+    DEBUG("Failed to send sensor values: %s", std::strerror(error));
+    subscription.written = subscription.size;
+    return;
+  }
+
+  subscription.written += static_cast<std::size_t>(sent);
+  if (subscription.written < subscription.size)
+    return;
+
+  subscription.sent_version = subscription.version;
+  subscription.sent_sensors = subscription.formatted_sensors;
+  subscription.last_sent = now;
+}
+
+std::size_t SensorsHub::format_messages(const application::SensorsValues &values,
+                                        std::uint32_t sensors, std::int64_t timestamp,
+                                        char *buffer, std::size_t size) {
+  using application::SensorType;
+
+  std::size_t offset = 0;
+  if (sensors & SensorType::AccelerationSensor)
+    offset = append_vector(buffer, size, offset, "acceleration", values.acceleration);
+  if (sensors & SensorType::MagneticFieldSensor)
+    offset = append_vector(buffer, size, offset, "magnetic", values.magneticField);
+  if (sensors & SensorType::OrientationSensor)
+    offset = append_vector(buffer, size, offset, "orientation", values.orientation);
+  if (sensors & SensorType::TemperatureSensor)
+    offset = append_scalar(buffer, size, offset, "temperature", values.temperature);
+  if (sensors & SensorType::ProximitySensor)
+    offset = append_scalar(buffer, size, offset, "proximity", values.proximity);
+  if (sensors & SensorType::LightSensor)
+    offset = append_scalar(buffer, size, offset, "light", values.light);
+  if (sensors & SensorType::PressureSensor)
+    offset = append_scalar(buffer, size, offset, "pressure", values.pressure);
+  if (sensors & SensorType::HumiditySensor)
+    offset = append_scalar(buffer, size, offset, "humidity", values.humidity);
+  return append_message(buffer, size, offset, "sync:%lld", static_cast<long long>(timestamp));
+}
+}
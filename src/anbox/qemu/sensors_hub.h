@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef ANBOX_QEMU_SENSORS_HUB_H_
+#define ANBOX_QEMU_SENSORS_HUB_H_
+
+#include "anbox/application/sensors_state.h"
+#include "anbox/network/socket_messenger.h"
+#include "anbox/runtime.h"
+
+#include <boost/asio.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace anbox::qemu {
+// Streams the sensor values to all sensors pipes from a single timer
+// instead of a thread per pipe. When a pipe is due, all its enabled
+// sensors and the sync message go out in one write. A pipe is skipped
+// while neither the values nor its enabled sensors changed since the last
+// send, for up to max_idle.
+class SensorsHub : public std::enable_shared_from_this<SensorsHub> {
+ public:
+  typedef std::chrono::steady_clock Clock;
+
+  // Rate used until the guest asks for another one.
+  static constexpr std::chrono::milliseconds default_delay{200};
+  // The fastest rate we send at, whatever the guest asks for.
+  static constexpr std::chrono::milliseconds min_delay{5};
+  // Unchanged values are still sent this often so continuous sensors
+  // don't look stalled to the guest.
+  static constexpr std::chrono::milliseconds max_idle{1000};
+
+  struct Subscription;
+
+  SensorsHub(const std::shared_ptr<Runtime> &rt,
+             const std::shared_ptr<application::SensorsState> &state);
+  ~SensorsHub();
+
+  const std::shared_ptr<application::SensorsState> &state() const { return state_; }
+
+  std::shared_ptr<Subscription> subscribe(const std::shared_ptr<network::SocketMessenger> &messenger);
+  void unsubscribe(const std::shared_ptr<Subscription> &subscription);
+
+  // Sets the application::SensorType mask of sensors to send.
+  void set_enabled_sensors(const std::shared_ptr<Subscription> &subscription, std::uint32_t sensors);
+  void set_delay(const std::shared_ptr<Subscription> &subscription, std::chrono::milliseconds delay);
+
+  // Writes the qemud framed messages for the given sensors followed by a
+  // sync message with the timestamp into buffer and returns their size.
+  static std::size_t format_messages(const application::SensorsValues &values, std::uint32_t sensors,
+                                     std::int64_t timestamp, char *buffer, std::size_t size);
+
+ private:
+  void arm_timer(Clock::time_point now);
+  void on_timer(std::uint64_t generation);
+  // Formats the messages for a subscription into its buffer. Needs mutex_.
+  void prepare(Subscription &subscription, const application::SensorsValues &values,
+               std::uint64_t version);
+  // Writes what a full pipe takes of a prepared buffer without waiting for
+  // it. Called without mutex_.
+  void send(Subscription &subscription, Clock::time_point now);
+
+  std::shared_ptr<application::SensorsState> const state_;
+  std::mutex mutex_;
+  std::vector<std::shared_ptr<Subscription>> subscriptions_;
+  boost::asio::steady_timer timer_;
+  // Tells the handler of the current wait apart from ones of waits which
+  // were replaced but already completed.
+  std::uint64_t timer_generation_ = 0;
+  bool timer_armed_ = false;
+  Clock::time_point timer_expiry_;
+};
+}
+
+#endif
@@ -20,8 +20,6 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/predicate.hpp>
 #include <chrono>
-#include <iostream>
-#include <thread>
 
 #include "anbox/application/sensor_type.h"
 #include "anbox/logger.h"
@@ -29,53 +27,14 @@
 using namespace std;
 using namespace anbox::application;
 
-namespace std {
-std::ostream& operator<<(std::ostream& os, std::tuple<double, double, double> t) {
-  os << std::get<0>(t) << ":" << std::get<1>(t) << ":" << std::get<2>(t);
-  return os;
-}
-}  // namespace std
-
-
 namespace anbox::qemu {
 SensorsMessageProcessor::SensorsMessageProcessor(
-    shared_ptr<network::SocketMessenger> messenger, shared_ptr<application::SensorsState> sensorsState)
-    : QemudMessageProcessor(messenger), sensors_state_(sensorsState) {
-  enabledSensors_ = 0;
-  thread_ = std::thread([this]() {
-    for (;;) {
-      auto enabledSensors = enabledSensors_.load();
-      if (enabledSensors & SensorType::AccelerationSensor)
-        send_message(utils::string_format("acceleration:%1%", sensors_state_->acceleration));
-      if (enabledSensors & SensorType::MagneticFieldSensor)
-        send_message(utils::string_format("magnetic:%1%", sensors_state_->magneticField));
-      if (enabledSensors & SensorType::OrientationSensor)
-        send_message(utils::string_format("orientation:%1%", sensors_state_->orientation));
-      if (enabledSensors & SensorType::TemperatureSensor)
-        send_message(utils::string_format("temperature:%1%", sensors_state_->temperature));
-      if (enabledSensors & SensorType::ProximitySensor)
-        send_message(utils::string_format("proximity:%1%", sensors_state_->proximity));
-      if (enabledSensors & SensorType::LightSensor)
-        send_message(utils::string_format("light:%1%", sensors_state_->light));
-      if (enabledSensors & SensorType::PressureSensor)
-        send_message(utils::string_format("pressure:%1%", sensors_state_->pressure));
-      if (enabledSensors & SensorType::HumiditySensor)
-        send_message(utils::string_format("humidity:%1%", sensors_state_->humidity));
-      if (enabledSensors) {
-        struct timeval tv;
-        gettimeofday(&tv, NULL);
-        send_message(utils::string_format("sync:%d", tv.tv_sec * 1000000LL + tv.tv_usec));
-      }
-      if (!run_thread_.load())
-        break;
-      this_thread::sleep_for(delay_.load() * 1ms);
-    }
-  });
+    shared_ptr<network::SocketMessenger> messenger, shared_ptr<SensorsHub> hub)
+    : QemudMessageProcessor(messenger), hub_(hub), subscription_(hub->subscribe(messenger)) {
 }
 
 SensorsMessageProcessor::~SensorsMessageProcessor() {
-  run_thread_ = false;
-  thread_.join();
+  hub_->unsubscribe(subscription_);
 }
 
 void SensorsMessageProcessor::handle_command(const string& command) {
@@ -92,10 +51,10 @@ void SensorsMessageProcessor::handle_command(const string& command) {
     enabledSensors |= SensorType::LightSensor;
     enabledSensors |= SensorType::PressureSensor;
     enabledSensors |= SensorType::HumiditySensor;
-    enabledSensors &= ~sensors_state_->disabled_sensors;
+    enabledSensors &= ~hub_->state()->disabled_sensors;
     send_message(to_string(enabledSensors));
-  } else if (sscanf(command.c_str(), "set-delay:%d", &value)) {
-    delay_ = value;
+  } else if (sscanf(command.c_str(), "set-delay:%d", &value) == 1) {
+    hub_->set_delay(subscription_, std::chrono::milliseconds(value));
   } else if (parts.size() == 3 && parts[0] == "set") {
     auto st = SensorTypeHelper::FromString(parts[1]);
     if (parts[2] == "1") {
@@ -103,6 +62,7 @@ void SensorsMessageProcessor::handle_command(const string& command) {
     } else {
       enabledSensors_ &= ~st;
     }
+    hub_->set_enabled_sensors(subscription_, enabledSensors_);
   } else {
     ERROR("Unknown command: " + command);
   }
@@ -18,16 +18,14 @@
 #ifndef ANBOX_QEMU_SENSORS_MESSAGE_PROCESSOR_H_
 #define ANBOX_QEMU_SENSORS_MESSAGE_PROCESSOR_H_
 
-#include <thread>
-
-#include "anbox/application/sensors_state.h"
 #include "anbox/qemu/qemud_message_processor.h"
+#include "anbox/qemu/sensors_hub.h"
 
 namespace anbox::qemu {
 class SensorsMessageProcessor : public QemudMessageProcessor {
  public:
   SensorsMessageProcessor(
-      std::shared_ptr<network::SocketMessenger> messenger, std::shared_ptr<application::SensorsState> sensorsState);
+      std::shared_ptr<network::SocketMessenger> messenger, std::shared_ptr<SensorsHub> hub);
   ~SensorsMessageProcessor();
 
  protected:
@@ -35,11 +33,9 @@ class SensorsMessageProcessor : public QemudMessageProcessor {
 
  private:
   void send_message(const std::string& message);
-  std::shared_ptr<application::SensorsState> sensors_state_;
-  std::atomic<int> delay_ = 200;
-  std::atomic<uint32_t> enabledSensors_;
-  std::atomic<bool> run_thread_ = true;
-  std::thread thread_;
+  std::shared_ptr<SensorsHub> hub_;
+  std::shared_ptr<SensorsHub::Subscription> subscription_;
+  uint32_t enabledSensors_ = 0;
 };
 }
 #endif
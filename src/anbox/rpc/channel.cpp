@@ -18,12 +18,10 @@
  */
 
 #include "anbox/rpc/channel.h"
-#include "anbox/common/variable_length_array.h"
 #include "anbox/network/message_sender.h"
-#include "anbox/rpc/constants.h"
 #include "anbox/rpc/pending_call_cache.h"
 
-#include "anbox_rpc.pb.h"
+#include <stdexcept>
 
 namespace anbox::rpc {
 Channel::Channel(const std::shared_ptr<PendingCallCache> &pending_calls,
@@ -32,71 +30,59 @@ Channel::Channel(const std::shared_ptr<PendingCallCache> &pending_calls,
 
 Channel::~Channel() {}
 
+template <typename Encode>
+void Channel::send_frame(Encode encode) {
+  try {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    const auto &frame = encode(encoder_);
+    sender_->send(reinterpret_cast<const char *>(frame.data()), frame.size());
+    encoder_.trim();
+  } catch (std::runtime_error const &) {
+    notify_disconnected();
+    throw;
+  }
+}
+
 void Channel::call_method(std::string const &method_name,
                           google::protobuf::MessageLite const *parameters,
                           google::protobuf::MessageLite *response,
                           google::protobuf::Closure *complete) {
-  auto const &invocation = invocation_for(method_name, parameters);
-  pending_calls_->save_completion_details(invocation, response, complete);
-  send_message(MessageType::invocation, invocation);
+  const auto id = next_id();
+  pending_calls_->save_completion_details(id, response, complete);
+  send_frame([&](FrameEncoder &encoder) -> const std::vector<std::uint8_t> & {
+    return encoder.encode_invocation(id, method_name, *parameters);
+  });
 }
 
-void Channel::send_event(google::protobuf::MessageLite const &event) {
-  VariableLengthArray<2048> buffer{static_cast<size_t>(event.ByteSize())};
-  event.SerializeWithCachedSizesToArray(buffer.data());
-
-  anbox::protobuf::rpc::Result response;
-  response.add_events(buffer.data(), buffer.size());
-
-  send_message(MessageType::response, response);
-}
-
-protobuf::rpc::Invocation Channel::invocation_for(
+std::uint32_t Channel::call_method_async(
     std::string const &method_name,
-    google::protobuf::MessageLite const *request) {
-  anbox::VariableLengthArray<2048> buffer{
-      static_cast<size_t>(request->ByteSize())};
-
-  request->SerializeWithCachedSizesToArray(buffer.data());
-
-  anbox::protobuf::rpc::Invocation invoke;
-
-  invoke.set_id(next_id());
-  invoke.set_method_name(method_name);
-  invoke.set_parameters(buffer.data(), buffer.size());
-  invoke.set_protocol_version(1);
-
-  return invoke;
-}
-
-void Channel::send_message(const std::uint8_t &type,
-                           google::protobuf::MessageLite const &message) {
-  const size_t size = message.ByteSize();
-  const unsigned char header_bytes[header_size] = {
-      static_cast<unsigned char>((size >>16) & 0xff),
-      static_cast<unsigned char>((size >> 8) & 0xff),
-      static_cast<unsigned char>((size >> 0) & 0xff), type,
-  };
-
-  std::vector<std::uint8_t> send_buffer(sizeof(header_bytes) + size);
-  std::copy(header_bytes, header_bytes + sizeof(header_bytes),
-            send_buffer.begin());
-  message.SerializeToArray(send_buffer.data() + sizeof(header_bytes), size);
-
+    google::protobuf::MessageLite const *parameters,
+    google::protobuf::MessageLite *response,
+    PendingCallCache::CompletionHandler const &complete) {
+  const auto id = next_id();
+  pending_calls_->save_completion_details(id, response, complete);
   try {
-    std::lock_guard<std::mutex> lock(write_mutex_);
-    sender_->send(reinterpret_cast<const char *>(send_buffer.data()),
-                  send_buffer.size());
+    send_frame([&](FrameEncoder &encoder) -> const std::vector<std::uint8_t> & {
+      return encoder.encode_invocation(id, method_name, *parameters);
+    });
   } catch (std::runtime_error const &) {
-    notify_disconnected();
-    throw;
+    // Sending failed which completed all pending calls, including this
+    // one, as disconnected already.
   }
+  return id;
+}
+
+bool Channel::cancel_call(std::uint32_t id, CallStatus status) {
+  return pending_calls_->cancel(id, status);
+}
+
+void Channel::send_event(google::protobuf::MessageLite const &event) {
+  send_frame([&](FrameEncoder &encoder) -> const std::vector<std::uint8_t> & {
+    return encoder.encode_event(event);
+  });
 }
 
 void Channel::notify_disconnected() { pending_calls_->force_completion(); }
 
-std::uint32_t Channel::next_id() {
-  static std::uint32_t next_message_id = 0;
-  return next_message_id++;
+std::uint32_t Channel::next_id() { return next_id_.fetch_add(1); }
 }
-}
\ No newline at end of file
@@ -18,6 +18,9 @@
 #ifndef ANBOX_RPC_CHANNEL_H_
 #define ANBOX_RPC_CHANNEL_H_
 
+#include "anbox/rpc/frame_encoder.h"
+#include "anbox/rpc/pending_call_cache.h"
+
 #include <atomic>
 #include <memory>
 #include <mutex>
@@ -27,14 +30,10 @@ namespace google::protobuf {
   class MessageLite;
 }
 
-namespace anbox::protobuf::rpc {
-  class Invocation;  
-}
 namespace anbox::network {
   class MessageSender;
 }
 namespace anbox::rpc {
-class PendingCallCache;
 class Channel {
  public:
   Channel(const std::shared_ptr<PendingCallCache> &pending_calls,
@@ -46,20 +45,34 @@ class Channel {
                    google::protobuf::MessageLite *response,
                    google::protobuf::Closure *complete);
 
+  // Sends an invocation without waiting for its response and returns the
+  // id of the call. |complete| runs exactly once, when the response arrived,
+  // the call was cancelled or the connection went away. Any number of
+  // calls can be in flight at the same time.
+  std::uint32_t call_method_async(std::string const &method_name,
+                                  google::protobuf::MessageLite const *parameters,
+                                  google::protobuf::MessageLite *response,
+                                  PendingCallCache::CompletionHandler const &complete);
+
+  // Ends a call started with call_method_async with |status| if it is
+  // still pending, e.g. when its deadline passed.
+  bool cancel_call(std::uint32_t id, CallStatus status);
+
   void send_event(google::protobuf::MessageLite const &event);
 
  private:
-  protobuf::rpc::Invocation invocation_for(
-      std::string const &method_name,
-      google::protobuf::MessageLite const *request);
-  void send_message(const std::uint8_t &type,
-                    google::protobuf::MessageLite const &message);
+  // Encodes a frame with |encode| and sends it. All frames of a channel
+  // share one buffer so this serializes senders.
+  template <typename Encode>
+  void send_frame(Encode encode);
   std::uint32_t next_id();
   void notify_disconnected();
 
   std::shared_ptr<PendingCallCache> pending_calls_;
   std::shared_ptr<network::MessageSender> sender_;
   std::mutex write_mutex_;
+  FrameEncoder encoder_;
+  std::atomic<std::uint32_t> next_id_{0};
 };
 }
 
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "anbox/rpc/frame_decoder.h"
+#include "anbox/rpc/constants.h"
+
+#include <algorithm>
+
+namespace {
+std::size_t payload_size(const std::uint8_t *header) {
+  return (static_cast<std::size_t>(header[0]) << 16) +
+         (static_cast<std::size_t>(header[1]) << 8) + header[2];
+}
+}
+
+namespace anbox {
+namespace rpc {
+void FrameDecoder::decode(const std::uint8_t *data, std::size_t size,
+                          const FrameHandler &handler) {
+  if (!partial_.empty()) {
+    // Complete the header first as the frame size isn't known before.
+    if (partial_.size() < header_size) {
+      const auto count = std::min<std::size_t>(header_size - partial_.size(), size);
+      partial_.insert(partial_.end(), data, data + count);
+      data += count;
+      size -= count;
+      if (partial_.size() < header_size) return;
+    }
+
+    const auto frame_size = header_size + payload_size(partial_.data());
+    const auto count = std::min(frame_size - partial_.size(), size);
+    partial_.insert(partial_.end(), data, data + count);
+    data += count;
+    size -= count;
+    if (partial_.size() < frame_size) return;
+
+    handler({partial_[3], partial_.data() + header_size, frame_size - header_size});
+    partial_.clear();
+  }
+
+  while (size >= header_size) {
+    const auto frame_size = header_size + payload_size(data);
+    if (size < frame_size) break;
+
+    handler({data[3], data + header_size, frame_size - header_size});
+    data += frame_size;
+    size -= frame_size;
+  }
+
+  if (size == 0) return;
+
+  // Keep the beginning of the next frame and make room for all of it
+  // right away if its size is known already.
+  if (size >= header_size) partial_.reserve(header_size + payload_size(data));
+  partial_.assign(data, data + size);
+}
+}  // namespace rpc
+}  // namespace anbox
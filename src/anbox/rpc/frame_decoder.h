@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef ANBOX_RPC_FRAME_DECODER_H_
+#define ANBOX_RPC_FRAME_DECODER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace anbox {
+namespace rpc {
+// Splits a byte stream into RPC frames. Every frame starts with a header
+// holding the size of its payload (24 bit, big endian) and its message
+// type, see constants.h.
+//
+// Frames which arrive completely within one chunk of data are handed out
+// in place without copying them. Only a frame which is split across
+// chunks gets buffered until its remaining bytes arrive, so every byte is
+// copied at most once no matter how the stream is chunked.
+class FrameDecoder {
+ public:
+  struct Frame {
+    std::uint8_t type;
+    const std::uint8_t *data;
+    std::size_t size;
+  };
+
+  // Called for every complete frame. The frame's data is only valid
+  // during the call.
+  typedef std::function<void(const Frame &)> FrameHandler;
+
+  // Decodes |size| bytes at |data| which follow the bytes passed before.
+  void decode(const std::uint8_t *data, std::size_t size, const FrameHandler &handler);
+
+  // Number of bytes of an incomplete frame kept until the rest arrives.
+  std::size_t buffered() const { return partial_.size(); }
+
+ private:
+  std::vector<std::uint8_t> partial_;
+};
+}  // namespace rpc
+}  // namespace anbox
+
+#endif
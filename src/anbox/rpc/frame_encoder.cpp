@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "anbox/rpc/frame_encoder.h"
+#include "anbox/rpc/constants.h"
+
+#include <cstring>
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/message_lite.h>
+
+namespace {
+// Field numbers of the Invocation and Result messages in anbox_rpc.proto
+constexpr std::uint32_t invocation_id{1};
+constexpr std::uint32_t invocation_method_name{2};
+constexpr std::uint32_t invocation_parameters{3};
+constexpr std::uint32_t invocation_protocol_version{4};
+constexpr std::uint32_t result_id{1};
+constexpr std::uint32_t result_response{2};
+constexpr std::uint32_t result_events{3};
+
+constexpr std::uint32_t protocol_version{1};
+
+constexpr std::uint32_t wire_type_varint{0};
+constexpr std::uint32_t wire_type_length_delimited{2};
+
+typedef google::protobuf::io::CodedOutputStream CodedOutputStream;
+
+constexpr std::uint32_t tag(std::uint32_t field, std::uint32_t wire_type) {
+  return (field << 3) | wire_type;
+}
+
+std::size_t varint_field_size(std::uint32_t field, std::uint32_t value) {
+  return CodedOutputStream::VarintSize32(tag(field, wire_type_varint)) +
+         CodedOutputStream::VarintSize32(value);
+}
+
+std::size_t length_delimited_field_size(std::uint32_t field, std::size_t size) {
+  return CodedOutputStream::VarintSize32(tag(field, wire_type_length_delimited)) +
+         CodedOutputStream::VarintSize32(static_cast<std::uint32_t>(size)) + size;
+}
+
+std::uint8_t *write_varint_field(std::uint8_t *out, std::uint32_t field, std::uint32_t value) {
+  out = CodedOutputStream::WriteVarint32ToArray(tag(field, wire_type_varint), out);
+  return CodedOutputStream::WriteVarint32ToArray(value, out);
+}
+
+std::uint8_t *write_length(std::uint8_t *out, std::uint32_t field, std::size_t size) {
+  out = CodedOutputStream::WriteVarint32ToArray(tag(field, wire_type_length_delimited), out);
+  return CodedOutputStream::WriteVarint32ToArray(static_cast<std::uint32_t>(size), out);
+}
+
+std::uint8_t *write_message_field(std::uint8_t *out, std::uint32_t field,
+                                  const google::protobuf::MessageLite &message,
+                                  std::size_t size) {
+  out = write_length(out, field, size);
+  return message.SerializeWithCachedSizesToArray(out);
+}
+}
+
+namespace anbox {
+namespace rpc {
+std::uint8_t *FrameEncoder::begin_frame(std::uint8_t type, std::size_t size) {
+  buffer_.resize(header_size + size);
+  buffer_[0] = static_cast<std::uint8_t>((size >> 16) & 0xff);
+  buffer_[1] = static_cast<std::uint8_t>((size >> 8) & 0xff);
+  buffer_[2] = static_cast<std::uint8_t>((size >> 0) & 0xff);
+  buffer_[3] = type;
+  return buffer_.data() + header_size;
+}
+
+const std::vector<std::uint8_t> &FrameEncoder::encode_invocation(
+    std::uint32_t id, const std::string &method_name,
+    const google::protobuf::MessageLite &parameters) {
+  const std::size_t parameters_size = parameters.ByteSize();
+  const auto size = varint_field_size(invocation_id, id) +
+                    length_delimited_field_size(invocation_method_name, method_name.size()) +
+                    length_delimited_field_size(invocation_parameters, parameters_size) +
+                    varint_field_size(invocation_protocol_version, protocol_version);
+
+  auto out = begin_frame(MessageType::invocation, size);
+  out = write_varint_field(out, invocation_id, id);
+  out = write_length(out, invocation_method_name, method_name.size());
+  out = static_cast<std::uint8_t *>(std::memcpy(out, method_name.data(), method_name.size())) +
+        method_name.size();
+  out = write_message_field(out, invocation_parameters, parameters, parameters_size);
+  write_varint_field(out, invocation_protocol_version, protocol_version);
+  return buffer_;
+}
+
+const std::vector<std::uint8_t> &FrameEncoder::encode_response(
+    std::uint32_t id, const google::protobuf::MessageLite &response) {
+  const std::size_t response_size = response.ByteSize();
+  const auto size = varint_field_size(result_id, id) +
+                    length_delimited_field_size(result_response, response_size);
+
+  auto out = begin_frame(MessageType::response, size);
+  out = write_varint_field(out, result_id, id);
+  write_message_field(out, result_response, response, response_size);
+  return buffer_;
+}
+
+const std::vector<std::uint8_t> &FrameEncoder::encode_event(
+    const google::protobuf::MessageLite &event) {
+  const std::size_t event_size = event.ByteSize();
+  const auto size = length_delimited_field_size(result_events, event_size);
+
+  auto out = begin_frame(MessageType::response, size);
+  write_message_field(out, result_events, event, event_size);
+  return buffer_;
+}
+
+void FrameEncoder::trim() {
+  if (buffer_.capacity() <= max_retained_size) return;
+  std::vector<std::uint8_t>().swap(buffer_);
+}
+}  // namespace rpc
+}  // namespace anbox
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef ANBOX_RPC_FRAME_ENCODER_H_
+#define ANBOX_RPC_FRAME_ENCODER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace protobuf {
+class MessageLite;
+}  // namespace protobuf
+}  // namespace google
+
+namespace anbox {
+namespace rpc {
+// Builds complete RPC frames, header included, in a buffer which is reused
+// for every frame. The Invocation and Result messages wrapping a payload
+// are encoded by hand so the payload message gets serialized only once,
+// directly into its place in the frame. The output is byte for byte what
+// serializing the wrapping message with protobuf gives.
+//
+// A frame stays valid until the next one is encoded, so callers sharing
+// an encoder have to serialize access to it.
+class FrameEncoder {
+ public:
+  // Frames up to this size keep their buffer around for the next frame.
+  static constexpr std::size_t max_retained_size{64 * 1024};
+
+  const std::vector<std::uint8_t> &encode_invocation(
+      std::uint32_t id, const std::string &method_name,
+      const google::protobuf::MessageLite &parameters);
+  const std::vector<std::uint8_t> &encode_response(
+      std::uint32_t id, const google::protobuf::MessageLite &response);
+  const std::vector<std::uint8_t> &encode_event(
+      const google::protobuf::MessageLite &event);
+
+  // Gives up the buffer if the last frame made it grow beyond
+  // max_retained_size.
+  void trim();
+
+ private:
+  std::uint8_t *begin_frame(std::uint8_t type, std::size_t size);
+
+  std::vector<std::uint8_t> buffer_;
+};
+}  // namespace rpc
+}  // namespace anbox
+
+#endif
@@ -16,7 +16,6 @@
  */
 
 #include "anbox/rpc/message_processor.h"
-#include "anbox/common/variable_length_array.h"
 #include "anbox/rpc/constants.h"
 #include "anbox/rpc/make_protobuf_object.h"
 #include "anbox/rpc/template_message_processor.h"
@@ -40,30 +39,31 @@ MessageProcessor::MessageProcessor(
     const std::shared_ptr<PendingCallCache> &pending_calls)
     : sender_(sender), pending_calls_(pending_calls) {}
 
-MessageProcessor::~MessageProcessor() {}
+MessageProcessor::~MessageProcessor() {
+  // The connection is gone, no more responses will arrive.
+  pending_calls_->force_completion();
+}
 
 bool MessageProcessor::process_data(const std::vector<std::uint8_t> &data) {
-  for (const auto &byte : data) buffer_.push_back(byte);
-
-  while (buffer_.size() > 0) {
-    const auto high = buffer_[0];
-    const auto medium = buffer_[1];
-    const auto low = buffer_[2];
-    size_t const message_size = (high << 16) + (medium << 8) + low;
-    const auto message_type = buffer_[3];
+  process_bytes(data.data(), data.size());
+  return true;
+}
 
-    // If we don't have yet all bytes for a new message return and wait
-    // until we have all.
-    if (buffer_.size() < (message_size + header_size)) break;
+bool MessageProcessor::process_data(network::ReceiveBuffer &&buffer) {
+  process_bytes(buffer.data(), buffer.size());
+  return true;
+}
 
-    if (message_type == MessageType::invocation) {
+void MessageProcessor::process_bytes(const std::uint8_t *data, size_t size) {
+  decoder_.decode(data, size, [&](const FrameDecoder::Frame &frame) {
+    if (frame.type == MessageType::invocation) {
       anbox::protobuf::rpc::Invocation raw_invocation;
-      raw_invocation.ParseFromArray(buffer_.data() + header_size, message_size);
+      raw_invocation.ParseFromArray(frame.data, frame.size);
 
       dispatch(Invocation(raw_invocation));
-    } else if (message_type == MessageType::response) {
+    } else if (frame.type == MessageType::response) {
       auto result = make_protobuf_object<protobuf::rpc::Result>();
-      result->ParseFromArray(buffer_.data() + header_size, message_size);
+      result->ParseFromArray(frame.data, frame.size);
 
       if (result->has_id()) {
         pending_calls_->populate_message_for_result(*result,
@@ -76,46 +76,15 @@ bool MessageProcessor::process_data(const std::vector<std::uint8_t> &data) {
       for (int n = 0; n < result->events_size(); n++)
         process_event_sequence(result->events(n));
     }
-
-    buffer_.erase(buffer_.begin(),
-                  buffer_.begin() + header_size + message_size);
-  }
-
-  return true;
+  });
 }
 
 void MessageProcessor::send_response(::google::protobuf::uint32 id,
                                      google::protobuf::MessageLite *response) {
-  VariableLengthArray<serialization_buffer_size> send_response_buffer(
-      static_cast<size_t>(response->ByteSize()));
-
-  response->SerializeWithCachedSizesToArray(send_response_buffer.data());
-
-  anbox::protobuf::rpc::Result send_response_result;
-  send_response_result.set_id(id);
-  send_response_result.set_response(send_response_buffer.data(),
-                                    send_response_buffer.size());
-
-  send_response_buffer.resize(send_response_result.ByteSize());
-  send_response_result.SerializeWithCachedSizesToArray(
-      send_response_buffer.data());
-
-  const size_t size = send_response_buffer.size();
-  const unsigned char header_bytes[header_size] = {
-      static_cast<unsigned char>((size >> 16) & 0xff),
-      static_cast<unsigned char>((size >> 8) & 0xff),
-      static_cast<unsigned char>((size >> 0) & 0xff), MessageType::response,
-  };
-
-  std::vector<std::uint8_t> send_buffer(sizeof(header_bytes) + size);
-  std::copy(header_bytes, header_bytes + sizeof(header_bytes),
-            send_buffer.begin());
-  std::copy(send_response_buffer.data(),
-            send_response_buffer.data() + send_response_buffer.size(),
-            send_buffer.begin() + sizeof(header_bytes));
-
-  sender_->send(reinterpret_cast<const char *>(send_buffer.data()),
-                send_buffer.size());
+  std::lock_guard<std::mutex> lock(send_mutex_);
+  const auto &frame = encoder_.encode_response(id, *response);
+  sender_->send(reinterpret_cast<const char *>(frame.data()), frame.size());
+  encoder_.trim();
 }
 }  // namespace anbox
 }  // namespace network
@@ -20,9 +20,12 @@
 
 #include "anbox/network/message_processor.h"
 #include "anbox/network/message_sender.h"
+#include "anbox/rpc/frame_decoder.h"
+#include "anbox/rpc/frame_encoder.h"
 #include "anbox/rpc/pending_call_cache.h"
 
 #include <memory>
+#include <mutex>
 
 #include <google/protobuf/message_lite.h>
 #include <google/protobuf/stubs/common.h>
@@ -52,6 +55,7 @@ class MessageProcessor : public network::MessageProcessor {
   ~MessageProcessor();
 
   bool process_data(const std::vector<std::uint8_t>& data) override;
+  bool process_data(network::ReceiveBuffer&& buffer) override;
 
   void send_response(::google::protobuf::uint32 id,
                      google::protobuf::MessageLite* response);
@@ -60,8 +64,12 @@ class MessageProcessor : public network::MessageProcessor {
   virtual void process_event_sequence(const std::string&) {}
 
  private:
+  void process_bytes(const std::uint8_t* data, size_t size);
+
   std::shared_ptr<network::MessageSender> sender_;
-  std::vector<std::uint8_t> buffer_;
+  FrameDecoder decoder_;
+  std::mutex send_mutex_;
+  FrameEncoder encoder_;
   std::shared_ptr<PendingCallCache> pending_calls_;
 };
 }
@@ -24,51 +24,76 @@
 #include <google/protobuf/stubs/callback.h>
 #endif
 
+#include <vector>
+
 namespace anbox::rpc {
 PendingCallCache::PendingCallCache() {}
 
 void PendingCallCache::save_completion_details(
-    anbox::protobuf::rpc::Invocation const& invocation,
+    std::uint32_t id,
     google::protobuf::MessageLite* response,
     google::protobuf::Closure* complete) {
+  // Closures delete themselves once run, so we run them no matter how the
+  // call ended to not leak them.
+  save_completion_details(id, response,
+                          [complete](CallStatus) { complete->Run(); });
+}
+
+void PendingCallCache::save_completion_details(
+    std::uint32_t id,
+    google::protobuf::MessageLite* response,
+    CompletionHandler const& complete) {
   std::unique_lock<std::mutex> lock(mutex_);
-  pending_calls_[invocation.id()] = PendingCall(response, complete);
+  pending_calls_[id] = PendingCall(response, complete);
 }
 
 void PendingCallCache::populate_message_for_result(
     anbox::protobuf::rpc::Result& result,
     std::function<void(google::protobuf::MessageLite*)> const& populator) {
   std::unique_lock<std::mutex> lock(mutex_);
-  populator(pending_calls_.at(result.id()).response);
+  // The call may have been cancelled before its response arrived.
+  auto call = pending_calls_.find(result.id());
+  if (call == pending_calls_.end()) return;
+  populator(call->second.response);
 }
 
 void PendingCallCache::complete_response(anbox::protobuf::rpc::Result& result) {
+  cancel(result.id(), CallStatus::completed);
+}
+
+bool PendingCallCache::cancel(std::uint32_t id, CallStatus status) {
   PendingCall completion;
 
   {
     std::unique_lock<std::mutex> lock(mutex_);
-    auto call = pending_calls_.find(result.id());
-    if (call != pending_calls_.end()) {
-      completion = call->second;
-      pending_calls_.erase(call);
-    }
+    auto call = pending_calls_.find(id);
+    if (call == pending_calls_.end()) return false;
+    completion = call->second;
+    pending_calls_.erase(call);
   }
 
-  if (completion.complete) completion.complete->Run();
+  if (completion.complete) completion.complete(status);
+  return true;
 }
 
 void PendingCallCache::force_completion() {
-  std::unique_lock<std::mutex> lock(mutex_);
-  for (auto& call : pending_calls_) {
-    auto& completion = call.second;
-    completion.complete->Run();
+  std::vector<PendingCall> completions;
+
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (auto& call : pending_calls_) completions.push_back(call.second);
+    pending_calls_.clear();
   }
 
-  pending_calls_.erase(pending_calls_.begin(), pending_calls_.end());
+  // Completion handlers may issue new calls so they must run without the
+  // lock held.
+  for (auto& completion : completions) {
+    if (completion.complete) completion.complete(CallStatus::disconnected);
+  }
 }
 
 bool PendingCallCache::empty() const {
   std::unique_lock<std::mutex> lock(mutex_);
   return pending_calls_.empty();
 }
-}
\ No newline at end of file
+}
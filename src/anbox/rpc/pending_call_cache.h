@@ -19,6 +19,7 @@
 #ifndef ANBOX_RPC_PENDING_CALL_CACHE_
 #define ANBOX_RPC_PENDING_CALL_CACHE_
 
+#include <cstdint>
 #include <functional>
 #include <map>
 #include <mutex>
@@ -29,40 +30,56 @@ namespace google::protobuf {
 }
 
 namespace anbox::protobuf::rpc {
-  class Invocation;
   class Result;
 }
 
 namespace anbox::rpc {
+// How a pending call ended. The response message of a call is only
+// populated when it completed.
+enum class CallStatus {
+  completed,
+  timed_out,
+  disconnected,
+};
+
 class PendingCallCache {
  public:
+  typedef std::function<void(CallStatus)> CompletionHandler;
+
   PendingCallCache();
 
   void save_completion_details(
-      anbox::protobuf::rpc::Invocation const &invocation,
+      std::uint32_t id,
       google::protobuf::MessageLite *response,
       google::protobuf::Closure *complete);
+  void save_completion_details(
+      std::uint32_t id,
+      google::protobuf::MessageLite *response,
+      CompletionHandler const &complete);
   void populate_message_for_result(
       anbox::protobuf::rpc::Result &result,
       std::function<void(google::protobuf::MessageLite *)> const &populator);
   void complete_response(anbox::protobuf::rpc::Result &result);
+  // Ends the call with the given id with |status| unless it completed
+  // already. A response arriving for it afterwards is dropped.
+  bool cancel(std::uint32_t id, CallStatus status);
   void force_completion();
   bool empty() const;
 
  private:
   struct PendingCall {
     PendingCall(google::protobuf::MessageLite *response,
-                google::protobuf::Closure *target)
-        : response(response), complete(target) {}
+                CompletionHandler const &complete)
+        : response(response), complete(complete) {}
 
     PendingCall() : response(0), complete() {}
 
     google::protobuf::MessageLite *response;
-    google::protobuf::Closure *complete;
+    CompletionHandler complete;
   };
 
   std::mutex mutable mutex_;
-  std::map<int, PendingCall> pending_calls_;
+  std::map<std::uint32_t, PendingCall> pending_calls_;
 };
 }
 
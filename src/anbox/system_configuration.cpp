@@ -101,6 +101,11 @@ std::string anbox::SystemConfiguration::input_device_dir() const {
   return dir;
 }
 
+std::string anbox::SystemConfiguration::headless_dir() const {
+  static std::string dir = anbox::utils::string_format("%s/anbox/headless", runtime_dir());
+  return dir;
+}
+
 std::string anbox::SystemConfiguration::application_item_dir() const {
   static auto dir = xdg::data().home() / "applications" / "anbox";
   if (anbox::utils::get_env_value("ANBOX_NO_DESKTOP_SUBDIR").length() > 0)
@@ -108,6 +113,13 @@ std::string anbox::SystemConfiguration::application_item_dir() const {
   return dir.string();
 }
 
+std::string anbox::SystemConfiguration::program_cache_dir() const {
+  // The session manager runs as the user and can't write to the data path
+  // owned by the container manager.
+  static auto dir = xdg::cache().home() / "anbox" / "programs";
+  return dir.string();
+}
+
 std::string anbox::SystemConfiguration::resource_dir() const {
   return resource_path.string();
 }
@@ -43,7 +43,9 @@ class SystemConfiguration {
   std::string container_devices_dir() const;
   std::string container_state_dir() const;
   std::string input_device_dir() const;
+  std::string headless_dir() const;
   std::string application_item_dir() const;
+  std::string program_cache_dir() const;
   std::string resource_dir() const;
 
  protected:
@@ -111,16 +111,25 @@ std::shared_ptr<Window> MultiWindowManager::find_window_for_task(const Task::Id
   return nullptr;
 }
 
+// Window changes are sent without waiting for Android to apply them as
+// they are requested from the platform's event loop or, for removals,
+// while handling an update from Android itself.
 void MultiWindowManager::resize_task(const Task::Id &task, const anbox::graphics::Rect &rect,
                                       const std::int32_t &resize_mode) {
-  android_api_stub_->resize_task(task, rect, resize_mode);
+  android_api_stub_->resize_task_async(task, rect, resize_mode, [task](const std::string &error) {
+    if (!error.empty()) WARNING("Failed to resize task %d: %s", task, error);
+  });
 }
 
 void MultiWindowManager::set_focused_task(const Task::Id &task) {
-  android_api_stub_->set_focused_task(task);
+  android_api_stub_->set_focused_task_async(task, [task](const std::string &error) {
+    if (!error.empty()) WARNING("Failed to focus task %d: %s", task, error);
+  });
 }
 
 void MultiWindowManager::remove_task(const Task::Id &task) {
-  android_api_stub_->remove_task(task);
+  android_api_stub_->remove_task_async(task, [task](const std::string &error) {
+    if (!error.empty()) WARNING("Failed to remove task %d: %s", task, error);
+  });
 }
 }
\ No newline at end of file
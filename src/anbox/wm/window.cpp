@@ -56,5 +56,6 @@ void Window::release() {
   if (!renderer_ || !attached_)
     return;
   renderer_->destroyNativeWindow(native_handle());
+  attached_ = false;
 }
 }
\ No newline at end of file
@@ -47,7 +47,7 @@ class Window {
   Window(const std::shared_ptr<Renderer> &renderer, const Task::Id &task, const graphics::Rect &frame, const std::string &title);
   virtual ~Window();
 
-  bool attach();
+  virtual bool attach();
   void release();
 
   void update_state(const WindowState::List &states);
@@ -58,12 +58,14 @@ class Window {
   Task::Id task() const;
   std::string title() const;
 
- private:
+ protected:
   std::shared_ptr<Renderer> renderer_;
+  bool attached_ = false;
+
+ private:
   Task::Id task_;
   graphics::Rect frame_;
   std::string title_;
-  bool attached_ = false;
 };
 }
 #endif
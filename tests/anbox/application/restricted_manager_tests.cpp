@@ -27,6 +27,10 @@ class MockManager : public anbox::application::Manager {
   MOCK_METHOD3(launch, void(const anbox::android::Intent&,
                             const anbox::graphics::Rect&,
                             const anbox::wm::Stack::Id&));
+  MOCK_METHOD4(launch_async, void(const anbox::android::Intent&,
+                                  const anbox::graphics::Rect&,
+                                  const anbox::wm::Stack::Id&,
+                                  const LaunchCallback&));
   MOCK_METHOD0(ready, core::Property<bool>&());
 };
 }
@@ -54,3 +58,29 @@ TEST(RestrictedManager, RedirectsLaunchesToRightStack) {
                         anbox::graphics::Rect::Empty,
                         anbox::wm::Stack::Id::Freeform);
 }
+
+TEST(RestrictedManager, RedirectsAsyncLaunchesToRightStack) {
+  auto mgr = std::make_shared<MockManager>();
+  anbox::application::RestrictedManager restricted_mgr(mgr, anbox::wm::Stack::Id::Freeform);
+
+  EXPECT_CALL(*mgr, launch(_, _, _)).Times(0);
+  EXPECT_CALL(*mgr, launch_async(_, _, anbox::wm::Stack::Id::Freeform, _))
+      .Times(2)
+      .WillRepeatedly(InvokeArgument<3>(std::string{}));
+
+  size_t completed = 0;
+  const auto done = [&](const std::string &error) {
+    EXPECT_TRUE(error.empty());
+    completed++;
+  };
+
+  restricted_mgr.launch_async(anbox::android::Intent{},
+                              anbox::graphics::Rect::Empty,
+                              anbox::wm::Stack::Id::Default, done);
+
+  restricted_mgr.launch_async(anbox::android::Intent{},
+                              anbox::graphics::Rect::Empty,
+                              anbox::wm::Stack::Id::Fullscreen, done);
+
+  ASSERT_EQ(2, completed);
+}
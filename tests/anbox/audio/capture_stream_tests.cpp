@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "anbox/audio/capture_stream.h"
+
+#include <gtest/gtest.h>
+
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <sys/mman.h>
+
+using namespace anbox::audio;
+
+namespace {
+const StreamFormat mono_s16{8000, 1, StreamFormat::Sample::S16, 0};
+// 10ms periods, 40ms ring.
+const CaptureConfig config{80, 4};
+
+// Numbers the frames it produces so the tests can see which ones arrive.
+class CountingSource : public Source {
+ public:
+  void set_format(const StreamFormat &format) override { ASSERT_EQ(frame_size(mono_s16), frame_size(format)); }
+  void read_data(std::vector<std::uint8_t> &data) override {
+    for (std::size_t n = 0; n + 1 < data.size(); n += 2) {
+      const auto sample = static_cast<std::int16_t>(next_++);
+      std::memcpy(data.data() + n, &sample, sizeof(sample));
+    }
+  }
+
+ private:
+  std::uint16_t next_ = 0;
+};
+
+class RecordingSender : public anbox::network::MessageSender {
+ public:
+  void send(char const *data, size_t length) override { send_raw(data, length); }
+
+  ssize_t send_raw(char const *data, size_t length) override {
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto accepted = std::min(length, accept_limit);
+    accept_limit -= accepted;
+    received.insert(received.end(), data, data + accepted);
+    calls++;
+    cond.notify_all();
+    return static_cast<ssize_t>(accepted);
+  }
+
+  std::mutex mutex;
+  std::condition_variable cond;
+  std::vector<std::uint8_t> received;
+  std::size_t calls = 0;
+  std::size_t accept_limit = SIZE_MAX;
+};
+
+struct Fixture {
+  explicit Fixture(bool shared_memory) :
+      rt{anbox::Runtime::create(1)},
+      sender{std::make_shared<RecordingSender>()},
+      stream{std::make_shared<CaptureStream>(rt, std::make_shared<CountingSource>(), sender,
+                                             mono_s16, config, shared_memory)} {
+    rt->start();
+  }
+
+  ~Fixture() {
+    stream->stop();
+    rt->stop();
+  }
+
+  std::shared_ptr<anbox::Runtime> rt;
+  std::shared_ptr<RecordingSender> sender;
+  std::shared_ptr<CaptureStream> stream;
+};
+
+// Maps the ring the way the HAL does.
+struct Ring {
+  explicit Ring(const anbox::Fd &fd) {
+    size = capture_ring_size(2, config.period_frames * config.period_count);
+    mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    EXPECT_NE(MAP_FAILED, mapping);
+    header = static_cast<CaptureRingHeader*>(mapping);
+    frames = reinterpret_cast<const std::int16_t*>(static_cast<std::uint8_t*>(mapping) + CaptureRingHeader::data_offset);
+  }
+  ~Ring() { ::munmap(mapping, size); }
+
+  void *mapping;
+  std::size_t size;
+  CaptureRingHeader *header;
+  const std::int16_t *frames;
+};
+}
+
+TEST(CaptureStream, NegotiatesWithinLimits) {
+  const auto defaults = CaptureStream::negotiate(mono_s16, CaptureConfig{0, 0});
+  EXPECT_EQ(160u, defaults.period_frames);
+  EXPECT_EQ(CaptureStream::default_period_count, defaults.period_count);
+
+  const auto tiny = CaptureStream::negotiate(mono_s16, CaptureConfig{1, 1});
+  EXPECT_EQ(16u, tiny.period_frames);
+  EXPECT_EQ(2u, tiny.period_count);
+
+  const auto huge = CaptureStream::negotiate(mono_s16, CaptureConfig{1000000, 1000});
+  EXPECT_EQ(4000u, huge.period_frames);
+  EXPECT_EQ(CaptureStream::max_period_count, huge.period_count);
+
+  const auto requested = CaptureStream::negotiate(mono_s16, config);
+  EXPECT_EQ(config.period_frames, requested.period_frames);
+  EXPECT_EQ(config.period_count, requested.period_count);
+}
+
+TEST(CaptureStream, DeliversThroughSharedMemory) {
+  Fixture f{true};
+  Ring ring{f.stream->ring_fd()};
+  ASSERT_EQ(CaptureRingHeader::magic_value, ring.header->magic);
+  ASSERT_EQ(2u, ring.header->frame_size);
+  ASSERT_EQ(config.period_frames * config.period_count, ring.header->capacity);
+
+  f.stream->start();
+
+  std::vector<std::int16_t> samples;
+  std::size_t wakeups = 0;
+  while (samples.size() < 800) {
+    auto read_position = ring.header->read_position.load();
+    auto available = ring.header->write_position.load() - read_position;
+    if (available == 0) {
+      // Block like the HAL does: announce it, look once more, then wait
+      // for the wakeup byte.
+      ring.header->reader_waiting.store(1);
+      available = ring.header->write_position.load() - read_position;
+      if (available == 0) {
+        std::unique_lock<std::mutex> lock(f.sender->mutex);
+        ASSERT_TRUE(f.sender->cond.wait_for(lock, std::chrono::seconds(2),
+                                            [&]() { return f.sender->received.size() > wakeups; }));
+        wakeups++;
+        continue;
+      }
+      ring.header->reader_waiting.store(0);
+    }
+
+    for (std::uint64_t n = 0; n < available; n++)
+      samples.push_back(ring.frames[(read_position + n) % ring.header->capacity]);
+    ring.header->read_position.store(read_position + available);
+  }
+
+  for (std::size_t n = 0; n < samples.size(); n++)
+    ASSERT_EQ(static_cast<std::int16_t>(n), samples[n]);
+  EXPECT_GT(wakeups, 0u);
+  EXPECT_EQ(0u, f.stream->dropped_frames());
+}
+
+TEST(CaptureStream, DropsWhatSlowClientsHaveNoRoomFor) {
+  Fixture f{true};
+  Ring ring{f.stream->ring_fd()};
+
+  f.stream->start();
+  std::this_thread::sleep_for(std::chrono::milliseconds{120});
+
+  // Nobody waited, so the socket stays quiet and the oldest frames are kept.
+  EXPECT_EQ(0u, f.sender->calls);
+  EXPECT_EQ(ring.header->capacity, ring.header->write_position.load());
+  EXPECT_GT(f.stream->dropped_frames(), 0u);
+  EXPECT_EQ(f.stream->dropped_frames(), ring.header->dropped_frames.load());
+  for (std::uint32_t n = 0; n < ring.header->capacity; n++)
+    ASSERT_EQ(static_cast<std::int16_t>(n), ring.frames[n]);
+}
+
+TEST(CaptureStream, KeepsSocketStreamFrameAligned) {
+  Fixture f{false};
+  EXPECT_LT(f.stream->ring_fd(), 0);
+
+  // The first write only gets the first frame and half of the second one
+  // through.
+  f.sender->accept_limit = 3;
+  f.stream->start();
+  std::this_thread::sleep_for(std::chrono::milliseconds{25});
+  {
+    std::lock_guard<std::mutex> lock(f.sender->mutex);
+    f.sender->accept_limit = SIZE_MAX;
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds{50});
+  f.stream->stop();
+
+  std::lock_guard<std::mutex> lock(f.sender->mutex);
+  ASSERT_EQ(0u, f.sender->received.size() % 2);
+  std::vector<std::int16_t> samples(f.sender->received.size() / 2);
+  std::memcpy(samples.data(), f.sender->received.data(), f.sender->received.size());
+
+  ASSERT_GT(samples.size(), 2u);
+  EXPECT_EQ(0, samples[0]);
+  EXPECT_EQ(1, samples[1]);
+  std::uint64_t gaps = 0;
+  for (std::size_t n = 1; n < samples.size(); n++) {
+    ASSERT_GT(samples[n], samples[n - 1]);
+    gaps += static_cast<std::uint64_t>(samples[n] - samples[n - 1] - 1);
+  }
+  EXPECT_EQ(gaps, f.stream->dropped_frames());
+  EXPECT_GT(gaps, 0u);
+}
@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "anbox/audio/converter.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using namespace anbox::audio;
+
+namespace {
+const StreamFormat stereo_s16{44100, 2, StreamFormat::Sample::S16, 0};
+
+template <typename T>
+std::vector<T> convert(Converter &converter, const std::vector<std::uint8_t> &input) {
+  const auto count = input.size() / frame_size(converter.input());
+  std::vector<std::uint8_t> output(converter.max_output_frames(count) * frame_size(converter.output()));
+  const auto frames = converter.convert(input.data(), count, output.data());
+  EXPECT_LE(frames, converter.max_output_frames(count));
+
+  std::vector<T> samples(frames * converter.output().channels);
+  std::memcpy(samples.data(), output.data(), samples.size() * sizeof(T));
+  return samples;
+}
+
+template <typename T>
+std::vector<std::uint8_t> raw(const std::vector<T> &samples) {
+  std::vector<std::uint8_t> result(samples.size() * sizeof(T));
+  std::memcpy(result.data(), samples.data(), result.size());
+  return result;
+}
+}
+
+TEST(Converter, RejectsUnsupportedFormats) {
+  EXPECT_FALSE(Converter::supports(StreamFormat{44100, 0, StreamFormat::Sample::S16, 0}));
+  EXPECT_FALSE(Converter::supports(StreamFormat{1000, 2, StreamFormat::Sample::S16, 0}));
+  EXPECT_FALSE(Converter::supports(StreamFormat{44100, 2, static_cast<StreamFormat::Sample>(7), 0}));
+  EXPECT_TRUE(Converter::supports(stereo_s16));
+  EXPECT_THROW(Converter(stereo_s16, StreamFormat{44100, 9, StreamFormat::Sample::S16, 0}),
+               std::invalid_argument);
+}
+
+TEST(Converter, SameFormatIsCopied) {
+  Converter converter(stereo_s16, stereo_s16);
+  EXPECT_TRUE(converter.passthrough());
+
+  const std::vector<std::int16_t> input{1, -1, 32767, -32768};
+  EXPECT_EQ(input, convert<std::int16_t>(converter, raw(input)));
+}
+
+TEST(Converter, S16SurvivesTheTripThroughFloat) {
+  const StreamFormat stereo_f32{44100, 2, StreamFormat::Sample::F32, 0};
+  Converter to_float(stereo_s16, stereo_f32);
+  Converter to_s16(stereo_f32, stereo_s16);
+
+  const std::vector<std::int16_t> input{0, 1, -1, 12345, -12345, 32767, -32768, 100};
+  const auto floats = convert<float>(to_float, raw(input));
+  EXPECT_FLOAT_EQ(-1.0f, floats[6]);
+  EXPECT_EQ(input, convert<std::int16_t>(to_s16, raw(floats)));
+}
+
+TEST(Converter, FloatIsClampedToS16Range) {
+  Converter converter(StreamFormat{44100, 1, StreamFormat::Sample::F32, 0},
+                      StreamFormat{44100, 1, StreamFormat::Sample::S16, 0});
+  const std::vector<float> input{2.0f, -2.0f, 0.5f};
+  EXPECT_EQ((std::vector<std::int16_t>{32767, -32768, 16384}),
+            convert<std::int16_t>(converter, raw(input)));
+}
+
+TEST(Converter, MapsChannels) {
+  const StreamFormat mono_s16{44100, 1, StreamFormat::Sample::S16, 0};
+
+  Converter downmix(stereo_s16, mono_s16);
+  EXPECT_EQ((std::vector<std::int16_t>{150, -50}),
+            convert<std::int16_t>(downmix, raw(std::vector<std::int16_t>{100, 200, 0, -100})));
+
+  Converter upmix(mono_s16, stereo_s16);
+  EXPECT_EQ((std::vector<std::int16_t>{7, 7, -3, -3}),
+            convert<std::int16_t>(upmix, raw(std::vector<std::int16_t>{7, -3})));
+}
+
+TEST(Converter, ResamplesToTheOutputRate) {
+  const StreamFormat input_format{44100, 1, StreamFormat::Sample::F32, 0};
+  const StreamFormat output_format{48000, 1, StreamFormat::Sample::F32, 0};
+
+  // One second of a 1 kHz sine, fed in 10 ms chunks.
+  std::vector<float> input(44100);
+  for (std::size_t n = 0; n < input.size(); n++)
+    input[n] = static_cast<float>(std::sin(2.0 * M_PI * 1000.0 * n / 44100.0));
+
+  Converter converter(input_format, output_format);
+  std::vector<float> output;
+  for (std::size_t offset = 0; offset < input.size(); offset += 441) {
+    const std::vector<float> chunk(input.begin() + offset, input.begin() + offset + 441);
+    const auto converted = convert<float>(converter, raw(chunk));
+    output.insert(output.end(), converted.begin(), converted.end());
+  }
+
+  // All but the last input frame are turned into output, which is held
+  // back until it can be interpolated with the next call's first frame.
+  EXPECT_NEAR(48000.0, static_cast<double>(output.size()), 2.0);
+
+  // Whichever way the input was cut up, the output is the same.
+  Converter at_once(input_format, output_format);
+  EXPECT_EQ(output, convert<float>(at_once, raw(input)));
+
+  // And is still the same sine, now sampled at 48 kHz.
+  for (std::size_t n = 0; n < output.size(); n++)
+    ASSERT_NEAR(std::sin(2.0 * M_PI * 1000.0 * n / 48000.0), output[n], 0.01) << "frame " << n;
+}
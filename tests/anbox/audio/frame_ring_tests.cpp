@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "anbox/audio/frame_ring.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace anbox::audio;
+
+namespace {
+std::vector<std::uint32_t> frames(std::uint32_t first, std::size_t count) {
+  std::vector<std::uint32_t> result(count);
+  for (std::size_t n = 0; n < count; n++)
+    result[n] = first + static_cast<std::uint32_t>(n);
+  return result;
+}
+
+const std::uint8_t* bytes(const std::vector<std::uint32_t> &frames) {
+  return reinterpret_cast<const std::uint8_t*>(frames.data());
+}
+
+std::uint8_t* bytes(std::vector<std::uint32_t> &frames) {
+  return reinterpret_cast<std::uint8_t*>(frames.data());
+}
+}
+
+TEST(FrameRing, WritesOnlyWhatFits) {
+  FrameRing ring(sizeof(std::uint32_t), 4);
+
+  const auto input = frames(1, 6);
+  ASSERT_EQ(4u, ring.write(bytes(input), input.size()));
+  ASSERT_EQ(4u, ring.size());
+  ASSERT_EQ(0u, ring.write(bytes(input), input.size()));
+
+  ring.drop(2);
+  const auto stats = ring.stats();
+  EXPECT_EQ(1u, stats.overruns);
+  EXPECT_EQ(2u, stats.dropped_frames);
+  EXPECT_EQ(0u, stats.underruns);
+
+  std::vector<std::uint32_t> output(4);
+  ASSERT_EQ(4u, ring.read(bytes(output), output.size()));
+  EXPECT_EQ(frames(1, 4), output);
+}
+
+TEST(FrameRing, ShortReadIsPaddedWithSilenceAndCounted) {
+  FrameRing ring(sizeof(std::uint32_t), 8);
+
+  const auto input = frames(1, 3);
+  ring.write(bytes(input), input.size());
+
+  std::vector<std::uint32_t> output(5, 0xffffffff);
+  ASSERT_EQ(3u, ring.read(bytes(output), output.size()));
+  EXPECT_EQ((std::vector<std::uint32_t>{1, 2, 3, 0, 0}), output);
+
+  const auto stats = ring.stats();
+  EXPECT_EQ(1u, stats.underruns);
+  EXPECT_EQ(2u, stats.silent_frames);
+  EXPECT_EQ(0u, stats.overruns);
+  EXPECT_EQ(0u, ring.size());
+}
+
+TEST(FrameRing, WrapsAround) {
+  FrameRing ring(sizeof(std::uint32_t), 5);
+  std::vector<std::uint32_t> output(3);
+
+  std::uint32_t next = 0;
+  for (int round = 0; round < 10; round++) {
+    const auto input = frames(next, 3);
+    ASSERT_EQ(3u, ring.write(bytes(input), input.size()));
+    ASSERT_EQ(3u, ring.read(bytes(output), output.size()));
+    ASSERT_EQ(input, output);
+    next += 3;
+  }
+  EXPECT_EQ(0u, ring.stats().underruns);
+}
+
+TEST(FrameRing, ConcurrentProducerAndConsumerKeepOrder) {
+  FrameRing ring(sizeof(std::uint32_t), 64);
+  const std::uint32_t total = 200000;
+
+  std::thread producer([&]() {
+    std::uint32_t next = 0;
+    while (next < total) {
+      const auto input = frames(next, std::min<std::uint32_t>(17, total - next));
+      const auto written = ring.write(bytes(input), input.size());
+      if (written == 0)
+        std::this_thread::yield();
+      next += static_cast<std::uint32_t>(written);
+    }
+  });
+
+  std::uint32_t expected = 0;
+  std::vector<std::uint32_t> output(13);
+  while (expected < total) {
+    const auto available = std::min(ring.size(), output.size());
+    if (available == 0) {
+      std::this_thread::yield();
+      continue;
+    }
+    ASSERT_EQ(available, ring.read(bytes(output), available));
+    for (std::size_t n = 0; n < available; n++)
+      ASSERT_EQ(expected++, output[n]);
+  }
+
+  producer.join();
+  EXPECT_EQ(0u, ring.stats().underruns);
+}
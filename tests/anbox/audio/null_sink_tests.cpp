@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "anbox/audio/null_sink.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace anbox::audio;
+
+namespace {
+// 10ms worth of the default format.
+std::vector<std::uint8_t> period() {
+  return std::vector<std::uint8_t>(default_stream_format.rate / 100 * frame_size(default_stream_format));
+}
+}
+
+TEST(NullSink, ConsumesInRealTime) {
+  NullSink sink;
+  EXPECT_EQ(NullSink::max_latency.count(), sink.set_format(default_stream_format));
+
+  const auto data = period();
+  const auto start = std::chrono::steady_clock::now();
+  for (int n = 0; n < 20; n++)
+    sink.write_data(data.data(), data.size());
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+
+  // 200ms of audio of which the last max_latency may still be buffered.
+  EXPECT_GE(elapsed, std::chrono::milliseconds(200) - NullSink::max_latency);
+  EXPECT_LT(elapsed, std::chrono::milliseconds(1000));
+}
+
+TEST(NullSink, DoesNotCatchUpAfterPauses) {
+  NullSink sink;
+  sink.set_format(default_stream_format);
+
+  const auto data = period();
+  sink.write_data(data.data(), data.size());
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  // The pause doesn't count as played, so a burst after it blocks again.
+  const auto start = std::chrono::steady_clock::now();
+  for (int n = 0; n < 10; n++)
+    sink.write_data(data.data(), data.size());
+  EXPECT_GE(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(100) - NullSink::max_latency);
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "anbox/audio/wav_file_source.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace anbox::audio;
+
+namespace {
+void put_u16(std::string &out, std::uint16_t value) {
+  out.push_back(static_cast<char>(value & 0xff));
+  out.push_back(static_cast<char>(value >> 8));
+}
+
+void put_u32(std::string &out, std::uint32_t value) {
+  put_u16(out, static_cast<std::uint16_t>(value & 0xffff));
+  put_u16(out, static_cast<std::uint16_t>(value >> 16));
+}
+
+std::string make_wav(std::uint16_t tag, std::uint16_t channels, std::uint32_t rate,
+                     std::uint16_t bits, const std::vector<std::uint8_t> &samples) {
+  std::string fmt;
+  put_u16(fmt, tag);
+  put_u16(fmt, channels);
+  put_u32(fmt, rate);
+  put_u32(fmt, rate * channels * bits / 8);
+  put_u16(fmt, static_cast<std::uint16_t>(channels * bits / 8));
+  put_u16(fmt, bits);
+
+  std::string body{"WAVE"};
+  body += "fmt ";
+  put_u32(body, static_cast<std::uint32_t>(fmt.size()));
+  body += fmt;
+  // Unknown chunks, here with an odd size, have to be skipped.
+  body += "LIST";
+  put_u32(body, 3);
+  body += std::string("abc\0", 4);
+  body += "data";
+  put_u32(body, static_cast<std::uint32_t>(samples.size()));
+  body.append(samples.begin(), samples.end());
+
+  std::string file{"RIFF"};
+  put_u32(file, static_cast<std::uint32_t>(body.size()));
+  return file + body;
+}
+
+struct TemporaryFile {
+  explicit TemporaryFile(const std::string &content) {
+    char name[] = "/tmp/anbox-wav-XXXXXX";
+    const auto fd = ::mkstemp(name);
+    EXPECT_GE(fd, 0);
+    ::close(fd);
+    path = name;
+    std::ofstream(path, std::ofstream::binary) << content;
+  }
+  ~TemporaryFile() { ::unlink(path.c_str()); }
+
+  std::string path;
+};
+
+template <typename T>
+std::vector<std::uint8_t> raw(const std::vector<T> &samples) {
+  std::vector<std::uint8_t> result(samples.size() * sizeof(T));
+  std::memcpy(result.data(), samples.data(), result.size());
+  return result;
+}
+
+template <typename T>
+std::vector<T> read_samples(Source &source, std::size_t count) {
+  std::vector<std::uint8_t> data(count * sizeof(T));
+  source.read_data(data);
+  std::vector<T> samples(count);
+  std::memcpy(samples.data(), data.data(), data.size());
+  return samples;
+}
+}
+
+TEST(WavFileSource, LoopsFileInItsOwnFormat) {
+  const std::vector<std::int16_t> samples{1, -1, 2, -2, 3, -3};
+  TemporaryFile file{make_wav(1, 2, 22050, 16, raw(samples))};
+
+  WavFileSource source{file.path};
+  EXPECT_EQ(22050u, source.file_format().rate);
+  EXPECT_EQ(2u, source.file_format().channels);
+  EXPECT_EQ(StreamFormat::Sample::S16, source.file_format().sample);
+
+  source.set_format(source.file_format());
+  const auto first = read_samples<std::int16_t>(source, 4);
+  const auto second = read_samples<std::int16_t>(source, 6);
+  EXPECT_EQ((std::vector<std::int16_t>{1, -1, 2, -2}), first);
+  EXPECT_EQ((std::vector<std::int16_t>{3, -3, 1, -1, 2, -2}), second);
+}
+
+TEST(WavFileSource, ConvertsToClientFormat) {
+  const std::vector<float> samples{0.5f, -0.25f, 0.5f, -0.25f};
+  TemporaryFile file{make_wav(3, 1, 16000, 32, raw(samples))};
+
+  WavFileSource source{file.path};
+  EXPECT_EQ(StreamFormat::Sample::F32, source.file_format().sample);
+
+  source.set_format(StreamFormat{16000, 2, StreamFormat::Sample::S16, 0});
+  const auto converted = read_samples<std::int16_t>(source, 4);
+  EXPECT_EQ((std::vector<std::int16_t>{16384, 16384, -8192, -8192}), converted);
+}
+
+TEST(WavFileSource, RejectsUnsupportedFiles) {
+  EXPECT_THROW(WavFileSource{"/nonexistent/file.wav"}, std::runtime_error);
+
+  TemporaryFile not_wav{"this is not a wav file at all"};
+  EXPECT_THROW(WavFileSource{not_wav.path}, std::runtime_error);
+
+  const std::vector<std::uint8_t> samples(16, 0);
+  TemporaryFile eight_bit{make_wav(1, 1, 8000, 8, samples)};
+  EXPECT_THROW(WavFileSource{eight_bit.path}, std::runtime_error);
+
+  TemporaryFile empty{make_wav(1, 1, 8000, 16, {})};
+  EXPECT_THROW(WavFileSource{empty.path}, std::runtime_error);
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "anbox/common/ring_buffer.h"
+
+#include <cstring>
+
+#include <gmock/gmock.h>
+
+namespace ac = anbox::common;
+
+using namespace ::testing;
+
+TEST(RingBuffer, CapacityIsRoundedUpToPageSize) {
+  ac::RingBuffer ring(1);
+  ASSERT_GE(ring.capacity(), 4096);
+  ASSERT_EQ(0, ring.capacity() & (ring.capacity() - 1));
+  ASSERT_TRUE(ring.empty());
+  ASSERT_EQ(ring.capacity(), ring.free());
+}
+
+TEST(RingBuffer, DataStaysContiguousAcrossTheEnd) {
+  ac::RingBuffer ring(4096);
+  const auto capacity = ring.capacity();
+
+  // Move the positions close to the end of the ring.
+  ring.commit(capacity - 4);
+  ring.consume(capacity - 4);
+
+  const char data[] = "0123456789";
+  ASSERT_EQ(capacity, ring.free());
+  std::memcpy(ring.write_ptr(), data, sizeof(data));
+  ring.commit(sizeof(data));
+
+  ASSERT_EQ(sizeof(data), ring.size());
+  ASSERT_EQ(0, std::memcmp(ring.read_ptr(), data, sizeof(data)));
+}
+
+TEST(RingBuffer, GrowKeepsReadableData) {
+  ac::RingBuffer ring(4096);
+  const auto capacity = ring.capacity();
+
+  ring.commit(capacity - 2);
+  ring.consume(capacity - 2);
+  std::memset(ring.write_ptr(), 0x42, capacity);
+  ring.commit(capacity);
+  ASSERT_TRUE(ring.full());
+
+  ring.grow(capacity + 1);
+  ASSERT_EQ(capacity * 2, ring.capacity());
+  ASSERT_EQ(capacity, ring.size());
+  ASSERT_EQ(capacity, ring.free());
+
+  const auto data = ring.read_ptr();
+  for (size_t n = 0; n < capacity; n++)
+    ASSERT_EQ(0x42, data[n]);
+}
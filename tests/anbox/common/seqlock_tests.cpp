@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#include "anbox/common/seqlock.h"
+
+#include <array>
+#include <atomic>
+#include <thread>
+
+#include <gmock/gmock.h>
+
+namespace ac = anbox::common;
+
+using namespace ::testing;
+
+namespace {
+struct Sample {
+  std::array<std::uint64_t, 9> fields;
+};
+}
+
+TEST(SeqLock, CountsVersions) {
+  ac::SeqLock<int> lock{42};
+
+  std::uint64_t version = 1;
+  ASSERT_EQ(42, lock.load(&version));
+  ASSERT_EQ(0, version);
+
+  lock.update([](int &value) { value++; });
+  lock.store(7);
+
+  ASSERT_EQ(7, lock.load(&version));
+  ASSERT_EQ(2, version);
+  ASSERT_EQ(2, lock.version());
+}
+
+TEST(SeqLock, ReadersNeverSeeTornValues) {
+  ac::SeqLock<Sample> lock;
+  const std::uint64_t count = 100000;
+  std::atomic<bool> done{false};
+
+  std::thread writer([&] {
+    for (std::uint64_t n = 1; n <= count; n++)
+      lock.update([n](Sample &values) { values.fields.fill(n); });
+    done = true;
+  });
+
+  std::uint64_t last = 0;
+  while (!done) {
+    std::uint64_t version = 0;
+    const auto values = lock.load(&version);
+    for (const auto field : values.fields)
+      ASSERT_EQ(values.fields[0], field);
+    // Each update fills in its own count so the value tells the version.
+    ASSERT_EQ(version, values.fields[0]);
+    ASSERT_LE(last, version);
+    last = version;
+  }
+
+  writer.join();
+  ASSERT_EQ(count, lock.load().fields[0]);
+}
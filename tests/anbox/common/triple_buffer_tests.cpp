@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "anbox/common/triple_buffer.h"
+
+#include <thread>
+
+#include <gmock/gmock.h>
+
+namespace ac = anbox::common;
+
+using namespace ::testing;
+
+TEST(TripleBuffer, NothingToLatchBeforePublish) {
+  ac::TripleBuffer<int> buffer;
+  ASSERT_FALSE(buffer.pending());
+  ASSERT_FALSE(buffer.latch());
+}
+
+TEST(TripleBuffer, LatchesMostRecentlyPublishedValue) {
+  ac::TripleBuffer<int> buffer;
+
+  buffer.back() = 1;
+  ASSERT_FALSE(buffer.publish());
+  buffer.back() = 2;
+  // The first value was never latched and gets dropped.
+  ASSERT_TRUE(buffer.publish());
+
+  ASSERT_TRUE(buffer.latch());
+  ASSERT_EQ(2, buffer.front());
+  ASSERT_FALSE(buffer.latch());
+  ASSERT_EQ(2, buffer.front());
+
+  buffer.back() = 3;
+  ASSERT_FALSE(buffer.publish());
+  ASSERT_TRUE(buffer.latch());
+  ASSERT_EQ(3, buffer.front());
+}
+
+TEST(TripleBuffer, ConsumerNeverSeesOlderValues) {
+  ac::TripleBuffer<int> buffer;
+  const int count = 100000;
+
+  std::thread producer([&] {
+    for (int n = 1; n <= count; n++) {
+      buffer.back() = n;
+      buffer.publish();
+    }
+  });
+
+  int last = 0;
+  bool ordered = true;
+  while (ordered && last < count) {
+    if (!buffer.latch()) continue;
+    ordered = buffer.front() > last;
+    last = buffer.front();
+  }
+
+  producer.join();
+  ASSERT_TRUE(ordered);
+}
@@ -18,6 +18,7 @@
 #include "anbox/graphics/buffered_io_stream.h"
 
 #include <chrono>
+#include <future>
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
@@ -43,6 +44,11 @@ class MockSocketMessenger :
   MOCK_METHOD1(receive_msg, boost::system::error_code(boost::asio::mutable_buffers_1 const&));
   MOCK_METHOD0(available_bytes, size_t());
 };
+
+class MockVectoredSocketMessenger : public MockSocketMessenger {
+ public:
+  MOCK_METHOD2(send_raw_vectored, ssize_t(struct iovec const*, size_t));
+};
 }
 
 namespace anbox {
@@ -93,6 +99,40 @@ TEST(BufferedIOStream, WriterContinuesWhenSocketIsBusy) {
   ASSERT_EQ(stream.commitBuffer(buffer_size), buffer_size);
 }
 
+TEST(BufferedIOStream, PendingRepliesAreWrittenTogether) {
+  auto messenger = std::make_shared<MockVectoredSocketMessenger>();
+  BufferedIOStream stream(messenger);
+
+  std::promise<void> writing;
+  std::promise<void> proceed;
+  auto proceed_future = proceed.get_future();
+
+  // The socket is busy for the first reply so it goes to the writer
+  // which we hold on to until two more replies got queued up behind it.
+  EXPECT_CALL(*messenger, send_raw(_, 10))
+      .Times(1)
+      .WillOnce(DoAll(Invoke([](char const*, size_t) { errno = EAGAIN; }), Return(-EAGAIN)));
+  EXPECT_CALL(*messenger, send_raw_vectored(_, 1))
+      .Times(1)
+      .WillOnce(DoAll(Invoke([&](struct iovec const*, size_t) {
+                        writing.set_value();
+                        proceed_future.wait();
+                      }),
+                      Return(10)));
+  EXPECT_CALL(*messenger, send_raw_vectored(_, 2))
+      .Times(1)
+      .WillOnce(Return(30));
+
+  stream.allocBuffer(10);
+  ASSERT_EQ(stream.commitBuffer(10), 10);
+  writing.get_future().wait();
+
+  stream.allocBuffer(20);
+  ASSERT_EQ(stream.commitBuffer(10), 10);
+  ASSERT_EQ(stream.commitBuffer(20), 20);
+  proceed.set_value();
+}
+
 TEST(BufferedIOStream, ReadWhenEnoughDataAvailable) {
   auto messenger = std::make_shared<MockSocketMessenger>();
   BufferedIOStream stream(messenger);
@@ -141,5 +181,72 @@ TEST(BufferedIOStream, ReadWithNoDataAvailable) {
   stopped = true;
   producer.join();
 }
+
+TEST(BufferedIOStream, ReadInPlaceWaitsForMoreThanPending) {
+  auto messenger = std::make_shared<MockSocketMessenger>();
+  BufferedIOStream stream(messenger);
+
+  Buffer buffer;
+  buffer.push_back(0x12);
+  buffer.push_back(0x34);
+  stream.post_data(std::move(buffer));
+
+  size_t len = 0;
+  auto data = stream.readInPlace(0, &len);
+  ASSERT_NE(nullptr, data);
+  EXPECT_EQ(2, len);
+  EXPECT_EQ(0x12, data[0]);
+
+  std::thread producer([&]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    Buffer more;
+    more.push_back(0x56);
+    stream.post_data(std::move(more));
+  });
+
+  // Nothing was consumed, so we only return once the third byte arrived.
+  data = stream.readInPlace(len, &len);
+  ASSERT_NE(nullptr, data);
+  EXPECT_EQ(3, len);
+  EXPECT_EQ(0x12, data[0]);
+  EXPECT_EQ(0x56, data[2]);
+
+  producer.join();
+
+  stream.consume(len);
+  EXPECT_TRUE(stream.needs_data());
+}
+
+TEST(BufferedIOStream, ReadInPlaceGrowsForPacketsLargerThanTheRing) {
+  auto messenger = std::make_shared<MockSocketMessenger>();
+  BufferedIOStream stream(messenger);
+
+  const size_t packet_size{BufferedIOStream::default_ring_size + 16};
+  std::thread producer([&]() {
+    size_t written = 0;
+    while (written < packet_size) {
+      size_t available = 0;
+      auto ptr = static_cast<std::uint8_t*>(stream.prepare_receive(&available));
+      ASSERT_NE(nullptr, ptr);
+      const auto count = std::min(available, packet_size - written);
+      memset(ptr, 0x42, count);
+      stream.commit_receive(count);
+      written += count;
+    }
+  });
+
+  size_t len = 0;
+  unsigned char *data = nullptr;
+  do {
+    data = stream.readInPlace(len, &len);
+    ASSERT_NE(nullptr, data);
+  } while (len < packet_size);
+
+  producer.join();
+
+  EXPECT_EQ(packet_size, len);
+  EXPECT_EQ(0x42, data[0]);
+  EXPECT_EQ(0x42, data[packet_size - 1]);
+}
 } // namespace graphics
 } // namespace anbox
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include "anbox/graphics/emugl/RenderApi.h"
+#include "anbox/graphics/emugl/RenderThreadInfo.h"
+#include "anbox/graphics/emugl/Renderer.h"
+
+#include <GLES2/gl2.h>
+
+#include <cstdlib>
+
+namespace {
+constexpr int buffer_size{16};
+
+// Runs against the host GL libraries and skips when there are none, e.g.
+// without a GPU and a software rasterizer.
+class RecycledColorBuffers : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Don't require a running display server (honored by Mesa).
+    setenv("EGL_PLATFORM", "surfaceless", 0);
+    if (!anbox::graphics::emugl::initialize(anbox::graphics::emugl::default_gl_libraries(), nullptr, nullptr) ||
+        !renderer.initialize(EGL_DEFAULT_DISPLAY))
+      GTEST_SKIP() << "No host GL available";
+
+    context = renderer.createRenderContext(0, 0, true);
+    surface = renderer.createWindowSurface(0, buffer_size, buffer_size);
+    ASSERT_NE(0, context);
+    ASSERT_NE(0, surface);
+    ASSERT_TRUE(renderer.bindContext(context, surface, surface));
+  }
+
+  void TearDown() override {
+    if (!context) return;
+    renderer.bindContext(0, 0, 0);
+    renderer.DestroyWindowSurface(surface);
+    renderer.DestroyRenderContext(context);
+    renderer.finalize();
+  }
+
+  HandleType create_buffer() {
+    return renderer.createColorBuffer(buffer_size, buffer_size, GL_RGBA);
+  }
+
+  RenderThreadInfo thread_info;
+  Renderer renderer;
+  HandleType context = 0;
+  HandleType surface = 0;
+};
+}
+
+TEST_F(RecycledColorBuffers, ReusesClosedBuffers) {
+  const auto &pool = renderer.getColorBufferPool();
+
+  renderer.closeColorBuffer(create_buffer());
+  ASSERT_EQ(1, pool.size());
+
+  const auto hits = pool.hits();
+  const auto buffer = create_buffer();
+  EXPECT_EQ(hits + 1, pool.hits());
+  EXPECT_EQ(0, pool.size());
+  renderer.closeColorBuffer(buffer);
+}
+
+TEST_F(RecycledColorBuffers, NeverHandsOutBuffersBoundToGuest) {
+  const auto &pool = renderer.getColorBufferPool();
+
+  GLuint texture = 0;
+  s_gles2.glGenTextures(1, &texture);
+  s_gles2.glBindTexture(GL_TEXTURE_2D, texture);
+  const auto textured = create_buffer();
+  ASSERT_TRUE(renderer.bindColorBufferToTexture(textured));
+  renderer.closeColorBuffer(textured);
+
+  GLuint renderbuffer = 0;
+  s_gles2.glGenRenderbuffers(1, &renderbuffer);
+  s_gles2.glBindRenderbuffer(GL_RENDERBUFFER, renderbuffer);
+  const auto rendered = create_buffer();
+  ASSERT_TRUE(renderer.bindColorBufferToRenderbuffer(rendered));
+  renderer.closeColorBuffer(rendered);
+
+  // Both still back the guest's texture and renderbuffer.
+  EXPECT_EQ(0, pool.size());
+  const auto hits = pool.hits();
+  const auto buffer = create_buffer();
+  EXPECT_EQ(hits, pool.hits());
+  renderer.closeColorBuffer(buffer);
+
+  s_gles2.glDeleteRenderbuffers(1, &renderbuffer);
+  s_gles2.glDeleteTextures(1, &texture);
+}
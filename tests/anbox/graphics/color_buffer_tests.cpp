@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include "anbox/graphics/emugl/DispatchTables.h"
+#include "anbox/graphics/emugl/RenderApi.h"
+#include "anbox/graphics/emugl/RenderThreadInfo.h"
+#include "anbox/graphics/emugl/Renderer.h"
+
+#include <GLES2/gl2.h>
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+
+namespace {
+constexpr int buffer_size{16};
+
+// Runs against the host GL libraries and skips when there are none, e.g.
+// without a GPU and a software rasterizer.
+class ColorBufferBlit : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Don't require a running display server (honored by Mesa).
+    setenv("EGL_PLATFORM", "surfaceless", 0);
+    if (!anbox::graphics::emugl::initialize(anbox::graphics::emugl::default_gl_libraries(), nullptr, nullptr) ||
+        !renderer.initialize(EGL_DEFAULT_DISPLAY))
+      GTEST_SKIP() << "No host GL available";
+
+    context = renderer.createRenderContext(0, 0, true);
+    surface = renderer.createWindowSurface(0, buffer_size, buffer_size);
+    ASSERT_NE(0, context);
+    ASSERT_NE(0, surface);
+    ASSERT_TRUE(renderer.bindContext(context, surface, surface));
+  }
+
+  void TearDown() override {
+    if (!context) return;
+    renderer.bindContext(0, 0, 0);
+    renderer.DestroyWindowSurface(surface);
+    renderer.DestroyRenderContext(context);
+    renderer.finalize();
+  }
+
+  // Clears the guest's surface and flushes it into |buffer|.
+  void flush(HandleType buffer, float red) {
+    ASSERT_TRUE(renderer.setWindowSurfaceColorBuffer(surface, buffer));
+    s_gles2.glClearColor(red, 0.0f, 0.0f, 1.0f);
+    s_gles2.glClear(GL_COLOR_BUFFER_BIT);
+    ASSERT_TRUE(renderer.flushWindowSurfaceColorBuffer(surface));
+  }
+
+  std::uint8_t red_of(HandleType buffer) {
+    std::array<std::uint8_t, 4> pixel{};
+    renderer.readColorBuffer(buffer, 0, 0, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixel.data());
+    return pixel[0];
+  }
+
+  RenderThreadInfo thread_info;
+  Renderer renderer;
+  HandleType context = 0;
+  HandleType surface = 0;
+};
+}
+
+TEST_F(ColorBufferBlit, CopiesTheReadSurface) {
+  const auto buffer = renderer.createColorBuffer(buffer_size, buffer_size, GL_RGBA);
+  ASSERT_NE(0, buffer);
+
+  flush(buffer, 1.0f);
+  EXPECT_EQ(255, red_of(buffer));
+  flush(buffer, 0.0f);
+  EXPECT_EQ(0, red_of(buffer));
+
+  renderer.closeColorBuffer(buffer);
+}
+
+TEST_F(ColorBufferBlit, LeavesTheGuestNamespaceAlone) {
+  const auto buffer = renderer.createColorBuffer(buffer_size, buffer_size, GL_RGBA);
+  ASSERT_NE(0, buffer);
+  flush(buffer, 1.0f);
+
+  // A GLES 2 guest may bind names it never generated, so the host must not
+  // have taken any of them for its own objects.
+  for (GLuint name = 1; name <= 8; name++) {
+    EXPECT_FALSE(s_gles2.glIsTexture(name)) << name;
+    EXPECT_FALSE(s_gles2.glIsFramebufferEXT(name)) << name;
+  }
+
+  renderer.closeColorBuffer(buffer);
+}
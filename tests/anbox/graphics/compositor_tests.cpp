@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+// Both includes need to go first as otherwise they can conflict with EGL.h
+// being included by the following includes.
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "anbox/application/database.h"
+#include "anbox/platform/base_platform.h"
+#include "anbox/wm/multi_window_manager.h"
+#include "anbox/wm/window_state.h"
+
+#include "anbox/graphics/compositor.h"
+#include "anbox/graphics/layer_composer.h"
+#include "anbox/graphics/multi_window_composer_strategy.h"
+
+#include <future>
+
+using namespace ::testing;
+
+namespace {
+class MockRenderer : public anbox::graphics::Renderer {
+ public:
+  MOCK_METHOD3(draw, bool(EGLNativeWindowType, const anbox::graphics::Rect&,
+                          const RenderableList&));
+  MOCK_METHOD4(draw_with_damage, bool(EGLNativeWindowType, const anbox::graphics::Rect&,
+                                      const RenderableList&, const anbox::graphics::Rect&));
+};
+
+constexpr std::chrono::seconds default_timeout{5};
+}
+
+namespace anbox {
+namespace graphics {
+class CompositorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    platform::Configuration config;
+    // The default policy will create a dumb window instance when requested
+    // from the manager.
+    platform = platform::create(std::string(), nullptr, config);
+    app_db = std::make_shared<application::Database>();
+    wm = std::make_shared<wm::MultiWindowManager>(platform, nullptr, app_db);
+
+    wm->apply_window_state_update({wm::WindowState{
+        wm::Display::Id{1},
+        true,
+        graphics::Rect{0, 0, 1024, 768},
+        "org.anbox.foo",
+        wm::Task::Id{1},
+        wm::Stack::Id::Freeform,
+    }}, {});
+
+    composer = std::make_shared<LayerComposer>(
+        renderer, std::make_shared<MultiWindowComposerStrategy>(wm));
+  }
+
+  static RenderableList frame(std::uint32_t buffer) {
+    return {{"org.anbox.surface.1", buffer, 1.0f, {0, 0, 1024, 768}, {0, 0, 1024, 768}}};
+  }
+
+  std::shared_ptr<MockRenderer> renderer = std::make_shared<MockRenderer>();
+  std::shared_ptr<platform::BasePlatform> platform;
+  std::shared_ptr<application::Database> app_db;
+  std::shared_ptr<wm::MultiWindowManager> wm;
+  std::shared_ptr<LayerComposer> composer;
+};
+
+TEST_F(CompositorTest, SupersededFramesAreDropped) {
+  std::promise<void> first_drawn, last_drawn, release;
+  auto released = release.get_future().share();
+
+  EXPECT_CALL(*renderer, draw(_, _, frame(0)))
+      .WillOnce(Invoke([&](EGLNativeWindowType, const Rect&, const RenderableList&) {
+        first_drawn.set_value();
+        released.wait();
+        return true;
+      }));
+  EXPECT_CALL(*renderer, draw(_, _, frame(1))).Times(0);
+  EXPECT_CALL(*renderer, draw(_, _, frame(2)))
+      .WillOnce(Invoke([&](EGLNativeWindowType, const Rect&, const RenderableList&) {
+        last_drawn.set_value();
+        return true;
+      }));
+
+  Compositor compositor(composer, std::chrono::nanoseconds{0});
+
+  compositor.submit_layers(frame(0));
+  ASSERT_EQ(std::future_status::ready, first_drawn.get_future().wait_for(default_timeout));
+
+  // Posting frames must not wait for the one being presented.
+  compositor.submit_layers(frame(1));
+  compositor.submit_layers(frame(2));
+  release.set_value();
+
+  ASSERT_EQ(std::future_status::ready, last_drawn.get_future().wait_for(default_timeout));
+  compositor.stop();
+
+  ASSERT_EQ(1, compositor.dropped_frames());
+}
+
+TEST_F(CompositorTest, PresentsAtMostOncePerVsyncPeriod) {
+  const std::chrono::milliseconds vsync_period{50};
+  std::promise<void> first_drawn, second_drawn;
+
+  EXPECT_CALL(*renderer, draw(_, _, frame(0)))
+      .WillOnce(Invoke([&](EGLNativeWindowType, const Rect&, const RenderableList&) {
+        first_drawn.set_value();
+        return true;
+      }));
+  EXPECT_CALL(*renderer, draw(_, _, frame(1)))
+      .WillOnce(Invoke([&](EGLNativeWindowType, const Rect&, const RenderableList&) {
+        second_drawn.set_value();
+        return true;
+      }));
+
+  const auto start = std::chrono::steady_clock::now();
+  Compositor compositor(composer, vsync_period);
+
+  compositor.submit_layers(frame(0));
+  ASSERT_EQ(std::future_status::ready, first_drawn.get_future().wait_for(default_timeout));
+  compositor.submit_layers(frame(1));
+  ASSERT_EQ(std::future_status::ready, second_drawn.get_future().wait_for(default_timeout));
+
+  ASSERT_GE(std::chrono::steady_clock::now() - start, vsync_period);
+  ASSERT_EQ(vsync_period, compositor.vsync_period());
+}
+}
+}
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "anbox/graphics/frame_exporter.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace anbox {
+namespace graphics {
+namespace {
+void paint(const FrameExporter::Target &target, std::uint8_t value) {
+  const auto &r = target.region;
+  for (auto y = r.top(); y < r.bottom(); y++)
+    std::memset(target.pixels + y * target.stride + r.left() * 4, value, r.width() * 4);
+}
+
+std::uint8_t pixel(const FrameExportReader::Frame &frame, std::int32_t x, std::int32_t y) {
+  return frame.pixels[y * frame.stride + x * 4];
+}
+}
+
+TEST(FrameExporter, FirstFramesAreCopiedCompletely) {
+  FrameExporter exporter(7, 64, 64);
+  FrameExportReader reader(exporter.fd());
+  EXPECT_EQ(7, reader.task());
+  EXPECT_FALSE(reader.latch());
+  EXPECT_EQ(0u, reader.current().sequence);
+
+  const auto target = exporter.begin_frame(32, 16, Rect{0, 0, 4, 4});
+  EXPECT_EQ(Rect(32, 16), target.region);
+  EXPECT_EQ(32u * 4, target.stride);
+  paint(target, 1);
+  exporter.end_frame();
+
+  ASSERT_TRUE(reader.latch());
+  const auto frame = reader.current();
+  EXPECT_EQ(1u, frame.sequence);
+  EXPECT_EQ(32u, frame.width);
+  EXPECT_EQ(16u, frame.height);
+  EXPECT_EQ(Rect(0, 0, 4, 4), frame.damage);
+  EXPECT_EQ(1, pixel(frame, 31, 15));
+  EXPECT_FALSE(reader.latch());
+}
+
+TEST(FrameExporter, SlotsOnlyReceiveWhatTheyMiss) {
+  FrameExporter exporter(1, 64, 64);
+  FrameExportReader reader(exporter.fd());
+
+  // Fill all three slots once.
+  for (std::uint8_t n = 1; n <= 3; n++) {
+    paint(exporter.begin_frame(16, 16, Rect(16, 16)), n);
+    exporter.end_frame();
+    reader.latch();
+  }
+
+  // The slot holding frame 1 misses the complete frames 2 and 3.
+  auto target = exporter.begin_frame(16, 16, Rect{0, 0, 2, 2});
+  EXPECT_EQ(Rect(16, 16), target.region);
+  paint(target, 4);
+  exporter.end_frame();
+  reader.latch();
+
+  target = exporter.begin_frame(16, 16, Rect{8, 8, 10, 10});
+  EXPECT_EQ(Rect(16, 16), target.region);
+  paint(target, 5);
+  exporter.end_frame();
+  reader.latch();
+
+  // The slot holding frame 3 misses frames 4 and 5 only.
+  target = exporter.begin_frame(16, 16, Rect{12, 12, 13, 13});
+  EXPECT_EQ(Rect(0, 0, 13, 13), target.region);
+  paint(target, 6);
+  exporter.end_frame();
+
+  ASSERT_TRUE(reader.latch());
+  const auto frame = reader.current();
+  EXPECT_EQ(6u, frame.sequence);
+  EXPECT_EQ(Rect(12, 12, 13, 13), frame.damage);
+  EXPECT_EQ(6, pixel(frame, 0, 0));
+  EXPECT_EQ(6, pixel(frame, 12, 12));
+  EXPECT_EQ(3, pixel(frame, 15, 15));
+}
+
+TEST(FrameExporter, SkippedFramesAddTheirDamage) {
+  FrameExporter exporter(1, 64, 64);
+  FrameExportReader reader(exporter.fd());
+
+  paint(exporter.begin_frame(16, 16, Rect(16, 16)), 1);
+  exporter.end_frame();
+  reader.latch();
+
+  paint(exporter.begin_frame(16, 16, Rect{0, 0, 1, 1}), 2);
+  exporter.end_frame();
+  paint(exporter.begin_frame(16, 16, Rect{4, 4, 5, 5}), 3);
+  exporter.end_frame();
+
+  ASSERT_TRUE(reader.latch());
+  const auto frame = reader.current();
+  EXPECT_EQ(3u, frame.sequence);
+  EXPECT_EQ(Rect(0, 0, 5, 5), frame.damage);
+}
+
+TEST(FrameExporter, CropsFramesLargerThanTheSlots) {
+  FrameExporter exporter(1, 16, 16);
+  const auto target = exporter.begin_frame(32, 32, Rect(32, 32));
+  EXPECT_EQ(Rect(32, 8), target.region);
+  exporter.end_frame();
+
+  FrameExportReader reader(exporter.fd());
+  ASSERT_TRUE(reader.latch());
+  EXPECT_EQ(32u, reader.current().width);
+  EXPECT_EQ(8u, reader.current().height);
+}
+
+TEST(FrameExporter, ReportsClose) {
+  FrameExporter exporter(1, 16, 16);
+  FrameExportReader reader(exporter.fd());
+  EXPECT_FALSE(reader.closed());
+  exporter.close();
+  EXPECT_TRUE(reader.closed());
+}
+
+TEST(FrameExporter, RejectsOtherFiles) {
+  Fd fd(::memfd_create("other", MFD_CLOEXEC));
+  ASSERT_EQ(0, ::ftruncate(fd, 8192));
+  EXPECT_THROW(FrameExportReader{fd}, std::runtime_error);
+}
+}
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "anbox/graphics/emugl/HandleTable.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <set>
+
+TEST(HandleTable, InsertedObjectsCanBeFound) {
+  HandleTable<int> table(1);
+  const auto a = table.insert(42);
+  const auto b = table.insert(23);
+
+  ASSERT_NE(0u, a);
+  ASSERT_NE(0u, b);
+  ASSERT_NE(a, b);
+  EXPECT_EQ(2u, table.size());
+  ASSERT_NE(nullptr, table.find(a));
+  EXPECT_EQ(42, *table.find(a));
+  ASSERT_NE(nullptr, table.find(b));
+  EXPECT_EQ(23, *table.find(b));
+  EXPECT_EQ(nullptr, table.find(0));
+}
+
+TEST(HandleTable, StaleHandlesDontResolveToReusedSlots) {
+  HandleTable<std::shared_ptr<int>> table(1);
+  const auto stale = table.insert(std::make_shared<int>(1));
+  const auto obj = *table.find(stale);
+
+  EXPECT_TRUE(table.erase(stale));
+  EXPECT_FALSE(table.erase(stale));
+  EXPECT_EQ(nullptr, table.find(stale));
+  // Erasing drops the reference the table held.
+  EXPECT_EQ(1, obj.use_count());
+
+  const auto handle = table.insert(std::make_shared<int>(2));
+  EXPECT_NE(stale, handle);
+  EXPECT_EQ(nullptr, table.find(stale));
+  EXPECT_EQ(2, **table.find(handle));
+}
+
+TEST(HandleTable, HandlesOfDifferentTablesDontCollide) {
+  HandleTable<int> contexts(1);
+  HandleTable<int> surfaces(2);
+
+  std::set<HandleType> handles;
+  for (int n = 0; n < 100; n++) {
+    handles.insert(contexts.insert(n));
+    handles.insert(surfaces.insert(n));
+  }
+  EXPECT_EQ(200u, handles.size());
+  for (const auto handle : handles)
+    EXPECT_TRUE(contexts.find(handle) == nullptr || surfaces.find(handle) == nullptr);
+}
+
+TEST(HandleTable, InsertFailsWhenFull) {
+  HandleTable<int> table(3);
+  for (size_t n = 0; n < HandleTable<int>::max_size; n++)
+    ASSERT_NE(0u, table.insert(0));
+  EXPECT_EQ(0u, table.insert(0));
+
+  table.clear();
+  EXPECT_TRUE(table.empty());
+  EXPECT_NE(0u, table.insert(0));
+}
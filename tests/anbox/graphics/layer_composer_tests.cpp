@@ -35,6 +35,10 @@ class MockRenderer : public anbox::graphics::Renderer {
  public:
   MOCK_METHOD3(draw, bool(EGLNativeWindowType, const anbox::graphics::Rect&,
                           const RenderableList&));
+  MOCK_METHOD4(draw_with_damage, bool(EGLNativeWindowType, const anbox::graphics::Rect&,
+                                      const RenderableList&, const anbox::graphics::Rect&));
+  MOCK_METHOD0(begin_frame, void());
+  MOCK_METHOD0(end_frame, void());
 };
 }
 
@@ -231,5 +235,112 @@ TEST(LayerComposer, PopupShouldNotCauseWindowLayerOffset) {
   composer.submit_layers(renderables);
 }
 
+TEST(LayerComposer, OnlyChangedLayersAreDamaged) {
+  auto renderer = std::make_shared<MockRenderer>();
+
+  platform::Configuration config;
+  // The default policy will create a dumb window instance when requested
+  // from the manager.
+  auto platform = platform::create(std::string(), nullptr, config);
+  auto app_db = std::make_shared<application::Database>();
+  auto wm = std::make_shared<wm::MultiWindowManager>(platform, nullptr, app_db);
+
+  auto window = wm::WindowState{
+      wm::Display::Id{1},
+      true,
+      graphics::Rect{0, 0, 1024, 768},
+      "org.anbox.foo",
+      wm::Task::Id{1},
+      wm::Stack::Id::Freeform,
+  };
+
+  wm->apply_window_state_update({window}, {});
+
+  LayerComposer composer(renderer, std::make_shared<MultiWindowComposerStrategy>(wm));
+
+  RenderableList first_frame = {
+    {"org.anbox.surface.1", 0, 1.0f, {0, 0, 1024, 768}, {0, 0, 1024, 768}},
+    {"org.anbox.surface.1", 1, 1.0f, {100, 100, 200, 150}, {0, 0, 100, 50}},
+  };
+
+  // Only the buffer of the small layer changes with the second frame and
+  // the third one is identical to the second one.
+  RenderableList second_frame = {
+    {"org.anbox.surface.1", 0, 1.0f, {0, 0, 1024, 768}, {0, 0, 1024, 768}},
+    {"org.anbox.surface.1", 2, 1.0f, {100, 100, 200, 150}, {0, 0, 100, 50}},
+  };
+
+  const Rect frame{0, 0, 1024, 768};
+
+  InSequence s;
+  EXPECT_CALL(*renderer, draw(_, frame, first_frame))
+      .Times(1)
+      .WillOnce(Return(true));
+  EXPECT_CALL(*renderer, draw_with_damage(_, frame, second_frame, Rect{100, 100, 200, 150}))
+      .Times(1)
+      .WillOnce(Return(true));
+  EXPECT_CALL(*renderer, draw_with_damage(_, frame, second_frame, Rect::Empty))
+      .Times(1)
+      .WillOnce(Return(true));
+
+  composer.submit_layers(first_frame);
+  composer.submit_layers(second_frame);
+  composer.submit_layers(second_frame);
+}
+
+TEST(LayerComposer, DrawsAllWindowsWithinOneFrame) {
+  auto renderer = std::make_shared<MockRenderer>();
+
+  platform::Configuration config;
+  auto platform = platform::create(std::string(), nullptr, config);
+  auto app_db = std::make_shared<application::Database>();
+  auto wm = std::make_shared<wm::MultiWindowManager>(platform, nullptr, app_db);
+
+  auto first_window = wm::WindowState{
+      wm::Display::Id{1},
+      true,
+      graphics::Rect{0, 0, 1024, 768},
+      "org.anbox.foo",
+      wm::Task::Id{1},
+      wm::Stack::Id::Freeform,
+  };
+
+  auto second_window = wm::WindowState{
+      wm::Display::Id{1},
+      true,
+      graphics::Rect{300, 400, 1324, 1168},
+      "org.anbox.bar",
+      wm::Task::Id{2},
+      wm::Stack::Id::Freeform,
+  };
+
+  wm->apply_window_state_update({first_window, second_window}, {});
+
+  LayerComposer composer(renderer, std::make_shared<MultiWindowComposerStrategy>(wm));
+
+  RenderableList renderables = {
+      {"org.anbox.surface.1", 0, 1.0f, {0, 0, 1024, 768}, {0, 0, 1024, 768}},
+      {"org.anbox.surface.2", 1, 1.0f, {0, 0, 1024, 768}, {0, 0, 1024, 768}},
+  };
+
+  // The renderer keeps its context bound across both windows.
+  {
+    InSequence s;
+    EXPECT_CALL(*renderer, begin_frame()).Times(1);
+    EXPECT_CALL(*renderer, draw(_, _, _)).Times(2).WillRepeatedly(Return(true));
+    EXPECT_CALL(*renderer, end_frame()).Times(1);
+  }
+
+  composer.submit_layers(renderables);
+
+  // Nothing is drawn and no frame started for layers without a window.
+  EXPECT_CALL(*renderer, begin_frame()).Times(0);
+  EXPECT_CALL(*renderer, end_frame()).Times(0);
+  RenderableList orphaned = {
+      {"org.anbox.surface.3", 2, 1.0f, {0, 0, 1024, 768}, {0, 0, 1024, 768}},
+  };
+  composer.submit_layers(orphaned);
+}
+
 }  // namespace graphics
 }  // namespace anbox
@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "anbox/graphics/program_binary_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+
+namespace fs = boost::filesystem;
+
+namespace anbox {
+namespace graphics {
+namespace {
+ProgramBinaryCache::Binary make_binary(std::uint32_t format, std::size_t size) {
+  ProgramBinaryCache::Binary binary;
+  binary.format = format;
+  binary.data.resize(size);
+  for (std::size_t n = 0; n < size; n++)
+    binary.data[n] = static_cast<std::uint8_t>(n * 13 + format);
+  return binary;
+}
+
+class ProgramBinaryCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    path = fs::temp_directory_path() / fs::unique_path("%%%%-%%%%.programs");
+  }
+  void TearDown() override { fs::remove_all(path); }
+
+  fs::path path;
+};
+}
+
+TEST_F(ProgramBinaryCacheTest, LoadsWhatWasStored) {
+  ProgramBinaryCache cache(path);
+
+  ProgramBinaryCache::Binary binary;
+  EXPECT_FALSE(cache.load("program a", binary));
+
+  const auto stored = make_binary(0x8740, 1000);
+  cache.store("program a", stored);
+
+  ASSERT_TRUE(cache.load("program a", binary));
+  EXPECT_EQ(stored.format, binary.format);
+  EXPECT_EQ(stored.data, binary.data);
+  EXPECT_FALSE(cache.load("program b", binary));
+
+  const auto stats = cache.statistics();
+  EXPECT_EQ(1u, stats.hits);
+  EXPECT_EQ(2u, stats.misses);
+  EXPECT_EQ(1u, stats.stores);
+  EXPECT_EQ(1u, stats.entries);
+}
+
+TEST_F(ProgramBinaryCacheTest, EntriesSurviveRestarts) {
+  const auto stored = make_binary(1, 4096);
+  {
+    ProgramBinaryCache cache(path);
+    cache.store("program", stored);
+  }
+
+  ProgramBinaryCache cache(path);
+  EXPECT_EQ(1u, cache.statistics().entries);
+
+  ProgramBinaryCache::Binary binary;
+  ASSERT_TRUE(cache.load("program", binary));
+  EXPECT_EQ(stored.data, binary.data);
+}
+
+TEST_F(ProgramBinaryCacheTest, EvictsLeastRecentlyUsedEntries) {
+  // Room for two of the entries but not for three.
+  ProgramBinaryCache cache(path, 2500);
+  cache.store("a", make_binary(1, 1000));
+  cache.store("b", make_binary(2, 1000));
+
+  ProgramBinaryCache::Binary binary;
+  ASSERT_TRUE(cache.load("a", binary));
+
+  cache.store("c", make_binary(3, 1000));
+
+  EXPECT_TRUE(cache.load("a", binary));
+  EXPECT_FALSE(cache.load("b", binary));
+  EXPECT_TRUE(cache.load("c", binary));
+
+  const auto stats = cache.statistics();
+  EXPECT_EQ(1u, stats.evictions);
+  EXPECT_EQ(2u, stats.entries);
+  EXPECT_LE(stats.size, 2500u);
+}
+
+TEST_F(ProgramBinaryCacheTest, RejectedEntriesAreRemoved) {
+  ProgramBinaryCache cache(path);
+  cache.store("program", make_binary(1, 100));
+  cache.reject("program");
+
+  ProgramBinaryCache::Binary binary;
+  EXPECT_FALSE(cache.load("program", binary));
+
+  const auto stats = cache.statistics();
+  EXPECT_EQ(1u, stats.rejects);
+  EXPECT_EQ(0u, stats.entries);
+  EXPECT_EQ(0u, stats.size);
+}
+
+TEST_F(ProgramBinaryCacheTest, IgnoresCorruptEntries) {
+  {
+    ProgramBinaryCache cache(path);
+    cache.store("program", make_binary(1, 100));
+  }
+
+  for (fs::directory_iterator it{path / "v1"}, end; it != end; ++it)
+    fs::resize_file(it->path(), 10);
+
+  ProgramBinaryCache cache(path);
+  ProgramBinaryCache::Binary binary;
+  EXPECT_FALSE(cache.load("program", binary));
+  EXPECT_EQ(1u, cache.statistics().misses);
+}
+
+TEST_F(ProgramBinaryCacheTest, RemovesEntriesWithBogusSizes) {
+  {
+    ProgramBinaryCache cache(path);
+    cache.store("program", make_binary(1, 100));
+  }
+
+  // Claim far more data than the file holds.
+  const std::uint64_t data_size = 1ULL << 62;
+  for (fs::directory_iterator it{path / "v1"}, end; it != end; ++it) {
+    std::fstream f(it->path().string(), std::ios::binary | std::ios::in | std::ios::out);
+    f.seekp(24);
+    f.write(reinterpret_cast<const char*>(&data_size), sizeof(data_size));
+  }
+
+  ProgramBinaryCache cache(path);
+  ProgramBinaryCache::Binary binary;
+  EXPECT_FALSE(cache.load("program", binary));
+
+  const auto stats = cache.statistics();
+  EXPECT_EQ(1u, stats.rejects);
+  EXPECT_EQ(0u, stats.entries);
+  EXPECT_EQ(0u, stats.size);
+  EXPECT_TRUE(fs::is_empty(path / "v1"));
+}
+
+TEST_F(ProgramBinaryCacheTest, RemovesEntriesOfOtherVersions) {
+  fs::create_directories(path / "v0");
+  std::ofstream(fs::path(path / "v0" / "0123456789abcdef").string()) << "old";
+
+  ProgramBinaryCache cache(path);
+  EXPECT_FALSE(fs::exists(path / "v0"));
+  EXPECT_TRUE(fs::is_directory(path / "v1"));
+}
+}  // namespace graphics
+}  // namespace anbox
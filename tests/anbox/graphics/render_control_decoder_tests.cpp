@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include "external/android-emugl/host/include/libOpenglRender/IOStream.h"
+#include "external/android-emugl/shared/OpenglCodecCommon/ChecksumCalculatorThreadInfo.h"
+
+// Generated with emugl at build time
+#include "renderControl_dec.h"
+#include "renderControl_opcodes.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace {
+// Places data right in front of an inaccessible page so that the decoder
+// faults as soon as it reads a single byte past the end of the stream.
+class GuardedBuffer {
+ public:
+  explicit GuardedBuffer(const std::vector<std::uint8_t> &data) {
+    page_size_ = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    map_size_ = ((data.size() + page_size_ - 1) / page_size_ + 1) * page_size_;
+    map_ = static_cast<std::uint8_t *>(mmap(nullptr, map_size_, PROT_READ | PROT_WRITE,
+                                            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    mprotect(map_ + map_size_ - page_size_, page_size_, PROT_NONE);
+    data_ = map_ + map_size_ - page_size_ - data.size();
+    std::memcpy(data_, data.data(), data.size());
+    size_ = data.size();
+  }
+
+  ~GuardedBuffer() { munmap(map_, map_size_); }
+
+  std::uint8_t *data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  size_t page_size_;
+  size_t map_size_;
+  std::uint8_t *map_;
+  std::uint8_t *data_;
+  size_t size_;
+};
+
+class NullStream : public IOStream {
+ public:
+  NullStream() : IOStream(256) {}
+
+  void *allocBuffer(size_t min_size) override {
+    buffer_.resize(min_size);
+    return buffer_.data();
+  }
+  size_t commitBuffer(size_t size) override { return size; }
+  const unsigned char *read(void *, size_t *) override { return nullptr; }
+  void forceStop() override {}
+
+ private:
+  std::vector<std::uint8_t> buffer_;
+};
+
+int s_calls = 0;
+
+GLint rcGetRendererVersion() {
+  s_calls++;
+  return 1;
+}
+
+EGLint rcGetEGLVersion(EGLint *major, EGLint *minor) {
+  s_calls++;
+  *major = 1;
+  *minor = 4;
+  return EGL_TRUE;
+}
+
+int rcUpdateColorBuffer(uint32_t, GLint, GLint, GLint, GLint, GLenum, GLenum, void *) {
+  s_calls++;
+  return 0;
+}
+
+void *no_proc(const char *, void *) { return nullptr; }
+
+void append_u32(std::vector<std::uint8_t> &buffer, std::uint32_t value) {
+  const auto offset = buffer.size();
+  buffer.resize(offset + sizeof(value));
+  std::memcpy(buffer.data() + offset, &value, sizeof(value));
+}
+
+void append_packet(std::vector<std::uint8_t> &buffer, std::uint32_t opcode,
+                   const std::vector<std::uint32_t> &args) {
+  append_u32(buffer, opcode);
+  append_u32(buffer, static_cast<std::uint32_t>(8 + args.size() * sizeof(std::uint32_t)));
+  for (const auto &arg : args)
+    append_u32(buffer, arg);
+}
+
+class RenderControlDecoder : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    decoder.initDispatchByName(no_proc, nullptr);
+    decoder.rcGetRendererVersion = rcGetRendererVersion;
+    decoder.rcGetEGLVersion = rcGetEGLVersion;
+    decoder.rcUpdateColorBuffer = rcUpdateColorBuffer;
+    s_calls = 0;
+  }
+
+  size_t decode(const std::vector<std::uint8_t> &packets) {
+    GuardedBuffer buffer(packets);
+    return decoder.decode(buffer.data(), buffer.size(), &stream);
+  }
+
+  ChecksumCalculatorThreadInfo checksum_info;
+  NullStream stream;
+  renderControl_decoder_context_t decoder;
+};
+}
+
+TEST_F(RenderControlDecoder, DecodesWellFormedPackets) {
+  std::vector<std::uint8_t> packets;
+  append_packet(packets, OP_rcGetRendererVersion, {});
+  append_packet(packets, OP_rcGetEGLVersion, {4, 4});
+
+  EXPECT_EQ(packets.size(), decode(packets));
+  EXPECT_EQ(2, s_calls);
+}
+
+TEST_F(RenderControlDecoder, SkipsPacketWithInPointerLargerThanPacket) {
+  // The pixels claim 4 KiB while the packet ends right after the size.
+  std::vector<std::uint8_t> packets;
+  append_packet(packets, OP_rcUpdateColorBuffer, {1, 0, 0, 16, 16, 0, 0, 4096});
+  append_packet(packets, OP_rcGetRendererVersion, {});
+
+  EXPECT_EQ(packets.size(), decode(packets));
+  EXPECT_EQ(1, s_calls);
+}
+
+TEST_F(RenderControlDecoder, SkipsPacketWithOversizedOutPointers) {
+  // Both sizes wrap to 8 when added in 32 bit.
+  std::vector<std::uint8_t> packets;
+  append_packet(packets, OP_rcGetEGLVersion, {0x80000004, 0x80000004});
+  append_packet(packets, OP_rcGetRendererVersion, {});
+
+  EXPECT_EQ(packets.size(), decode(packets));
+  EXPECT_EQ(1, s_calls);
+}
+
+TEST_F(RenderControlDecoder, StopsAtPacketShorterThanItsHeader) {
+  std::vector<std::uint8_t> packets;
+  append_packet(packets, OP_rcGetRendererVersion, {});
+  append_u32(packets, OP_rcGetRendererVersion);
+  append_u32(packets, 4);
+
+  EXPECT_EQ(8, decode(packets));
+  EXPECT_EQ(1, s_calls);
+}
+
+TEST_F(RenderControlDecoder, StopsAtUnknownOpcode) {
+  std::vector<std::uint8_t> packets;
+  append_packet(packets, OP_rcGetRendererVersion, {});
+  append_packet(packets, OP_last + 1, {});
+  append_packet(packets, OP_rcGetRendererVersion, {});
+
+  EXPECT_EQ(8, decode(packets));
+  EXPECT_EQ(1, s_calls);
+}
+
+TEST_F(RenderControlDecoder, WaitsForTruncatedPacket) {
+  std::vector<std::uint8_t> packets;
+  append_packet(packets, OP_rcGetRendererVersion, {});
+  append_packet(packets, OP_rcGetEGLVersion, {4, 4});
+  packets.resize(packets.size() - 4);
+
+  EXPECT_EQ(8, decode(packets));
+  EXPECT_EQ(1, s_calls);
+}
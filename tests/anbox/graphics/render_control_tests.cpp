@@ -21,9 +21,15 @@
 
 extern int rcGetDisplayWidth(uint32_t display_id);
 extern int rcGetDisplayHeight(uint32_t display_id);
+extern int rcGetDisplayVsyncPeriod(uint32_t display_id);
 
 TEST(RenderControl, WidthHeightAreCorrectlyAssigned) {
   anbox::graphics::emugl::DisplayInfo::get()->set_resolution(640, 480);
   ASSERT_EQ(rcGetDisplayWidth(0), 640);
   ASSERT_EQ(rcGetDisplayHeight(0), 480);
 }
+
+TEST(RenderControl, VsyncPeriodIsReportedInNanoseconds) {
+  anbox::graphics::emugl::DisplayInfo::get()->set_vsync_period(std::chrono::milliseconds{8});
+  ASSERT_EQ(rcGetDisplayVsyncPeriod(0), 8000000);
+}
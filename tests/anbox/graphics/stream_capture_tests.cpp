@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "anbox/graphics/stream_capture.h"
+
+#include <gtest/gtest.h>
+
+#include <boost/filesystem.hpp>
+
+#include <cstring>
+#include <fstream>
+
+namespace fs = boost::filesystem;
+
+namespace anbox {
+namespace graphics {
+class StreamCaptureTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    path = (fs::temp_directory_path() / fs::unique_path("%%%%-%%%%.glcap")).string();
+  }
+  void TearDown() override { fs::remove(path); }
+
+  std::string path;
+};
+
+TEST_F(StreamCaptureTest, ChunksAreReadBackInOrder) {
+  const std::string first = "first chunk";
+  const std::string second = "second";
+  {
+    StreamCaptureWriter writer(path, 42);
+    writer.append(first.data(), first.size());
+    writer.append(second.data(), second.size());
+  }
+
+  const auto capture = StreamCapture::load(path);
+  EXPECT_EQ(42u, capture.client_flags());
+  ASSERT_EQ(2u, capture.chunks().size());
+  EXPECT_EQ(first + second, std::string(capture.data().begin(), capture.data().end()));
+
+  const auto &a = capture.chunks()[0];
+  const auto &b = capture.chunks()[1];
+  EXPECT_EQ(0u, a.offset);
+  EXPECT_EQ(first.size(), a.size);
+  EXPECT_EQ(first.size(), b.offset);
+  EXPECT_EQ(second.size(), b.size);
+  EXPECT_LE(a.timestamp_ns, b.timestamp_ns);
+}
+
+TEST_F(StreamCaptureTest, TruncatedRecordIsKeptPartially) {
+  const std::string data = "0123456789";
+  {
+    StreamCaptureWriter writer(path, 0);
+    writer.append(data.data(), data.size());
+  }
+  fs::resize_file(path, fs::file_size(path) - 4);
+
+  const auto capture = StreamCapture::load(path);
+  ASSERT_EQ(1u, capture.chunks().size());
+  EXPECT_EQ(data.size() - 4, capture.chunks()[0].size);
+}
+
+TEST_F(StreamCaptureTest, RejectsOtherFiles) {
+  std::ofstream(path) << "not a capture at all";
+  EXPECT_THROW(StreamCapture::load(path), std::runtime_error);
+  EXPECT_THROW(StreamCapture::load(path + ".missing"), std::runtime_error);
+}
+}  // namespace graphics
+}  // namespace anbox
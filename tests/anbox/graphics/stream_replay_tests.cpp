@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "anbox/graphics/stream_replay.h"
+#include "anbox/graphics/emugl/RenderApi.h"
+
+// Generated with emugl at build time
+#include "renderControl_opcodes.h"
+
+#include <gtest/gtest.h>
+
+#include <boost/filesystem.hpp>
+
+#include <cstdlib>
+#include <cstring>
+
+namespace fs = boost::filesystem;
+
+namespace {
+void append_u32(std::vector<std::uint8_t> &buffer, std::uint32_t value) {
+  const auto offset = buffer.size();
+  buffer.resize(offset + sizeof(value));
+  std::memcpy(buffer.data() + offset, &value, sizeof(value));
+}
+
+void append_packet(std::vector<std::uint8_t> &buffer, std::uint32_t opcode,
+                   const std::vector<std::uint32_t> &args) {
+  append_u32(buffer, opcode);
+  append_u32(buffer, static_cast<std::uint32_t>(8 + args.size() * sizeof(std::uint32_t)));
+  for (const auto &arg : args)
+    append_u32(buffer, arg);
+}
+}
+
+namespace anbox {
+namespace graphics {
+class StreamReplayTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // The decoders resolve their GL entry points from the host libraries
+    // when a render thread starts.
+    setenv("EGL_PLATFORM", "surfaceless", 0);
+    if (!emugl::initialize(emugl::default_gl_libraries(), nullptr, nullptr))
+      GTEST_SKIP() << "No host GL available";
+
+    path = (fs::temp_directory_path() / fs::unique_path("%%%%-%%%%.glcap")).string();
+  }
+  void TearDown() override {
+    if (!path.empty()) fs::remove(path);
+  }
+
+  std::string path;
+};
+
+TEST_F(StreamReplayTest, DropsRenderControlCallsWithoutRenderer) {
+  // What the guest's eglInitialize() starts with.
+  std::vector<std::uint8_t> packets;
+  append_packet(packets, OP_rcGetRendererVersion, {});
+  append_packet(packets, OP_rcGetNumConfigs, {sizeof(std::uint32_t)});
+  append_packet(packets, OP_rcGetConfigs, {256, 256});
+  append_packet(packets, OP_rcChooseConfig, {0, 0, 0, 0});
+  {
+    StreamCaptureWriter writer(path, 0);
+    writer.append(packets.data(), packets.size());
+  }
+
+  std::vector<StreamCapture> captures;
+  captures.push_back(StreamCapture::load(path));
+  StreamReplay replay(std::move(captures));
+  const auto result = replay.run(nullptr);
+
+  EXPECT_EQ(4u, result.packets);
+  EXPECT_EQ(packets.size(), result.bytes);
+}
+}  // namespace graphics
+}  // namespace anbox
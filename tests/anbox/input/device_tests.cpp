@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "anbox/input/device.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+using namespace anbox::input;
+
+namespace ba = boost::asio;
+
+namespace {
+// What the Android side reads, see
+// frameworks/native/services/inputflinger/EventHub.cpp
+struct Info {
+  char name[80];
+  int driver_version;
+  struct input_id id;
+  char physical_location[80];
+  char unique_id[80];
+  std::uint8_t key_bitmask[(KEY_MAX + 1) / 8];
+  std::uint8_t abs_bitmask[(ABS_MAX + 1) / 8];
+  std::uint8_t rel_bitmask[(REL_MAX + 1) / 8];
+  std::uint8_t sw_bitmask[(SW_MAX + 1) / 8];
+  std::uint8_t led_bitmask[(LED_MAX + 1) / 8];
+  std::uint8_t ff_bitmask[(FF_MAX + 1) / 8];
+  std::uint8_t prop_bitmask[(INPUT_PROP_MAX + 1) / 8];
+  std::uint32_t abs_max[ABS_CNT];
+  std::uint32_t abs_min[ABS_CNT];
+};
+
+struct WireEvent {
+  std::uint64_t sec;
+  std::uint64_t usec;
+  std::uint16_t type;
+  std::uint16_t code;
+  std::int32_t value;
+};
+
+bool operator==(const WireEvent &a, const Event &b) {
+  return a.type == b.type && a.code == b.code && a.value == b.value;
+}
+
+struct Fixture {
+  Fixture() : rt{anbox::Runtime::create(1)} {
+    char dir_template[] = "/tmp/anbox-input-XXXXXX";
+    dir = ::mkdtemp(dir_template);
+    device = Device::create(dir + "/event0", rt);
+    device->set_name("test-device");
+    rt->start();
+  }
+
+  ~Fixture() {
+    rt->stop();
+    ::unlink((dir + "/event0").c_str());
+    ::rmdir(dir.c_str());
+  }
+
+  std::unique_ptr<ba::local::stream_protocol::socket> connect() {
+    auto client = std::make_unique<ba::local::stream_protocol::socket>(rt->service());
+    client->connect(ba::local::stream_protocol::endpoint(device->socket_path()));
+    Info info;
+    ba::read(*client, ba::buffer(&info, sizeof(info)));
+    EXPECT_STREQ("test-device", info.name);
+    // The device only starts sending events once it saw the info go out.
+    std::this_thread::sleep_for(std::chrono::milliseconds{50});
+    return client;
+  }
+
+  std::vector<WireEvent> receive(ba::local::stream_protocol::socket &client, std::size_t count) {
+    std::vector<WireEvent> events(count);
+    ba::read(client, ba::buffer(events.data(), events.size() * sizeof(WireEvent)));
+    return events;
+  }
+
+  std::shared_ptr<anbox::Runtime> rt;
+  std::string dir;
+  std::shared_ptr<Device> device;
+};
+
+void expect_events(const std::vector<Event> &expected, const std::vector<WireEvent> &received) {
+  ASSERT_EQ(expected.size(), received.size());
+  for (std::size_t n = 0; n < expected.size(); n++)
+    EXPECT_TRUE(received[n] == expected[n]) << "event " << n << " is " << received[n].type << " "
+                                            << received[n].code << " " << received[n].value;
+}
+}
+
+TEST(InputDevice, SendsInfoThenEvents) {
+  Fixture f;
+  auto client = f.connect();
+
+  f.device->send_events({{EV_KEY, KEY_A, 1}, {EV_KEY, KEY_A, 0}});
+  const auto received = f.receive(*client, 2);
+  expect_events({{EV_KEY, KEY_A, 1}, {EV_KEY, KEY_A, 0}}, received);
+  EXPECT_GT(received[0].sec + received[0].usec, 0u);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds{20});
+  EXPECT_EQ(1u, f.device->latency().count);
+}
+
+TEST(InputDevice, MergesPointerMotionBetweenReports) {
+  Fixture f;
+  auto client = f.connect();
+
+  const std::vector<Event> motion{{EV_ABS, ABS_X, 10}, {EV_ABS, ABS_Y, 20},
+                                  {EV_REL, REL_X, 1}, {EV_REL, REL_Y, 2}, {EV_SYN, SYN_REPORT, 0}};
+  f.device->queue_events(motion);
+  f.device->queue_events({{EV_ABS, ABS_X, 11}, {EV_ABS, ABS_Y, 22},
+                          {EV_REL, REL_X, 1}, {EV_REL, REL_Y, 2}, {EV_SYN, SYN_REPORT, 0}});
+  // Buttons and axes the previous report didn't move separate reports.
+  f.device->queue_events({{EV_KEY, BTN_LEFT, 1}, {EV_SYN, SYN_REPORT, 0}});
+  f.device->queue_events(motion);
+  f.device->queue_events({{EV_REL, REL_WHEEL, 1}, {EV_SYN, SYN_REPORT, 0}});
+  f.device->queue_events({{EV_REL, REL_WHEEL, 1}, {EV_SYN, SYN_REPORT, 0}});
+  f.device->flush();
+
+  expect_events({{EV_ABS, ABS_X, 11}, {EV_ABS, ABS_Y, 22}, {EV_REL, REL_X, 2}, {EV_REL, REL_Y, 4}, {EV_SYN, SYN_REPORT, 0},
+                 {EV_KEY, BTN_LEFT, 1}, {EV_SYN, SYN_REPORT, 0},
+                 {EV_ABS, ABS_X, 10}, {EV_ABS, ABS_Y, 20}, {EV_REL, REL_X, 1}, {EV_REL, REL_Y, 2}, {EV_SYN, SYN_REPORT, 0},
+                 {EV_REL, REL_WHEEL, 2}, {EV_SYN, SYN_REPORT, 0}},
+                f.receive(*client, 14));
+}
+
+TEST(InputDevice, MergesTouchMotionOfTheSameSlotOnly) {
+  Fixture f;
+  auto client = f.connect();
+
+  f.device->queue_events({{EV_ABS, ABS_MT_SLOT, 0}, {EV_ABS, ABS_MT_TRACKING_ID, 1},
+                          {EV_ABS, ABS_MT_POSITION_X, 10}, {EV_ABS, ABS_MT_POSITION_Y, 10}, {EV_SYN, SYN_REPORT, 0}});
+  f.device->queue_events({{EV_ABS, ABS_MT_POSITION_X, 11}, {EV_ABS, ABS_MT_POSITION_Y, 11}, {EV_SYN, SYN_REPORT, 0}});
+  f.device->queue_events({{EV_ABS, ABS_MT_POSITION_X, 12}, {EV_ABS, ABS_MT_POSITION_Y, 12}, {EV_SYN, SYN_REPORT, 0}});
+  f.device->queue_events({{EV_ABS, ABS_MT_SLOT, 1}, {EV_ABS, ABS_MT_POSITION_X, 50},
+                          {EV_ABS, ABS_MT_POSITION_Y, 50}, {EV_SYN, SYN_REPORT, 0}});
+  f.device->queue_events({{EV_ABS, ABS_MT_SLOT, 0}, {EV_ABS, ABS_MT_POSITION_X, 13},
+                          {EV_ABS, ABS_MT_POSITION_Y, 13}, {EV_SYN, SYN_REPORT, 0}});
+  f.device->queue_events({{EV_ABS, ABS_MT_SLOT, 0}, {EV_ABS, ABS_MT_POSITION_X, 14},
+                          {EV_ABS, ABS_MT_POSITION_Y, 14}, {EV_SYN, SYN_REPORT, 0}});
+  f.device->queue_events({{EV_ABS, ABS_MT_TRACKING_ID, -1}, {EV_SYN, SYN_REPORT, 0}});
+  f.device->flush();
+
+  expect_events({{EV_ABS, ABS_MT_SLOT, 0}, {EV_ABS, ABS_MT_TRACKING_ID, 1},
+                 {EV_ABS, ABS_MT_POSITION_X, 10}, {EV_ABS, ABS_MT_POSITION_Y, 10}, {EV_SYN, SYN_REPORT, 0},
+                 {EV_ABS, ABS_MT_POSITION_X, 12}, {EV_ABS, ABS_MT_POSITION_Y, 12}, {EV_SYN, SYN_REPORT, 0},
+                 {EV_ABS, ABS_MT_SLOT, 1}, {EV_ABS, ABS_MT_POSITION_X, 50},
+                 {EV_ABS, ABS_MT_POSITION_Y, 50}, {EV_SYN, SYN_REPORT, 0},
+                 {EV_ABS, ABS_MT_SLOT, 0}, {EV_ABS, ABS_MT_POSITION_X, 14},
+                 {EV_ABS, ABS_MT_POSITION_Y, 14}, {EV_SYN, SYN_REPORT, 0},
+                 {EV_ABS, ABS_MT_TRACKING_ID, -1}, {EV_SYN, SYN_REPORT, 0}},
+                f.receive(*client, 18));
+}
+
+TEST(InputDevice, KeepsServingAfterClientLeft) {
+  Fixture f;
+  auto first = f.connect();
+  first.reset();
+
+  // The write to the client which is gone fails and drops it.
+  f.device->send_events({{EV_KEY, KEY_A, 1}});
+  std::this_thread::sleep_for(std::chrono::milliseconds{50});
+
+  auto second = f.connect();
+  f.device->send_events({{EV_KEY, KEY_B, 1}});
+  expect_events({{EV_KEY, KEY_B, 1}}, f.receive(*second, 1));
+}
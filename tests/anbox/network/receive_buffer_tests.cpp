@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "anbox/network/receive_buffer.h"
+
+#include <gmock/gmock.h>
+
+#include <cstring>
+#include <string>
+
+using namespace ::testing;
+
+namespace {
+anbox::network::ReceiveBuffer make_buffer(anbox::network::ReceiveBufferPool &pool,
+                                          const std::string &content) {
+  auto buffer = pool.acquire(content.size());
+  std::memcpy(buffer.data(), content.data(), content.size());
+  buffer.resize(content.size());
+  return buffer;
+}
+}
+
+TEST(ReceiveBufferPool, ReusesReleasedBuffers) {
+  auto pool = anbox::network::ReceiveBufferPool::create();
+
+  for (int n = 0; n < 100; n++) {
+    auto buffer = pool->acquire(100);
+    buffer.resize(100);
+    auto copy = buffer;
+    ASSERT_EQ(buffer.data(), copy.data());
+  }
+
+  const auto stats = pool->stats();
+  ASSERT_EQ(1, stats.allocations);
+  ASSERT_EQ(99, stats.reuses);
+}
+
+TEST(ReceiveBufferPool, SizesBuffersAfterRequest) {
+  auto pool = anbox::network::ReceiveBufferPool::create();
+
+  ASSERT_EQ(anbox::network::ReceiveBufferPool::min_size, pool->acquire(0).capacity());
+  ASSERT_EQ(anbox::network::ReceiveBufferPool::min_size, pool->acquire(1).capacity());
+  ASSERT_EQ(32 * 1024, pool->acquire(20000).capacity());
+  ASSERT_EQ(anbox::network::ReceiveBufferPool::max_size,
+            pool->acquire(10 * anbox::network::ReceiveBufferPool::max_size).capacity());
+}
+
+TEST(ReceiveBufferPool, BuffersOutliveTheirPool) {
+  auto pool = anbox::network::ReceiveBufferPool::create();
+  auto buffer = make_buffer(*pool, "abc");
+  pool.reset();
+
+  ASSERT_EQ("abc", std::string(buffer.begin(), buffer.end()));
+}
+
+TEST(ReceiveBufferChain, ReadsAcrossBuffers) {
+  auto pool = anbox::network::ReceiveBufferPool::create();
+  anbox::network::ReceiveBufferChain chain;
+
+  chain.append(make_buffer(*pool, "00"));
+  chain.append(make_buffer(*pool, "05he"));
+  chain.append(make_buffer(*pool, "llo"));
+  chain.append(make_buffer(*pool, ""));
+  ASSERT_EQ(9, chain.size());
+
+  char header[5] = {0};
+  ASSERT_EQ(4, chain.copy(header, 4));
+  ASSERT_STREQ("0005", header);
+
+  std::string body(5, ' ');
+  ASSERT_EQ(5, chain.copy(&body[0], 5, 4));
+  ASSERT_EQ("hello", body);
+
+  ASSERT_EQ(anbox::network::ReceiveBufferChain::npos, chain.find('x'));
+
+  chain.consume(5);
+  ASSERT_EQ(4, chain.size());
+  ASSERT_EQ(3, chain.find('o'));
+
+  char rest[4] = {0};
+  ASSERT_EQ(4, chain.copy(rest, sizeof(rest)));
+  ASSERT_EQ(0, std::memcmp("ello", rest, sizeof(rest)));
+
+  chain.consume(10);
+  ASSERT_TRUE(chain.empty());
+}
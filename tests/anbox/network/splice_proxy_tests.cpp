@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "anbox/network/splice_proxy.h"
+
+#include <gmock/gmock.h>
+
+#include <chrono>
+#include <future>
+#include <string>
+#include <thread>
+
+#include <sys/socket.h>
+
+using namespace ::testing;
+
+namespace ba = boost::asio;
+
+namespace {
+typedef anbox::network::SpliceProxy<ba::local::stream_protocol, ba::local::stream_protocol> Proxy;
+
+// Two socket pairs with a proxy in between: guest <-> a <-proxy-> b <-> host.
+struct Fixture {
+  Fixture() : rt{anbox::Runtime::create(2)} {
+    ba::local::connect_pair(guest, *a);
+    ba::local::connect_pair(*b, host);
+    proxy = std::make_shared<Proxy>(rt, a, b);
+    rt->start();
+  }
+
+  ~Fixture() { rt->stop(); }
+
+  std::shared_ptr<anbox::Runtime> rt;
+  ba::local::stream_protocol::socket guest{rt->service()};
+  ba::local::stream_protocol::socket host{rt->service()};
+  std::shared_ptr<ba::local::stream_protocol::socket> a =
+      std::make_shared<ba::local::stream_protocol::socket>(rt->service());
+  std::shared_ptr<ba::local::stream_protocol::socket> b =
+      std::make_shared<ba::local::stream_protocol::socket>(rt->service());
+  std::shared_ptr<Proxy> proxy;
+};
+
+std::string make_payload(size_t size) {
+  std::string payload(size, '\0');
+  for (size_t n = 0; n < size; n++) payload[n] = static_cast<char>(n * 7);
+  return payload;
+}
+}
+
+TEST(SpliceProxy, ForwardsBothDirections) {
+  Fixture f;
+  f.proxy->start([](const boost::system::error_code &) {});
+
+  const auto to_host = make_payload(4 * 1024 * 1024);
+  auto writer = std::async(std::launch::async, [&]() { ba::write(f.guest, ba::buffer(to_host)); });
+  std::string received(to_host.size(), '\0');
+  ba::read(f.host, ba::buffer(&received[0], received.size()));
+  writer.get();
+  ASSERT_EQ(to_host, received);
+
+  const std::string to_guest{"OKAY"};
+  ba::write(f.host, ba::buffer(to_guest));
+  received.resize(to_guest.size());
+  ba::read(f.guest, ba::buffer(&received[0], received.size()));
+  ASSERT_EQ(to_guest, received);
+
+  // The counters are updated right after the data was handed to the sink.
+  auto stats = f.proxy->stats();
+  for (int n = 0; n < 100 && (stats.a_to_b < to_host.size() || stats.b_to_a < to_guest.size()); n++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    stats = f.proxy->stats();
+  }
+  ASSERT_EQ(to_host.size(), stats.a_to_b);
+  ASSERT_EQ(to_guest.size(), stats.b_to_a);
+}
+
+TEST(SpliceProxy, StopsReadingWhileSinkIsBlocked) {
+  Fixture f;
+  f.proxy->start([](const boost::system::error_code &) {});
+
+  // Nobody reads on the host side so the guest must eventually be unable to
+  // write anything more instead of the proxy taking all of it.
+  f.guest.non_blocking(true);
+  const auto chunk = make_payload(64 * 1024);
+  std::string written;
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (std::chrono::steady_clock::now() < deadline) {
+    boost::system::error_code err;
+    const auto n = f.guest.write_some(ba::buffer(chunk), err);
+    if (err == ba::error::would_block) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      if (f.guest.write_some(ba::buffer(chunk), err) == 0 && err == ba::error::would_block)
+        break;
+    }
+    ASSERT_FALSE(err && err != ba::error::would_block);
+    written.append(chunk, 0, n);
+  }
+  ASSERT_LT(std::chrono::steady_clock::now(), deadline);
+
+  // Everything written so far still arrives in order once the host reads.
+  std::string received(written.size(), '\0');
+  ba::read(f.host, ba::buffer(&received[0], received.size()));
+  ASSERT_EQ(written, received);
+}
+
+TEST(SpliceProxy, ReportsEndOfStream) {
+  Fixture f;
+  std::promise<boost::system::error_code> closed;
+  f.proxy->start([&](const boost::system::error_code &err) { closed.set_value(err); });
+
+  f.guest.close();
+
+  auto result = closed.get_future();
+  ASSERT_EQ(std::future_status::ready, result.wait_for(std::chrono::seconds(5)));
+  ASSERT_EQ(ba::error::eof, result.get());
+}
+
+TEST(SpliceProxy, StopDoesNotCallCloseHandler) {
+  Fixture f;
+  bool called = false;
+  f.proxy->start([&](const boost::system::error_code &) { called = true; });
+  f.proxy->stop();
+
+  std::promise<void> drained;
+  f.rt->service().post([&]() { drained.set_value(); });
+  drained.get_future().wait();
+
+  f.guest.close();
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  ASSERT_FALSE(called);
+}
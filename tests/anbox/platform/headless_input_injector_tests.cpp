@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "anbox/platform/headless/input_injector.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+using namespace anbox::platform::headless;
+using anbox::input::Device;
+using anbox::input::Event;
+
+namespace ba = boost::asio;
+
+namespace {
+struct WireEvent {
+  std::uint64_t sec;
+  std::uint64_t usec;
+  std::uint16_t type;
+  std::uint16_t code;
+  std::int32_t value;
+};
+
+struct Fixture {
+  Fixture() : rt{anbox::Runtime::create(1)} {
+    char dir_template[] = "/tmp/anbox-injector-XXXXXX";
+    dir = ::mkdtemp(dir_template);
+    touch = Device::create(dir + "/touch", rt);
+    keyboard = Device::create(dir + "/keyboard", rt);
+    injector = InputInjector::create(dir + "/input", rt, touch, keyboard);
+    rt->start();
+  }
+
+  ~Fixture() {
+    rt->stop();
+    for (const auto &name : {"/touch", "/keyboard", "/input"})
+      ::unlink((dir + name).c_str());
+    ::rmdir(dir.c_str());
+  }
+
+  std::unique_ptr<ba::local::stream_protocol::socket> connect(const std::shared_ptr<Device> &device) {
+    auto client = std::make_unique<ba::local::stream_protocol::socket>(rt->service());
+    client->connect(ba::local::stream_protocol::endpoint(device->socket_path()));
+    // Skip the device info; events only go out once it was sent.
+    std::vector<char> info(4096);
+    while (client->available() == 0)
+      std::this_thread::sleep_for(std::chrono::milliseconds{5});
+    std::this_thread::sleep_for(std::chrono::milliseconds{50});
+    info.resize(client->available());
+    ba::read(*client, ba::buffer(info));
+    return client;
+  }
+
+  void expect_events(ba::local::stream_protocol::socket &client, const std::vector<Event> &expected) {
+    std::vector<WireEvent> received(expected.size());
+    ba::read(client, ba::buffer(received.data(), received.size() * sizeof(WireEvent)));
+    for (std::size_t n = 0; n < expected.size(); n++) {
+      EXPECT_EQ(expected[n].type, received[n].type) << "event " << n;
+      EXPECT_EQ(expected[n].code, received[n].code) << "event " << n;
+      EXPECT_EQ(expected[n].value, received[n].value) << "event " << n;
+    }
+  }
+
+  std::shared_ptr<anbox::Runtime> rt;
+  std::string dir;
+  std::shared_ptr<Device> touch;
+  std::shared_ptr<Device> keyboard;
+  std::shared_ptr<InputInjector> injector;
+};
+}
+
+TEST(HeadlessInputInjector, RejectsInvalidCommands) {
+  InputInjector injector(nullptr, nullptr, nullptr);
+
+  EXPECT_EQ("", injector.execute("").reply);
+  EXPECT_EQ("", injector.execute("  # a comment").reply);
+  EXPECT_EQ("ERROR unknown command 'swipe'", injector.execute("swipe 1 2 3 4").reply);
+  EXPECT_EQ("ERROR usage: down <slot> <x> <y>", injector.execute("down 0 1").reply);
+  EXPECT_EQ("ERROR usage: up <slot>", injector.execute("up 0 1").reply);
+  EXPECT_EQ("ERROR usage: key <code> [1|0]", injector.execute("key 30 2").reply);
+  EXPECT_EQ("ERROR no touch screen", injector.execute("down 0 1 2").reply);
+
+  const auto result = injector.execute("sleep 25");
+  EXPECT_EQ("OK", result.reply);
+  EXPECT_EQ(std::chrono::milliseconds{25}, result.delay);
+}
+
+TEST(HeadlessInputInjector, SendsTouchAndKeyEvents) {
+  Fixture f;
+  auto touch = f.connect(f.touch);
+  auto keyboard = f.connect(f.keyboard);
+
+  EXPECT_EQ("OK", f.injector->execute("down 1 10 20").reply);
+  f.expect_events(*touch, {{EV_ABS, ABS_MT_SLOT, 1}, {EV_ABS, ABS_MT_TRACKING_ID, 2},
+                           {EV_ABS, ABS_MT_POSITION_X, 10}, {EV_ABS, ABS_MT_POSITION_Y, 20},
+                           {EV_SYN, SYN_REPORT, 0}});
+  EXPECT_EQ("ERROR finger is already down", f.injector->execute("down 1 0 0").reply);
+
+  EXPECT_EQ("OK", f.injector->execute("move 1 11 21").reply);
+  f.expect_events(*touch, {{EV_ABS, ABS_MT_POSITION_X, 11}, {EV_ABS, ABS_MT_POSITION_Y, 21},
+                           {EV_SYN, SYN_REPORT, 0}});
+
+  // Taps take the first free finger.
+  EXPECT_EQ("OK", f.injector->execute("tap 5 6").reply);
+  f.expect_events(*touch, {{EV_ABS, ABS_MT_SLOT, 0}, {EV_ABS, ABS_MT_TRACKING_ID, 1},
+                           {EV_ABS, ABS_MT_POSITION_X, 5}, {EV_ABS, ABS_MT_POSITION_Y, 6},
+                           {EV_SYN, SYN_REPORT, 0},
+                           {EV_ABS, ABS_MT_TRACKING_ID, -1}, {EV_SYN, SYN_REPORT, 0}});
+
+  EXPECT_EQ("OK", f.injector->execute("up 1").reply);
+  f.expect_events(*touch, {{EV_ABS, ABS_MT_SLOT, 1}, {EV_ABS, ABS_MT_TRACKING_ID, -1},
+                           {EV_SYN, SYN_REPORT, 0}});
+  EXPECT_EQ("ERROR finger is not down", f.injector->execute("move 1 0 0").reply);
+
+  EXPECT_EQ("OK", f.injector->execute("key 30").reply);
+  f.expect_events(*keyboard, {{EV_KEY, 30, 1}, {EV_SYN, SYN_REPORT, 0},
+                              {EV_KEY, 30, 0}, {EV_SYN, SYN_REPORT, 0}});
+  EXPECT_EQ("OK", f.injector->execute("key 30 1").reply);
+  f.expect_events(*keyboard, {{EV_KEY, 30, 1}, {EV_SYN, SYN_REPORT, 0}});
+}
+
+TEST(HeadlessInputInjector, AnswersScriptsOverItsSocket) {
+  Fixture f;
+  ba::local::stream_protocol::socket client(f.rt->service());
+  client.connect(ba::local::stream_protocol::endpoint(f.dir + "/input"));
+
+  const auto start = std::chrono::steady_clock::now();
+  const std::string script = "# wait a bit\nsleep 30\ntap 1 2\nswipe\n";
+  ba::write(client, ba::buffer(script));
+
+  ba::streambuf buffer;
+  std::istream in(&buffer);
+  std::vector<std::string> replies;
+  while (replies.size() < 3) {
+    ba::read_until(client, buffer, '\n');
+    std::string line;
+    std::getline(in, line);
+    replies.push_back(line);
+  }
+
+  EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds{30});
+  EXPECT_EQ((std::vector<std::string>{"OK", "OK", "ERROR unknown command 'swipe'"}), replies);
+}
+
+TEST(HeadlessInputInjector, SerializesCommandsOfConcurrentSessions) {
+  Fixture f;
+
+  // Each tap takes a free finger and lifts it again, so none may ever
+  // find its finger taken by another session.
+  std::vector<std::thread> sessions;
+  std::vector<std::size_t> failures(InputInjector::max_fingers + 2, 0);
+  for (std::size_t n = 0; n < failures.size(); n++) {
+    sessions.emplace_back([&f, &failures, n]() {
+      for (int i = 0; i < 2000; i++) {
+        if (f.injector->execute("tap 1 1").reply != "OK")
+          failures[n]++;
+      }
+    });
+  }
+  for (auto &session : sessions)
+    session.join();
+
+  for (const auto &count : failures)
+    EXPECT_EQ(0u, count);
+}
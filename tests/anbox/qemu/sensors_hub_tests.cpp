@@ -0,0 +1,279 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "anbox/qemu/sensors_hub.h"
+#include "anbox/application/sensor_type.h"
+
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ::testing;
+using namespace std::chrono_literals;
+
+namespace {
+class RecordingMessenger : public anbox::network::SocketMessenger {
+ public:
+  void send(char const *data, size_t length) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    writes_.push_back(std::string(data, length));
+    cond_.notify_all();
+  }
+
+  ssize_t send_raw(char const *data, size_t length) override {
+    send(data, length);
+    return length;
+  }
+
+  void async_receive_msg(AnboxReadHandler const &, boost::asio::mutable_buffers_1 const &) override {}
+  boost::system::error_code receive_msg(boost::asio::mutable_buffers_1 const &) override { return {}; }
+  size_t available_bytes() override { return 0; }
+  anbox::network::Credentials creds() const override { return {0, 0, 0}; }
+  unsigned short local_port() const override { return 0; }
+  void set_no_delay() override {}
+  void close() override {}
+
+  std::vector<std::string> wait_for_writes(size_t count) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait_for(lock, 5s, [&]() { return writes_.size() >= count; });
+    return writes_;
+  }
+
+  std::vector<std::string> writes() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return writes_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::vector<std::string> writes_;
+};
+
+// Holds up every write until release() is called, like a pipe the guest
+// doesn't read from.
+class StalledMessenger : public RecordingMessenger {
+ public:
+  void send(char const *data, size_t length) override {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      stalled_ = true;
+      cond_.notify_all();
+      cond_.wait(lock, [&]() { return released_; });
+    }
+    RecordingMessenger::send(data, length);
+  }
+
+  bool wait_until_stalled() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return cond_.wait_for(lock, 5s, [&]() { return stalled_; });
+  }
+
+  void release() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    released_ = true;
+    cond_.notify_all();
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  bool stalled_ = false;
+  bool released_ = false;
+};
+
+// A pipe the guest doesn't read from which only has room for a few more
+// bytes until open() is called.
+class FullMessenger : public RecordingMessenger {
+ public:
+  explicit FullMessenger(size_t room) : room_(room) {}
+
+  // Like the blocking send of a real socket messenger.
+  void send(char const *data, size_t length) override {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cond_.wait(lock, [&]() { return opened_; });
+    }
+    RecordingMessenger::send(data, length);
+  }
+
+  ssize_t send_raw(char const *data, size_t length) override {
+    size_t taken = 0;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      taken = opened_ ? length : std::min(length, room_);
+      room_ -= std::min(taken, room_);
+    }
+    if (taken == 0) {
+      errno = EAGAIN;
+      return -1;
+    }
+    RecordingMessenger::send(data, taken);
+    return taken;
+  }
+
+  void open() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    opened_ = true;
+    cond_.notify_all();
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  size_t room_;
+  bool opened_ = false;
+};
+
+// Drops the sync message at the end as its timestamp changes every time.
+std::string without_sync(const std::string &messages) {
+  return messages.substr(0, messages.rfind("sync:") - 4);
+}
+
+struct Fixture {
+  Fixture() : rt{anbox::Runtime::create(1)} { rt->start(); }
+  ~Fixture() { rt->stop(); }
+
+  std::shared_ptr<anbox::Runtime> rt;
+  std::shared_ptr<anbox::application::SensorsState> state = std::make_shared<anbox::application::SensorsState>();
+  std::shared_ptr<anbox::qemu::SensorsHub> hub = std::make_shared<anbox::qemu::SensorsHub>(rt, state);
+  std::shared_ptr<RecordingMessenger> messenger = std::make_shared<RecordingMessenger>();
+};
+}
+
+TEST(SensorsHub, FormatsAllEnabledSensorsInOneBuffer) {
+  using anbox::application::SensorType;
+
+  anbox::application::SensorsValues values;
+  char buffer[1024];
+  const auto size = anbox::qemu::SensorsHub::format_messages(
+      values, SensorType::AccelerationSensor | SensorType::LightSensor, 1234, buffer, sizeof(buffer));
+
+  ASSERT_EQ("0018acceleration:0:0:9.80665000alight:12400009sync:1234", std::string(buffer, size));
+}
+
+TEST(SensorsHub, SendsOnlyWhenValuesChange) {
+  Fixture f;
+  auto subscription = f.hub->subscribe(f.messenger);
+  f.hub->set_delay(subscription, 10ms);
+  f.hub->set_enabled_sensors(subscription, anbox::application::SensorType::ProximitySensor);
+
+  // Sent right away and then only once the values change.
+  auto writes = f.messenger->wait_for_writes(1);
+  ASSERT_EQ(1, writes.size());
+  ASSERT_EQ("000bproximity:5", without_sync(writes[0]));
+
+  std::this_thread::sleep_for(100ms);
+  ASSERT_EQ(1, f.messenger->writes().size());
+
+  f.state->values.update([](anbox::application::SensorsValues &values) { values.proximity = 0; });
+  writes = f.messenger->wait_for_writes(2);
+  ASSERT_EQ(2, writes.size());
+  ASSERT_EQ("000bproximity:0", without_sync(writes[1]));
+
+  f.hub->unsubscribe(subscription);
+}
+
+TEST(SensorsHub, ResendsUnchangedValuesAfterMaxIdle) {
+  Fixture f;
+  auto subscription = f.hub->subscribe(f.messenger);
+  f.hub->set_delay(subscription, 10ms);
+  f.hub->set_enabled_sensors(subscription, anbox::application::SensorType::LightSensor);
+
+  const auto start = std::chrono::steady_clock::now();
+  const auto writes = f.messenger->wait_for_writes(2);
+  ASSERT_EQ(2, writes.size());
+  ASSERT_GE(std::chrono::steady_clock::now() - start, anbox::qemu::SensorsHub::max_idle - 10ms);
+
+  f.hub->unsubscribe(subscription);
+}
+
+TEST(SensorsHub, StopsSendingOnceSensorsAreDisabled) {
+  Fixture f;
+  auto first = f.hub->subscribe(f.messenger);
+  auto second_messenger = std::make_shared<RecordingMessenger>();
+  auto second = f.hub->subscribe(second_messenger);
+  f.hub->set_delay(first, 10ms);
+  f.hub->set_delay(second, 10ms);
+  f.hub->set_enabled_sensors(first, anbox::application::SensorType::LightSensor);
+  f.hub->set_enabled_sensors(second, anbox::application::SensorType::LightSensor);
+  ASSERT_EQ(1, f.messenger->wait_for_writes(1).size());
+  ASSERT_EQ(1, second_messenger->wait_for_writes(1).size());
+
+  f.hub->set_enabled_sensors(first, 0);
+  for (int n = 0; n < 5; n++) {
+    f.state->values.update([n](anbox::application::SensorsValues &values) { values.light = n; });
+    std::this_thread::sleep_for(30ms);
+  }
+
+  ASSERT_EQ(1, f.messenger->writes().size());
+  ASSERT_LT(1, second_messenger->writes().size());
+
+  f.hub->unsubscribe(first);
+  f.hub->unsubscribe(second);
+}
+
+TEST(SensorsHub, SendsWithoutHoldingItsLock) {
+  Fixture f;
+  auto messenger = std::make_shared<StalledMessenger>();
+  auto subscription = f.hub->subscribe(messenger);
+  f.hub->set_enabled_sensors(subscription, anbox::application::SensorType::LightSensor);
+  ASSERT_TRUE(messenger->wait_until_stalled());
+
+  // The guest changing its rate must not wait for the stalled write.
+  auto changed = std::async(std::launch::async, [&]() { f.hub->set_delay(subscription, 10ms); });
+  const auto status = changed.wait_for(1s);
+  messenger->release();
+  ASSERT_EQ(std::future_status::ready, status);
+  ASSERT_EQ(1, messenger->wait_for_writes(1).size());
+
+  f.hub->unsubscribe(subscription);
+}
+
+TEST(SensorsHub, KeepsSendingWhileAnotherPipeIsFull) {
+  Fixture f;
+  auto full_messenger = std::make_shared<FullMessenger>(5);
+  auto full = f.hub->subscribe(full_messenger);
+  auto other = f.hub->subscribe(f.messenger);
+  f.hub->set_delay(full, 10ms);
+  f.hub->set_delay(other, 10ms);
+  f.hub->set_enabled_sensors(full, anbox::application::SensorType::LightSensor);
+  f.hub->set_enabled_sensors(other, anbox::application::SensorType::LightSensor);
+  ASSERT_EQ(1, full_messenger->wait_for_writes(1).size());
+
+  for (int n = 0; n < 3; n++)
+    f.state->values.update([n](anbox::application::SensorsValues &values) { values.light = n; });
+  ASSERT_LE(2, f.messenger->wait_for_writes(2).size());
+
+  // The rest of the first messages follows once the guest reads again.
+  full_messenger->open();
+  const auto writes = full_messenger->wait_for_writes(2);
+  ASSERT_EQ(2, writes.size());
+  ASSERT_EQ("000alight:1240", without_sync(writes[0] + writes[1]));
+
+  f.hub->unsubscribe(full);
+  f.hub->unsubscribe(other);
+}
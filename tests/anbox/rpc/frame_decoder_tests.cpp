@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "anbox/rpc/frame_decoder.h"
+#include "anbox/rpc/constants.h"
+
+#include <gmock/gmock.h>
+
+#include <string>
+
+using namespace ::testing;
+
+namespace {
+std::vector<std::uint8_t> make_frame(std::uint8_t type, const std::string &payload) {
+  const auto size = payload.size();
+  std::vector<std::uint8_t> frame{
+      static_cast<std::uint8_t>((size >> 16) & 0xff),
+      static_cast<std::uint8_t>((size >> 8) & 0xff),
+      static_cast<std::uint8_t>((size >> 0) & 0xff), type};
+  frame.insert(frame.end(), payload.begin(), payload.end());
+  return frame;
+}
+
+struct DecodedFrame {
+  std::uint8_t type;
+  std::string payload;
+
+  bool operator==(const DecodedFrame &other) const {
+    return type == other.type && payload == other.payload;
+  }
+};
+
+class FrameCollector {
+ public:
+  void decode(anbox::rpc::FrameDecoder &decoder, const std::vector<std::uint8_t> &data,
+              size_t offset, size_t size) {
+    decoder.decode(data.data() + offset, size, [&](const anbox::rpc::FrameDecoder::Frame &frame) {
+      frames.push_back({frame.type, std::string(reinterpret_cast<const char *>(frame.data), frame.size)});
+    });
+  }
+
+  std::vector<DecodedFrame> frames;
+};
+}
+
+TEST(FrameDecoder, DecodesAllFramesOfOneChunk) {
+  auto data = make_frame(anbox::rpc::MessageType::invocation, "first");
+  const auto second = make_frame(anbox::rpc::MessageType::response, "");
+  const auto third = make_frame(anbox::rpc::MessageType::response, "third");
+  data.insert(data.end(), second.begin(), second.end());
+  data.insert(data.end(), third.begin(), third.end());
+
+  anbox::rpc::FrameDecoder decoder;
+  FrameCollector collector;
+  collector.decode(decoder, data, 0, data.size());
+
+  ASSERT_THAT(collector.frames,
+              ElementsAre(DecodedFrame{anbox::rpc::MessageType::invocation, "first"},
+                          DecodedFrame{anbox::rpc::MessageType::response, ""},
+                          DecodedFrame{anbox::rpc::MessageType::response, "third"}));
+  ASSERT_EQ(0, decoder.buffered());
+}
+
+TEST(FrameDecoder, HandlesHeadersSplitAcrossChunks) {
+  auto data = make_frame(anbox::rpc::MessageType::invocation, "abc");
+  const auto second = make_frame(anbox::rpc::MessageType::response, "de");
+  data.insert(data.end(), second.begin(), second.end());
+
+  anbox::rpc::FrameDecoder decoder;
+  FrameCollector collector;
+  for (size_t n = 0; n < data.size(); n++) {
+    collector.decode(decoder, data, n, 1);
+    // The first frame has a header and three bytes of payload
+    ASSERT_EQ(n < 6 ? 0 : n < data.size() - 1 ? 1 : 2, collector.frames.size());
+  }
+
+  ASSERT_THAT(collector.frames,
+              ElementsAre(DecodedFrame{anbox::rpc::MessageType::invocation, "abc"},
+                          DecodedFrame{anbox::rpc::MessageType::response, "de"}));
+  ASSERT_EQ(0, decoder.buffered());
+}
+
+TEST(FrameDecoder, ReassemblesLargeFrameFromManyChunks) {
+  std::string payload(3 * 1024 * 1024 + 17, '\0');
+  for (size_t n = 0; n < payload.size(); n++)
+    payload[n] = static_cast<char>(n * 31);
+
+  auto data = make_frame(anbox::rpc::MessageType::invocation, payload);
+  const auto small = make_frame(anbox::rpc::MessageType::response, "x");
+  data.insert(data.end(), small.begin(), small.end());
+
+  anbox::rpc::FrameDecoder decoder;
+  FrameCollector collector;
+  const size_t chunk_size = 8192;
+  for (size_t offset = 0; offset < data.size(); offset += chunk_size)
+    collector.decode(decoder, data, offset, std::min(chunk_size, data.size() - offset));
+
+  ASSERT_EQ(2, collector.frames.size());
+  ASSERT_TRUE(collector.frames[0] == (DecodedFrame{anbox::rpc::MessageType::invocation, payload}));
+  ASSERT_TRUE(collector.frames[1] == (DecodedFrame{anbox::rpc::MessageType::response, "x"}));
+  ASSERT_EQ(0, decoder.buffered());
+}
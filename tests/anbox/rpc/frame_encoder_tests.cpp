@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "anbox/rpc/frame_encoder.h"
+#include "anbox/rpc/constants.h"
+
+#include "anbox_rpc.pb.h"
+
+#include <gmock/gmock.h>
+
+using namespace ::testing;
+
+namespace {
+std::vector<std::uint8_t> make_frame(std::uint8_t type, const google::protobuf::MessageLite &message) {
+  const auto payload = message.SerializeAsString();
+  const auto size = payload.size();
+  std::vector<std::uint8_t> frame{
+      static_cast<std::uint8_t>((size >> 16) & 0xff),
+      static_cast<std::uint8_t>((size >> 8) & 0xff),
+      static_cast<std::uint8_t>((size >> 0) & 0xff), type};
+  frame.insert(frame.end(), payload.begin(), payload.end());
+  return frame;
+}
+
+anbox::protobuf::rpc::Void make_payload(size_t size) {
+  anbox::protobuf::rpc::Void payload;
+  payload.set_error(std::string(size, 'x'));
+  return payload;
+}
+}
+
+TEST(FrameEncoder, EncodesInvocationsLikeProtobuf) {
+  anbox::rpc::FrameEncoder encoder;
+
+  for (const auto payload_size : {0, 10, 200, 70000}) {
+    for (const std::uint32_t id : {0u, 127u, 128u, 0xffffffffu}) {
+      const auto payload = make_payload(payload_size);
+
+      anbox::protobuf::rpc::Invocation invocation;
+      invocation.set_id(id);
+      invocation.set_method_name("launch_application");
+      invocation.set_parameters(payload.SerializeAsString());
+      invocation.set_protocol_version(1);
+
+      ASSERT_EQ(make_frame(anbox::rpc::MessageType::invocation, invocation),
+                encoder.encode_invocation(id, "launch_application", payload));
+    }
+  }
+}
+
+TEST(FrameEncoder, EncodesResponsesAndEventsLikeProtobuf) {
+  anbox::rpc::FrameEncoder encoder;
+
+  for (const auto payload_size : {0, 10, 200, 70000}) {
+    const auto payload = make_payload(payload_size);
+
+    anbox::protobuf::rpc::Result response;
+    response.set_id(300);
+    response.set_response(payload.SerializeAsString());
+    ASSERT_EQ(make_frame(anbox::rpc::MessageType::response, response),
+              encoder.encode_response(300, payload));
+
+    anbox::protobuf::rpc::Result event;
+    event.add_events(payload.SerializeAsString());
+    ASSERT_EQ(make_frame(anbox::rpc::MessageType::response, event),
+              encoder.encode_event(payload));
+  }
+}
+
+TEST(FrameEncoder, ReleasesOversizedBuffers) {
+  anbox::rpc::FrameEncoder encoder;
+
+  const auto small = encoder.encode_event(make_payload(10)).data();
+  encoder.trim();
+  ASSERT_EQ(small, encoder.encode_event(make_payload(5)).data());
+
+  encoder.encode_event(make_payload(anbox::rpc::FrameEncoder::max_retained_size));
+  encoder.trim();
+  ASSERT_LT(encoder.encode_event(make_payload(10)).capacity(),
+            anbox::rpc::FrameEncoder::max_retained_size);
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "anbox/rpc/pending_call_cache.h"
+
+#include "anbox_rpc.pb.h"
+
+#include <gmock/gmock.h>
+
+#include <vector>
+
+using namespace ::testing;
+
+namespace {
+anbox::protobuf::rpc::Invocation make_invocation(std::uint32_t id) {
+  anbox::protobuf::rpc::Invocation invocation;
+  invocation.set_id(id);
+  invocation.set_method_name("test");
+  invocation.set_parameters("");
+  invocation.set_protocol_version(1);
+  return invocation;
+}
+
+anbox::protobuf::rpc::Result make_result(std::uint32_t id, const std::string &response) {
+  anbox::protobuf::rpc::Result result;
+  result.set_id(id);
+  result.set_response(response);
+  return result;
+}
+
+void deliver(anbox::rpc::PendingCallCache &cache, anbox::protobuf::rpc::Result &result) {
+  cache.populate_message_for_result(result, [&](google::protobuf::MessageLite *message) {
+    message->ParseFromString(result.response());
+  });
+  cache.complete_response(result);
+}
+}
+
+TEST(PendingCallCache, CompletesCallsInAnyOrder) {
+  anbox::rpc::PendingCallCache cache;
+
+  std::vector<std::uint32_t> completed;
+  anbox::protobuf::rpc::Invocation responses[3];
+  for (std::uint32_t id = 0; id < 3; id++) {
+    cache.save_completion_details(id, &responses[id],
+                                  [&completed, id](anbox::rpc::CallStatus status) {
+                                    EXPECT_EQ(anbox::rpc::CallStatus::completed, status);
+                                    completed.push_back(id);
+                                  });
+  }
+
+  for (const std::uint32_t id : {2, 0, 1}) {
+    auto result = make_result(id, make_invocation(100 + id).SerializeAsString());
+    deliver(cache, result);
+  }
+
+  ASSERT_THAT(completed, ElementsAre(2, 0, 1));
+  for (std::uint32_t id = 0; id < 3; id++) ASSERT_EQ(100 + id, responses[id].id());
+  ASSERT_TRUE(cache.empty());
+}
+
+TEST(PendingCallCache, DropsResponsesOfCancelledCalls) {
+  anbox::rpc::PendingCallCache cache;
+
+  anbox::protobuf::rpc::Invocation response;
+  std::vector<anbox::rpc::CallStatus> statuses;
+  cache.save_completion_details(7, &response,
+                                [&](anbox::rpc::CallStatus status) { statuses.push_back(status); });
+
+  ASSERT_TRUE(cache.cancel(7, anbox::rpc::CallStatus::timed_out));
+  ASSERT_FALSE(cache.cancel(7, anbox::rpc::CallStatus::timed_out));
+
+  auto result = make_result(7, make_invocation(42).SerializeAsString());
+  deliver(cache, result);
+
+  ASSERT_THAT(statuses, ElementsAre(anbox::rpc::CallStatus::timed_out));
+  ASSERT_FALSE(response.has_id());
+  ASSERT_TRUE(cache.empty());
+}
+
+TEST(PendingCallCache, ForcedCompletionReportsDisconnect) {
+  anbox::rpc::PendingCallCache cache;
+
+  anbox::protobuf::rpc::Invocation responses[2];
+  std::vector<anbox::rpc::CallStatus> statuses;
+  for (std::uint32_t id = 0; id < 2; id++) {
+    cache.save_completion_details(id, &responses[id],
+                                  [&](anbox::rpc::CallStatus status) {
+                                    statuses.push_back(status);
+                                    // Handlers run without the cache locked
+                                    // and may start new calls.
+                                    EXPECT_TRUE(cache.empty());
+                                  });
+  }
+
+  cache.force_completion();
+
+  ASSERT_THAT(statuses, ElementsAre(anbox::rpc::CallStatus::disconnected,
+                                    anbox::rpc::CallStatus::disconnected));
+}